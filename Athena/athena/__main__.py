@@ -14,9 +14,9 @@ if __name__ == "__main__":
     global_config = GlobalConfig.get_instance()
     default_port = global_config.config.athena.port
     
-    # Use direct uvicorn.run() to ensure startup events work
-    import uvicorn
+    # Serve on a socket the launcher can hand over for overlapping restarts
+    from shared.utils.socket_server import run_with_socket_reuse
     from athena.api.app import app
     
     print(f"Starting Athena on port {default_port}...")
-    uvicorn.run(app, host="0.0.0.0", port=default_port)
\ No newline at end of file
+    run_with_socket_reuse(app, host="0.0.0.0", port=default_port, component_name="athena")
\ No newline at end of file
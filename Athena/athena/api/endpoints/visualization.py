@@ -239,7 +239,18 @@ async def get_node_subgraph(
     center_entity = await engine.get_entity(center_node)
     if not center_entity:
         raise HTTPException(status_code=404, detail=f"Entity with ID {center_node} not found")
-    
+
+    # The in-memory adapter expands the whole neighbourhood in one call
+    adapter = getattr(engine, "adapter", None)
+    if min_confidence <= 0.0 and hasattr(adapter, "get_neighborhood"):
+        entities, relationships = await adapter.get_neighborhood(
+            [center_entity.entity_id], depth, relationship_type, "both"
+        )
+        return {
+            "entities": entities,
+            "relationships": relationships
+        }
+
     # Collect entities and relationships
     entities = [center_entity]
     relationships = []
@@ -2,7 +2,8 @@
 Memory-based Graph Module for Athena
 
 Provides a simple in-memory implementation of the graph database interface
-with file-based persistence. Uses NetworkX as the underlying graph storage.
+persisted as a mapped binary snapshot plus a write-ahead log. The graph's
+structure is kept in a GraphIndex (shared/utils/graph_index.py).
 """
 
 from .adapter import MemoryAdapter
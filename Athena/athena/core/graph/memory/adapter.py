@@ -7,13 +7,15 @@ Provides the main adapter class with common operations.
 import os
 import json
 import logging
-from typing import Dict, Any, List, Optional
+from typing import Dict, Any, List, Optional, Tuple
 from pathlib import Path
-import networkx as nx
+
+from shared.utils.graph_index import GraphIndex
 
 from ...entity import Entity
 from ...relationship import Relationship
-from .persistence import load_data, save_data
+from .persistence import close_data, load_data, save_data
+from .snapshot import RecordMap
 from .entity_ops import (
     create_entity, 
     get_entity, 
@@ -31,16 +33,19 @@ from .query_ops import (
     get_entity_relationships, 
     execute_query
 )
-from .path_ops import find_paths
+from .path_ops import find_paths, get_neighborhood
 
 logger = logging.getLogger("athena.graph.memory.adapter")
 
 class MemoryAdapter:
     """
-    In-memory graph database adapter using NetworkX.
+    In-memory graph database adapter.
     
-    Provides a simple implementation of the graph database interface
-    with optional file persistence for testing and development.
+    Entities and relationships are kept in maps by ID; the graph's
+    structure is kept in a GraphIndex (compressed-sparse-row arrays, native
+    when src/tekton-graph is built) that answers adjacency, path and
+    neighbourhood queries. The graph persists as a mapped snapshot plus a
+    write-ahead log of the mutations since, checkpointed in the background.
     """
     
     def __init__(self, data_path: str, **kwargs):
@@ -50,11 +55,23 @@ class MemoryAdapter:
         Args:
             data_path: Path to store persistence files
             **kwargs: Additional configuration options
+                graph_threads: Threads for neighbourhood expansion (default: one per CPU)
+                checkpoint_bytes: Log size that starts a background checkpoint (default: 64 MiB)
+                wal_fsync: Sync the log after every mutation (default: False)
         """
         self.data_path = data_path
+        self.snapshot_file = os.path.join(data_path, "graph.snapshot")
+        # Read once, from graphs saved before the snapshot format
         self.entity_file = os.path.join(data_path, "entities.json")
         self.relationship_file = os.path.join(data_path, "relationships.json")
-        self.graph = nx.MultiDiGraph()
+        self.entities: RecordMap = RecordMap(Entity.from_dict)
+        self.relationships: RecordMap = RecordMap(Relationship.from_dict)
+        self.index = GraphIndex(threads=kwargs.get("graph_threads", 0))
+        self.checkpoint_bytes = kwargs.get("checkpoint_bytes", 64 << 20)
+        self.wal_fsync = kwargs.get("wal_fsync", False)
+        self.wal = None
+        self.checkpoint_thread = None
+        self.checkpoint_error = None
         self.is_connected = False
         
     async def connect(self) -> bool:
@@ -85,8 +102,8 @@ class MemoryAdapter:
         """
         logger.info("Disconnecting from in-memory graph database")
         
-        # Save data to files
-        await save_data(self)
+        # Checkpoint, so the next start has no log to replay
+        await close_data(self)
         
         self.is_connected = False
         logger.info("Disconnected from in-memory graph database")
@@ -142,6 +159,11 @@ class MemoryAdapter:
     async def find_paths(self, source_id: str, target_id: str, max_depth: int = 3):
         return await find_paths(self, source_id, target_id, max_depth)
         
+    async def get_neighborhood(self, entity_ids: List[str], depth: int = 1,
+                               relationship_type: Optional[str] = None,
+                               direction: str = "both") -> Tuple[List[Entity], List[Relationship]]:
+        return await get_neighborhood(self, entity_ids, depth, relationship_type, direction)
+        
     # Persistence operations
     async def sync(self) -> bool:
         """
@@ -160,7 +182,7 @@ class MemoryAdapter:
         
     # Count operations
     async def count_entities(self) -> int:
-        return len(self.graph.nodes)
+        return self.index.node_count()
         
     async def count_relationships(self) -> int:
-        return len(self.graph.edges)
\ No newline at end of file
+        return len(self.relationships)
\ No newline at end of file
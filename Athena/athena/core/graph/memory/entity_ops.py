@@ -8,6 +8,8 @@ import logging
 from typing import Optional
 
 from ...entity import Entity
+from .persistence import log_mutation
+from .wal import DELETE_ENTITY, PUT_ENTITY
 
 logger = logging.getLogger("athena.graph.memory.entity_ops")
 
@@ -22,7 +24,9 @@ async def create_entity(adapter, entity: Entity) -> str:
     Returns:
         Entity ID
     """
-    adapter.graph.add_node(entity.entity_id, entity=entity)
+    adapter.entities[entity.entity_id] = entity
+    adapter.index.add_node(entity.entity_id)
+    log_mutation(adapter, PUT_ENTITY, entity)
     logger.debug(f"Created entity: {entity.name} ({entity.entity_id})")
     return entity.entity_id
 
@@ -37,8 +41,8 @@ async def get_entity(adapter, entity_id: str) -> Optional[Entity]:
     Returns:
         Entity or None if not found
     """
-    if entity_id in adapter.graph.nodes:
-        entity = adapter.graph.nodes[entity_id].get('entity')
+    if adapter.index.has_node(entity_id):
+        entity = adapter.entities.get(entity_id)
         if entity:
             logger.debug(f"Retrieved entity: {entity.name} ({entity.entity_id})")
         else:
@@ -58,8 +62,9 @@ async def update_entity(adapter, entity: Entity) -> bool:
     Returns:
         True if successful
     """
-    if entity.entity_id in adapter.graph.nodes:
-        adapter.graph.nodes[entity.entity_id]['entity'] = entity
+    if adapter.index.has_node(entity.entity_id):
+        adapter.entities[entity.entity_id] = entity
+        log_mutation(adapter, PUT_ENTITY, entity)
         logger.debug(f"Updated entity: {entity.name} ({entity.entity_id})")
         return True
     logger.warning(f"Cannot update entity: {entity.entity_id} - not found")
@@ -76,8 +81,12 @@ async def delete_entity(adapter, entity_id: str) -> bool:
     Returns:
         True if successful
     """
-    if entity_id in adapter.graph.nodes:
-        adapter.graph.remove_node(entity_id)
+    if adapter.index.has_node(entity_id):
+        # Its relationships go with it
+        for relationship_id in adapter.index.remove_node(entity_id):
+            adapter.relationships.pop(relationship_id, None)
+        adapter.entities.pop(entity_id, None)
+        log_mutation(adapter, DELETE_ENTITY, object_id=entity_id)
         logger.debug(f"Deleted entity: {entity_id}")
         return True
     logger.warning(f"Cannot delete entity: {entity_id} - not found")
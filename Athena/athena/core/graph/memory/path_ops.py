@@ -1,69 +1,80 @@
 """
 Path Operations for Memory Graph
 
-Provides functions for finding paths in the memory graph.
+Provides functions for finding paths and neighbourhoods in the memory graph.
 """
 
 import logging
-import networkx as nx
-from typing import List, Union
+from typing import List, Optional, Tuple, Union
+
+from shared.utils.graph_index import PATH_LIMIT
 
 from ...entity import Entity
 from ...relationship import Relationship
 
 logger = logging.getLogger("athena.graph.memory.path_ops")
 
-async def find_paths(adapter, source_id: str, target_id: str, max_depth: int = 3) -> List[List[Union[Entity, Relationship]]]:
+async def find_paths(adapter, source_id: str, target_id: str, max_depth: int = 3,
+                     limit: int = PATH_LIMIT) -> List[List[Union[Entity, Relationship]]]:
     """
     Find paths between two entities.
-    
+
     Args:
         adapter: The memory adapter instance
         source_id: Source entity ID
         target_id: Target entity ID
         max_depth: Maximum path length
-        
+        limit: Maximum number of paths returned
+
     Returns:
         List of paths, where each path is a list of alternating Entity and Relationship objects
     """
-    if source_id not in adapter.graph.nodes or target_id not in adapter.graph.nodes:
+    if not adapter.index.has_node(source_id) or not adapter.index.has_node(target_id):
         logger.debug(f"Cannot find path: source {source_id} or target {target_id} not found")
         return []
-        
-    # Use NetworkX to find simple paths
-    try:
-        # Find all simple paths up to length 2*max_depth (edges + nodes)
-        # This accounts for the fact that we're counting relationship hops, not graph hops
-        simple_paths = list(nx.all_simple_paths(
-            adapter.graph, source_id, target_id, cutoff=max_depth*2-1
-        ))
-    except nx.NetworkXNoPath:
-        logger.debug(f"No path found between {source_id} and {target_id}")
-        return []
-        
-    # Convert simple paths to entity/relationship sequences
+    if source_id == target_id:
+        return [[adapter.entities.get(source_id)]]
+
+    # Simple paths of up to 2*max_depth-1 relationships, as the adapter has always
+    # searched. Between two entities joined by several relationships, the first
+    # one created is used, so each sequence of entities appears once.
+    edge_paths = adapter.index.paths(source_id, target_id, max_depth * 2 - 1, limit)
+
+    # Convert edge paths to entity/relationship sequences
     result_paths = []
-    for path in simple_paths:
-        entity_rel_path = []
-        
-        # Add the source entity
-        entity_rel_path.append(adapter.graph.nodes[path[0]].get('entity'))
-        
-        # Add relationships and entities along the path
-        for i in range(len(path) - 1):
-            source = path[i]
-            target = path[i + 1]
-            
-            # Find the relationship between these nodes
-            # (there could be multiple, take the first one)
-            rel_id = list(adapter.graph[source][target].keys())[0]
-            relationship = adapter.graph[source][target][rel_id].get('relationship')
+    for edge_path in edge_paths:
+        entity_rel_path = [adapter.entities.get(source_id)]
+        for rel_id in edge_path:
+            relationship = adapter.relationships[rel_id]
             entity_rel_path.append(relationship)
-            
-            # Add the target entity
-            entity_rel_path.append(adapter.graph.nodes[target].get('entity'))
-            
+            entity_rel_path.append(adapter.entities.get(relationship.target_id))
         result_paths.append(entity_rel_path)
-    
+
     logger.debug(f"Found {len(result_paths)} paths between {source_id} and {target_id}")
-    return result_paths
\ No newline at end of file
+    return result_paths
+
+async def get_neighborhood(adapter, entity_ids: List[str], depth: int = 1,
+                           relationship_type: Optional[str] = None,
+                           direction: str = "both") -> Tuple[List[Entity], List[Relationship]]:
+    """
+    Get the entities within depth relationships of the given ones.
+
+    Args:
+        adapter: The memory adapter instance
+        entity_ids: IDs of the entities to start from
+        depth: Maximum number of relationship hops
+        relationship_type: Optional relationship type filter
+        direction: Relationship direction ('outgoing', 'incoming', or 'both')
+
+    Returns:
+        (entities, relationships): the starting entities first, then nearer
+        before farther, and every relationship followed to reach them
+    """
+    node_ids, rel_ids = adapter.index.neighborhood(entity_ids, depth, direction, relationship_type)
+    entities = [adapter.entities[node_id] for node_id in node_ids if node_id in adapter.entities]
+    # Relationships to IDs that have no entity are left out, as get_entity_relationships does
+    relationships = [relationship for relationship in map(adapter.relationships.__getitem__, rel_ids)
+                     if relationship.source_id in adapter.entities and relationship.target_id in adapter.entities]
+    logger.debug(f"Neighborhood of {len(entity_ids)} entities at depth {depth}: "
+                 f"{len(entities)} entities, {len(relationships)} relationships")
+    return entities, relationships
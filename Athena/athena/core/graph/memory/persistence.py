@@ -2,100 +2,255 @@
 In-Memory Graph Persistence
 
 Provides functions for loading and saving graph data to disk.
+
+The graph is kept as a binary snapshot (see snapshot.py) plus write-ahead
+logs of the mutations made since (see wal.py). Every mutation is logged
+as it happens; once the current log passes checkpoint_bytes, a checkpoint
+starts a new log and writes a fresh snapshot in a background thread.
+Loading maps the snapshot and replays only the logs written after it.
+
+Graphs saved by earlier versions as entities.json and relationships.json
+are loaded from those once and checkpointed into a snapshot.
 """
 
 import os
 import json
+import asyncio
 import logging
-from typing import Dict, Any, List, Optional
+import threading
+from typing import Optional
 
 from ...entity import Entity
 from ...relationship import Relationship
+from .snapshot import Snapshot, write_snapshot
+from .wal import (DELETE_ENTITY, DELETE_RELATIONSHIP, PUT_ENTITY, PUT_RELATIONSHIP, WriteAheadLog,
+                  read_log, wal_generations, wal_path)
 
 logger = logging.getLogger("athena.graph.memory.persistence")
 
 async def load_data(adapter) -> None:
     """
-    Load graph data from persistence files.
-    
+    Load graph data from the snapshot and the logs after it.
+
     Args:
         adapter: The memory adapter instance
     """
+    generation = 0
+    migrate = False
+    if os.path.exists(adapter.snapshot_file):
+        try:
+            snapshot = Snapshot(adapter.snapshot_file)
+            topology = snapshot.topology()
+            adapter.entities = snapshot.entities(topology)
+            adapter.relationships = snapshot.relationships(topology)
+            adapter.index.add_edge_columns(topology.relationship_ids, topology.node_ids, topology.sources,
+                                           topology.targets, topology.type_names, topology.types)
+            generation = snapshot.generation
+            logger.info(f"Mapped {snapshot.entity_count} entities and {snapshot.relationship_count} "
+                        f"relationships from {adapter.snapshot_file}")
+        except Exception as e:
+            # Carrying on empty would let the next checkpoint replace the graph
+            logger.error(f"Error loading snapshot {adapter.snapshot_file}: {e}")
+            raise
+    else:
+        migrate = await load_json(adapter)
+
+    # Replay the logs the snapshot does not include
+    generations = wal_generations(adapter.data_path)
+    replayed = 0
+    for log_generation in generations:
+        path = wal_path(adapter.data_path, log_generation)
+        if log_generation < generation:
+            # Left behind by a checkpoint that finished writing its snapshot
+            os.remove(path)
+            continue
+        for op, payload in read_log(path):
+            apply_record(adapter, op, payload)
+            replayed += 1
+    if replayed:
+        logger.info(f"Replayed {replayed} logged mutations")
+
+    adapter.wal = WriteAheadLog(adapter.data_path, max([generation] + generations), fsync=adapter.wal_fsync)
+    if migrate:
+        logger.info(f"Moving the JSON graph files into {adapter.snapshot_file}")
+        await save_data(adapter)
+
+async def load_json(adapter) -> bool:
+    """
+    Load graph data saved as JSON by earlier versions.
+
+    Args:
+        adapter: The memory adapter instance
+
+    Returns:
+        True if there was anything to load
+    """
+    found = False
     # Load entities
     if os.path.exists(adapter.entity_file):
+        found = True
         try:
             with open(adapter.entity_file, 'r') as f:
                 entities_data = json.load(f)
-                
+
             for entity_data in entities_data:
                 entity = Entity.from_dict(entity_data)
-                adapter.graph.add_node(entity.entity_id, entity=entity)
-                
+                adapter.entities[entity.entity_id] = entity
+            adapter.index.add_nodes(adapter.entities)
+
             logger.info(f"Loaded {len(entities_data)} entities from {adapter.entity_file}")
         except Exception as e:
             logger.error(f"Error loading entities: {e}")
-            
+
     # Load relationships
     if os.path.exists(adapter.relationship_file):
+        found = True
         try:
             with open(adapter.relationship_file, 'r') as f:
                 relationships_data = json.load(f)
-                
-            for rel_data in relationships_data:
-                relationship = Relationship.from_dict(rel_data)
-                adapter.graph.add_edge(
-                    relationship.source_id,
-                    relationship.target_id,
-                    key=relationship.relationship_id,
-                    relationship=relationship
-                )
-                
+
+            relationships = [Relationship.from_dict(rel_data) for rel_data in relationships_data]
+            for relationship in relationships:
+                adapter.relationships[relationship.relationship_id] = relationship
+            # One batch, so the index is built once
+            adapter.index.add_edges(
+                (r.relationship_id, r.source_id, r.target_id, r.relationship_type)
+                for r in relationships
+            )
+
             logger.info(f"Loaded {len(relationships_data)} relationships from {adapter.relationship_file}")
         except Exception as e:
             logger.error(f"Error loading relationships: {e}")
+    return found
+
+def apply_record(adapter, op: int, payload: bytes) -> None:
+    """
+    Apply a logged mutation without logging it again.
+
+    Args:
+        adapter: The memory adapter instance
+        op: Logged operation
+        payload: The object as JSON for puts, its ID for deletes
+    """
+    if op == PUT_ENTITY:
+        entity = Entity.from_dict(json.loads(payload))
+        adapter.entities[entity.entity_id] = entity
+        adapter.index.add_node(entity.entity_id)
+    elif op == DELETE_ENTITY:
+        entity_id = payload.decode()
+        for relationship_id in adapter.index.remove_node(entity_id):
+            adapter.relationships.pop(relationship_id, None)
+        adapter.entities.pop(entity_id, None)
+    elif op == PUT_RELATIONSHIP:
+        relationship = Relationship.from_dict(json.loads(payload))
+        adapter.relationships[relationship.relationship_id] = relationship
+        adapter.index.add_edge(relationship.relationship_id, relationship.source_id,
+                               relationship.target_id, relationship.relationship_type)
+    elif op == DELETE_RELATIONSHIP:
+        relationship_id = payload.decode()
+        if adapter.relationships.pop(relationship_id, None) is not None:
+            adapter.index.remove_edge(relationship_id)
+    else:
+        logger.warning(f"Skipping logged mutation with unknown operation {op}")
+
+def log_mutation(adapter, op: int, obj=None, object_id: Optional[str] = None) -> None:
+    """
+    Log a mutation the adapter has just applied, and checkpoint in the
+    background once the log is large enough.
+
+    Args:
+        adapter: The memory adapter instance
+        op: Operation (PUT_ENTITY, DELETE_ENTITY, PUT_RELATIONSHIP or DELETE_RELATIONSHIP)
+        obj: The entity or relationship put
+        object_id: The ID deleted
+    """
+    if adapter.wal is None:
+        # Not connected: whatever is in memory is written at the next checkpoint
+        return
+    if obj is not None:
+        adapter.wal.put(op, obj)
+    else:
+        adapter.wal.delete(op, object_id)
+    if adapter.wal.size >= adapter.checkpoint_bytes and not checkpoint_running(adapter):
+        checkpoint(adapter)
+
+def checkpoint_running(adapter) -> bool:
+    return adapter.checkpoint_thread is not None and adapter.checkpoint_thread.is_alive()
+
+def checkpoint(adapter) -> threading.Thread:
+    """
+    Start a new log and write a snapshot of everything before it in the background.
+
+    The entries are captured (decoded ones encoded) before this returns;
+    later mutations go to the new log. A checkpoint still running is waited
+    for first, blocking the caller; async callers wait for it off the loop
+    (see save_data) before calling this. The old logs are removed once the snapshot is in place; if
+    writing it fails, they stay and are replayed on the next load.
+
+    Args:
+        adapter: The memory adapter instance
+
+    Returns:
+        The thread writing the snapshot
+    """
+    if checkpoint_running(adapter):
+        adapter.checkpoint_thread.join()
+    previous = adapter.wal
+    generation = previous.generation + 1 if previous else max([0] + wal_generations(adapter.data_path)) + 1
+    adapter.wal = WriteAheadLog(adapter.data_path, generation, fsync=adapter.wal_fsync)
+    if previous:
+        previous.close()
+    entities = adapter.entities.capture()
+    relationships = adapter.relationships.capture()
+
+    def write() -> None:
+        try:
+            size = write_snapshot(adapter.snapshot_file, generation, entities, relationships)
+            for old in wal_generations(adapter.data_path):
+                if old < generation:
+                    os.remove(wal_path(adapter.data_path, old))
+            adapter.checkpoint_error = None
+            logger.info(f"Checkpointed {len(entities.items)} entities and {len(relationships.items)} "
+                        f"relationships to {adapter.snapshot_file} ({size} bytes)")
+        except Exception as e:
+            adapter.checkpoint_error = e
+            logger.error(f"Error writing snapshot {adapter.snapshot_file}: {e}")
+
+    adapter.checkpoint_thread = threading.Thread(target=write, name="athena-checkpoint", daemon=True)
+    adapter.checkpoint_error = None
+    adapter.checkpoint_thread.start()
+    return adapter.checkpoint_thread
 
 async def save_data(adapter) -> bool:
     """
-    Save graph data to persistence files.
-    
+    Save graph data to disk with a checkpoint, waiting for it to finish.
+
+    Args:
+        adapter: The memory adapter instance
+
+    Returns:
+        True if successful, False otherwise
+    """
+    os.makedirs(adapter.data_path, exist_ok=True)
+    # Let one started by log_mutation finish without blocking the event loop
+    while checkpoint_running(adapter):
+        await asyncio.to_thread(adapter.checkpoint_thread.join)
+    thread = checkpoint(adapter)
+    await asyncio.to_thread(thread.join)
+    return adapter.checkpoint_error is None
+
+async def close_data(adapter) -> bool:
+    """
+    Checkpoint and close the log.
+
     Args:
         adapter: The memory adapter instance
-        
+
     Returns:
         True if successful, False otherwise
     """
-    success = True
-    
-    # Save entities
-    try:
-        entities_data = []
-        for node_id in adapter.graph.nodes():
-            entity = adapter.graph.nodes[node_id].get('entity')
-            if entity:
-                entities_data.append(entity.to_dict())
-                
-        with open(adapter.entity_file, 'w') as f:
-            json.dump(entities_data, f, indent=2)
-            
-        logger.info(f"Saved {len(entities_data)} entities to {adapter.entity_file}")
-    except Exception as e:
-        logger.error(f"Error saving entities: {e}")
-        success = False
-        
-    # Save relationships
-    try:
-        relationships_data = []
-        for source_id, target_id, rel_id in adapter.graph.edges(keys=True):
-            relationship = adapter.graph[source_id][target_id][rel_id].get('relationship')
-            if relationship:
-                relationships_data.append(relationship.to_dict())
-                
-        with open(adapter.relationship_file, 'w') as f:
-            json.dump(relationships_data, f, indent=2)
-            
-        logger.info(f"Saved {len(relationships_data)} relationships to {adapter.relationship_file}")
-    except Exception as e:
-        logger.error(f"Error saving relationships: {e}")
-        success = False
-        
-    return success
\ No newline at end of file
+    success = await save_data(adapter)
+    if adapter.wal is not None:
+        adapter.wal.close()
+        adapter.wal = None
+    return success
@@ -29,11 +29,7 @@ async def search_entities(adapter, query: str, entity_type: Optional[str] = None
     
     # Handle None or empty query - return all entities (filtered by type if specified)
     if not query:
-        for node_id in adapter.graph.nodes():
-            entity = adapter.graph.nodes[node_id].get('entity')
-            if not entity:
-                continue
-                
+        for entity in adapter.entities.values():
             # Filter by entity type if specified
             if entity_type and entity.entity_type != entity_type:
                 continue
@@ -49,11 +45,7 @@ async def search_entities(adapter, query: str, entity_type: Optional[str] = None
     # Normal search with query
     query = query.lower()
     
-    for node_id in adapter.graph.nodes():
-        entity = adapter.graph.nodes[node_id].get('entity')
-        if not entity:
-            continue
-            
+    for entity in adapter.entities.values():
         # Filter by entity type if specified
         if entity_type and entity.entity_type != entity_type:
             continue
@@ -101,9 +93,9 @@ async def get_entity_relationships(adapter, entity_id: str,
     
     # Get outgoing relationships
     if direction in ["outgoing", "both"]:
-        for _, target_id, rel_id in adapter.graph.out_edges(entity_id, keys=True):
-            relationship = adapter.graph[entity_id][target_id][rel_id].get('relationship')
-            target_entity = adapter.graph.nodes[target_id].get('entity')
+        for rel_id in adapter.index.edges(entity_id, "outgoing", relationship_type):
+            relationship = adapter.relationships.get(rel_id)
+            target_entity = adapter.entities.get(relationship.target_id) if relationship else None
             
             if not relationship or not target_entity:
                 continue
@@ -115,9 +107,9 @@ async def get_entity_relationships(adapter, entity_id: str,
             
     # Get incoming relationships
     if direction in ["incoming", "both"]:
-        for source_id, _, rel_id in adapter.graph.in_edges(entity_id, keys=True):
-            relationship = adapter.graph[source_id][entity_id][rel_id].get('relationship')
-            source_entity = adapter.graph.nodes[source_id].get('entity')
+        for rel_id in adapter.index.edges(entity_id, "incoming", relationship_type):
+            relationship = adapter.relationships.get(rel_id)
+            source_entity = adapter.entities.get(relationship.source_id) if relationship else None
             
             if not relationship or not source_entity:
                 continue
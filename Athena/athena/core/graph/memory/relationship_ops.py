@@ -8,6 +8,8 @@ import logging
 from typing import Optional
 
 from ...relationship import Relationship
+from .persistence import log_mutation
+from .wal import DELETE_RELATIONSHIP, PUT_RELATIONSHIP
 
 logger = logging.getLogger("athena.graph.memory.relationship_ops")
 
@@ -22,12 +24,14 @@ async def create_relationship(adapter, relationship: Relationship) -> str:
     Returns:
         Relationship ID
     """
-    adapter.graph.add_edge(
+    adapter.relationships[relationship.relationship_id] = relationship
+    adapter.index.add_edge(
+        relationship.relationship_id,
         relationship.source_id,
         relationship.target_id,
-        key=relationship.relationship_id,
-        relationship=relationship
+        relationship.relationship_type
     )
+    log_mutation(adapter, PUT_RELATIONSHIP, relationship)
     logger.debug(f"Created relationship: {relationship.relationship_type} ({relationship.relationship_id})")
     return relationship.relationship_id
 
@@ -42,14 +46,10 @@ async def get_relationship(adapter, relationship_id: str) -> Optional[Relationsh
     Returns:
         Relationship or None if not found
     """
-    for source_id, target_id, rel_id in adapter.graph.edges(keys=True):
-        if rel_id == relationship_id:
-            relationship = adapter.graph[source_id][target_id][rel_id].get('relationship')
-            if relationship:
-                logger.debug(f"Retrieved relationship: {relationship.relationship_type} ({relationship_id})")
-            else:
-                logger.warning(f"Relationship exists but has no relationship data: {relationship_id}")
-            return relationship
+    relationship = adapter.relationships.get(relationship_id)
+    if relationship:
+        logger.debug(f"Retrieved relationship: {relationship.relationship_type} ({relationship_id})")
+        return relationship
     logger.debug(f"Relationship not found: {relationship_id}")
     return None
 
@@ -64,11 +64,20 @@ async def update_relationship(adapter, relationship: Relationship) -> bool:
     Returns:
         True if successful
     """
-    for source_id, target_id, rel_id in adapter.graph.edges(keys=True):
-        if rel_id == relationship.relationship_id:
-            adapter.graph[source_id][target_id][rel_id]['relationship'] = relationship
-            logger.debug(f"Updated relationship: {relationship.relationship_type} ({relationship.relationship_id})")
-            return True
+    if relationship.relationship_id in adapter.relationships:
+        # Re-link it in the index (an edge with the same ID is replaced). The
+        # stored object may be the one passed in, edited in place, so the old
+        # endpoints cannot be compared.
+        adapter.index.add_edge(
+            relationship.relationship_id,
+            relationship.source_id,
+            relationship.target_id,
+            relationship.relationship_type
+        )
+        adapter.relationships[relationship.relationship_id] = relationship
+        log_mutation(adapter, PUT_RELATIONSHIP, relationship)
+        logger.debug(f"Updated relationship: {relationship.relationship_type} ({relationship.relationship_id})")
+        return True
     logger.warning(f"Cannot update relationship: {relationship.relationship_id} - not found")
     return False
 
@@ -83,10 +92,10 @@ async def delete_relationship(adapter, relationship_id: str) -> bool:
     Returns:
         True if successful
     """
-    for source_id, target_id, rel_id in list(adapter.graph.edges(keys=True)):
-        if rel_id == relationship_id:
-            adapter.graph.remove_edge(source_id, target_id, rel_id)
-            logger.debug(f"Deleted relationship: {relationship_id}")
-            return True
+    if adapter.relationships.pop(relationship_id, None) is not None:
+        adapter.index.remove_edge(relationship_id)
+        log_mutation(adapter, DELETE_RELATIONSHIP, object_id=relationship_id)
+        logger.debug(f"Deleted relationship: {relationship_id}")
+        return True
     logger.warning(f"Cannot delete relationship: {relationship_id} - not found")
     return False
\ No newline at end of file
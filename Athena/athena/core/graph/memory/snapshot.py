@@ -0,0 +1,291 @@
+"""
+Binary Snapshot for Memory Graph
+
+A snapshot holds every entity and relationship as of one WAL generation:
+
+    header          magic, version, generation, entity count, relationship count
+    section table   (offset, length) of each section below, 8-byte aligned
+    node ids        JSON list: the entities, then relationship endpoints
+                    that have no entity
+    entity offsets  u64 per entity, plus the end, into the entity records
+    entity records  each entity's to_dict() as JSON
+    rel ids         JSON list
+    type names      JSON list
+    sources         u32 per relationship, a position in node ids
+    targets         u32 per relationship, a position in node ids
+    types           u32 per relationship, a position in type names
+    rel offsets     u64 per relationship, plus the end
+    rel records     each relationship's to_dict() as JSON
+
+Integers in the header are little-endian; the columns and offsets are in
+the machine's byte order, as the library that loads them expects.
+
+Opening a snapshot maps the file and reads only the id lists; the
+topology columns go to the graph index as they lie. Records are decoded
+when first looked up, through a RecordMap. A checkpoint copies the records
+that were never decoded straight from the old mapping into the new file.
+
+Snapshots are written to a temporary file and renamed into place, so a
+snapshot on disk is always complete.
+"""
+
+import os
+import json
+import mmap
+import struct
+from array import array
+from typing import Any, Callable, Dict, Iterator, List, MutableMapping, Optional, Tuple
+
+from ...entity import Entity
+from ...relationship import Relationship
+
+SNAPSHOT_MAGIC = b"ATGS"
+VERSION = 1
+
+# magic, version, generation, entity_count, relationship_count
+HEADER = struct.Struct("<4sIQQQ")
+SECTION_COUNT = 10
+# (offset, length) per section
+SECTIONS = struct.Struct("<" + "QQ" * SECTION_COUNT)
+(NODE_IDS, ENTITY_OFFSETS, ENTITY_RECORDS, RELATIONSHIP_IDS, TYPE_NAMES,
+ SOURCES, TARGETS, TYPES, RELATIONSHIP_OFFSETS, RELATIONSHIP_RECORDS) = range(SECTION_COUNT)
+
+# The sections holding each kind's (offsets, records)
+ENTITIES = (ENTITY_OFFSETS, ENTITY_RECORDS)
+RELATIONSHIPS = (RELATIONSHIP_OFFSETS, RELATIONSHIP_RECORDS)
+
+
+class Topology:
+    """The relationships' structure, as a snapshot stores it"""
+
+    def __init__(self, node_ids: List[str], relationship_ids: List[str], type_names: List[str],
+                 sources: array, targets: array, types: array):
+        self.node_ids = node_ids
+        self.relationship_ids = relationship_ids
+        self.type_names = type_names
+        self.sources = sources
+        self.targets = targets
+        self.types = types
+
+    def endpoints(self, position: int) -> Tuple[str, str, str]:
+        """(source, target, type) of the relationship at position"""
+        return (self.node_ids[self.sources[position]], self.node_ids[self.targets[position]],
+                self.type_names[self.types[position]])
+
+
+class Snapshot:
+    """A snapshot file, mapped read-only"""
+
+    def __init__(self, path: str):
+        self.path = path
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        if len(self._map) < HEADER.size + SECTIONS.size:
+            raise ValueError(f"{path} is too short to be a graph snapshot")
+        magic, version, self.generation, self.entity_count, self.relationship_count = \
+            HEADER.unpack_from(self._map)
+        if magic != SNAPSHOT_MAGIC or version != VERSION:
+            raise ValueError(f"{path} is not a version {VERSION} graph snapshot")
+        table = SECTIONS.unpack_from(self._map, HEADER.size)
+        self._sections = list(zip(table[0::2], table[1::2]))
+        if any(offset + length > len(self._map) for offset, length in self._sections):
+            raise ValueError(f"{path} is truncated")
+        self._view = memoryview(self._map)
+        self._offsets = {kind: self._section(kind[0]).cast("Q") for kind in (ENTITIES, RELATIONSHIPS)}
+        if (len(self._offsets[ENTITIES]), len(self._offsets[RELATIONSHIPS])) != \
+                (self.entity_count + 1, self.relationship_count + 1):
+            raise ValueError(f"{path} has record offsets that do not match its counts")
+
+    def _section(self, section: int) -> memoryview:
+        offset, length = self._sections[section]
+        return self._view[offset:offset + length]
+
+    def _json(self, section: int) -> Any:
+        return json.loads(self._section(section).tobytes())
+
+    def _column(self, section: int) -> array:
+        column = array("I")
+        column.frombytes(self._section(section))
+        if len(column) != self.relationship_count:
+            raise ValueError(f"{self.path} has a topology column that does not match its count")
+        return column
+
+    def record(self, kind: Tuple[int, int], position: int) -> memoryview:
+        """The bytes of a kind's record at position"""
+        offsets = self._offsets[kind]
+        return self._section(kind[1])[offsets[position]:offsets[position + 1]]
+
+    def topology(self) -> Topology:
+        return Topology(self._json(NODE_IDS), self._json(RELATIONSHIP_IDS), self._json(TYPE_NAMES),
+                        self._column(SOURCES), self._column(TARGETS), self._column(TYPES))
+
+    def entities(self, topology: Topology) -> "RecordMap":
+        return RecordMap(Entity.from_dict, self, ENTITIES, topology.node_ids[:self.entity_count])
+
+    def relationships(self, topology: Topology) -> "RecordMap":
+        return RecordMap(Relationship.from_dict, self, RELATIONSHIPS, topology.relationship_ids)
+
+
+class RecordMap(MutableMapping):
+    """
+    Objects by ID, where an object may still be an undecoded snapshot record.
+
+    A pending record is kept as its position in the snapshot (an int) until
+    it is first looked up, then replaced in place by the decoded object, so
+    the map keeps its insertion order.
+    """
+
+    def __init__(self, decode: Callable[[Dict[str, Any]], Any], snapshot: Optional[Snapshot] = None,
+                 kind: Tuple[int, int] = ENTITIES, ids: List[str] = ()):
+        self._decode = decode
+        self.snapshot = snapshot
+        self.kind = kind
+        self._items: Dict[str, Any] = dict(zip(ids, range(len(ids))))
+
+    def __getitem__(self, key: str) -> Any:
+        value = self._items[key]
+        if type(value) is int:
+            value = self._decode(json.loads(self.snapshot.record(self.kind, value).tobytes()))
+            self._items[key] = value
+        return value
+
+    def __setitem__(self, key: str, value: Any) -> None:
+        self._items[key] = value
+
+    def __delitem__(self, key: str) -> None:
+        del self._items[key]
+
+    def __iter__(self) -> Iterator[str]:
+        return iter(self._items)
+
+    def __len__(self) -> int:
+        return len(self._items)
+
+    def __contains__(self, key: object) -> bool:
+        return key in self._items
+
+    def capture(self) -> "Capture":
+        """
+        The current entries, taken between two mutations.
+
+        Decoded objects are encoded here rather than by the checkpoint
+        thread: callers keep changing them in place. Records never decoded
+        are still only positions in the snapshot, which does not change.
+        """
+        items = []
+        for key, value in self._items.items():
+            if type(value) is not int:
+                record = json.dumps(value.to_dict(), separators=(",", ":")).encode()
+                endpoints = None
+                if isinstance(value, Relationship):
+                    endpoints = (value.source_id, value.target_id, value.relationship_type)
+                value = (record, endpoints)
+            items.append((key, value))
+        return Capture(self.snapshot, self.kind, items)
+
+
+class Capture:
+    """
+    A RecordMap's entries at one moment: (id, snapshot position) for records
+    never decoded, (id, (record, endpoints)) for the others, where endpoints
+    is a relationship's (source, target, type) and None for an entity
+    """
+
+    def __init__(self, snapshot: Optional[Snapshot], kind: Tuple[int, int], items: List[Tuple[str, Any]]):
+        self.snapshot = snapshot
+        self.kind = kind
+        self.items = items
+
+    def records(self) -> Iterator[bytes]:
+        for _, value in self.items:
+            if type(value) is int:
+                yield self.snapshot.record(self.kind, value).tobytes()
+            else:
+                yield value[0]
+
+    def topology(self, entity_ids: List[str]) -> Topology:
+        """The captured relationships' topology over nodes numbered from entity_ids"""
+        node_ids = list(entity_ids)
+        nodes = dict(zip(node_ids, range(len(node_ids))))
+        type_names: List[str] = []
+        type_index: Dict[str, int] = {}
+        sources, targets, types = array("I"), array("I"), array("I")
+        old = None
+        for _, value in self.items:
+            if type(value) is int:
+                # Never decoded: its endpoints are in the old snapshot's topology
+                old = old or self.snapshot.topology()
+                source, target, kind = old.endpoints(value)
+            else:
+                source, target, kind = value[1]
+            for node_id, column in ((source, sources), (target, targets)):
+                n = nodes.get(node_id)
+                if n is None:
+                    n = nodes[node_id] = len(node_ids)
+                    node_ids.append(node_id)
+                column.append(n)
+            t = type_index.get(kind)
+            if t is None:
+                t = type_index[kind] = len(type_names)
+                type_names.append(kind)
+            types.append(t)
+        return Topology(node_ids, [key for key, _ in self.items], type_names, sources, targets, types)
+
+
+def write_snapshot(path: str, generation: int, entities: Capture, relationships: Capture) -> int:
+    """
+    Write a snapshot atomically
+
+    Args:
+        path: Snapshot file to replace
+        generation: The first WAL generation not included in the snapshot
+        entities: Captured entities
+        relationships: Captured relationships
+
+    Returns:
+        Size of the snapshot in bytes
+    """
+    topology = relationships.topology([key for key, _ in entities.items])
+    temporary = path + ".tmp"
+    with open(temporary, "wb") as f:
+        f.write(b"\0" * (HEADER.size + SECTIONS.size))
+        table = []
+
+        def section(chunks) -> None:
+            start = f.tell()
+            for chunk in chunks:
+                f.write(chunk)
+            table.extend((start, f.tell() - start))
+            f.write(b"\0" * (-f.tell() % 8))
+
+        def records(capture: Capture) -> None:
+            offsets = array("Q", [0])
+            encoded = []
+            for record in capture.records():
+                encoded.append(record)
+                offsets.append(offsets[-1] + len(record))
+            section([offsets.tobytes()])
+            section(encoded)
+
+        section([json.dumps(topology.node_ids).encode()])
+        records(entities)
+        section([json.dumps(topology.relationship_ids).encode()])
+        section([json.dumps(topology.type_names).encode()])
+        for column in (topology.sources, topology.targets, topology.types):
+            section([column.tobytes()])
+        records(relationships)
+
+        f.seek(0)
+        f.write(HEADER.pack(SNAPSHOT_MAGIC, VERSION, generation, len(entities.items), len(relationships.items)))
+        f.write(SECTIONS.pack(*table))
+        f.seek(0, os.SEEK_END)
+        size = f.tell()
+        f.flush()
+        os.fsync(f.fileno())
+    os.replace(temporary, path)
+    directory = os.open(os.path.dirname(os.path.abspath(path)), os.O_RDONLY)
+    try:
+        os.fsync(directory)
+    finally:
+        os.close(directory)
+    return size
@@ -0,0 +1,128 @@
+"""
+Write-Ahead Log for Memory Graph
+
+Every entity and relationship mutation is appended to the log of the
+current generation before the call returns:
+
+    graph.<generation>.wal   header: magic, version, generation
+                             records: u32 length, u32 crc32, u8 op, payload
+
+Puts carry the object's to_dict() as JSON and deletes carry its ID, so
+replaying a log over any older state gives the state it was written
+against. A checkpoint starts a new generation; once the snapshot of
+everything before it is on disk, the older logs are removed.
+
+Records are written with one os.write() each, so they survive the process
+crashing; they reach the disk when the log is synced (on every record
+with fsync=True). A torn record at the end of a log is dropped on open.
+"""
+
+import os
+import re
+import json
+import struct
+import zlib
+import logging
+from typing import Iterator, List, Tuple
+
+logger = logging.getLogger("athena.graph.memory.wal")
+
+WAL_MAGIC = b"ATGW"
+VERSION = 1
+
+# magic, version, generation
+LOG_HEADER = struct.Struct("<4sIQ")
+# length, crc32, op
+RECORD_HEADER = struct.Struct("<IIB")
+
+PUT_ENTITY, DELETE_ENTITY, PUT_RELATIONSHIP, DELETE_RELATIONSHIP = 1, 2, 3, 4
+
+WAL_NAME = re.compile(r"^graph\.(\d+)\.wal$")
+
+
+def wal_path(data_path: str, generation: int) -> str:
+    return os.path.join(data_path, f"graph.{generation}.wal")
+
+
+def wal_generations(data_path: str) -> List[int]:
+    """Generations of the logs in data_path, oldest first"""
+    found = (WAL_NAME.match(name) for name in os.listdir(data_path))
+    return sorted(int(match.group(1)) for match in found if match)
+
+
+def _checksum(op: int, payload: bytes) -> int:
+    return zlib.crc32(payload, zlib.crc32(bytes((op,))))
+
+
+def read_log(path: str) -> Iterator[Tuple[int, bytes]]:
+    """
+    (op, payload) of each intact record, stopping at the first torn one,
+    which is cut off along with everything after it
+    """
+    with open(path, "r+b") as f:
+        data = f.read()
+        if len(data) < LOG_HEADER.size:
+            # Torn while being created: it holds nothing
+            f.truncate(0)
+            return
+        magic, version, _ = LOG_HEADER.unpack_from(data)
+        if magic != WAL_MAGIC or version != VERSION:
+            raise ValueError(f"{path} is not a version {VERSION} graph log")
+        offset = LOG_HEADER.size
+        while offset + RECORD_HEADER.size <= len(data):
+            length, crc, op = RECORD_HEADER.unpack_from(data, offset)
+            end = offset + RECORD_HEADER.size + length
+            payload = data[offset + RECORD_HEADER.size:end]
+            if end > len(data) or _checksum(op, payload) != crc:
+                break
+            yield op, payload
+            offset = end
+        if offset < len(data):
+            logger.warning(f"Dropping {len(data) - offset} bytes of torn records from {path}")
+            f.truncate(offset)
+
+
+class WriteAheadLog:
+    """The log of one generation, open for appending"""
+
+    def __init__(self, data_path: str, generation: int, fsync: bool = False):
+        """
+        Open (or create) a generation's log
+
+        Args:
+            data_path: Directory holding the logs
+            generation: Generation to append to
+            fsync: Sync the log after every record
+        """
+        self.data_path = data_path
+        self.generation = generation
+        self.fsync = fsync
+        self.path = wal_path(data_path, generation)
+        self._fd = os.open(self.path, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o644)
+        self.size = os.fstat(self._fd).st_size
+        if self.size == 0:
+            self._write(LOG_HEADER.pack(WAL_MAGIC, VERSION, generation))
+
+    def _write(self, data: bytes) -> None:
+        os.write(self._fd, data)
+        self.size += len(data)
+        if self.fsync:
+            os.fdatasync(self._fd)
+
+    def append(self, op: int, payload: bytes) -> None:
+        self._write(RECORD_HEADER.pack(len(payload), _checksum(op, payload), op) + payload)
+
+    def put(self, op: int, obj) -> None:
+        self.append(op, json.dumps(obj.to_dict(), separators=(",", ":")).encode())
+
+    def delete(self, op: int, object_id: str) -> None:
+        self.append(op, object_id.encode())
+
+    def sync(self) -> None:
+        os.fdatasync(self._fd)
+
+    def close(self) -> None:
+        if self._fd is not None:
+            os.fsync(self._fd)
+            os.close(self._fd)
+            self._fd = None
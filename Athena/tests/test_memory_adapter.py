@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""
+Unit tests for the in-memory graph adapter.
+"""
+
+import asyncio
+import json
+import os
+import sys
+
+athena_root = os.path.join(os.path.dirname(__file__), "..")
+sys.path[:0] = [athena_root, os.path.join(athena_root, "..")]
+
+from athena.core.entity import Entity  # noqa: E402
+from athena.core.graph.memory import MemoryAdapter  # noqa: E402
+from athena.core.relationship import Relationship  # noqa: E402
+
+
+def run(coroutine):
+    return asyncio.run(coroutine)
+
+
+def build(path):
+    """a -> b -> c, a -> c, with a second a -> b relationship"""
+    adapter = MemoryAdapter(str(path))
+    run(adapter.connect())
+    for name in "abc":
+        run(adapter.create_entity(Entity(entity_id=name, name=name, entity_type="letter")))
+    for rel_id, source, target, kind in [("ab", "a", "b", "next"), ("bc", "b", "c", "next"),
+                                         ("ac", "a", "c", "skip"), ("ab2", "a", "b", "again")]:
+        run(adapter.create_relationship(Relationship(relationship_id=rel_id, relationship_type=kind,
+                                                     source_id=source, target_id=target)))
+    return adapter
+
+
+def ids(path):
+    return [item.entity_id if isinstance(item, Entity) else item.relationship_id for item in path]
+
+
+class TestMemoryAdapter:
+    """CRUD, relationship lookups, paths and neighbourhoods over the index."""
+
+    def test_relationship_lookups(self, tmp_path):
+        adapter = build(tmp_path)
+        assert run(adapter.get_relationship("bc")).target_id == "c"
+        outgoing = run(adapter.get_entity_relationships("a", direction="outgoing"))
+        assert sorted((r.relationship_id, e.entity_id) for r, e in outgoing) == [
+            ("ab", "b"), ("ab2", "b"), ("ac", "c")]
+        incoming = run(adapter.get_entity_relationships("c", "skip", "incoming"))
+        assert [(r.relationship_id, e.entity_id) for r, e in incoming] == [("ac", "a")]
+        assert (run(adapter.count_entities()), run(adapter.count_relationships())) == (3, 4)
+
+    def test_paths_use_the_first_parallel_relationship(self, tmp_path):
+        adapter = build(tmp_path)
+        paths = sorted(map(ids, run(adapter.find_paths("a", "c"))))
+        assert paths == [["a", "ab", "b", "bc", "c"], ["a", "ac", "c"]]
+        assert ids(run(adapter.find_paths("a", "a"))[0]) == ["a"]
+        assert run(adapter.find_paths("c", "a")) == []
+
+    def test_updates_and_deletes_relink(self, tmp_path):
+        adapter = build(tmp_path)
+        moved = run(adapter.get_relationship("ac"))
+        moved.source_id = "b"
+        assert run(adapter.update_relationship(moved))
+        assert sorted(map(ids, run(adapter.find_paths("a", "c")))) == [["a", "ab", "b", "bc", "c"]]
+        assert run(adapter.delete_entity("b"))
+        assert run(adapter.get_relationship("ab")) is None
+        assert run(adapter.find_paths("a", "c")) == []
+        assert run(adapter.count_relationships()) == 0
+
+    def test_neighborhood(self, tmp_path):
+        adapter = build(tmp_path)
+        entities, relationships = run(adapter.get_neighborhood(["b"], 1))
+        assert [e.entity_id for e in entities][0] == "b"
+        assert {e.entity_id for e in entities} == {"a", "b", "c"}
+        assert sorted(r.relationship_id for r in relationships) == ["ab", "ab2", "bc"]
+        entities, _ = run(adapter.get_neighborhood(["a"], 2, "next", "outgoing"))
+        assert [e.entity_id for e in entities] == ["a", "b", "c"]
+
+    def test_sync_and_reload(self, tmp_path):
+        adapter = build(tmp_path)
+        assert run(adapter.disconnect())
+        reloaded = MemoryAdapter(str(tmp_path))
+        run(reloaded.connect())
+        assert run(reloaded.get_entity("b")).name == "b"
+        assert sorted(map(ids, run(reloaded.find_paths("a", "c")))) == [
+            ["a", "ab", "b", "bc", "c"], ["a", "ac", "c"]]
+        assert (run(reloaded.count_entities()), run(reloaded.count_relationships())) == (3, 4)
+
+
+class TestPersistence:
+    """The snapshot, the write-ahead log, and what survives a crash."""
+
+    def test_log_is_replayed_without_a_disconnect(self, tmp_path):
+        adapter = build(tmp_path)
+        run(adapter.delete_relationship("ab2"))
+        run(adapter.update_entity(Entity(entity_id="c", name="renamed")))
+        # No disconnect: the process died
+        reloaded = MemoryAdapter(str(tmp_path))
+        run(reloaded.connect())
+        assert run(reloaded.get_entity("c")).name == "renamed"
+        assert run(reloaded.get_relationship("ab2")) is None
+        assert (run(reloaded.count_entities()), run(reloaded.count_relationships())) == (3, 3)
+
+    def test_torn_record_is_dropped(self, tmp_path):
+        adapter = build(tmp_path)
+        log = adapter.wal.path
+        with open(log, "ab") as f:
+            f.write(b"\x40\x00\x00\x00\x00\x00\x00\x00\x03{\"relationship_id\"")
+        size = os.path.getsize(log)
+        reloaded = MemoryAdapter(str(tmp_path))
+        run(reloaded.connect())
+        assert run(reloaded.count_relationships()) == 4
+        assert os.path.getsize(log) < size
+
+    def test_snapshot_records_decode_on_demand(self, tmp_path):
+        adapter = build(tmp_path)
+        assert run(adapter.disconnect())
+        assert [name for name in os.listdir(tmp_path) if name.endswith(".wal")] == ["graph.1.wal"]
+        reloaded = MemoryAdapter(str(tmp_path))
+        run(reloaded.connect())
+        assert all(type(value) is int for value in reloaded.relationships._items.values())
+        assert run(reloaded.get_relationship("ab")).source_id == "a"
+        assert type(reloaded.relationships._items["ab"]) is not int
+        assert type(reloaded.relationships._items["bc"]) is int
+        assert sorted(map(ids, run(reloaded.find_paths("a", "c")))) == [
+            ["a", "ab", "b", "bc", "c"], ["a", "ac", "c"]]
+
+    def test_background_checkpoint(self, tmp_path):
+        adapter = build(tmp_path)
+        assert run(adapter.disconnect())
+        adapter = MemoryAdapter(str(tmp_path), checkpoint_bytes=4096)
+        run(adapter.connect())
+        # In-place edits are kept by the next checkpoint, logged or not
+        run(adapter.get_entity("a")).name = "edited"
+        for i in range(100):
+            run(adapter.create_entity(Entity(entity_id=f"n{i}", name="x" * 100)))
+            run(adapter.create_relationship(Relationship(relationship_id=f"r{i}", source_id="c",
+                                                         target_id=f"n{i}")))
+        adapter.checkpoint_thread.join()
+        assert adapter.checkpoint_error is None
+        assert len([name for name in os.listdir(tmp_path) if name.endswith(".wal")]) == 1
+        reloaded = MemoryAdapter(str(tmp_path))
+        run(reloaded.connect())
+        assert run(reloaded.get_entity("a")).name == "edited"
+        assert (run(reloaded.count_entities()), run(reloaded.count_relationships())) == (103, 104)
+        # Endpoints of relationships never decoded come from the old snapshot
+        assert sorted(map(ids, run(reloaded.find_paths("a", "n7")))) == [
+            ["a", "ab", "b", "bc", "c", "r7", "n7"], ["a", "ac", "c", "r7", "n7"]]
+
+    def test_capture_is_not_changed_by_later_edits(self, tmp_path):
+        adapter = build(tmp_path)
+        entities = adapter.entities.capture()
+        relationships = adapter.relationships.capture()
+        run(adapter.get_entity("a")).name = "edited after"
+        run(adapter.get_relationship("ab")).target_id = "c"
+        assert json.loads(next(entities.records()))["name"] == "a"
+        assert relationships.topology(["a", "b", "c"]).endpoints(0)[:2] == ("a", "b")
+        assert run(adapter.disconnect())
+
+    def test_json_files_are_migrated(self, tmp_path):
+        with open(tmp_path / "entities.json", "w") as f:
+            json.dump([Entity(entity_id=name, name=name).to_dict() for name in "ab"], f)
+        with open(tmp_path / "relationships.json", "w") as f:
+            json.dump([Relationship(relationship_id="ab", source_id="a", target_id="b").to_dict()], f)
+        adapter = MemoryAdapter(str(tmp_path))
+        run(adapter.connect())
+        assert os.path.exists(tmp_path / "graph.snapshot")
+        assert [ids(path) for path in run(adapter.find_paths("a", "b"))] == [["a", "ab", "b"]]
+        os.remove(tmp_path / "relationships.json")
+        reloaded = MemoryAdapter(str(tmp_path))
+        run(reloaded.connect())
+        assert run(reloaded.count_relationships()) == 1
+
+    def test_relationship_to_a_missing_entity(self, tmp_path):
+        adapter = build(tmp_path)
+        run(adapter.create_relationship(Relationship(relationship_id="cx", source_id="c", target_id="ghost")))
+        assert run(adapter.disconnect())
+        reloaded = MemoryAdapter(str(tmp_path))
+        run(reloaded.connect())
+        assert sorted(reloaded.entities) == ["a", "b", "c"]
+        assert run(reloaded.get_relationship("cx")).target_id == "ghost"
+        assert reloaded.index.edges("ghost", "incoming") == ["cx"]
+        assert run(reloaded.sync())
+        again = MemoryAdapter(str(tmp_path))
+        run(again.connect())
+        assert again.index.edges("ghost", "incoming") == ["cx"]
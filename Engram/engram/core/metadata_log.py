@@ -0,0 +1,334 @@
+#!/usr/bin/env python
+"""
+Append-only metadata log for VectorStore compartments.
+
+A compartment's metadata lives in two files next to its FAISS index:
+
+    <compartment>.metalog   records: u32 length, u32 crc32, u64 id, JSON payload
+    <compartment>.metaidx   header, then one u64 log offset per FAISS id
+
+Adding entries appends their records and offsets, so saving costs only
+what was added, and loading maps both files instead of parsing one large
+JSON document. Entries are decoded when they are read.
+
+Replacing an entry appends a new record and repoints its offset; the old
+record is dead weight until flush() compacts the log, which it does once
+dead records outweigh live ones. Truncating compacts at once, since the
+records it drops would otherwise come back if the index were rebuilt.
+
+The index header carries the log size it accounts for. Records beyond it
+(written before a crash, ahead of their offsets) are picked up again on
+open; a log that is shorter than the index expects, or belongs to another
+compaction, is rescanned from the start.
+"""
+
+import os
+import json
+import mmap
+import struct
+import zlib
+import logging
+from typing import Any, Dict, Iterable, Iterator, List, Optional
+
+logger = logging.getLogger("engram.metadata_log")
+
+LOG_MAGIC = b"EGML"
+INDEX_MAGIC = b"EGMI"
+VERSION = 1
+
+# magic, version, generation
+LOG_HEADER = struct.Struct("<4sIQ")
+# magic, version, generation, count, log_size, dead_bytes
+INDEX_HEADER = struct.Struct("<4sIQQQQ")
+# length, crc32, id
+RECORD_HEADER = struct.Struct("<IIQ")
+OFFSET = struct.Struct("<Q")
+
+INITIAL_SLOTS = 1024
+# Compact when dead records are at least this large and outweigh live ones
+COMPACT_MIN_DEAD_BYTES = 1 << 20
+
+
+class MetadataLog:
+    """The metadata entries of one compartment, entry i belonging to FAISS id i"""
+
+    def __init__(self, base_path: str):
+        """
+        Open (or create) the log for a compartment
+
+        Args:
+            base_path: Path without extension, e.g. vector_data/default
+        """
+        self.log_path = base_path + ".metalog"
+        self.index_path = base_path + ".metaidx"
+        self._log = None
+        self._log_map: Optional[mmap.mmap] = None
+        self._index = None
+        self._index_map: Optional[mmap.mmap] = None
+        self._open()
+
+    @classmethod
+    def create(cls, base_path: str, entries: Iterable[Dict[str, Any]] = ()) -> "MetadataLog":
+        """A new log holding entries, replacing any existing one"""
+        for path in (base_path + ".metalog", base_path + ".metaidx"):
+            if os.path.exists(path):
+                os.remove(path)
+        log = cls(base_path)
+        log.extend(entries)
+        return log
+
+    @staticmethod
+    def exists(base_path: str) -> bool:
+        return os.path.exists(base_path + ".metalog")
+
+    @staticmethod
+    def remove(base_path: str) -> None:
+        for path in (base_path + ".metalog", base_path + ".metaidx"):
+            if os.path.exists(path):
+                os.remove(path)
+
+    # -- files ---------------------------------------------------------
+
+    def _open(self) -> None:
+        new_log = not os.path.exists(self.log_path) or os.path.getsize(self.log_path) < LOG_HEADER.size
+        self._log = open(self.log_path, "r+b" if not new_log else "w+b")
+        if new_log:
+            self._log.write(LOG_HEADER.pack(LOG_MAGIC, VERSION, 0))
+            self._log.flush()
+        self._log.seek(0)
+        magic, version, self.generation = LOG_HEADER.unpack(self._log.read(LOG_HEADER.size))
+        if magic != LOG_MAGIC or version != VERSION:
+            raise ValueError(f"{self.log_path} is not a version {VERSION} metadata log")
+        self._log.seek(0, os.SEEK_END)
+        self._log_size = self._log.tell()
+
+        fd = os.open(self.index_path, os.O_RDWR | os.O_CREAT, 0o644)
+        self._index = os.fdopen(fd, "r+b")
+        size = os.fstat(fd).st_size
+        if size < INDEX_HEADER.size + INITIAL_SLOTS * OFFSET.size:
+            self._index.truncate(INDEX_HEADER.size + INITIAL_SLOTS * OFFSET.size)
+        self._index_map = mmap.mmap(fd, 0)
+        magic, version, generation, count, log_size, dead = INDEX_HEADER.unpack_from(self._index_map)
+        if size == 0 or magic != INDEX_MAGIC or version != VERSION:
+            self._rebuild()
+        elif generation != self.generation or log_size > self._log_size:
+            logger.warning(f"{self.index_path} does not match its log, rebuilding it")
+            self._rebuild()
+        else:
+            self._count, self._indexed_size, self.dead_bytes = count, log_size, dead
+            if self._log_size > self._indexed_size:
+                self._recover_tail()
+
+    def _map_log(self) -> mmap.mmap:
+        """The log mapped up to its current end"""
+        if self._log_map is None or len(self._log_map) < self._log_size:
+            self._log.flush()
+            if self._log_map is not None:
+                self._log_map.close()
+            self._log_map = mmap.mmap(self._log.fileno(), 0, access=mmap.ACCESS_READ)
+        return self._log_map
+
+    def _write_header(self) -> None:
+        INDEX_HEADER.pack_into(self._index_map, 0, INDEX_MAGIC, VERSION, self.generation,
+                               self._count, self._indexed_size, self.dead_bytes)
+
+    def _slot(self, i: int) -> int:
+        return INDEX_HEADER.size + i * OFFSET.size
+
+    def _offset(self, i: int) -> int:
+        return OFFSET.unpack_from(self._index_map, self._slot(i))[0]
+
+    def _set_offset(self, i: int, offset: int) -> None:
+        end = self._slot(i) + OFFSET.size
+        if end > len(self._index_map):
+            self._index_map.resize(max(end, 2 * len(self._index_map)))
+        OFFSET.pack_into(self._index_map, self._slot(i), offset)
+
+    def _record_size(self, offset: int) -> int:
+        length = struct.unpack_from("<I", self._map_log(), offset)[0]
+        return RECORD_HEADER.size + length
+
+    def _scan(self, start: int) -> Iterator[tuple]:
+        """(offset, size, id) of each intact record from start, stopping at the first torn one"""
+        data = self._map_log()
+        offset = start
+        while offset + RECORD_HEADER.size <= len(data):
+            length, crc, ident = RECORD_HEADER.unpack_from(data, offset)
+            end = offset + RECORD_HEADER.size + length
+            if end > len(data) or zlib.crc32(data[offset + RECORD_HEADER.size:end]) != crc:
+                break
+            yield offset, end - offset, ident
+            offset = end
+
+    def _truncate_log(self, size: int) -> None:
+        if size < self._log_size:
+            logger.warning(f"Dropping {self._log_size - size} bytes of torn records from {self.log_path}")
+            if self._log_map is not None:
+                self._log_map.close()
+                self._log_map = None
+            self._log.truncate(size)
+            self._log.seek(0, os.SEEK_END)
+            self._log_size = size
+
+    def _apply(self, offset: int, size: int, ident: int) -> bool:
+        """Index a record found by scanning; False if it cannot belong here"""
+        if ident < self._count:
+            self.dead_bytes += self._record_size(self._offset(ident))
+        elif ident == self._count:
+            self._count += 1
+        else:
+            return False
+        self._set_offset(ident, offset)
+        return True
+
+    def _recover_tail(self) -> None:
+        end = self._indexed_size
+        for offset, size, ident in self._scan(self._indexed_size):
+            if not self._apply(offset, size, ident):
+                break
+            end = offset + size
+        self._truncate_log(end)
+        self._indexed_size = end
+        self._write_header()
+
+    def _rebuild(self) -> None:
+        self._count = 0
+        self.dead_bytes = 0
+        end = LOG_HEADER.size
+        for offset, size, ident in self._scan(LOG_HEADER.size):
+            if not self._apply(offset, size, ident):
+                break
+            end = offset + size
+        self._truncate_log(end)
+        self._indexed_size = end
+        self._write_header()
+
+    # -- sequence interface ----------------------------------------------
+
+    def __len__(self) -> int:
+        return self._count
+
+    def __getitem__(self, i):
+        if isinstance(i, slice):
+            return [self[j] for j in range(*i.indices(self._count))]
+        i = int(i)
+        if i < 0:
+            i += self._count
+        if not 0 <= i < self._count:
+            raise IndexError("metadata id out of range")
+        offset = self._offset(i)
+        data = self._map_log()
+        length = struct.unpack_from("<I", data, offset)[0]
+        start = offset + RECORD_HEADER.size
+        return json.loads(data[start:start + length])
+
+    def __iter__(self) -> Iterator[Dict[str, Any]]:
+        for i in range(self._count):
+            yield self[i]
+
+    def _append_record(self, ident: int, entry: Dict[str, Any]) -> int:
+        payload = json.dumps(entry).encode("utf-8")
+        offset = self._log_size
+        self._log.write(RECORD_HEADER.pack(len(payload), zlib.crc32(payload), ident))
+        self._log.write(payload)
+        self._log_size += RECORD_HEADER.size + len(payload)
+        return offset
+
+    def append(self, entry: Dict[str, Any]) -> int:
+        """Add an entry; returns its id"""
+        ident = self._count
+        self._set_offset(ident, self._append_record(ident, entry))
+        self._count += 1
+        self._indexed_size = self._log_size
+        self._write_header()
+        return ident
+
+    def extend(self, entries: Iterable[Dict[str, Any]]) -> None:
+        for entry in entries:
+            ident = self._count
+            self._set_offset(ident, self._append_record(ident, entry))
+            self._count += 1
+        self._indexed_size = self._log_size
+        self._write_header()
+
+    def __setitem__(self, i: int, entry: Dict[str, Any]) -> None:
+        i = int(i)
+        if not 0 <= i < self._count:
+            raise IndexError("metadata id out of range")
+        self.dead_bytes += self._record_size(self._offset(i))
+        self._set_offset(i, self._append_record(i, entry))
+        self._indexed_size = self._log_size
+        self._write_header()
+
+    def truncate(self, count: int) -> None:
+        """
+        Forget entries from id count on
+
+        Their records are still intact in the log, and a rebuild would
+        replay them, so the log is compacted right away. Truncation only
+        happens when a load finds entries the index never saved.
+        """
+        if count >= self._count:
+            return
+        for i in range(count, self._count):
+            self.dead_bytes += self._record_size(self._offset(i))
+        self._count = count
+        self._write_header()
+        self.compact()
+
+    # -- durability --------------------------------------------------------
+
+    def flush(self) -> None:
+        """Make everything appended so far durable, compacting first if worthwhile"""
+        live = self._log_size - LOG_HEADER.size - self.dead_bytes
+        if self.dead_bytes >= COMPACT_MIN_DEAD_BYTES and self.dead_bytes > live:
+            self.compact()
+            return
+        self._log.flush()
+        os.fsync(self._log.fileno())
+        self._index_map.flush()
+
+    def compact(self) -> None:
+        """Rewrite the log with live records only, in id order"""
+        generation = self.generation + 1
+        log_tmp = self.log_path + ".tmp"
+        index_tmp = self.index_path + ".tmp"
+        data = self._map_log()
+        with open(log_tmp, "wb") as log, open(index_tmp, "wb") as index:
+            log.write(LOG_HEADER.pack(LOG_MAGIC, VERSION, generation))
+            offsets = bytearray()
+            offset = LOG_HEADER.size
+            for i in range(self._count):
+                start = self._offset(i)
+                size = self._record_size(start)
+                log.write(data[start:start + size])
+                offsets += OFFSET.pack(offset)
+                offset += size
+            index.write(INDEX_HEADER.pack(INDEX_MAGIC, VERSION, generation, self._count, offset, 0))
+            index.write(offsets)
+            for f in (log, index):
+                f.flush()
+                os.fsync(f.fileno())
+        before = self._log_size
+        self.close()
+        # The log goes first: a crash in between leaves an index of the old
+        # generation, which is rebuilt from the new log on open
+        os.replace(log_tmp, self.log_path)
+        os.replace(index_tmp, self.index_path)
+        self._open()
+        logger.info(f"Compacted {self.log_path} from {before} to {self._log_size} bytes")
+
+    def close(self) -> None:
+        if self._index_map is not None:
+            self._index_map.flush()
+            self._index_map.close()
+            self._index_map = None
+        if self._index is not None:
+            self._index.close()
+            self._index = None
+        if self._log_map is not None:
+            self._log_map.close()
+            self._log_map = None
+        if self._log is not None:
+            self._log.close()
+            self._log = None
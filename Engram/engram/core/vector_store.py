@@ -11,6 +11,9 @@ import logging
 import numpy as np
 from typing import List, Dict, Any, Optional, Tuple, Union
 
+from engram.core.simple_embedding import SimpleEmbedding
+from engram.core.metadata_log import MetadataLog
+
 # Configure logging
 logging.basicConfig(level=logging.INFO,
                    format='%(asctime)s - %(name)s - %(levelname)s - %(message)s')
@@ -25,99 +28,6 @@ except ImportError:
     HAS_FAISS = False
     logger.warning("FAISS not available. Vector search will not work.")
 
-class SimpleEmbedding:
-    """
-    A simple embedding generator using basic techniques
-    that don't require SentenceTransformers.
-    
-    This provides a deterministic embedding approach with minimal dependencies.
-    """
-    
-    def __init__(self, vector_size: int = 128, seed: int = 42):
-        """
-        Initialize the simple embedding generator
-        
-        Args:
-            vector_size: Dimension of the generated embeddings
-            seed: Random seed for reproducibility
-        """
-        self.vector_size = vector_size
-        self.seed = seed
-        self.vocab: Dict[str, np.ndarray] = {}
-        self.rng = np.random.RandomState(seed)
-        
-    def _tokenize(self, text: str) -> List[str]:
-        """
-        Simple tokenization by splitting on non-alphanumeric characters
-        and converting to lowercase
-        """
-        import re
-        text = text.lower()
-        tokens = re.findall(r'\b\w+\b', text)
-        return tokens
-    
-    def _get_or_create_token_vector(self, token: str) -> np.ndarray:
-        """Generate a stable vector for a token"""
-        if token not in self.vocab:
-            # Generate a stable random vector for this token
-            # We use the hash of the token to seed the random generator
-            # This ensures the same token always gets the same vector
-            token_hash = hash(token) % 2**32
-            token_rng = np.random.RandomState(token_hash)
-            self.vocab[token] = token_rng.randn(self.vector_size).astype(np.float32)
-        return self.vocab[token]
-    
-    def encode(self, texts: Union[str, List[str]], 
-               normalize: bool = True) -> np.ndarray:
-        """
-        Encode text(s) into fixed-size vectors using a simple TF-IDF
-        like approach with random vectors for words.
-        
-        Args:
-            texts: Text or list of texts to encode
-            normalize: Whether to normalize the vectors to unit length
-            
-        Returns:
-            Numpy array of embeddings with shape (n_texts, vector_size)
-        """
-        if isinstance(texts, str):
-            texts = [texts]
-            
-        result = np.zeros((len(texts), self.vector_size), dtype=np.float32)
-        
-        for i, text in enumerate(texts):
-            tokens = self._tokenize(text)
-            if not tokens:
-                continue
-                
-            # Create the embedding by averaging token vectors
-            token_vectors = np.stack([self._get_or_create_token_vector(t) for t in tokens])
-            
-            # Apply TF component (token frequency)
-            token_counts = {}
-            for token in tokens:
-                token_counts[token] = token_counts.get(token, 0) + 1
-            
-            # Calculate embedding as weighted average of token vectors
-            embedding = np.zeros(self.vector_size, dtype=np.float32)
-            for token, count in token_counts.items():
-                # Higher weight for tokens that appear less frequently in this document
-                # (similar to TF-IDF concept, but very simplified)
-                weight = 1.0 / (1.0 + np.log(count))
-                embedding += weight * self._get_or_create_token_vector(token)
-            
-            # Store the result
-            result[i] = embedding
-        
-        # Normalize if requested
-        if normalize:
-            norms = np.linalg.norm(result, axis=1, keepdims=True)
-            # Avoid division by zero
-            norms = np.maximum(norms, 1e-10)
-            result = result / norms
-            
-        return result
-
 class VectorStore:
     """
     A vector store using FAISS for high-performance similarity search.
@@ -140,7 +50,7 @@ class VectorStore:
         self.dimension = dimension
         self.use_gpu = use_gpu
         self.indices: Dict[str, Any] = {}
-        self.metadata: Dict[str, List[Dict[str, Any]]] = {}
+        self.metadata: Dict[str, MetadataLog] = {}
         self.embedding = SimpleEmbedding(vector_size=dimension)
         
         # Create data directory if it doesn't exist
@@ -189,10 +99,14 @@ class VectorStore:
         return index
     
     def _ensure_compartment(self, compartment: str) -> None:
-        """Ensure the compartment exists, creating it if necessary"""
+        """Ensure the compartment exists, loading or creating it if necessary"""
         if compartment not in self.indices:
+            # Metadata is appended to disk as it is added, so a compartment
+            # saved earlier is picked up rather than overwritten
+            if os.path.exists(self._get_index_path(compartment)) and self.load(compartment):
+                return
             self.indices[compartment] = self._create_index(compartment)
-            self.metadata[compartment] = []
+            self.metadata[compartment] = MetadataLog.create(self._get_metadata_log_path(compartment))
             logger.info(f"Created new compartment '{compartment}'")
     
     def _get_index_path(self, compartment: str) -> str:
@@ -200,9 +114,13 @@ class VectorStore:
         return os.path.join(self.data_path, f"{compartment}.index")
     
     def _get_metadata_path(self, compartment: str) -> str:
-        """Get the path for storing a compartment's metadata"""
+        """Get the path of a compartment's metadata as saved before the metadata log"""
         return os.path.join(self.data_path, f"{compartment}.json")
     
+    def _get_metadata_log_path(self, compartment: str) -> str:
+        """Get the base path of a compartment's metadata log (.metalog and .metaidx)"""
+        return os.path.join(self.data_path, compartment)
+    
     def save(self, compartment: str) -> None:
         """Save the compartment to disk"""
         if not HAS_FAISS:
@@ -214,21 +132,21 @@ class VectorStore:
             return
         
         index_path = self._get_index_path(compartment)
-        metadata_path = self._get_metadata_path(compartment)
+        metadata = self.metadata[compartment]
         
         # FAISS CPU index for saving
         index = self.indices[compartment]
         if self.use_gpu:
             index = faiss.index_gpu_to_cpu(index)
         
+        # Metadata was appended as it was added; make it durable before the
+        # index that refers to it
+        metadata.flush()
+        
         # Save index
         faiss.write_index(index, index_path)
         
-        # Save metadata
-        with open(metadata_path, 'w') as f:
-            json.dump(self.metadata[compartment], f)
-        
-        logger.info(f"Saved compartment '{compartment}' to {index_path} and {metadata_path}")
+        logger.info(f"Saved compartment '{compartment}' to {index_path} and {metadata.log_path}")
     
     def load(self, compartment: str) -> bool:
         """Load a compartment from disk"""
@@ -238,8 +156,10 @@ class VectorStore:
             
         index_path = self._get_index_path(compartment)
         metadata_path = self._get_metadata_path(compartment)
+        log_path = self._get_metadata_log_path(compartment)
         
-        if not os.path.exists(index_path) or not os.path.exists(metadata_path):
+        if not os.path.exists(index_path) or not (
+                MetadataLog.exists(log_path) or os.path.exists(metadata_path)):
             logger.warning(f"Compartment '{compartment}' files not found")
             return False
         
@@ -255,11 +175,28 @@ class VectorStore:
                 except Exception as e:
                     logger.warning(f"Failed to move index to GPU: {str(e)}")
             
-            # Load metadata
-            with open(metadata_path, 'r') as f:
-                metadata = json.load(f)
+            # Map the metadata log, converting a compartment saved as JSON once
+            if not MetadataLog.exists(log_path):
+                with open(metadata_path, 'r') as f:
+                    metadata = MetadataLog.create(log_path, json.load(f))
+                metadata.flush()
+                os.remove(metadata_path)
+                logger.info(f"Converted {metadata_path} to a metadata log")
+            else:
+                metadata = MetadataLog(log_path)
+            
+            # Entries past the index were added but never saved
+            if len(metadata) > index.ntotal:
+                logger.warning(f"Dropping {len(metadata) - index.ntotal} unsaved metadata "
+                               f"entries from compartment '{compartment}'")
+                metadata.truncate(index.ntotal)
+            elif len(metadata) < index.ntotal:
+                logger.warning(f"Compartment '{compartment}' has {index.ntotal - len(metadata)} "
+                               f"vectors without metadata")
             
             # Store in memory
+            if compartment in self.metadata:
+                self.metadata[compartment].close()
             self.indices[compartment] = index
             self.metadata[compartment] = metadata
             
@@ -317,15 +254,10 @@ class VectorStore:
         
         # Add timestamp to metadata
         timestamp = time.time()
-        for i, (text, meta) in enumerate(zip(texts, metadatas)):
-            # Store the original text, metadata, and timestamp
-            entry = {
-                "id": ids[i],
-                "text": text,
-                "timestamp": timestamp,
-                **meta
-            }
-            self.metadata[compartment].append(entry)
+        # Store the original text, metadata, and timestamp
+        self.metadata[compartment].extend(
+            {"id": ids[i], "text": text, "timestamp": timestamp, **meta}
+            for i, (text, meta) in enumerate(zip(texts, metadatas)))
         
         logger.info(f"Added {len(texts)} texts to compartment '{compartment}'")
         return ids
@@ -399,6 +331,9 @@ class VectorStore:
         if os.path.exists(metadata_path):
             os.remove(metadata_path)
         
+        self.metadata[compartment].close()
+        MetadataLog.remove(self._get_metadata_log_path(compartment))
+        
         # Remove from memory
         del self.indices[compartment]
         del self.metadata[compartment]
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""
+Unit tests for the append-only metadata log behind VectorStore compartments.
+"""
+
+import importlib.util
+import os
+import shutil
+
+import pytest
+
+# Load the module alone; importing the engram package pulls in its heavy dependencies
+spec = importlib.util.spec_from_file_location(
+    "metadata_log", os.path.join(os.path.dirname(__file__), "..", "engram", "core", "metadata_log.py"))
+metadata_log = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(metadata_log)
+MetadataLog = metadata_log.MetadataLog
+
+
+def entries(first, count):
+    return [{"id": i, "text": f"memory {i}", "tags": ["a", i]} for i in range(first, first + count)]
+
+
+class TestMetadataLog:
+    """Entries are appended, reopened by mapping, and survive torn writes."""
+
+    def test_append_and_reopen(self, tmp_path):
+        base = str(tmp_path / "default")
+        log = MetadataLog.create(base, entries(0, 3000))
+        assert log.append({"id": 3000, "text": "last"}) == 3000
+        assert log[2] == entries(2, 1)[0]
+        assert log[-1]["text"] == "last"
+        assert [e["id"] for e in log[10:13]] == [10, 11, 12]
+        log.flush()
+        log.close()
+
+        log = MetadataLog(base)
+        assert len(log) == 3001
+        assert log[2999] == entries(2999, 1)[0]
+        with pytest.raises(IndexError):
+            log[3001]
+
+    def test_unindexed_records_are_recovered_and_torn_ones_dropped(self, tmp_path):
+        base = str(tmp_path / "default")
+        log = MetadataLog.create(base, entries(0, 5))
+        log.flush()
+        shutil.copy(base + ".metaidx", tmp_path / "old.metaidx")
+        log.extend(entries(5, 5))
+        log.flush()
+        log.close()
+        # An index from before the last records, and half of a record after them
+        shutil.copy(tmp_path / "old.metaidx", base + ".metaidx")
+        size = os.path.getsize(base + ".metalog")
+        with open(base + ".metalog", "ab") as f:
+            f.write(b"\x40\x00\x00\x00partial")
+
+        log = MetadataLog(base)
+        assert len(log) == 10
+        assert log[9] == entries(9, 1)[0]
+        assert os.path.getsize(base + ".metalog") == size
+        log.append({"id": 10})
+        log.close()
+        assert len(MetadataLog(base)) == 11
+
+    def test_replaced_entries_are_compacted(self, tmp_path, monkeypatch):
+        monkeypatch.setattr(metadata_log, "COMPACT_MIN_DEAD_BYTES", 0)
+        base = str(tmp_path / "default")
+        log = MetadataLog.create(base, entries(0, 4))
+        for _ in range(8):
+            log[1] = {"id": 1, "text": "updated"}
+        before = os.path.getsize(base + ".metalog")
+        log.flush()
+        assert log.generation == 1
+        assert os.path.getsize(base + ".metalog") < before
+        # Truncating compacts without waiting for a flush
+        before = os.path.getsize(base + ".metalog")
+        log.truncate(3)
+        assert log.generation == 2
+        assert os.path.getsize(base + ".metalog") < before
+        assert [e["text"] for e in log] == ["memory 0", "updated", "memory 2"]
+        log.close()
+        assert MetadataLog(base)[1]["text"] == "updated"
+
+    def test_index_from_another_generation_is_rebuilt(self, tmp_path):
+        base = str(tmp_path / "default")
+        log = MetadataLog.create(base, entries(0, 3))
+        log[0] = {"id": 0, "text": "new"}
+        log.flush()
+        shutil.copy(base + ".metaidx", tmp_path / "old.metaidx")
+        log.compact()
+        log.close()
+        shutil.copy(tmp_path / "old.metaidx", base + ".metaidx")
+
+        log = MetadataLog(base)
+        assert [e["text"] for e in log] == ["new", "memory 1", "memory 2"]
+        assert log.dead_bytes == 0
+
+    def test_truncated_entries_stay_gone_after_a_rebuild(self, tmp_path):
+        base = str(tmp_path / "default")
+        log = MetadataLog.create(base, entries(0, 5))
+        log.flush()
+        log.truncate(3)
+        log.append({"id": 3, "text": "after"})
+        log.close()
+        os.remove(base + ".metaidx")
+
+        log = MetadataLog(base)
+        assert [e["id"] for e in log] == [0, 1, 2, 3]
+        assert log[3]["text"] == "after"
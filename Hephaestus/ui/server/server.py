@@ -12,6 +12,7 @@ import argparse
 import time
 from http.server import HTTPServer, SimpleHTTPRequestHandler
 import socketserver
+import subprocess
 import asyncio
 import websockets
 import threading
@@ -66,6 +67,9 @@ if tekton_root not in sys.path:
 # Import shared utilities
 from shared.utils.logging_setup import setup_component_logging
 from shared.utils.global_config import GlobalConfig
+from shared.utils.http_proxy import Route, RouteTable, StreamingProxy
+from shared.utils.ws_frames import (OP_CLOSE, OP_PING, OP_PONG, OP_TEXT, FrameDecoder,
+                                    FrameEncoder, WebSocketError, negotiate_deflate)
 
 # Configure logging
 logger = setup_component_logging("hephaestus")
@@ -73,14 +77,43 @@ logger = setup_component_logging("hephaestus")
 # Get global configuration instance
 global_config = GlobalConfig.get_instance()
 
+# Backends for /api/* paths, matched by longest prefix:
+# (prefix, component whose port to use, replacement for the prefix, exact match only)
+API_ROUTES = [
+    ("/api/terminal/", "ergon", "/terminal/", False),
+    ("/api/register", "hermes", None, False),
+    ("/api/message", "hermes", None, False),
+    ("/api/status", "hermes", None, True),
+    ("/api/query", "hermes", None, False),
+    ("/api/components", "hermes", None, False),
+    ("/api/ai/", "rhetor", None, False),
+    ("/api/v1/ai/", "rhetor", None, False),
+]
+
+
+# Used when neither the global config nor the environment has the port
+DEFAULT_PORTS = {"hermes": 8001, "ergon": 8002, "rhetor": 8003}
+
+
+def component_port(component):
+    try:
+        return getattr(global_config.config, component).port
+    except (AttributeError, TypeError):
+        return int(TektonEnviron.get(f"{component.upper()}_PORT", DEFAULT_PORTS[component]))
+
+
+def build_api_routes():
+    return RouteTable(Route(prefix, "localhost", component_port(component), rewrite, exact)
+                      for prefix, component, rewrite, exact in API_ROUTES)
+
+
+api_proxy = StreamingProxy(build_api_routes())
+
 @architecture_decision("Single-port HTTP/WebSocket server architecture for unified UI serving and API proxying")
 class TektonUIRequestHandler(SimpleHTTPRequestHandler):
     """Handler for serving the Tekton UI"""
     
-    # Configuration for API proxying - using environment variables
-    ERGON_API_HOST = "localhost"
-    global_config = GlobalConfig.get_instance()
-    ERGON_API_PORT = global_config.config.ergon.port if hasattr(global_config.config, 'ergon') else int(TektonEnviron.get("ERGON_PORT"))
+    # API proxying goes through api_proxy, routed by API_ROUTES
     
     # Add class variable to store the WebSocket server instance
     websocket_server = None
@@ -274,12 +307,17 @@ class TektonUIRequestHandler(SimpleHTTPRequestHandler):
             # Log handshake details
             logger.info(f"WebSocket handshake - Key: {websocket_key}, Accept: {accept_key}")
             
+            # Accept permessage-deflate if the browser offers it
+            deflate = negotiate_deflate(self.headers.get("Sec-WebSocket-Extensions"))
+            extensions = f"Sec-WebSocket-Extensions: {deflate.header()}\r\n" if deflate else ""
+
             # Send WebSocket upgrade response
             handshake_response = (
                 f"HTTP/1.1 101 Switching Protocols\r\n"
                 f"Upgrade: websocket\r\n"
                 f"Connection: Upgrade\r\n"
                 f"Sec-WebSocket-Accept: {accept_key}\r\n"
+                f"{extensions}"
                 f"\r\n"
             )
             
@@ -295,7 +333,7 @@ class TektonUIRequestHandler(SimpleHTTPRequestHandler):
             # Start a separate thread to handle this WebSocket connection
             ws_thread = threading.Thread(
                 target=self._handle_websocket_connection,
-                args=(client_socket,),
+                args=(client_socket, deflate),
                 daemon=True
             )
             ws_thread.start()
@@ -311,90 +349,27 @@ class TektonUIRequestHandler(SimpleHTTPRequestHandler):
             logger.error(f"Error handling WebSocket request: {str(e)}")
             self.send_error(HTTPStatus.INTERNAL_SERVER_ERROR, f"WebSocket error: {str(e)}")
     
-    def _handle_websocket_connection(self, client_socket):
+    def _handle_websocket_connection(self, client_socket, deflate=None):
         """Handle the WebSocket connection after upgrade
         
+        Frames are decoded by shared.utils.ws_frames, which receives straight
+        into its buffer and parses frames in place (natively when
+        src/tekton-ws is built), joins fragments and handles compression.
+        
         Args:
             client_socket: The socket connection to the client
+            deflate: Negotiated permessage-deflate parameters, if any
         """
         import select
         import json
         import struct
         import time
         
+        decoder = FrameDecoder(server=True, deflate=deflate)
+        encoder = FrameEncoder(server=True, deflate=deflate)
         try:
-            # Helper function to decode WebSocket frames
-            def decode_websocket_frame(data):
-                """Decode a WebSocket frame"""
-                if len(data) < 2:
-                    return None, None, 0
-                
-                # Parse the first two bytes
-                fin = (data[0] & 0x80) != 0
-                opcode = data[0] & 0x0F
-                masked = (data[1] & 0x80) != 0
-                payload_length = data[1] & 0x7F
-                
-                # Get the index where the header ends
-                header_length = 2
-                
-                # Handle extended payload length
-                if payload_length == 126:
-                    if len(data) < 4:
-                        return None, None, 0
-                    payload_length = struct.unpack("!H", data[2:4])[0]
-                    header_length = 4
-                elif payload_length == 127:
-                    if len(data) < 10:
-                        return None, None, 0
-                    payload_length = struct.unpack("!Q", data[2:10])[0]
-                    header_length = 10
-                
-                # Get the masking key if present
-                mask_key = None
-                if masked:
-                    if len(data) < header_length + 4:
-                        return None, None, 0
-                    mask_key = data[header_length:header_length+4]
-                    header_length += 4
-                
-                # Check if we have enough data
-                if len(data) < header_length + payload_length:
-                    return None, None, 0
-                
-                # Get the payload
-                payload = data[header_length:header_length+payload_length]
-                
-                # Unmask the payload if needed
-                if masked and mask_key:
-                    payload = bytearray(payload)
-                    for i in range(len(payload)):
-                        payload[i] ^= mask_key[i % 4]
-                
-                return opcode, payload, header_length + payload_length
-            
-            # Helper function to encode WebSocket frames
-            def encode_websocket_frame(opcode, payload):
-                """Encode a WebSocket frame"""
-                # First byte: FIN bit set, opcode
-                first_byte = 0x80 | opcode
-                
-                # Determine payload length bytes
-                payload_length = len(payload)
-                if payload_length <= 125:
-                    length_bytes = struct.pack("!B", payload_length)
-                elif payload_length <= 65535:
-                    length_bytes = struct.pack("!BH", 126, payload_length)
-                else:
-                    length_bytes = struct.pack("!BQ", 127, payload_length)
-                
-                # Build frame
-                frame = bytes([first_byte]) + length_bytes + payload
-                return frame
-            
             # Main connection loop
             logger.info("Starting WebSocket connection handler")
-            buffer = bytearray()
             client_socket.setblocking(0)  # Non-blocking mode
             
             # Send a welcome message
@@ -407,8 +382,7 @@ class TektonUIRequestHandler(SimpleHTTPRequestHandler):
                     "message": "Welcome to Tekton UI WebSocket server"
                 }
             }
-            welcome_frame = encode_websocket_frame(1, json.dumps(welcome_message).encode())
-            client_socket.sendall(welcome_frame)
+            client_socket.sendall(encoder.encode(OP_TEXT, json.dumps(welcome_message).encode()))
             
             # Main loop
             while True:
@@ -418,33 +392,29 @@ class TektonUIRequestHandler(SimpleHTTPRequestHandler):
                 if not readable:
                     continue
                 
-                # Read data
+                # Read data into the decoder
                 try:
-                    data = client_socket.recv(4096)
+                    received = decoder.recv_from(client_socket)
                 except BlockingIOError:
                     continue
                 
                 # Check for disconnection
-                if not data:
+                if not received:
                     logger.info("Client disconnected")
                     break
                 
-                # Add to buffer
-                buffer.extend(data)
+                # Messages decoded before a protocol error are still handled
+                messages = []
+                error = None
+                try:
+                    for message in decoder.messages():
+                        messages.append(message)
+                except WebSocketError as e:
+                    error = e
                 
-                # Process frames in buffer
-                while buffer:
-                    opcode, payload, consumed = decode_websocket_frame(buffer)
-                    
-                    # If we don't have a complete frame yet
-                    if opcode is None:
-                        break
-                    
-                    # Remove consumed bytes from buffer
-                    buffer = buffer[consumed:]
-                    
+                for opcode, payload in messages:
                     # Handle different opcodes
-                    if opcode == 0x1:  # Text frame
+                    if opcode == OP_TEXT:
                         try:
                             message = payload.decode('utf-8')
                             logger.info(f"Received message: {message[:100]}")
@@ -467,35 +437,38 @@ class TektonUIRequestHandler(SimpleHTTPRequestHandler):
                                 }
                                 
                                 # Encode and send response
-                                response_frame = encode_websocket_frame(1, json.dumps(response).encode())
-                                client_socket.sendall(response_frame)
+                                client_socket.sendall(encoder.encode(OP_TEXT, json.dumps(response).encode()))
                             
                         except Exception as e:
                             logger.error(f"Error processing message: {str(e)}")
                     
-                    elif opcode == 0x8:  # Close frame
+                    elif opcode == OP_CLOSE:
                         logger.info("Received close frame")
-                        # Send close frame response
-                        close_frame = encode_websocket_frame(0x8, b'')
-                        client_socket.sendall(close_frame)
+                        # Echo the close code back
+                        client_socket.sendall(encoder.encode(OP_CLOSE, payload[:2]))
                         return
                     
-                    elif opcode == 0x9:  # Ping frame
+                    elif opcode == OP_PING:
                         logger.info("Received ping frame")
-                        # Send pong frame
-                        pong_frame = encode_websocket_frame(0xA, payload)
-                        client_socket.sendall(pong_frame)
+                        client_socket.sendall(encoder.encode(OP_PONG, payload))
                     
-                    elif opcode == 0xA:  # Pong frame
+                    elif opcode == OP_PONG:
                         logger.info("Received pong frame")
                     
                     else:
                         logger.warning(f"Unsupported opcode: {opcode}")
+                
+                if error is not None:
+                    logger.warning(f"Closing WebSocket on protocol error: {error}")
+                    client_socket.sendall(encoder.encode(OP_CLOSE, struct.pack("!H", error.code)))
+                    return
             
         except Exception as e:
             logger.error(f"WebSocket connection handler error: {str(e)}")
         finally:
             logger.info("WebSocket connection handler ending")
+            decoder.close()
+            encoder.close()
             try:
                 client_socket.close()
             except:
@@ -840,78 +813,19 @@ class TektonUIRequestHandler(SimpleHTTPRequestHandler):
             logger.error(f"Error handling chat command: {e}")
             self.send_error(500, f"Internal error: {str(e)}")
     
-    @integration_point("API gateway - proxies requests to Ergon, Hermes, and Rhetor backend services")
+    @integration_point("API gateway - streams requests to Ergon, Hermes, and Rhetor over pooled connections")
     def proxy_api_request(self, method):
-        """Proxy API requests to the appropriate backend service"""
+        """Proxy API requests to the backend their path routes to (see API_ROUTES)"""
+        route = api_proxy.routes.match(self.path)
+        if route is None:
+            self.send_error(404, f"API endpoint not supported: {self.path}")
+            return
+        logger.info(f"Proxying {method} request to {route.host}:{route.port}{route.target(self.path)}")
         try:
-            # Determine target based on path
-            target_host = self.ERGON_API_HOST
-            target_port = self.ERGON_API_PORT
-            
-            # Terminal/LLM endpoints
-            if self.path.startswith("/api/terminal/"):
-                # Convert /api/terminal/* to /terminal/* for Ergon API
-                target_path = self.path.replace("/api/terminal/", "/terminal/")
-            # Hermes endpoints - proxy to actual Hermes service
-            elif self.path.startswith("/api/register") or \
-                 self.path.startswith("/api/message") or \
-                 self.path == "/api/status" or \
-                 self.path.startswith("/api/query") or \
-                 self.path.startswith("/api/components"):
-                # Proxy to Hermes
-                target_host = "localhost"
-                try:
-                    target_port = global_config.config.hermes.port
-                except (AttributeError, TypeError):
-                    target_port = int(TektonEnviron.get("HERMES_PORT", 8001))
-                target_path = self.path  # Keep the same path
-            # Rhetor CI specialist endpoints - proxy to Rhetor service
-            elif self.path.startswith("/api/ai/") or self.path.startswith("/api/v1/ai/"):
-                target_host = "localhost"
-                try:
-                    target_port = global_config.config.rhetor.port
-                except (AttributeError, TypeError):
-                    target_port = int(TektonEnviron.get("RHETOR_PORT", 8003))
-                target_path = self.path  # Keep the same path
-            else:
-                # Unknown API endpoint
-                self.send_error(404, f"API endpoint not supported: {self.path}")
-                return
-            
-            # Get content length for POST requests
-            content_length = int(self.headers.get('Content-Length', 0))
-            body = None
-            if content_length > 0:
-                body = self.rfile.read(content_length)
-            
-            # Get all headers to forward
-            headers = {}
-            for header, value in self.headers.items():
-                if header.lower() not in ('host', 'content-length'):
-                    headers[header] = value
-            
-            # Make request to backend
-            logger.info(f"Proxying {method} request to {target_host}:{target_port}{target_path}")
-            
-            conn = http.client.HTTPConnection(target_host, target_port)
-            conn.request(method, target_path, body=body, headers=headers)
-            response = conn.getresponse()
-            
-            # Forward response status and headers
-            self.send_response(response.status)
-            for header, value in response.getheaders():
-                if header.lower() not in ('transfer-encoding',):
-                    self.send_header(header, value)
-            self.end_headers()
-            
-            # Forward response body
-            self.wfile.write(response.read())
-            conn.close()
-            
+            api_proxy.forward(self, route)
         except Exception as e:
             logger.error(f"Error proxying request: {e}")
-            self.send_error(500, f"Error proxying request: {str(e)}")
-    
+            self.close_connection = True
 
     @api_contract("GET /health, /api/health - Returns component health status in standard Tekton format")
     def handle_health_check(self):
@@ -1538,21 +1452,70 @@ def run_websocket_server(port):
     
     logger.info("WebSocket server initialized for Single Port Architecture")
 
-def run_http_server(directory, port):
-    """Run the HTTP server"""
+FRONT_SERVER = os.path.join(tekton_root, "src", "tekton-front", "tekton-front")
+
+
+class TektonHTTPServer(socketserver.ThreadingMixIn, socketserver.TCPServer):
+    """One thread per connection, so a held-open WebSocket cannot stall page loads"""
+    allow_reuse_address = True
+    daemon_threads = True
+
+
+def make_http_server(directory, port, host=""):
     handler = lambda *args, **kwargs: TektonUIRequestHandler(*args, directory=directory, **kwargs)
-    
-    # Create a custom TCPServer that allows address reuse
-    class TektonTCPServer(socketserver.TCPServer):
-        allow_reuse_address = True
-    
-    with TektonTCPServer(("", port), handler) as httpd:
+    return TektonHTTPServer((host, port), handler)
+
+
+def front_server_routes():
+    """API routes the front server can stream straight to their backend (no rewrite, prefix match)"""
+    routes = []
+    for route in api_proxy.routes:
+        if route.rewrite is None and not route.exact:
+            host = "127.0.0.1" if route.host == "localhost" else route.host
+            routes += ["--route", f"{route.prefix}={host}:{route.port}"]
+    return routes
+
+
+def start_front_server(directory, port, upstream_port):
+    """
+    Start src/tekton-front on the public port, in front of the Python server
+    on upstream_port. Returns the process, or None if it is not built or
+    could not take the port.
+    """
+    if not os.access(FRONT_SERVER, os.X_OK) or TektonEnviron.get("HEPHAESTUS_FRONT", "true").lower() == "false":
+        return None
+    command = [FRONT_SERVER, "--port", str(port), "--root", directory,
+               "--upstream", f"127.0.0.1:{upstream_port}", "--parent", str(os.getpid())]
+    command += front_server_routes()
+    process = subprocess.Popen(command, stdin=subprocess.DEVNULL)
+    time.sleep(0.2)
+    if process.poll() is not None:
+        logger.warning(f"tekton-front exited with {process.returncode}, serving port {port} from Python")
+        return None
+    return process
+
+
+def run_http_server(directory, port):
+    """Run the HTTP server, behind the native front server when it is built"""
+    httpd = make_http_server(directory, 0, host="127.0.0.1")
+    front = start_front_server(directory, port, httpd.server_address[1])
+    if front is None:
+        httpd.server_close()
+        httpd = make_http_server(directory, port)
         logger.info(f"Serving at http://localhost:{port}")
+    else:
+        logger.info(f"Serving at http://localhost:{port} through tekton-front "
+                    f"(Python handler on 127.0.0.1:{httpd.server_address[1]})")
+
+    with httpd:
         try:
             httpd.serve_forever()
         except KeyboardInterrupt:
             logger.info("HTTP server stopped")
-            httpd.server_close()
+        finally:
+            if front is not None:
+                front.terminate()
+                front.wait()
 
 def main():
     """Main entry point"""
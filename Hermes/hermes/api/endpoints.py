@@ -84,6 +84,23 @@ class ComponentRegistrationResponse(TektonBaseModel):
     token: Optional[str] = None
     message: Optional[str] = None
 
+class BulkRegistrationRequest(TektonBaseModel):
+    """Model for registering many components in one call (used by the launcher)."""
+    components: List[ComponentRegistrationRequest] = []
+
+class BulkRegistrationResponse(TektonBaseModel):
+    """Model for bulk registration responses."""
+    success: bool
+    registrations: Dict[str, ComponentRegistrationResponse] = {}
+    failed: List[str] = []
+
+class ConfirmRegistrationRequest(TektonBaseModel):
+    """Model for a component confirming its pre-registration."""
+    component_id: str
+    version: Optional[str] = None
+    capabilities: List[str] = []
+    metadata: Dict[str, Any] = {}
+
 class HeartbeatRequest(TektonBaseModel):
     """Model for heartbeat requests."""
     component_id: str
@@ -95,6 +112,23 @@ class HeartbeatResponse(TektonBaseModel):
     timestamp: float
     message: Optional[str] = None
 
+class BatchHeartbeatEntry(TektonBaseModel):
+    """One component's entry in a batched heartbeat."""
+    component_id: str
+    token: str
+    status: Dict[str, Any] = {}
+
+class BatchHeartbeatRequest(TektonBaseModel):
+    """Model for batched heartbeat requests relayed by the launcher."""
+    heartbeats: List[BatchHeartbeatEntry] = []
+
+class BatchHeartbeatResponse(TektonBaseModel):
+    """Model for batched heartbeat responses."""
+    success: bool
+    timestamp: float
+    accepted: int
+    rejected: List[str] = []
+
 class ServiceQueryRequest(TektonBaseModel):
     """Model for service query requests."""
     capability: Optional[str] = None
@@ -170,6 +204,88 @@ async def register_component(
         message="Component registered successfully"
     )
 
+@app.post("/register/bulk", response_model=BulkRegistrationResponse)
+@api_contract(
+    title="Bulk Component Registration API",
+    endpoint="/register/bulk",
+    method="POST",
+    request_schema={"components": "list of registration requests"}
+)
+async def register_components_bulk(
+    bulk: BulkRegistrationRequest,
+    manager: RegistrationManager = Depends(get_registration_manager)
+):
+    """
+    Register a set of components in one call.
+    
+    The launcher knows every component's name, port and capabilities from
+    tekton_components.yaml, so it pre-registers them all once Hermes is
+    ready. Components then confirm via /register/confirm instead of each
+    racing to /register at startup. Results are keyed by component name.
+    """
+    registrations: Dict[str, ComponentRegistrationResponse] = {}
+    failed: List[str] = []
+    
+    for registration in bulk.components:
+        component_id = registration.component_id or generate_component_id(
+            name=registration.name,
+            component_type=registration.component_type
+        )
+        success, token_str = manager.register_component(
+            component_id=component_id,
+            name=registration.name,
+            version=registration.version,
+            component_type=registration.component_type,
+            endpoint=registration.endpoint,
+            capabilities=registration.capabilities,
+            metadata=registration.metadata
+        )
+        if success:
+            registrations[registration.name] = ComponentRegistrationResponse(
+                success=True,
+                component_id=component_id,
+                token=token_str,
+                message="Component pre-registered"
+            )
+        else:
+            failed.append(registration.name)
+    
+    return BulkRegistrationResponse(
+        success=not failed,
+        registrations=registrations,
+        failed=failed
+    )
+
+@app.post("/register/confirm", response_model=ComponentRegistrationResponse)
+async def confirm_registration(
+    confirmation: ConfirmRegistrationRequest,
+    x_authentication_token: str = Header(...),
+    manager: RegistrationManager = Depends(get_registration_manager)
+):
+    """
+    Confirm a registration made by the launcher's bulk pre-registration.
+    
+    Returns 404 if the registration is unknown (e.g. Hermes restarted), in
+    which case the component should fall back to a full /register.
+    """
+    success = manager.confirm_component(
+        component_id=confirmation.component_id,
+        token_str=x_authentication_token,
+        version=confirmation.version,
+        capabilities=confirmation.capabilities,
+        metadata=confirmation.metadata
+    )
+    
+    if not success:
+        raise HTTPException(status_code=404, detail="Pre-registration not found or token invalid")
+    
+    return ComponentRegistrationResponse(
+        success=True,
+        component_id=confirmation.component_id,
+        token=x_authentication_token,
+        message="Registration confirmed"
+    )
+
 @app.post("/heartbeat", response_model=HeartbeatResponse)
 @api_contract(
     title="Component Heartbeat API",
@@ -211,6 +327,44 @@ async def send_heartbeat(
         message="Heartbeat received"
     )
 
+@app.post("/heartbeat/batch", response_model=BatchHeartbeatResponse)
+@api_contract(
+    title="Batched Component Heartbeat API",
+    endpoint="/heartbeat/batch",
+    method="POST",
+    request_schema={"heartbeats": [{"component_id": "string", "token": "string", "status": "object"}]}
+)
+async def send_heartbeat_batch(
+    batch: BatchHeartbeatRequest,
+    manager: RegistrationManager = Depends(get_registration_manager)
+):
+    """
+    Accept heartbeats for many components in one request.
+
+    The launcher's supervisor collects liveness from the components it
+    started and forwards them here once per interval, so Hermes sees one
+    connection per installation instead of one per component per tick.
+    Each entry carries its own registration token.
+    """
+    accepted = 0
+    rejected: List[str] = []
+    for entry in batch.heartbeats:
+        if manager.send_heartbeat(
+            component_id=entry.component_id,
+            token_str=entry.token,
+            status=entry.status
+        ):
+            accepted += 1
+        else:
+            rejected.append(entry.component_id)
+
+    return BatchHeartbeatResponse(
+        success=not rejected,
+        timestamp=time.time(),
+        accepted=accepted,
+        rejected=rejected
+    )
+
 @app.post("/unregister")
 async def unregister_component(
     component_id: str,
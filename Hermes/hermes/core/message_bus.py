@@ -5,18 +5,52 @@ This module provides the main interface for message passing, publishing,
 and subscribing to events across Tekton components.
 """
 
+import errno
 import logging
 import json
 import asyncio
+import inspect
+import select
+import threading
 import time
-from typing import Dict, List, Any, Optional, Union, Callable, Set
+from collections import deque
+from typing import Deque, Dict, List, Any, Optional, Union, Callable, Set, Tuple
 
 from landmarks import architecture_decision, performance_boundary, integration_point
 
+try:
+    from shared.utils.shm_bus import BUS_TOPICS_ENV, SharedBus, Subscription
+except ImportError:
+    SharedBus = Subscription = None
+    BUS_TOPICS_ENV = "TEKTON_BUS_TOPICS"
+
 # Configure logger
 logger = logging.getLogger(__name__)
 
 
+def _envelope_encoder() -> Callable[[Any], str]:
+    """
+    Compact JSON for envelopes crossing processes.
+
+    json.dumps sets up a new C encoder on every call, which costs about as
+    much as encoding a small envelope; this one is set up once. It skips
+    the circular reference check, so a cyclic message fails with
+    RecursionError rather than ValueError.
+    """
+    from json import encoder
+    if encoder.c_make_encoder is None:
+        return json.JSONEncoder(separators=(",", ":")).encode
+    iterencode = encoder.c_make_encoder(None, json.JSONEncoder().default, encoder.encode_basestring_ascii,
+                                        None, ":", ",", False, False, True)
+    return lambda envelope: "".join(iterencode(envelope, 0))
+
+
+_encode = _envelope_encoder()
+
+# Seconds between warnings about messages the shared bus rejects on a topic
+REJECT_WARNING_INTERVAL = 60.0
+
+
 @architecture_decision(
     title="Pub/Sub messaging pattern",
     rationale="Enable loose coupling between components with asynchronous event-driven communication",
@@ -28,7 +62,7 @@ logger = logging.getLogger(__name__)
 @integration_point(
     title="Central message bus",
     target_component="All Tekton components",
-    protocol="In-memory pub/sub (future: WebSocket)",
+    protocol="Shared-memory rings via tekton-busd, in-process when no broker is running",
     data_flow="Components publish events -> MessageBus routes -> Subscribers receive"
 )
 class MessageBus:
@@ -37,6 +71,12 @@ class MessageBus:
     
     This class provides methods for publishing and subscribing to messages,
     enabling asynchronous communication between Tekton components.
+
+    When the launcher has started the bus broker (TEKTON_BUS_SOCKET),
+    messages also go through its shared-memory rings, so subscribers in
+    other processes receive them and history is kept there. Local
+    subscribers are still called directly; a bus never hears its own
+    messages back from the rings.
     """
     
     def __init__(self, 
@@ -59,13 +99,26 @@ class MessageBus:
         self.subscriptions: Dict[str, Set[Callable]] = {}
         
         # Message history for replay (optional, configurable size)
-        self.history: Dict[str, List[Dict[str, Any]]] = {}
+        self.history: Dict[str, Deque[Dict[str, Any]]] = {}
         self.history_size = self.config.get("history_size", 100)
         
-        # Placeholder for connection
+        # Shared-memory bus, one feed per subscribed pattern
         self.connection = None
-        
-        logger.info(f"Message bus initialized at {host}:{port}")
+        if SharedBus is not None and self.config.get("shared_bus", True):
+            self.connection = SharedBus.connect()
+        self._feeds: Dict[str, Subscription] = {}
+        self._feed_loops: Dict[str, asyncio.AbstractEventLoop] = {}
+        self._feed_thread: Optional[threading.Thread] = None
+        self._local_only_topics: Set[str] = set()
+        # Topic -> (last warning, messages rejected since) for oversized messages
+        self._rejected: Dict[str, Tuple[float, int]] = {}
+        # Event loop each coroutine callback was subscribed from; the feed
+        # thread hands their messages back to it
+        self._callback_loops: Dict[Callable, asyncio.AbstractEventLoop] = {}
+        self._loop: Optional[asyncio.AbstractEventLoop] = None
+        
+        logger.info(f"Message bus initialized at {host}:{port}"
+                    f"{' (shared memory)' if self.connection else ''}")
     
     def connect(self) -> bool:
         """
@@ -74,8 +127,12 @@ class MessageBus:
         Returns:
             True if connection successful
         """
-        # TODO: Implement actual connection to message broker
         logger.info(f"Connecting to message broker at {self.host}:{self.port}")
+        if self.connection is None and SharedBus is not None and self.config.get("shared_bus", True):
+            self.connection = SharedBus.connect()
+            if self.connection:
+                for topic in self.subscriptions:
+                    self._open_feed(topic)
         return True
     
     @performance_boundary(
@@ -99,7 +156,25 @@ class MessageBus:
         Returns:
             True if publication successful
         """
-        # Create message envelope
+        envelope = self._record(topic, message, headers)
+        if envelope is None:
+            return False
+        
+        # Deliver to local subscribers
+        self._deliver_to_subscribers(topic, envelope)
+        
+        return True
+    
+    def _record(self,
+               topic: str,
+               message: Any,
+               headers: Optional[Dict[str, Any]]) -> Optional[Dict[str, Any]]:
+        """
+        Build the envelope and put it on the shared bus, or in local history.
+        
+        Only the shared bus needs the envelope as JSON; without it messages
+        stay Python objects. Returns None if the message cannot be sent.
+        """
         headers = headers or {}
         headers["timestamp"] = time.time()
         headers["topic"] = topic
@@ -108,32 +183,152 @@ class MessageBus:
             "headers": headers,
             "payload": message
         }
+        logger.debug(f"Publishing message to topic {topic}")
         
-        # Serialize to JSON
+        # Serialize to JSON even without the shared bus, so a message that
+        # could never cross processes fails the same way everywhere
         try:
-            message_json = json.dumps(envelope)
-        except TypeError:
+            data = _encode(envelope).encode("ascii")
+        except (TypeError, ValueError, RecursionError):
             logger.error(f"Cannot serialize message for topic {topic}")
-            return False
+            return None
+        
+        if self.connection:
+            try:
+                self.connection.publish(topic, data)
+                return envelope
+            except OSError as e:
+                if e.errno == errno.ENOSPC:
+                    # Topics are never reclaimed; other processes will not see this one
+                    if topic not in self._local_only_topics:
+                        self._local_only_topics.add(topic)
+                        logger.error(f"Shared bus topic table is full: topic {topic} reaches local "
+                                     f"subscribers only. Raise {BUS_TOPICS_ENV} and restart Tekton.")
+                else:
+                    # Too large (over max_payload) or too long a topic name for the rings
+                    self._warn_rejected(topic, e, len(data))
         
-        # TODO: Implement actual message publication
-        logger.info(f"Publishing message to topic {topic}")
-        
-        # Store in history if enabled
         if self.history_size > 0:
             if topic not in self.history:
-                self.history[topic] = []
-            
+                self.history[topic] = deque(maxlen=self.history_size)
             self.history[topic].append(envelope)
-            
-            # Trim history if needed
-            if len(self.history[topic]) > self.history_size:
-                self.history[topic] = self.history[topic][-self.history_size:]
-        
-        # Deliver to local subscribers
-        self._deliver_to_subscribers(topic, envelope)
-        
-        return True
+        return envelope
+    
+    def _warn_rejected(self, topic: str, error: OSError, size: int) -> None:
+        """Warn about messages the rings reject at most once a minute per topic"""
+        now = time.monotonic()
+        last, suppressed = self._rejected.get(topic, (None, 0))
+        if last is not None and now - last < REJECT_WARNING_INTERVAL:
+            self._rejected[topic] = (last, suppressed + 1)
+            return
+        more = f", {suppressed} more since the last warning" if suppressed else ""
+        logger.warning(f"Shared bus rejected a {size}-byte message for topic {topic} ({error}{more}); "
+                       f"delivering locally only")
+        self._rejected[topic] = (now, 0)
+    
+    def _open_feed(self, topic: str) -> None:
+        """Receive messages other processes publish on a subscribed topic or pattern"""
+        if not self.connection or topic in self._feeds:
+            return
+        try:
+            feed = self.connection.subscribe(topic)
+        except OSError as e:
+            logger.warning(f"No shared bus feed for {topic}: {e}")
+            return
+        self._feeds[topic] = feed
+        try:
+            loop = asyncio.get_running_loop()
+        except RuntimeError:
+            loop = None
+        if loop:
+            loop.add_reader(feed.fileno(), self._drain_feed, feed)
+            self._feed_loops[topic] = loop
+        elif self._feed_thread is None:
+            # Subscribed outside an event loop: a thread waits on those feeds
+            self._feed_thread = threading.Thread(target=self._feed_worker, name="message-bus-feeds", daemon=True)
+            self._feed_thread.start()
+    
+    def _close_feed(self, topic: str) -> None:
+        feed = self._feeds.pop(topic, None)
+        if feed is None:
+            return
+        loop = self._feed_loops.pop(topic, None)
+        if loop and not loop.is_closed():
+            loop.remove_reader(feed.fileno())
+        feed.close()
+    
+    def _feed_worker(self) -> None:
+        while self.connection:
+            feeds = [f for t, f in list(self._feeds.items()) if t not in self._feed_loops]
+            if not feeds:
+                time.sleep(0.5)
+                continue
+            # The timeout picks up feeds opened (or closed) since
+            try:
+                ready, _, _ = select.select(feeds, [], [], 0.5)
+            except (OSError, ValueError):
+                continue
+            for feed in ready:
+                self._drain_feed(feed)
+    
+    def _drain_feed(self, feed: "Subscription") -> None:
+        """Hand messages from other processes to this pattern's callbacks"""
+        connection = self.connection
+        if connection is None or not feed.handle:
+            return
+        try:
+            messages = feed.drain()
+        except OSError as e:
+            logger.error(f"Shared bus feed for {feed.pattern} failed: {e}")
+            return
+        # The bus skips our own messages; local subscribers already have them
+        for topic, data, _origin in messages:
+            try:
+                envelope = json.loads(data)
+            except ValueError:
+                logger.error(f"Undecodable message on shared bus topic {topic}")
+                continue
+            for callback in list(self.subscriptions.get(feed.pattern, ())):
+                try:
+                    if inspect.iscoroutinefunction(callback):
+                        self._schedule(callback, envelope, topic)
+                    else:
+                        callback(envelope)
+                except Exception as e:
+                    logger.error(f"Error in subscriber callback for topic {topic}: {e}")
+    
+    def _schedule(self, callback: Callable, envelope: Dict[str, Any], topic: str) -> None:
+        """Run a coroutine callback on the loop it was subscribed from, whichever thread drained the feed"""
+        loop = self._callback_loops.get(callback) or self._loop
+        try:
+            running = asyncio.get_running_loop()
+        except RuntimeError:
+            running = None
+        if loop is None or loop.is_closed():
+            if running is None:
+                logger.warning(f"No event loop for an async subscriber of topic {topic}; message dropped")
+                return
+            loop = running
+        if loop is running:
+            loop.create_task(self._run_callback(callback, envelope, topic))
+        else:
+            asyncio.run_coroutine_threadsafe(self._run_callback(callback, envelope, topic), loop)
+    
+    async def _run_callback(self, callback: Callable, envelope: Dict[str, Any], topic: str) -> None:
+        try:
+            await callback(envelope)
+        except Exception as e:
+            logger.error(f"Error in subscriber callback for topic {topic}: {e}")
+    
+    def _note_loop(self, callback: Callable) -> None:
+        """Remember the running loop, if any, for callbacks the feed thread has to call"""
+        try:
+            loop = asyncio.get_running_loop()
+        except RuntimeError:
+            return
+        self._loop = loop
+        if inspect.iscoroutinefunction(callback):
+            self._callback_loops[callback] = loop
     
     def subscribe(self,
                  topic: str,
@@ -155,6 +350,8 @@ class MessageBus:
         
         # Add callback
         self.subscriptions[topic].add(callback)
+        self._note_loop(callback)
+        self._open_feed(topic)
         
         logger.info(f"Subscribed to topic {topic}")
         return True
@@ -174,6 +371,10 @@ class MessageBus:
         """
         if topic in self.subscriptions and callback in self.subscriptions[topic]:
             self.subscriptions[topic].remove(callback)
+            if not self.subscriptions[topic]:
+                self._close_feed(topic)
+            if not any(callback in callbacks for callbacks in self.subscriptions.values()):
+                self._callback_loops.pop(callback, None)
             logger.info(f"Unsubscribed from topic {topic}")
             return True
             
@@ -257,20 +458,32 @@ class MessageBus:
         Returns:
             List of messages
         """
-        if topic not in self.history:
-            return []
+        local = list(self.history.get(topic, ()))
+        if self.connection and self.history_size > 0:
+            limit = self.history_size if limit is None else min(limit, self.history_size)
+            shared = [json.loads(data) for data in self.connection.history(topic, limit)]
+            if local:
+                # Messages the rings rejected stay here; interleave them by publication time
+                local = sorted(shared + local,
+                               key=lambda envelope: envelope.get("headers", {}).get("timestamp", 0))
+            else:
+                local = shared
             
-        if limit is None or limit >= len(self.history[topic]):
-            return self.history[topic]
+        if limit is None or limit >= len(local):
+            return local
         else:
-            return self.history[topic][-limit:]
+            return local[-limit:]
     
     def close(self) -> None:
         """
         Close the connection to the message broker.
         """
         logger.info("Closing message bus connection")
-        # TODO: Implement actual connection closing
+        for topic in list(self._feeds):
+            self._close_feed(topic)
+        if self.connection:
+            connection, self.connection = self.connection, None
+            connection.close()
         
     async def create_channel(self, channel_name: str, description: str = "") -> bool:
         """
@@ -313,6 +526,8 @@ class MessageBus:
         
         # Add callback
         self.subscriptions[topic].add(callback)
+        self._note_loop(callback)
+        self._open_feed(topic)
         
         logger.info(f"Subscribed to topic {topic} (async)")
         return True
@@ -332,37 +547,10 @@ class MessageBus:
         Returns:
             True if publication successful
         """
-        # Create message envelope
-        headers = headers or {}
-        headers["timestamp"] = time.time()
-        headers["topic"] = topic
-        
-        envelope = {
-            "headers": headers,
-            "payload": message
-        }
-        
-        # Serialize to JSON
-        try:
-            message_json = json.dumps(envelope)
-        except TypeError:
-            logger.error(f"Cannot serialize message for topic {topic}")
+        envelope = self._record(topic, message, headers)
+        if envelope is None:
             return False
         
-        # TODO: Implement actual message publication
-        logger.info(f"Publishing message to topic {topic} (async)")
-        
-        # Store in history if enabled
-        if self.history_size > 0:
-            if topic not in self.history:
-                self.history[topic] = []
-            
-            self.history[topic].append(envelope)
-            
-            # Trim history if needed
-            if len(self.history[topic]) > self.history_size:
-                self.history[topic] = self.history[topic][-self.history_size:]
-        
         # Deliver to local subscribers
         await self._deliver_to_subscribers_async(topic, envelope)
         
@@ -177,6 +177,49 @@ class RegistrationManager:
         logger.info(f"Component {component_id} ({name}) registered successfully")
         return True, token_str
     
+    def confirm_component(self,
+                          component_id: str,
+                          token_str: str,
+                          version: Optional[str] = None,
+                          capabilities: Optional[List[str]] = None,
+                          metadata: Optional[Dict[str, Any]] = None) -> bool:
+        """
+        Confirm a registration made on the component's behalf.
+        
+        The launcher pre-registers every component in one bulk call; each
+        component then only confirms with the token it was handed and fills
+        in what the launcher could not know (version, runtime metadata).
+        
+        Args:
+            component_id: Pre-registered component ID
+            token_str: Registration token issued by the bulk registration
+            version: Actual component version
+            capabilities: Capabilities to replace the configured ones
+            metadata: Metadata to merge into the registration
+            
+        Returns:
+            True if the registration exists and the token is valid
+        """
+        token_payload = RegistrationToken.validate(token_str, self.secret_key)
+        if not token_payload or token_payload["component_id"] != component_id:
+            logger.warning(f"Invalid token for component {component_id} confirmation")
+            return False
+        
+        service = self.service_registry.get_service(component_id)
+        if not service:
+            logger.warning(f"Component {component_id} not pre-registered")
+            return False
+        
+        if version:
+            service["version"] = version
+        if capabilities:
+            service["capabilities"] = capabilities
+        service["metadata"].update(metadata or {})
+        service["metadata"]["confirmed_at"] = time.time()
+        
+        logger.info(f"Component {component_id} confirmed pre-registration")
+        return True
+    
     def unregister_component(self, 
                            component_id: str,
                            token_str: str) -> bool:
@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""
+Athena Graph Benchmark
+
+Compares the in-memory adapter's graph as it was (a networkx MultiDiGraph
+holding every entity and relationship, scanned edge by edge to find a
+relationship by ID) against shared.utils.graph_index, in Python and with
+the native library (src/tekton-graph), on a synthetic knowledge graph of a
+million relationships.
+
+    python scripts/athena_graph_benchmark.py
+    python scripts/athena_graph_benchmark.py --nodes 50000 --edges 250000 --no-legacy
+
+The library is built into a temporary directory, so the tree is untouched.
+The networkx baseline runs only when networkx is installed.
+
+Reported per backend: seconds to load the graph, then queries per second
+for relationships of an entity, paths of up to three hops (find_paths with
+max_depth=2), depth-2 neighbourhoods and relationship lookups by ID.
+"""
+import os
+import sys
+import time
+import random
+import argparse
+import json
+import subprocess
+import tempfile
+from typing import Callable, Dict, List, Tuple
+
+script_path = os.path.realpath(__file__)
+tekton_root = os.path.dirname(os.path.dirname(script_path))
+sys.path.insert(0, tekton_root)
+
+from shared.utils import graph_index  # noqa: E402
+from shared.utils.graph_index import GraphIndex  # noqa: E402
+
+GRAPH_SOURCE = os.path.join(tekton_root, graph_index.GRAPH_SOURCE)
+TYPES = ["related_to", "part_of", "depends_on", "mentions", "created_by", "located_in"]
+Edge = Tuple[str, str, str, str]
+
+
+class LegacyGraph:
+    """The memory adapter's networkx operations as they were"""
+
+    def __init__(self, nodes: List[str], edges: List[Edge]):
+        import networkx as nx
+        self.nx = nx
+        self.graph = nx.MultiDiGraph()
+        for node in nodes:
+            self.graph.add_node(node, entity=node)
+        for edge_id, source, target, edge_type in edges:
+            self.graph.add_edge(source, target, key=edge_id, relationship=(edge_id, edge_type))
+
+    def relationships(self, node: str) -> int:
+        found = 0
+        for _, target, key in self.graph.out_edges(node, keys=True):
+            found += self.graph[node][target][key].get("relationship") is not None
+        for source, _, key in self.graph.in_edges(node, keys=True):
+            found += self.graph[source][node][key].get("relationship") is not None
+        return found
+
+    def paths(self, source: str, target: str, max_hops: int) -> int:
+        found = 0
+        for path in self.nx.all_simple_paths(self.graph, source, target, cutoff=max_hops):
+            for u, v in zip(path, path[1:]):
+                self.graph[u][v][list(self.graph[u][v].keys())[0]].get("relationship")
+            found += 1
+        return found
+
+    def neighborhood(self, node: str, depth: int) -> int:
+        # get_node_subgraph's breadth-first loop of get_entity_relationships calls
+        seen, queue, followed = {node}, [(node, 0)], set()
+        while queue:
+            current, level = queue.pop(0)
+            if level >= depth:
+                continue
+            for u, v, key in list(self.graph.out_edges(current, keys=True)) + \
+                    list(self.graph.in_edges(current, keys=True)):
+                followed.add(key)
+                other = v if u == current else u
+                if other not in seen:
+                    seen.add(other)
+                    queue.append((other, level + 1))
+        return len(seen)
+
+    def lookup(self, edge_id: str) -> bool:
+        for source, target, key in self.graph.edges(keys=True):
+            if key == edge_id:
+                return self.graph[source][target][key].get("relationship") is not None
+        return False
+
+
+class IndexGraph:
+    """The adapter's operations over a GraphIndex and a dict of relationships"""
+
+    def __init__(self, nodes: List[str], edges: List[Edge]):
+        self.relationships_by_id = {edge[0]: edge for edge in edges}
+        self.index = GraphIndex()
+        self.index.add_nodes(nodes)
+        self.index.add_edges(edges)
+
+    def relationships(self, node: str) -> int:
+        return len(self.index.edges(node, "both"))
+
+    def paths(self, source: str, target: str, max_hops: int) -> int:
+        return len(self.index.paths(source, target, max_hops))
+
+    def neighborhood(self, node: str, depth: int) -> int:
+        return len(self.index.neighborhood([node], depth)[0])
+
+    def lookup(self, edge_id: str) -> bool:
+        return edge_id in self.relationships_by_id
+
+
+def synthetic_graph(nodes: int, edges: int, seed: int = 11) -> Tuple[List[str], List[Edge]]:
+    """Entities with skewed degrees: a few hubs, a long tail"""
+    rng = random.Random(seed)
+    ids = [f"entity-{i:07d}" for i in range(nodes)]
+    weights = [1.0 / (1 + i) ** 0.6 for i in range(nodes)]
+    sources = rng.choices(ids, weights=weights, k=edges)
+    targets = rng.choices(ids, k=edges)
+    return ids, [(f"rel-{i:08d}", s, t, rng.choice(TYPES)) for i, (s, t) in enumerate(zip(sources, targets))]
+
+
+def path_queries(edges: List[Edge], count: int, seed: int = 3) -> List[Tuple[str, str]]:
+    """Pairs joined by a walk of three relationships, so every query finds something"""
+    rng = random.Random(seed)
+    out: Dict[str, List[str]] = {}
+    for _, source, target, _ in edges:
+        out.setdefault(source, []).append(target)
+    starts = list(out)
+    pairs = []
+    while len(pairs) < count:
+        node = start = rng.choice(starts)
+        for _ in range(3):
+            node = rng.choice(out.get(node) or [node])
+        if node != start:
+            pairs.append((start, node))
+    return pairs
+
+
+def rate(operation: Callable, arguments: List) -> float:
+    start = time.perf_counter()
+    for args in arguments:
+        operation(*args)
+    return len(arguments) / (time.perf_counter() - start)
+
+
+def bench(make_graph: Callable, nodes: List[str], edges: List[Edge], queries: Dict[str, List],
+          lookups: int) -> Dict:
+    start = time.perf_counter()
+    graph = make_graph(nodes, edges)
+    result = {"load_seconds": time.perf_counter() - start}
+    result["relationships_per_sec"] = rate(graph.relationships, queries["relationships"])
+    result["paths_per_sec"] = rate(lambda s, t: graph.paths(s, t, 3), queries["paths"])
+    result["neighborhoods_per_sec"] = rate(lambda n: graph.neighborhood(n, 2), queries["neighborhoods"])
+    result["lookups_per_sec"] = rate(graph.lookup, queries["lookups"][:lookups])
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark Athena's in-memory graph")
+    parser.add_argument("--nodes", type=int, default=200000, help="Entities (default: 200000)")
+    parser.add_argument("--edges", type=int, default=1000000, help="Relationships (default: 1000000)")
+    parser.add_argument("-q", "--queries", type=int, default=200, help="Queries of each kind (default: 200)")
+    parser.add_argument("--no-legacy", action="store_true", help="Skip the networkx baseline")
+    parser.add_argument("--json", metavar="FILE", help="Also write results as JSON")
+    args = parser.parse_args()
+
+    nodes, edges = synthetic_graph(args.nodes, args.edges)
+    rng = random.Random(5)
+    queries = {
+        "relationships": [(node,) for node in rng.choices(nodes, k=args.queries * 10)],
+        "paths": path_queries(edges, args.queries),
+        "neighborhoods": [(node,) for node in rng.choices(nodes, k=args.queries)],
+        "lookups": [(edge[0],) for edge in rng.choices(edges, k=args.queries * 10)],
+    }
+
+    backends: List[Tuple[str, Callable, int]] = []
+    if not args.no_legacy:
+        try:
+            import networkx  # noqa: F401
+            # Every lookup scans the edge list, so only a few are timed
+            backends.append(("legacy", LegacyGraph, 5))
+        except ImportError:
+            print("networkx is not installed; skipping the legacy baseline")
+
+    results = {}
+    with tempfile.TemporaryDirectory(prefix="tekton-graph-bench-") as work:
+        library = os.path.join(work, graph_index.LIBRARY_NAME)
+        subprocess.run(["make", "-s", "-C", GRAPH_SOURCE, f"LIBRARY={library}"], check=True)
+        backends += [("python", IndexGraph, len(queries["lookups"])),
+                     ("native", IndexGraph, len(queries["lookups"]))]
+
+        for name, make_graph, lookups in backends:
+            path = library if name == "native" else os.path.join(work, "missing.so")
+            os.environ[graph_index.GRAPH_LIBRARY_ENV] = path
+            graph_index._lib = None
+            results[name] = bench(make_graph, nodes, edges, queries, lookups)
+
+    print(f"{args.nodes:,} entities, {args.edges:,} relationships, {os.cpu_count()} CPUs")
+    print(f"  {'backend':<8} {'load s':>8} {'rels/s':>12} {'paths/s':>10} {'hood/s':>10} {'lookups/s':>12}")
+    for name, r in results.items():
+        print(f"  {name:<8} {r['load_seconds']:>8.2f} {r['relationships_per_sec']:>12,.0f} "
+              f"{r['paths_per_sec']:>10,.1f} {r['neighborhoods_per_sec']:>10,.1f} {r['lookups_per_sec']:>12,.0f}")
+    baseline = results.get("legacy")
+    if baseline:
+        for name in ("python", "native"):
+            print(f"  {name} vs legacy: paths {results[name]['paths_per_sec'] / baseline['paths_per_sec']:.1f}x, "
+                  f"neighbourhoods {results[name]['neighborhoods_per_sec'] / baseline['neighborhoods_per_sec']:.1f}x")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
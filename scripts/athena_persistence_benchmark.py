@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""
+Athena Persistence Benchmark
+
+Compares the in-memory adapter's persistence as it was (every entity and
+relationship re-serialized into entities.json and relationships.json with
+indent=2 on each save, and parsed back in full on start) against the
+mapped snapshot and write-ahead log, on a synthetic knowledge graph.
+
+    python scripts/athena_persistence_benchmark.py
+    python scripts/athena_persistence_benchmark.py --entities 20000 --relationships 100000
+
+Reported: seconds to save the graph, seconds from start until the adapter
+is connected (with a log tail of --tail mutations to replay for the
+snapshot), seconds for the first full search after start (which decodes
+every mapped entity), and the cost of one logged mutation. For the
+snapshot, also the seconds to checkpoint again right after the start.
+"""
+import os
+import sys
+import time
+import random
+import argparse
+import asyncio
+import json
+import tempfile
+from typing import Dict, List
+
+script_path = os.path.realpath(__file__)
+tekton_root = os.path.dirname(os.path.dirname(script_path))
+sys.path[:0] = [os.path.join(tekton_root, "Athena"), tekton_root]
+
+from athena.core.entity import Entity  # noqa: E402
+from athena.core.graph.memory import MemoryAdapter  # noqa: E402
+from athena.core.relationship import Relationship  # noqa: E402
+
+TYPES = ["related_to", "part_of", "depends_on", "mentions", "created_by", "located_in"]
+
+
+class LegacyPersistence:
+    """load_data and save_data as they were in persistence.py"""
+
+    def __init__(self, adapter: MemoryAdapter):
+        self.adapter = adapter
+        self.entity_file = os.path.join(adapter.data_path, "legacy-entities.json")
+        self.relationship_file = os.path.join(adapter.data_path, "legacy-relationships.json")
+
+    def save(self) -> None:
+        with open(self.entity_file, "w") as f:
+            json.dump([entity.to_dict() for entity in self.adapter.entities.values()], f, indent=2)
+        with open(self.relationship_file, "w") as f:
+            json.dump([relationship.to_dict() for relationship in self.adapter.relationships.values()], f,
+                      indent=2)
+
+    def load(self) -> None:
+        with open(self.entity_file) as f:
+            for entity_data in json.load(f):
+                entity = Entity.from_dict(entity_data)
+                self.adapter.entities[entity.entity_id] = entity
+        self.adapter.index.add_nodes(self.adapter.entities)
+        with open(self.relationship_file) as f:
+            relationships = [Relationship.from_dict(data) for data in json.load(f)]
+        for relationship in relationships:
+            self.adapter.relationships[relationship.relationship_id] = relationship
+        self.adapter.index.add_edges((r.relationship_id, r.source_id, r.target_id, r.relationship_type)
+                                     for r in relationships)
+
+
+def synthetic_graph(entities: int, relationships: int, seed: int = 11):
+    rng = random.Random(seed)
+    people = [Entity(entity_id=f"entity-{i:07d}", entity_type=rng.choice(["person", "project", "concept"]),
+                     name=f"Entity {i}", properties={"rank": i, "note": "x" * rng.randint(10, 80)})
+              for i in range(entities)]
+    links = [Relationship(relationship_id=f"rel-{i:08d}", relationship_type=rng.choice(TYPES),
+                          source_id=rng.choice(people).entity_id, target_id=rng.choice(people).entity_id,
+                          properties={"weight": rng.random()})
+             for i in range(relationships)]
+    return people, links
+
+
+def timed(coroutine) -> float:
+    start = time.perf_counter()
+    asyncio.run(coroutine)
+    return time.perf_counter() - start
+
+
+async def fill(adapter: MemoryAdapter, entities: List[Entity], relationships: List[Relationship]) -> None:
+    for entity in entities:
+        await adapter.create_entity(entity)
+    for relationship in relationships:
+        await adapter.create_relationship(relationship)
+
+
+def bench_legacy(work: str, entities, relationships) -> Dict:
+    os.makedirs(work)
+    adapter = MemoryAdapter(work)
+    asyncio.run(fill(adapter, entities, relationships))
+    legacy = LegacyPersistence(adapter)
+    start = time.perf_counter()
+    legacy.save()
+    result = {"save_seconds": time.perf_counter() - start}
+    loaded = LegacyPersistence(MemoryAdapter(work))
+    start = time.perf_counter()
+    loaded.load()
+    result["start_seconds"] = time.perf_counter() - start
+    result["first_search_seconds"] = timed(loaded.adapter.search_entities("Entity 1", limit=10 ** 9))
+    result["bytes"] = os.path.getsize(legacy.entity_file) + os.path.getsize(legacy.relationship_file)
+    return result
+
+
+def bench_snapshot(work: str, entities, relationships, tail: int) -> Dict:
+    adapter = MemoryAdapter(work, checkpoint_bytes=1 << 40)
+    asyncio.run(adapter.connect())
+    start = time.perf_counter()
+    asyncio.run(fill(adapter, entities, relationships))
+    logged = time.perf_counter() - start
+    result = {"mutation_us": logged / (len(entities) + len(relationships)) * 1e6}
+    result["save_seconds"] = timed(adapter.sync())
+    result["bytes"] = os.path.getsize(adapter.snapshot_file)
+    # A log tail written after the checkpoint, replayed on start
+    asyncio.run(fill(adapter, [], [Relationship(relationship_id=f"tail-{i}", source_id=entities[i].entity_id,
+                                                target_id=entities[-i].entity_id) for i in range(tail)]))
+    adapter.wal.sync()
+
+    loaded = MemoryAdapter(work)
+    result["start_seconds"] = timed(loaded.connect())
+    # Records not decoded since the start are copied as they are
+    result["resave_seconds"] = timed(loaded.sync())
+    result["first_search_seconds"] = timed(loaded.search_entities("Entity 1", limit=10 ** 9))
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark Athena's graph persistence")
+    parser.add_argument("--entities", type=int, default=100000, help="Entities (default: 100000)")
+    parser.add_argument("--relationships", type=int, default=500000, help="Relationships (default: 500000)")
+    parser.add_argument("--tail", type=int, default=10000, help="Logged mutations to replay (default: 10000)")
+    parser.add_argument("--json", metavar="FILE", help="Also write results as JSON")
+    args = parser.parse_args()
+
+    entities, relationships = synthetic_graph(args.entities, args.relationships)
+    results = {}
+    with tempfile.TemporaryDirectory(prefix="athena-persist-bench-") as work:
+        results["legacy"] = bench_legacy(os.path.join(work, "legacy"), entities, relationships)
+        results["snapshot"] = bench_snapshot(os.path.join(work, "snapshot"), entities, relationships, args.tail)
+
+    print(f"{args.entities:,} entities, {args.relationships:,} relationships, {args.tail:,} logged after the snapshot")
+    print(f"  {'format':<9} {'save s':>8} {'start s':>8} {'1st search s':>13} {'MB':>8}")
+    for name, r in results.items():
+        print(f"  {name:<9} {r['save_seconds']:>8.2f} {r['start_seconds']:>8.2f} "
+              f"{r['first_search_seconds']:>13.2f} {r['bytes'] / 1e6:>8.1f}")
+    print(f"  checkpoint after start: {results['snapshot']['resave_seconds']:.2f} s, in the background")
+    print(f"  logged mutation: {results['snapshot']['mutation_us']:.1f} us "
+          f"(legacy: nothing saved until the next full save)")
+    print(f"  start: {results['legacy']['start_seconds'] / results['snapshot']['start_seconds']:.1f}x faster")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
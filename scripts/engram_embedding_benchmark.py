@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""
+Engram Embedding Benchmark
+
+Compares SimpleEmbedding.encode as it was (a NumPy RandomState per unseen
+token, vectors kept in a vocabulary dict) against hashed token vectors,
+computed with NumPy and with the native batch encoder (src/tekton-embed),
+on a synthetic bulk ingestion of memories.
+
+    python scripts/engram_embedding_benchmark.py
+    python scripts/engram_embedding_benchmark.py -n 50000 --dim 384 --batch 1000
+
+The library is built into a temporary directory, so the tree is untouched.
+
+Reported per encoder: texts/s and the memory still held after the run (the
+legacy vocabulary grows with every new word; hashed vectors hold nothing).
+"""
+import os
+import re
+import sys
+import time
+import random
+import argparse
+import importlib.util
+import json
+import subprocess
+import tempfile
+import tracemalloc
+from typing import Dict, List
+
+import numpy as np
+
+script_path = os.path.realpath(__file__)
+tekton_root = os.path.dirname(os.path.dirname(script_path))
+sys.path.insert(0, tekton_root)
+
+from shared.utils import hash_embedding  # noqa: E402
+
+EMBED_SOURCE = os.path.join(tekton_root, "src", "tekton-embed")
+SIMPLE_EMBEDDING = os.path.join(tekton_root, "Engram", "engram", "core", "simple_embedding.py")
+
+
+def load_simple_embedding():
+    """SimpleEmbedding without importing the engram package (and its heavy dependencies)"""
+    spec = importlib.util.spec_from_file_location("engram_simple_embedding", SIMPLE_EMBEDDING)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module.SimpleEmbedding
+
+
+class LegacySimpleEmbedding:
+    """encode() as it was before hashing: a RandomState per unseen token, kept forever"""
+
+    def __init__(self, vector_size: int = 128, seed: int = 42):
+        self.vector_size = vector_size
+        self.vocab: Dict[str, np.ndarray] = {}
+
+    def _vector(self, token: str) -> np.ndarray:
+        if token not in self.vocab:
+            rng = np.random.RandomState(hash(token) % 2**32)
+            self.vocab[token] = rng.randn(self.vector_size).astype(np.float32)
+        return self.vocab[token]
+
+    def encode(self, texts: List[str], normalize: bool = True) -> np.ndarray:
+        result = np.zeros((len(texts), self.vector_size), dtype=np.float32)
+        for i, text in enumerate(texts):
+            tokens = re.findall(r'\b\w+\b', text.lower())
+            if not tokens:
+                continue
+            np.stack([self._vector(t) for t in tokens])
+            counts = {}
+            for token in tokens:
+                counts[token] = counts.get(token, 0) + 1
+            embedding = np.zeros(self.vector_size, dtype=np.float32)
+            for token, count in counts.items():
+                embedding += (1.0 / (1.0 + np.log(count))) * self._vector(token)
+            result[i] = embedding
+        if normalize:
+            norms = np.maximum(np.linalg.norm(result, axis=1, keepdims=True), 1e-10)
+            result = result / norms
+        return result
+
+
+def corpus(count: int, words: int, seed: int = 7) -> List[str]:
+    """Memory-like texts: Zipf-distributed common words plus fresh identifiers"""
+    rng = random.Random(seed)
+    vocabulary = [f"w{i}" for i in range(20000)]
+    weights = [1.0 / (rank + 1) for rank in range(len(vocabulary))]
+    texts = []
+    for i in range(count):
+        picked = rng.choices(vocabulary, weights, k=words)
+        picked[rng.randrange(words)] = f"task-{i}-{rng.getrandbits(32):08x}"
+        texts.append("User said: " + " ".join(picked) + ".")
+    return texts
+
+
+def bench(make_encoder, texts: List[str], batch: int) -> Dict:
+    """Timed on one fresh encoder; memory held afterwards traced on another"""
+    def ingest(encoder):
+        for first in range(0, len(texts), batch):
+            encoder.encode(texts[first:first + batch])
+
+    encoder = make_encoder()
+    start = time.perf_counter()
+    ingest(encoder)
+    elapsed = time.perf_counter() - start
+    tracemalloc.start()
+    encoder = make_encoder()
+    ingest(encoder)
+    held, _ = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+    return {"texts_per_sec": len(texts) / elapsed, "seconds": elapsed, "held_bytes": held}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark Engram's SimpleEmbedding")
+    parser.add_argument("-n", "--count", type=int, default=20000, help="Texts to ingest (default: 20000)")
+    parser.add_argument("--words", type=int, default=40, help="Words per text (default: 40)")
+    parser.add_argument("--dim", type=int, default=128, help="Vector size (default: 128)")
+    parser.add_argument("--batch", type=int, default=500, help="Texts per encode() call (default: 500)")
+    parser.add_argument("--threads", type=int, default=0, help="Native encoder threads (default: all CPUs)")
+    parser.add_argument("--json", metavar="FILE", help="Also write results as JSON")
+    args = parser.parse_args()
+
+    texts = corpus(args.count, args.words)
+    SimpleEmbedding = load_simple_embedding()
+    results = {}
+    with tempfile.TemporaryDirectory(prefix="engram-embed-bench-") as work:
+        library = os.path.join(work, hash_embedding.LIBRARY_NAME)
+        subprocess.run(["make", "-s", "-C", EMBED_SOURCE, f"LIBRARY={library}"], check=True)
+
+        results["legacy"] = bench(lambda: LegacySimpleEmbedding(args.dim), texts, args.batch)
+
+        os.environ[hash_embedding.EMBED_LIBRARY_ENV] = os.path.join(work, "missing.so")
+        results["hashed_numpy"] = bench(lambda: SimpleEmbedding(args.dim), texts, args.batch)
+
+        os.environ[hash_embedding.EMBED_LIBRARY_ENV] = library
+        results["native_1_thread"] = bench(lambda: SimpleEmbedding(args.dim, threads=1), texts, args.batch)
+        results["native"] = bench(lambda: SimpleEmbedding(args.dim, threads=args.threads), texts, args.batch)
+
+    legacy = results["legacy"]["texts_per_sec"]
+    print(f"{args.count} texts x {args.words} words, dim {args.dim}, batches of {args.batch}, "
+          f"{os.cpu_count()} CPUs")
+    for name, r in results.items():
+        print(f"  {name:<16} {r['texts_per_sec']:>12,.0f} texts/s  {r['texts_per_sec'] / legacy:>6.1f}x"
+              f"  {r['held_bytes'] / 1e6:>8.1f} MB held")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
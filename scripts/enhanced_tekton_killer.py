@@ -78,6 +78,7 @@ else:
 from tekton.utils.component_config import get_component_config
 from shared.utils.env_config import get_component_config as get_env_config
 from tekton.utils.port_config import get_component_port
+from shared.utils.shm_bus import stop_broker
 
 
 class KillMethod(Enum):
@@ -1066,6 +1067,9 @@ async def main():
             # Full cleanup for nuclear or all components
             print("\n🔥 Starting final cleanup phase for all components...")
             await killer.final_cleanup_phase()
+            # Nothing is left to publish on the shared message bus
+            if not killer.dry_run and stop_broker(tekton_root):
+                killer.log("Stopped message bus broker", "success")
         elif args.force:
             # Targeted cleanup only for specific components when using --force
             print(f"\n🔥 Starting cleanup phase for {', '.join(components)}...")
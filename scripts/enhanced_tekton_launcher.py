@@ -81,6 +81,21 @@ else:
 from tekton.utils.component_config import get_component_config
 from shared.utils.env_config import get_component_config as get_env_config
 from tekton.utils.port_config import get_component_port
+from shared.urls import hermes_url
+from shared.utils.supervisor_channel import HeartbeatRelay
+from shared.utils.socket_server import LISTEN_FD_ENV, request_listen_socket
+from shared.utils.log_index import LogIndexWriter, index_path
+from shared.utils.launch_trace import LaunchTrace, LAUNCHER_TRACK
+from shared.utils.supervisor_metrics import (
+    SupervisorMetrics, MetricsServer, METRICS_SOCKET, count_restart, read_restarts, sample_processes
+)
+from shared.utils.usdt import SupervisorProbes
+from shared.utils.pressure import MemoryGuard, LaunchWindow, StallSampler, psi_some_avg10
+from shared.utils.env_tracking import READS_FILE_ENV, reset_reads, write_snapshot
+from shared.utils.shm_bus import BUS_SOCKET_ENV, start_broker
+from shared.utils.hermes_registration import (
+    PREREGISTERED_NAME_ENV, PREREGISTERED_ID_ENV, PREREGISTERED_TOKEN_ENV
+)
 from landmarks import architecture_decision, performance_boundary, integration_point, danger_zone
 
 
@@ -92,6 +107,7 @@ class ComponentState(Enum):
     UNHEALTHY = "unhealthy"
     FAILED = "failed"
     STOPPED = "stopped"
+    SUSPENDED = "suspended"
 
 
 @dataclass
@@ -125,14 +141,27 @@ class HealthCheckResult:
 class LogReader(threading.Thread):
     """Background thread to read from a stream and write to log file"""
     
-    def __init__(self, stream, log_file, component_name, stream_name="output"):
+    def __init__(self, stream, log_file, component_name, stream_name="output",
+                 index: Optional[LogIndexWriter] = None, trace: Optional[LaunchTrace] = None,
+                 metrics: Optional[SupervisorMetrics] = None):
         super().__init__(daemon=True)
         self.stream = stream
         self.log_file = log_file
         self.component_name = component_name
         self.stream_name = stream_name
+        self.index = index
+        self.trace = trace
+        self.metrics = metrics
         self.running = True
         
+    def write(self, text: str):
+        """Write to the log, through the segment index when there is one"""
+        if self.index:
+            self.index.write(text)
+        else:
+            self.log_file.write(text)
+            self.log_file.flush()
+        
     def run(self):
         """Read lines from stream and write to log file"""
         import re
@@ -146,6 +175,12 @@ class LogReader(threading.Thread):
                 line = self.stream.readline()
                 if not line:
                     break
+                if self.trace:
+                    self.trace.instant(f"first {self.stream_name} line", cat="component",
+                                       track=self.component_name)
+                    self.trace = None
+                if self.metrics:
+                    self.metrics.log_line(self.component_name, self.stream_name)
                     
                 # Decode and strip trailing newline
                 decoded_line = line.decode('utf-8', errors='replace').rstrip('\n')
@@ -155,8 +190,7 @@ class LogReader(threading.Thread):
                 
                 # Skip empty lines
                 if not clean_line.strip():
-                    self.log_file.write('\n')
-                    self.log_file.flush()
+                    self.write('\n')
                     continue
                 
                 # Detect if it's a Python log line (has timestamp + formatted content)
@@ -171,8 +205,7 @@ class LogReader(threading.Thread):
                     source = "STDERR" if self.stream_name == "stderr" else "STDOUT"
                     log_line = f"{timestamp} [{source}] {clean_line}\n"
                 
-                self.log_file.write(log_line)
-                self.log_file.flush()
+                self.write(log_line)
                 
                 # Also print to console if verbose (for errors)
                 if self.stream_name == "stderr" and "ERROR" in clean_line:
@@ -182,6 +215,8 @@ class LogReader(threading.Thread):
             print(f"[{self.component_name}] Log reader error: {e}")
         finally:
             self.running = False
+            if self.index:
+                self.index.flush()
 
 
 @architecture_decision(
@@ -199,14 +234,37 @@ class LogReader(threading.Thread):
 class EnhancedComponentLauncher:
     """Advanced component launcher with monitoring and recovery"""
     
-    def __init__(self, verbose: bool = False, health_check_retries: int = 3):
+    def __init__(self, verbose: bool = False, health_check_retries: int = 3,
+                 trace_path: Optional[str] = None, metrics_port: Optional[int] = None,
+                 memory_guard: Optional[MemoryGuard] = None, supervise: bool = False):
         self.verbose = verbose
         self.health_check_retries = health_check_retries
         self.config = get_component_config()
+        # Share the parsed config with status, killer and components
+        try:
+            self.config.compile_blob()
+        except (OSError, ValueError) as e:
+            print(f"Warning: Could not compile component config blob: {e}")
         self.launched_components: Dict[str, LaunchResult] = {}
         self.health_monitor_task: Optional[asyncio.Task] = None
         self.session: Optional[aiohttp.ClientSession] = None
         self.log_readers: List[LogReader] = []
+        # Only a launcher that stays up (--monitor) can relay heartbeats
+        self.supervise = supervise
+        self.heartbeat_relay: Optional[HeartbeatRelay] = None
+        self.preregistrations: Dict[str, Dict[str, str]] = {}
+        # Disabled (no-op) unless --trace was given
+        self.trace = LaunchTrace(trace_path)
+        # Served while monitoring; see start_health_monitoring()
+        self.metrics = SupervisorMetrics()
+        self.metrics_port = metrics_port
+        self.metrics_server: Optional[MetricsServer] = None
+        self.metrics_sampler_task: Optional[asyncio.Task] = None
+        # USDT probes for bpftrace; no-ops without python-stapsdt
+        self.probes = SupervisorProbes()
+        # Sheds components under memory pressure while monitoring (--memory-guard)
+        self.memory_guard = memory_guard
+        self.memory_guard_task: Optional[asyncio.Task] = None
         
         # Setup log directory
         self.tekton_root = tekton_root  # Use the globally found tekton_root
@@ -220,6 +278,11 @@ class EnhancedComponentLauncher:
             timeout=aiohttp.ClientTimeout(total=10),
             connector=aiohttp.TCPConnector(limit=50)
         )
+        # Components report liveness to us; we forward one batch per interval.
+        # Without a supervisor they get no channel and heartbeat Hermes directly.
+        if self.supervise:
+            self.heartbeat_relay = HeartbeatRelay(hermes_url(""))
+            self.heartbeat_relay.start(self.session)
         return self
         
     async def __aexit__(self, exc_type, exc_val, exc_tb):
@@ -228,6 +291,18 @@ class EnhancedComponentLauncher:
             await self.session.close()
         if self.health_monitor_task:
             self.health_monitor_task.cancel()
+        if self.metrics_sampler_task:
+            self.metrics_sampler_task.cancel()
+        if self.memory_guard_task:
+            self.memory_guard_task.cancel()
+        # Never leave components stopped behind us
+        for comp_name, result in self.launched_components.items():
+            if result.state == ComponentState.SUSPENDED:
+                self._signal_component(comp_name, signal.SIGCONT)
+        if self.metrics_server:
+            self.metrics_server.stop()
+        if self.heartbeat_relay:
+            self.heartbeat_relay.stop()
             
         # Stop all log readers
         for reader in self.log_readers:
@@ -250,6 +325,12 @@ class EnhancedComponentLauncher:
         comp_prefix = f"[{component}] " if component else ""
         print(f"{symbol} {timestamp} {comp_prefix}{message}")
         
+    async def sleep(self, seconds: float, reason: str, component_name: Optional[str] = None):
+        """asyncio.sleep that shows up in the launch trace"""
+        with self.trace.span(f"sleep: {reason}", cat="sleep",
+                             track=component_name or LAUNCHER_TRACK, seconds=seconds):
+            await asyncio.sleep(seconds)
+            
     def get_log_file_path(self, component_name: str) -> str:
         """Get the log file path for a component"""
         return os.path.join(self.log_dir, f"{component_name}.log")
@@ -334,7 +415,7 @@ class EnhancedComponentLauncher:
 
             # Wait before retry
             if attempt < self.health_check_retries - 1:
-                await asyncio.sleep(2 ** attempt)  # Exponential backoff
+                await self.sleep(2 ** attempt, "health check backoff", component_name)  # Exponential backoff
 
         # Should never reach here, but just in case
         return HealthCheckResult(
@@ -354,6 +435,7 @@ class EnhancedComponentLauncher:
 
         while time.time() - start_time < timeout:
             health = await self.enhanced_health_check(component_name, port)
+            self.metrics.observe_health(component_name, health.response_time, health.healthy)
 
             if health.healthy:
                 self.log(
@@ -381,7 +463,7 @@ class EnhancedComponentLauncher:
                     )
                 last_update = elapsed
 
-            await asyncio.sleep(check_interval)
+            await self.sleep(check_interval, "health poll", component_name)
 
         return False
     
@@ -437,7 +519,7 @@ class EnhancedComponentLauncher:
                         message=f"Could not free port {port}",
                         startup_time=time.time() - launch_start
                     )
-                await asyncio.sleep(2)
+                await self.sleep(2, "port release", "ui_dev_tools")
         
         # Get the run script path
         hephaestus_dir = os.path.join(self.tekton_root, "Hephaestus")
@@ -511,7 +593,7 @@ class EnhancedComponentLauncher:
         self.log_readers.extend([stdout_reader, stderr_reader])
         
         # Check if process started successfully
-        await asyncio.sleep(1)
+        await self.sleep(1, "early exit check", "ui_dev_tools")
         if process.poll() is not None:
             # Process exited immediately
             stdout_reader.join(timeout=1)
@@ -565,6 +647,10 @@ class EnhancedComponentLauncher:
         
     async def enhanced_launch_component(self, component_name: str) -> LaunchResult:
         """Enhanced component launch with detailed monitoring"""
+        with self.trace.span("launch", track=component_name):
+            return await self._enhanced_launch_component(component_name)
+            
+    async def _enhanced_launch_component(self, component_name: str) -> LaunchResult:
         launch_start = time.time()
         
         try:
@@ -601,10 +687,12 @@ class EnhancedComponentLauncher:
                     )
                     # Register with monitoring so it counts as successful
                     self.launched_components[component_name] = result
+                    self.metrics.component_started(component_name, self.find_port_pid(port))
                     return result
                 else:
                     # Kill unhealthy process
                     self.log(f"Killing unhealthy process on port {port}", "warning", component_name)
+                    self.count_restart(component_name)
                     if not self.kill_port_process(port):
                         return LaunchResult(
                             component_name=component_name,
@@ -613,7 +701,7 @@ class EnhancedComponentLauncher:
                             message=f"Could not free port {port}",
                             startup_time=time.time() - launch_start
                         )
-                    await asyncio.sleep(2)
+                    await self.sleep(2, "port release", component_name)
                     
             # Launch the component
             result = await self.launch_component_process(component_name)
@@ -627,7 +715,9 @@ class EnhancedComponentLauncher:
             # Use component-specific timeouts - be more aggressive
             timeout = 8 if component_name in ["hermes", "engram", "rhetor"] else 5
 
-            if await self.wait_for_healthy(component_name, port, timeout=timeout):
+            with self.trace.span("readiness", track=component_name, port=port):
+                healthy = await self.wait_for_healthy(component_name, port, timeout=timeout)
+            if healthy:
                 final_health = await self.enhanced_health_check(component_name, port)
                 result.state = ComponentState.HEALTHY
                 result.health_check_time = time.time() - health_start
@@ -635,6 +725,9 @@ class EnhancedComponentLauncher:
                 
                 # Register with monitoring
                 self.launched_components[component_name] = result
+                readiness = time.time() - launch_start
+                self.metrics.component_started(component_name, result.pid, readiness=readiness)
+                self.probes.ready(component_name, result.pid, readiness)
                 
                 self.log(
                     f"Launch completed in {result.startup_time:.1f}s, health in {result.health_check_time:.1f}s",
@@ -648,7 +741,8 @@ class EnhancedComponentLauncher:
                 )
                 
                 # Always launch CI - components and CIs are paired with fixed ports
-                await self.launch_component_ai(component_name)
+                with self.trace.span("CI launch", track=component_name):
+                    await self.launch_component_ai(component_name)
             else:
                 result.state = ComponentState.UNHEALTHY
                 result.message = f"Launched but failed health check within {timeout}s"
@@ -669,8 +763,141 @@ class EnhancedComponentLauncher:
                 startup_time=time.time() - launch_start
             )
             
-    async def launch_component_process(self, component_name: str) -> LaunchResult:
-        """Launch the actual component process with logging"""
+    async def restart_component(self, component_name: str, overlap: bool = False,
+                                drain_timeout: float = 10.0) -> LaunchResult:
+        """Restart a component; with overlap the port keeps accepting throughout
+
+        The running instance hands us a duplicate of its listening socket,
+        the replacement serves from that same socket, and only once the
+        replacement has finished startup is the old instance stopped. Both
+        accept from one queue meanwhile, so no connection is refused.
+        """
+        restart_start = time.time()
+        comp_info = self.config.get_component(component_name)
+        if not comp_info:
+            return LaunchResult(
+                component_name=component_name,
+                success=False,
+                state=ComponentState.FAILED,
+                message=f"Unknown component: {component_name}"
+            )
+        port = comp_info.port
+        
+        handoff = None
+        if overlap and platform.system() != "Windows":
+            handoff = request_listen_socket(component_name, self.tekton_root)
+            if handoff is None:
+                self.log("No listening socket offered (not running or no overlap support), "
+                         "falling back to stop/start", "warning", component_name)
+                
+        if handoff is None:
+            if not self.check_port_available(port):
+                self.log(f"Stopping process on port {port}", "info", component_name)
+                if not self.kill_port_process(port):
+                    return LaunchResult(
+                        component_name=component_name,
+                        success=False,
+                        state=ComponentState.FAILED,
+                        message=f"Could not free port {port}",
+                        startup_time=time.time() - restart_start
+                    )
+                await self.sleep(2, "port release", component_name)
+                self.count_restart(component_name)
+            return await self.enhanced_launch_component(component_name)
+        
+        listen_sock, info = handoff
+        old_pid = info.get("pid")
+        try:
+            result = await self.launch_component_process(component_name, listen_fd=listen_sock.fileno())
+        finally:
+            # The replacement holds its own reference now
+            listen_sock.close()
+        if not result.success:
+            self.log(f"Replacement failed, PID {old_pid} keeps serving", "error", component_name)
+            return result
+        
+        # The replacement offers the socket itself only after startup completes
+        self.log(f"Waiting for PID {result.pid} to take over port {port}...", "info", component_name)
+        deadline = time.time() + (8 if component_name in ["hermes", "engram", "rhetor"] else 5) * 3
+        ready = False
+        while time.time() < deadline:
+            offered = request_listen_socket(component_name, self.tekton_root)
+            if offered:
+                offered[0].close()
+                if offered[1].get("pid") == result.pid:
+                    ready = True
+                    break
+            await self.sleep(0.25, "handoff poll", component_name)
+        
+        if not ready:
+            self.log(f"Replacement not ready, stopping it; PID {old_pid} keeps serving", "warning", component_name)
+            await asyncio.get_running_loop().run_in_executor(
+                None, self._stop_process, result.pid, drain_timeout
+            )
+            result.success = False
+            result.state = ComponentState.UNHEALTHY
+            result.message = "Replacement did not become ready"
+            return result
+        
+        # Old instance stops accepting and finishes in-flight requests
+        self.log(f"Draining old instance PID {old_pid}", "info", component_name)
+        if old_pid:
+            await asyncio.get_running_loop().run_in_executor(
+                None, self._stop_process, old_pid, drain_timeout
+            )
+            self.probes.exit(component_name, old_pid, None)
+        
+        health = await self.enhanced_health_check(component_name, port)
+        result.state = ComponentState.HEALTHY if health.healthy else ComponentState.UNHEALTHY
+        result.startup_time = time.time() - restart_start
+        result.message = f"Restarted on port {port} without closing it (PID {old_pid} -> {result.pid})"
+        self.launched_components[component_name] = result
+        self.count_restart(component_name)
+        self.metrics.component_started(component_name, result.pid, readiness=result.startup_time)
+        self.probes.ready(component_name, result.pid, result.startup_time)
+        self.probes.restart(component_name, old_pid, result.pid)
+        self.log(result.message, "success", component_name)
+        return result
+        
+    def count_restart(self, component_name: str):
+        """Count a restart where a supervisor in another process sees it too"""
+        try:
+            count = count_restart(self.tekton_root, component_name)
+        except OSError as e:
+            self.log(f"Could not record restart: {e}", "warning", component_name)
+            self.metrics.component_restarted(component_name)
+            return
+        self.metrics.record_restarts({component_name: count})
+        
+    def _stop_process(self, pid: int, timeout: float):
+        """SIGTERM a component's process group, SIGKILL it if it outlives timeout"""
+        try:
+            proc = psutil.Process(pid)
+        except psutil.NoSuchProcess:
+            return
+        try:
+            # Components are started with setsid, so their PID is the group id
+            if os.getpgid(pid) == pid:
+                os.killpg(pid, signal.SIGTERM)
+            else:
+                proc.terminate()
+            proc.wait(timeout=timeout)
+        except psutil.TimeoutExpired:
+            self.log(f"PID {pid} did not drain within {timeout:.0f}s, killing", "warning")
+            try:
+                proc.kill()
+            except psutil.NoSuchProcess:
+                pass
+        except (ProcessLookupError, psutil.NoSuchProcess):
+            pass
+            
+    async def launch_component_process(self, component_name: str,
+                                       listen_fd: Optional[int] = None) -> LaunchResult:
+        """Launch the actual component process with logging
+
+        listen_fd hands the new process an already listening socket to serve
+        from instead of binding the port (used by overlapping restarts).
+        """
         try:
             comp_info = self.config.get_component(component_name)
             port = comp_info.port
@@ -691,6 +918,30 @@ class EnhancedComponentLauncher:
             env = os.environ.copy()
             env[f"{component_name.upper()}_PORT"] = str(port)
             
+            # Hand the supervisor control fd to the component for heartbeats
+            pass_fds = ()
+            if self.heartbeat_relay:
+                env.update(self.heartbeat_relay.child_env())
+                pass_fds = (self.heartbeat_relay.child_fd,)
+            
+            if listen_fd is not None:
+                env[LISTEN_FD_ENV] = str(listen_fd)
+                pass_fds += (listen_fd,)
+            
+            # Component only has to confirm if we registered it in bulk
+            prereg = self.preregistrations.get(component_name)
+            if prereg:
+                env[PREREGISTERED_NAME_ENV] = component_name
+                env[PREREGISTERED_ID_ENV] = prereg["component_id"]
+                env[PREREGISTERED_TOKEN_ENV] = prereg["token"]
+
+            # Record which settings the component reads and their values, for `tekton reload`
+            try:
+                env[READS_FILE_ENV] = reset_reads(self.tekton_root, component_name)
+                write_snapshot(self.tekton_root, component_name, os.environ)
+            except OSError as e:
+                self.log(f"Env read tracking disabled: {e}", "warning", component_name)
+
             # Add Tekton root to PYTHONPATH for shared imports
             tekton_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
             current_pythonpath = env.get('PYTHONPATH', '')
@@ -743,7 +994,8 @@ class EnhancedComponentLauncher:
                 
             # Open log file
             log_file_path = self.get_log_file_path(component_name)
-            log_file = open(log_file_path, 'a')
+            # UTF-8 whatever the locale: the log index counts offsets in UTF-8 bytes
+            log_file = open(log_file_path, 'a', encoding='utf-8')
             
             # Write launch header to log
             log_file.write(f"\n{'='*60}\n")
@@ -770,18 +1022,33 @@ class EnhancedComponentLauncher:
                     creationflags=subprocess.CREATE_NEW_PROCESS_GROUP
                 )
             else:
-                process = subprocess.Popen(
-                    cmd,
-                    cwd=component_dir,
-                    env=env,
-                    stdout=subprocess.PIPE,
-                    stderr=subprocess.PIPE,
-                    preexec_fn=os.setsid
-                )
+                # Components join the trace (and time their imports) from here
+                env.update(self.trace.child_env())
+                with self.trace.span("fork", track=component_name):
+                    process = subprocess.Popen(
+                        cmd,
+                        cwd=component_dir,
+                        env=env,
+                        stdout=subprocess.PIPE,
+                        stderr=subprocess.PIPE,
+                        pass_fds=pass_fds,
+                        preexec_fn=os.setsid
+                    )
+            self.probes.spawn(component_name, process.pid, port)
                 
-            # Start log reader threads
-            stdout_reader = LogReader(process.stdout, log_file, component_name, "stdout")
-            stderr_reader = LogReader(process.stderr, log_file, component_name, "stderr")
+            # Start log reader threads; both share one segment index for the log
+            try:
+                index = LogIndexWriter(log_file, log_file_path)
+            except OSError as e:
+                self.log(f"Log index disabled: {e}", "warning", component_name)
+                index = None
+            trace = self.trace if self.trace.enabled else None
+            # Reserve the metrics slot here; reader threads only increment it
+            self.metrics.slot(component_name)
+            stdout_reader = LogReader(process.stdout, log_file, component_name, "stdout",
+                                      index, trace, self.metrics)
+            stderr_reader = LogReader(process.stderr, log_file, component_name, "stderr",
+                                      index, trace, self.metrics)
             stdout_reader.start()
             stderr_reader.start()
             
@@ -789,15 +1056,16 @@ class EnhancedComponentLauncher:
             self.log_readers.extend([stdout_reader, stderr_reader])
                 
             # Check if process started successfully (faster check)
-            await asyncio.sleep(1)  # Reduced from 2s to 1s
+            await self.sleep(1, "early exit check", component_name)  # Reduced from 2s to 1s
             if process.poll() is not None:
+                self.probes.exit(component_name, process.pid, process.returncode)
                 # Process exited immediately - wait for readers to capture output
                 stdout_reader.join(timeout=1)
                 stderr_reader.join(timeout=1)
                 
                 # Read last few lines from log file for error message
                 log_file.close()
-                with open(log_file_path, 'r') as f:
+                with open(log_file_path, 'r', encoding='utf-8', errors='replace') as f:
                     lines = f.readlines()
                     error_lines = lines[-10:] if len(lines) > 10 else lines
                     error_msg = ''.join(error_lines)
@@ -871,6 +1139,16 @@ class EnhancedComponentLauncher:
             except OSError:
                 return False
         
+    def find_port_pid(self, port: int) -> Optional[int]:
+        """PID of the process listening on a port, if it can be seen"""
+        try:
+            for conn in psutil.net_connections(kind='inet'):
+                if conn.laddr and conn.laddr.port == port and conn.status == 'LISTEN':
+                    return conn.pid
+        except (psutil.AccessDenied, OSError):
+            pass
+        return None
+        
     def kill_port_process(self, port: int) -> bool:
         """Kill process listening on a port (only LISTEN state, not TIME_WAIT)"""
         try:
@@ -886,7 +1164,8 @@ class EnhancedComponentLauncher:
                     for pid in pids:
                         try:
                             os.kill(int(pid), signal.SIGTERM)
-                            time.sleep(1)
+                            with self.trace.span("sleep: kill grace", cat="sleep", seconds=1):
+                                time.sleep(1)
                             try:
                                 os.kill(int(pid), 0)
                                 os.kill(int(pid), signal.SIGKILL)
@@ -1017,7 +1296,7 @@ class EnhancedComponentLauncher:
                 self.log(f"  - {comp_name} on port {port}", "warning")
             
             self.log("Waiting 3 seconds for socket cleanup...", "info")
-            await asyncio.sleep(3)  # Match the SO_LINGER + buffer time
+            await self.sleep(3, "socket cleanup")  # Match the SO_LINGER + buffer time
             
             # Re-check
             still_blocked = []
@@ -1041,25 +1320,40 @@ class EnhancedComponentLauncher:
             return
         
         # Pre-launch check for lingering processes - only for components we're launching
-        await self.pre_launch_check(target_components=components)
+        with self.trace.span("pre-launch check"):
+            await self.pre_launch_check(target_components=components)
             
         # Group by priority
         launch_groups = self.get_launch_groups(components)
         
         self.log(f"Launching {len(components)} components in {len(launch_groups)} groups", "info")
         self.log(f"Logs will be written to: {self.log_dir}", "log")
-        
+
+        # Shared-memory message bus for Hermes and its clients; components inherit the socket
+        with self.trace.span("message bus broker"):
+            # Polls the socket for up to 2 s; keep that off the event loop
+            bus_socket = await asyncio.get_running_loop().run_in_executor(
+                None, start_broker, self.tekton_root, os.path.join(self.log_dir, "tekton-busd.log"))
+        if bus_socket:
+            os.environ[BUS_SOCKET_ENV] = bus_socket
+        elif self.verbose:
+            self.log("Message bus broker not built (make -C src/tekton-bus); Hermes stays in-process", "info")
+
         # Launch each priority group
+        preregistered = False
         for priority, group_components in launch_groups.items():
             self.log(f"Priority {priority}: {', '.join(group_components)}", "info")
             
-            # Launch in parallel within the group
-            tasks = [
-                self.enhanced_launch_component(comp)
-                for comp in group_components
-            ]
+            # Once Hermes is up, register everything still to come in one call
+            if "hermes" not in group_components and not preregistered:
+                remaining = [c for p, group in launch_groups.items() if p >= priority for c in group]
+                with self.trace.span("hermes bulk pre-registration", components=len(remaining)):
+                    await self.preregister_with_hermes(remaining)
+                preregistered = True
             
-            results = await asyncio.gather(*tasks)
+            # Launch in parallel within the group, as many at once as the host absorbs
+            with self.trace.span(f"priority group {priority}", components=group_components):
+                results = await self.launch_group(group_components)
             
             # Process results
             for result in results:
@@ -1067,15 +1361,135 @@ class EnhancedComponentLauncher:
                     self.log(result.message, "success", result.component_name)
                 else:
                     self.log(result.message, "error", result.component_name)
+                    await self.withdraw_preregistration(result.component_name)
                     
             # Wait a bit between priority groups
             if priority < max(launch_groups.keys()):
-                await asyncio.sleep(2)
+                await self.sleep(2, "between priority groups")
                 
         # Start health monitoring if requested
         if enable_monitoring:
             self.start_health_monitoring()
             
+    async def launch_group(self, components: List[str], sample_interval: float = 0.5) -> List[LaunchResult]:
+        """Launch components concurrently under an adaptive window
+        
+        The window starts small and grows while CPU/IO stall rates stay
+        low, and shrinks when they rise, so a small VM isn't buried in
+        simultaneous imports that all miss their health checks. Without
+        PSI (non-Linux, old kernels) everything launches at once.
+        """
+        sampler = StallSampler()
+        if len(components) <= 1 or not sampler.available:
+            return await asyncio.gather(*(self.enhanced_launch_component(c) for c in components))
+        
+        window = LaunchWindow.from_env(TektonEnviron.all())
+        last_sample = time.monotonic()
+        sampler.sample(last_sample)
+        pending = list(components)
+        running: Dict[asyncio.Task, str] = {}
+        results: Dict[str, LaunchResult] = {}
+        
+        while pending or running:
+            while pending and len(running) < window.size:
+                comp = pending.pop(0)
+                running[asyncio.create_task(self.enhanced_launch_component(comp))] = comp
+            timeout = max(0.0, last_sample + sample_interval - time.monotonic())
+            done, _ = await asyncio.wait(running, timeout=timeout,
+                                         return_when=asyncio.FIRST_COMPLETED)
+            for task in done:
+                results[running.pop(task)] = task.result()
+            # A completion wakes this early; the window only moves once per
+            # interval, however many components finish within it
+            now = time.monotonic()
+            if now - last_sample < sample_interval:
+                continue
+            last_sample = now
+            stall = sampler.sample(now)
+            previous = window.size
+            window.update(stall)
+            if window.size != previous:
+                self.trace.instant("launch window", size=window.size, stall=stall)
+                if self.verbose:
+                    self.log(f"Launch window {previous} -> {window.size} (CPU/IO stall {stall:.0f}%)", "info")
+                    
+        return [results[c] for c in components]
+            
+    async def preregister_with_hermes(self, components: List[str]) -> int:
+        """Pre-register components with Hermes in a single bulk call
+        
+        Avoids the registration stampede when the second wave starts: each
+        component is handed its component_id and token through the
+        environment and only confirms at startup.
+        
+        Returns:
+            Number of components pre-registered
+        """
+        hermes_info = self.config.get_component("hermes")
+        if not hermes_info or self.check_port_available(hermes_info.port):
+            return 0
+        
+        registrations = []
+        for comp_name in components:
+            comp_info = self.config.get_component(comp_name)
+            if not comp_info or comp_name == "hermes":
+                continue
+            registrations.append({
+                "name": comp_name,
+                "version": "pending",
+                "type": comp_name,
+                "endpoint": f"http://localhost:{comp_info.port}",
+                "capabilities": comp_info.capabilities,
+                "metadata": {"preregistered_by": "launcher", "description": comp_info.description}
+            })
+        if not registrations:
+            return 0
+        
+        try:
+            async with self.session.post(
+                hermes_url("/api/register/bulk"),
+                json={"components": registrations}
+            ) as resp:
+                if resp.status != 200:
+                    self.log(f"Bulk pre-registration rejected (HTTP {resp.status})", "warning", "hermes")
+                    return 0
+                data = await resp.json()
+        except Exception as e:
+            self.log(f"Bulk pre-registration unavailable: {e}", "warning", "hermes")
+            return 0
+        
+        for comp_name, reg in data.get("registrations", {}).items():
+            if reg.get("token"):
+                self.preregistrations[comp_name] = {
+                    "component_id": reg["component_id"],
+                    "token": reg["token"]
+                }
+        self.log(f"Pre-registered {len(self.preregistrations)} components", "success", "hermes")
+        return len(self.preregistrations)
+        
+    async def withdraw_preregistration(self, component_name: str) -> bool:
+        """Unregister a component's bulk pre-registration after its launch failed
+        
+        Otherwise Hermes keeps listing it with version "pending". If the
+        component comes up later anyway, its confirm is refused and it falls
+        back to a full registration.
+        """
+        prereg = self.preregistrations.pop(component_name, None)
+        if not prereg:
+            return False
+        try:
+            async with self.session.post(
+                hermes_url("/api/unregister"),
+                params={"component_id": prereg["component_id"]},
+                headers={"X-Authentication-Token": prereg["token"]}
+            ) as resp:
+                if resp.status == 200:
+                    return True
+                self.log(f"Could not withdraw pre-registration (HTTP {resp.status})", "warning", component_name)
+        except Exception as e:
+            self.log(f"Could not withdraw pre-registration: {e}", "warning", component_name)
+        return False
+            
     @performance_boundary(
         title="Component startup orchestration",
         sla="<30s for full stack startup",
@@ -1177,6 +1591,7 @@ class EnhancedComponentLauncher:
                         result = self.launched_components[comp_name]
                         if result.state == ComponentState.HEALTHY:
                             health = await self.enhanced_health_check(comp_name, result.port)
+                            self.metrics.observe_health(comp_name, health.response_time, health.healthy)
                             
                             if not health.healthy:
                                 self.log(
@@ -1193,6 +1608,116 @@ class EnhancedComponentLauncher:
                     
         self.health_monitor_task = asyncio.create_task(monitor())
         self.log("Health monitoring started", "monitor")
+        self.start_metrics()
+        if self.memory_guard:
+            self.start_memory_guard()
+        
+    def start_metrics(self, sample_interval: float = 5.0):
+        """Serve supervisor metrics and keep process samples fresh"""
+        async def sampler():
+            loop = asyncio.get_running_loop()
+            while True:
+                try:
+                    # Read in the executor, stored here: the loop stays the only writer
+                    samples = await loop.run_in_executor(None, sample_processes, dict(self.metrics.pids))
+                    self.metrics.record_samples(samples)
+                    # Restarts done by `tekton restart` and `tekton reload`
+                    restarts = await loop.run_in_executor(None, read_restarts, self.tekton_root)
+                    self.metrics.record_restarts(restarts)
+                    await asyncio.sleep(sample_interval)
+                except asyncio.CancelledError:
+                    break
+                except Exception as e:
+                    self.log(f"Metrics sampling error: {e}", "error")
+                    await asyncio.sleep(sample_interval)
+                    
+        self.metrics_sampler_task = asyncio.create_task(sampler())
+        self.metrics_server = MetricsServer(
+            self.metrics,
+            unix_path=os.path.join(self.tekton_root, METRICS_SOCKET),
+            port=self.metrics_port
+        )
+        try:
+            for endpoint in self.metrics_server.start():
+                self.log(f"Metrics at {endpoint}", "monitor")
+        except OSError as e:
+            self.log(f"Metrics endpoint unavailable: {e}", "warning")
+
+            
+    def start_memory_guard(self, interval: float = 5.0):
+        """Shed low-priority components under memory pressure, bring them back after"""
+        guard = self.memory_guard
+        
+        async def watch():
+            while True:
+                try:
+                    await asyncio.sleep(interval)
+                    psi = psi_some_avg10("memory")
+                    pss, priorities = {}, {}
+                    for comp_name, result in self.launched_components.items():
+                        if comp_name not in self.metrics.pids or result.state not in (
+                                ComponentState.HEALTHY, ComponentState.SUSPENDED):
+                            continue
+                        i = self.metrics.slot(comp_name)
+                        pss[comp_name] = (self.metrics.values["memory_pss_bytes"][i]
+                                          or self.metrics.values["memory_rss_bytes"][i])
+                        comp_info = self.config.get_component(comp_name)
+                        priorities[comp_name] = comp_info.startup_priority if comp_info else 0
+                    decision = guard.evaluate(time.monotonic(), psi, pss, priorities)
+                    if decision:
+                        await self.apply_memory_decision(decision)
+                except asyncio.CancelledError:
+                    break
+                except Exception as e:
+                    self.log(f"Memory guard error: {e}", "error")
+                    
+        budget = f"{guard.budget / 2**20:.0f} MB budget" if guard.budget else "no PSS budget"
+        self.log(f"Memory guard started ({budget}, PSI {guard.psi_high:g}%/{guard.psi_low:g}%, "
+                 f"{guard.mode} on pressure)", "monitor")
+        self.memory_guard_task = asyncio.create_task(watch())
+        
+    async def apply_memory_decision(self, decision):
+        """Carry out a MemoryGuard decision and log it"""
+        comp_name = decision.component
+        result = self.launched_components[comp_name]
+        pid = self.metrics.pids.get(comp_name)
+        
+        if decision.action == "suspend":
+            self.log(f"Memory pressure ({decision.reason}): suspending", "warning", comp_name)
+            if self._signal_component(comp_name, signal.SIGSTOP):
+                result.state = ComponentState.SUSPENDED
+            else:
+                self.memory_guard.forget(comp_name)
+        elif decision.action == "stop":
+            self.log(f"Memory pressure ({decision.reason}): stopping", "warning", comp_name)
+            if result.state == ComponentState.SUSPENDED:
+                # A stopped process group never acts on SIGTERM; let it run to shut down
+                self._signal_component(comp_name, signal.SIGCONT)
+            if pid:
+                await asyncio.get_running_loop().run_in_executor(None, self._stop_process, pid, 10.0)
+                self.probes.exit(comp_name, pid, None)
+            self.metrics.pids.pop(comp_name, None)
+            result.state = ComponentState.STOPPED
+        elif result.state == ComponentState.SUSPENDED:
+            self.log(f"Memory pressure cleared ({decision.reason}): resuming", "success", comp_name)
+            if self._signal_component(comp_name, signal.SIGCONT):
+                result.state = ComponentState.HEALTHY
+        else:
+            self.log(f"Memory pressure cleared ({decision.reason}): restarting", "success", comp_name)
+            relaunched = await self.enhanced_launch_component(comp_name)
+            if not relaunched.success:
+                self.log(f"Restart after memory pressure failed: {relaunched.message}", "error", comp_name)
+                
+    def _signal_component(self, comp_name: str, sig: int) -> bool:
+        """Signal a component's process group (components run under setsid)"""
+        pid = self.metrics.pids.get(comp_name)
+        if not pid:
+            return False
+        try:
+            os.killpg(os.getpgid(pid), sig)
+            return True
+        except (ProcessLookupError, PermissionError):
+            return False
 
 
 async def main():
@@ -1244,12 +1769,51 @@ async def main():
         action="store_true",
         help="Skip automatic Athena population after startup"
     )
+    parser.add_argument(
+        "--metrics-port",
+        type=int,
+        default=int(TektonEnviron.get("TEKTON_METRICS_PORT", "0") or 0) or None,
+        help="With --monitor, also serve OpenMetrics on 127.0.0.1:PORT (default: TEKTON_METRICS_PORT)"
+    )
+    parser.add_argument(
+        "--memory-guard",
+        action="store_true",
+        default=TektonEnviron.get("TEKTON_MEMORY_GUARD") == "1",
+        help="With --monitor, shed low-priority components under memory pressure (default: TEKTON_MEMORY_GUARD)"
+    )
+    parser.add_argument(
+        "--memory-budget",
+        metavar="SIZE",
+        help="PSS budget for all components, e.g. 6G; implies --memory-guard (default: TEKTON_MEMORY_BUDGET)"
+    )
+    parser.add_argument(
+        "--memory-shed",
+        choices=["suspend", "stop"],
+        help="How to shed a component under PSI pressure; a budget overrun always stops one (default: TEKTON_MEMORY_SHED or suspend)"
+    )
+    parser.add_argument(
+        "--trace",
+        metavar="FILE",
+        help="Write a launch timeline in Chrome trace-event format (open in Perfetto)"
+    )
     
     args = parser.parse_args()
     
+    memory_guard = None
+    if args.memory_guard or args.memory_budget or TektonEnviron.get("TEKTON_MEMORY_BUDGET"):
+        try:
+            memory_guard = MemoryGuard.from_env(TektonEnviron.all(), args.memory_budget, args.memory_shed)
+        except ValueError as e:
+            print(f"Invalid memory guard setting: {e}", file=sys.stderr)
+            return
+    
     async with EnhancedComponentLauncher(
         verbose=args.verbose,
-        health_check_retries=args.health_retries
+        health_check_retries=args.health_retries,
+        trace_path=os.path.abspath(args.trace) if args.trace else None,
+        metrics_port=args.metrics_port,
+        memory_guard=memory_guard,
+        supervise=args.monitor
     ) as launcher:
         
         # Determine components to launch
@@ -1284,6 +1848,12 @@ async def main():
                             cleared_count += 1
                         except Exception as e:
                             print(f"Warning: Could not delete log file {log_file}: {e}")
+                    # Its segment index describes the deleted file
+                    if os.path.exists(index_path(log_path)):
+                        try:
+                            os.remove(index_path(log_path))
+                        except OSError:
+                            pass
                 if cleared_count > 0:
                     print(f"✅ Cleared {cleared_count} log files for components being launched")
             
@@ -1321,7 +1891,8 @@ async def main():
         
         # Launch components
         start_time = time.time()
-        await launcher.launch_with_monitoring(components, enable_monitoring=args.monitor)
+        with launcher.trace.span("tekton start", components=components):
+            await launcher.launch_with_monitoring(components, enable_monitoring=args.monitor)
         
         
         # Report results
@@ -1349,7 +1920,8 @@ async def main():
                         stdout=asyncio.subprocess.PIPE,
                         stderr=asyncio.subprocess.PIPE
                     )
-                    stdout, stderr = await process.communicate()
+                    with launcher.trace.span("athena population"):
+                        stdout, stderr = await process.communicate()
                     
                     if process.returncode == 0:
                         launcher.log("✅ Athena populated with component relationships", "success")
@@ -1361,6 +1933,10 @@ async def main():
             except Exception as e:
                 launcher.log(f"⚠️ Error populating Athena: {str(e)}", "warning")
             
+        if launcher.trace.enabled:
+            trace_file = launcher.trace.write()
+            launcher.log(f"Launch trace written to {trace_file} (open in https://ui.perfetto.dev)", "log")
+            
         # Keep monitoring if requested
         if args.monitor and launcher.health_monitor_task:
             launcher.log("Monitoring active. Press Ctrl+C to stop.", "info")
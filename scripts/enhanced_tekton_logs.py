@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""
+Tekton Component Logs
+
+Shows component logs from $TEKTON_ROOT/.tekton/logs/ as one stream,
+merged by timestamp and tagged with the component name.
+
+    tekton logs                  # last lines of every component, merged
+    tekton logs -f rhetor engram # follow two components
+    tekton logs -n 0 hermes      # the whole Hermes log
+    tekton logs --grep 'timeout' --since 1h --level ERROR rhetor engram
+
+Searches use the per-segment indexes the launcher writes next to each log
+(<component>.log.idx) to skip segments that cannot match.
+"""
+import os
+import sys
+import argparse
+from concurrent.futures import ProcessPoolExecutor
+
+# Add parent directory to sys.path to import shared modules first
+script_path = os.path.realpath(__file__)
+parent_dir = os.path.dirname(os.path.dirname(script_path))
+if parent_dir not in sys.path:
+    sys.path.insert(0, parent_dir)
+
+from shared.env import TektonEnviron
+from shared.utils.log_merge import LogSource, DirectoryWatcher, merge_sources, merge_batches
+from shared.utils.log_index import LEVELS, parse_since, read_index, search_log
+
+# Try to import colorama for colored output
+try:
+    from colorama import init, Fore, Style
+    init()
+    HAS_COLOR = True
+except ImportError:
+    HAS_COLOR = False
+    class Fore:
+        GREEN = ''
+        RED = ''
+        YELLOW = ''
+        BLUE = ''
+        CYAN = ''
+        MAGENTA = ''
+    class Style:
+        RESET_ALL = ''
+
+TAG_COLORS = [Fore.CYAN, Fore.GREEN, Fore.YELLOW, Fore.MAGENTA, Fore.BLUE, Fore.RED]
+
+# Flush merged output in blocks; one write per line can't keep up with busy logs
+WRITE_BATCH = 256
+
+
+def get_log_dir() -> str:
+    """Log directory used by the launcher"""
+    tekton_root = TektonEnviron.get('TEKTON_ROOT') or os.getcwd()
+    return TektonEnviron.get('TEKTON_LOG_DIR', os.path.join(tekton_root, ".tekton", "logs"))
+
+
+def select_components(log_dir: str, requested: list) -> list:
+    """Components to show: the ones named, or every log present"""
+    if requested:
+        components = []
+        for arg in requested:
+            components.extend(c.strip().lower().replace("-", "_") for c in arg.split(",") if c.strip())
+        return components
+    if not os.path.isdir(log_dir):
+        return []
+    return sorted(name[:-4] for name in os.listdir(log_dir) if name.endswith(".log"))
+
+
+def make_prefixes(components: list, color: bool) -> list:
+    """Pre-encoded "[component] " tags, padded to a common width"""
+    width = max(len(c) for c in components) + 2
+    prefixes = []
+    for i, component in enumerate(components):
+        tag = f"[{component}]".ljust(width) + " "
+        if color:
+            tag = f"{TAG_COLORS[i % len(TAG_COLORS)]}{tag}{Style.RESET_ALL}"
+        prefixes.append(tag.encode("utf-8"))
+    return prefixes
+
+
+def write_merged(merged, prefixes: list, out) -> None:
+    """Write (source index, line) pairs with component tags"""
+    buf = []
+    for index, line in merged:
+        buf.append(prefixes[index] + line + b"\n")
+        if len(buf) >= WRITE_BATCH:
+            out.write(b"".join(buf))
+            buf.clear()
+    if buf:
+        out.write(b"".join(buf))
+    out.flush()
+
+
+def search(args, log_dir: str, components: list, prefixes: list, out) -> int:
+    """Indexed search across component logs, printed merged by time"""
+    try:
+        since = parse_since(args.since) if args.since else None
+    except ValueError:
+        print(f"Invalid --since value: {args.since}", file=sys.stderr)
+        return 2
+    min_level = LEVELS.index(args.level) if args.level else 0
+
+    batches, matches, skipped, segments = [], 0, 0, 0
+    with ProcessPoolExecutor(max_workers=args.jobs) as executor:
+        for i, component in enumerate(components):
+            log_path = os.path.join(log_dir, f"{component}.log")
+            if not os.path.exists(log_path):
+                continue
+            results, component_skipped = search_log(
+                log_path, args.grep, ignore_case=args.ignore_case,
+                since=since, min_level=min_level, executor=executor
+            )
+            batches.append((i, results))
+            matches += len(results)
+            skipped += component_skipped
+            segments += len(read_index(log_path))
+
+    write_merged(merge_batches(batches), prefixes, out)
+    if args.verbose:
+        print(f"{matches} matching lines; skipped {skipped} of {segments} indexed segments",
+              file=sys.stderr)
+    return 0 if matches else 1
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Show merged Tekton component logs")
+    parser.add_argument(
+        "components",
+        nargs="*",
+        help="Components to show (default: all with a log file)"
+    )
+    parser.add_argument(
+        "--follow", "-f",
+        action="store_true",
+        help="Keep printing lines as components write them"
+    )
+    parser.add_argument(
+        "--lines", "-n",
+        type=int,
+        default=20,
+        help="Lines to show from the end of each log first (0 for the whole file, default: 20)"
+    )
+    parser.add_argument(
+        "--grep", "-g",
+        metavar="PATTERN",
+        help="Only lines matching this regular expression"
+    )
+    parser.add_argument(
+        "--ignore-case", "-i",
+        action="store_true",
+        help="Case-insensitive --grep"
+    )
+    parser.add_argument(
+        "--since",
+        help="Only lines newer than this (e.g. 90s, 30m, 1h, 2d or an ISO timestamp)"
+    )
+    parser.add_argument(
+        "--level",
+        type=str.upper,
+        choices=LEVELS,
+        help="Only records at this level or above"
+    )
+    parser.add_argument(
+        "--jobs", "-j",
+        type=int,
+        default=None,
+        help="Parallel scan processes for searches (default: CPU count)"
+    )
+    parser.add_argument(
+        "--verbose", "-v",
+        action="store_true",
+        help="Report how many index segments a search skipped"
+    )
+    parser.add_argument(
+        "--no-color",
+        action="store_true",
+        help="Do not color component tags"
+    )
+    args = parser.parse_args()
+
+    log_dir = get_log_dir()
+    components = select_components(log_dir, args.components)
+    if not components:
+        print(f"No component logs found in {log_dir}")
+        return 1
+
+    missing = [c for c in components if not os.path.exists(os.path.join(log_dir, f"{c}.log"))]
+    if missing and not args.follow:
+        print(f"No log for: {', '.join(missing)}", file=sys.stderr)
+
+    color = HAS_COLOR and not args.no_color and sys.stdout.isatty()
+    prefixes = make_prefixes(components, color)
+    sources = [
+        LogSource(c, os.path.join(log_dir, f"{c}.log"), start_lines=args.lines)
+        for c in components
+    ]
+    out = sys.stdout.buffer
+    searching = bool(args.grep or args.since or args.level)
+    if searching and args.follow:
+        print("--follow cannot be combined with --grep, --since or --level", file=sys.stderr)
+        return 2
+
+    try:
+        if searching:
+            return search(args, log_dir, components, prefixes, out)
+        if not args.follow:
+            write_merged(merge_sources(sources), prefixes, out)
+            return 0
+
+        os.makedirs(log_dir, exist_ok=True)
+        watcher = DirectoryWatcher(log_dir)
+        try:
+            while True:
+                # Without an explicit list, pick up components launched while following
+                if not args.components:
+                    new = [c for c in select_components(log_dir, []) if c not in components]
+                    if new:
+                        components.extend(new)
+                        sources.extend(LogSource(c, os.path.join(log_dir, f"{c}.log")) for c in new)
+                        prefixes = make_prefixes(components, color)
+                batches = [(i, source.read_lines()) for i, source in enumerate(sources)]
+                write_merged(merge_batches(batches), prefixes, out)
+                watcher.wait(timeout=1.0)
+        finally:
+            watcher.close()
+    except KeyboardInterrupt:
+        return 0
+    except BrokenPipeError:
+        # Output piped into head/less that exited
+        sys.stderr.close()
+        return 0
+    finally:
+        for source in sources:
+            source.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
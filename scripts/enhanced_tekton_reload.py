@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+Tekton Environment Reload
+
+Applies edits to ~/.env, .env.tekton and .env.local by restarting only the
+running components that read a changed setting. The launcher records the
+settings it handed each component and the keys each one read through
+TektonEnviron (shared/utils/env_tracking.py); reload diffs the freshly
+merged files against that record.
+
+    tekton reload              # restart what the edit affects
+    tekton reload --dry-run    # show what would restart and why
+    tekton reload --overlap    # keep ports open while replacing
+"""
+import os
+import sys
+import asyncio
+import argparse
+
+# Same directory as the launcher, which sets up sys.path and the environment
+from enhanced_tekton_launcher import EnhancedComponentLauncher
+from shared.utils.env_tracking import (
+    affected_components, env_snapshot, read_snapshot, restore_snapshot
+)
+
+
+async def main():
+    """Restart the components affected by env file changes"""
+    parser = argparse.ArgumentParser(description="Apply env file changes to running components")
+    parser.add_argument(
+        "--dry-run", "-n",
+        action="store_true",
+        help="List the changed settings and affected components without restarting"
+    )
+    parser.add_argument(
+        "--overlap", "-o",
+        action="store_true",
+        help="Start each replacement on the live socket before stopping the old instance"
+    )
+    parser.add_argument(
+        "--verbose", "-v",
+        action="store_true",
+        help="Verbose output"
+    )
+    args = parser.parse_args()
+
+    failed = 0
+    async with EnhancedComponentLauncher(verbose=args.verbose) as launcher:
+        root = launcher.tekton_root
+        # The C launcher merged the env files again before starting us
+        current = env_snapshot(root, os.environ)
+        running = [
+            name for name, info in launcher.config.get_all_components().items()
+            if not launcher.check_port_available(info.port)
+        ]
+        affected = affected_components(root, running, current)
+        if not affected:
+            launcher.log("No running component reads a setting changed since its launch", "info")
+            return 0
+        for component, keys in affected.items():
+            reason = "untracked, may read anything" if keys == ["*"] else ", ".join(keys)
+            launcher.log(f"{'Would restart' if args.dry_run else 'Restarting'} ({reason})",
+                         "info", component)
+
+        if args.dry_run:
+            return 0
+
+        # Each launch records the new settings; a failed one leaves the
+        # component on the old ones, so its old record goes back
+        for component in affected:
+            previous = read_snapshot(root, component)
+            result = await launcher.restart_component(component, overlap=args.overlap)
+            if not result.success:
+                launcher.log(result.message, "error", component)
+                failed += 1
+                if previous is not None:
+                    restore_snapshot(root, component, previous)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    try:
+        sys.exit(asyncio.run(main()))
+    except KeyboardInterrupt:
+        print("\n\nReload interrupted by user")
+        sys.exit(1)
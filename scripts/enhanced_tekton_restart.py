@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""
+Tekton Component Restart
+
+Restarts running components. With --overlap the replacement is started on
+the running instance's listening socket and the old instance is only
+drained once the replacement is ready, so the port never refuses a
+connection. Components that do not offer their socket (older entry points,
+not running) fall back to a plain stop/start.
+
+    tekton restart rhetor --overlap
+    tekton restart hermes apollo
+"""
+import sys
+import asyncio
+import argparse
+
+# Same directory as the launcher, which sets up sys.path and the environment
+from enhanced_tekton_launcher import EnhancedComponentLauncher
+
+
+async def main():
+    """Restart the named components one at a time"""
+    parser = argparse.ArgumentParser(description="Restart Tekton components")
+    parser.add_argument(
+        "components",
+        nargs="+",
+        help="Components to restart"
+    )
+    parser.add_argument(
+        "--overlap", "-o",
+        action="store_true",
+        help="Start the new instance on the live socket before stopping the old one"
+    )
+    parser.add_argument(
+        "--drain-timeout",
+        type=float,
+        default=10.0,
+        help="Seconds the old instance gets to finish in-flight requests (default: 10)"
+    )
+    parser.add_argument(
+        "--verbose", "-v",
+        action="store_true",
+        help="Verbose output"
+    )
+    args = parser.parse_args()
+
+    components = []
+    for arg in args.components:
+        components.extend(c.strip().lower().replace("-", "_") for c in arg.split(",") if c.strip())
+
+    failed = 0
+    async with EnhancedComponentLauncher(verbose=args.verbose) as launcher:
+        for component in components:
+            result = await launcher.restart_component(
+                component, overlap=args.overlap, drain_timeout=args.drain_timeout
+            )
+            if not result.success:
+                launcher.log(result.message, "error", component)
+                failed += 1
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    try:
+        sys.exit(asyncio.run(main()))
+    except KeyboardInterrupt:
+        print("\n\nRestart interrupted by user")
+        sys.exit(1)
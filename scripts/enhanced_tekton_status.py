@@ -102,6 +102,9 @@ logger = logging.getLogger(__name__)
 
 from tekton.utils.component_config import get_component_config, ComponentInfo
 from shared.utils.env_config import get_component_config as get_env_config
+from shared.utils.installations import (
+    list_installations, load_installation_env, load_installation_components, read_port_leases
+)
 # Registry client removed - using direct port checks
 # from shared.ai.registry_client import AIRegistryClient
 
@@ -472,7 +475,7 @@ class EnhancedStatusChecker:
             metrics.capabilities = await self.get_component_capabilities(comp_name, comp_info.port)
         
         # Check CI status
-        ai_info = await self.check_ai_status(comp_name)
+        ai_info = await self.check_ai_status(comp_name, comp_info.ai_port)
         metrics.ai_status = ai_info['model']
         metrics.ai_health = ai_info['health']
             
@@ -481,18 +484,19 @@ class EnhancedStatusChecker:
         
         return metrics
     
-    async def check_ai_status(self, component_name: str) -> Dict[str, str]:
+    async def check_ai_status(self, component_name: str, ai_port: Optional[int] = None) -> Dict[str, str]:
         """Check CI status for a component."""
         # CI is always enabled with fixed ports
         
-        # Calculate CI port from component port
-        component_port = self.env_config.get_port(component_name.lower())
-        if not component_port:
-            return {'model': None, 'health': 'none'}
-        
-        # Calculate CI port using configurable bases
-        from shared.utils.ai_port_utils import get_ai_port
-        ai_port = get_ai_port(component_port)
+        # The compiled component blob carries the CI port; otherwise calculate it
+        if not ai_port:
+            component_port = self.env_config.get_port(component_name.lower())
+            if not component_port:
+                return {'model': None, 'health': 'none'}
+            
+            # Calculate CI port using configurable bases
+            from shared.utils.ai_port_utils import get_ai_port
+            ai_port = get_ai_port(component_port)
         ai_id = f"{component_name.lower()}-ci"
         
         # Try to connect to AI
@@ -1130,6 +1134,144 @@ class EnhancedStatusChecker:
     
 
 
+class FleetStatusChecker:
+    """Status of every registered installation on this host from one process
+    
+    Takes one host-wide snapshot of listening sockets, then probes only the
+    ports that are actually listening, all installations concurrently over
+    one HTTP session.
+    """
+    
+    def __init__(self, timeout: float = 2.0, max_concurrency: int = 64):
+        self.timeout = timeout
+        self.max_concurrency = max_concurrency
+        self.session = None
+        
+    async def __aenter__(self):
+        self.session = aiohttp.ClientSession(
+            timeout=aiohttp.ClientTimeout(total=self.timeout),
+            connector=aiohttp.TCPConnector(limit=self.max_concurrency)
+        )
+        return self
+        
+    async def __aexit__(self, exc_type, exc_val, exc_tb):
+        if self.session:
+            await self.session.close()
+    
+    @staticmethod
+    def listening_snapshot() -> Optional[Dict[int, Optional[int]]]:
+        """Map of every listening TCP port on the host to its pid (one scan), or None if it cannot be listed"""
+        snapshot = {}
+        try:
+            for conn in psutil.net_connections(kind='inet'):
+                if conn.status == 'LISTEN' and conn.laddr:
+                    snapshot[conn.laddr.port] = conn.pid
+        except psutil.AccessDenied:
+            logger.debug("Access denied listing connections; probing all ports")
+            return None
+        return snapshot
+    
+    async def probe(self, port: int, semaphore: asyncio.Semaphore) -> Dict[str, Any]:
+        """Probe one component's /health endpoint"""
+        async with semaphore:
+            start = time.time()
+            try:
+                async with self.session.get(f"http://localhost:{port}/health") as resp:
+                    return {
+                        "status": "healthy" if resp.status == 200 else "unhealthy",
+                        "response_time": time.time() - start
+                    }
+            except aiohttp.ClientConnectorError:
+                return {"status": "not_running", "response_time": None}
+            except asyncio.TimeoutError:
+                return {"status": "timeout", "response_time": None}
+            except Exception as e:
+                return {"status": "unhealthy", "response_time": None, "error": str(e)}
+    
+    @staticmethod
+    def cell_score(result: Dict[str, Any]) -> float:
+        """Per-component score on the same 0-100 scale as the single-installation view"""
+        status = result["status"]
+        if status == "healthy":
+            rt = result.get("response_time") or 0
+            return 100.0 if rt < 0.5 else 80.0
+        if status in ("unhealthy", "timeout"):
+            return 30.0
+        return 0.0
+    
+    async def check_all(self) -> List[Dict[str, Any]]:
+        """Check every component of every installation in the registry"""
+        installations = list_installations()
+        leases = read_port_leases()
+        listening = self.listening_snapshot()
+        semaphore = asyncio.Semaphore(self.max_concurrency)
+        
+        fleet = []
+        probes = []
+        for inst in installations:
+            env = load_installation_env(inst.root, leases)
+            entry = {"installation": inst.short_name, "root": inst.root, "components": {}}
+            for comp_id in load_installation_components(inst.root):
+                port_str = env.get(f"{comp_id.upper()}_PORT")
+                if not port_str or not port_str.isdigit():
+                    entry["components"][comp_id] = {"status": "unconfigured", "port": None}
+                    continue
+                port = int(port_str)
+                if listening is not None and port not in listening:
+                    # Nothing listening - no need for a network round trip
+                    entry["components"][comp_id] = {"status": "not_running", "port": port}
+                    continue
+                entry["components"][comp_id] = {"status": "pending", "port": port,
+                                                "pid": listening.get(port) if listening else None}
+                probes.append((entry["components"][comp_id], port))
+            fleet.append(entry)
+        
+        results = await asyncio.gather(*(self.probe(port, semaphore) for _, port in probes))
+        for (cell, _), result in zip(probes, results):
+            cell.update(result)
+        
+        for entry in fleet:
+            cells = list(entry["components"].values())
+            scored = [self.cell_score(c) for c in cells if c["status"] != "unconfigured"]
+            entry["health_score"] = statistics.mean(scored) if scored else 0.0
+            entry["healthy"] = sum(1 for c in cells if c["status"] == "healthy")
+            entry["total"] = len(cells)
+        return fleet
+    
+    @staticmethod
+    def format_matrix(fleet: List[Dict[str, Any]]) -> str:
+        """Compact installation x component matrix"""
+        if not fleet:
+            return "No installations found in the till registry"
+        
+        symbols = {
+            "healthy": f"{Fore.GREEN}●{Style.RESET_ALL}",
+            "unhealthy": f"{Fore.YELLOW}◐{Style.RESET_ALL}",
+            "timeout": f"{Fore.YELLOW}◐{Style.RESET_ALL}",
+            "not_running": f"{Fore.RED}○{Style.RESET_ALL}",
+            "unconfigured": "·",
+        }
+        component_ids = []
+        for entry in fleet:
+            for comp_id in entry["components"]:
+                if comp_id not in component_ids:
+                    component_ids.append(comp_id)
+        
+        headers = ["Installation"] + [c.replace("tekton_core", "core")[:5] for c in component_ids] + ["Up", "Score"]
+        rows = []
+        for entry in fleet:
+            row = [entry["installation"]]
+            for comp_id in component_ids:
+                cell = entry["components"].get(comp_id)
+                row.append(symbols.get(cell["status"], "?") if cell else " ")
+            row.append(f"{entry['healthy']}/{entry['total']}")
+            row.append(f"{entry['health_score']:.0f}")
+            rows.append(row)
+        
+        legend = "● healthy  ◐ unhealthy/timeout  ○ not running  · no port configured"
+        return tabulate(rows, headers=headers, tablefmt="simple") + f"\n\n{legend}"
+
+
 async def main():
     """Enhanced main entry point"""
     parser = argparse.ArgumentParser(description="Enhanced Tekton status checker")
@@ -1143,9 +1285,19 @@ async def main():
     parser.add_argument("--watch", "-w", type=int, help="Watch mode - refresh every N seconds")
     parser.add_argument("--timeout", type=float, default=2.0, help="HTTP request timeout in seconds (default: 2.0)")
     parser.add_argument("--quick", "-q", action="store_true", help="Quick mode - skip detailed checks for faster results")
+    parser.add_argument("--all-installations", "-A", action="store_true", help="Status matrix for every installation in the till registry")
     
     args = parser.parse_args()
     
+    if args.all_installations:
+        async with FleetStatusChecker(timeout=args.timeout) as fleet_checker:
+            fleet = await fleet_checker.check_all()
+        if args.json:
+            print(json.dumps({"installations": fleet}, indent=2, default=str))
+        else:
+            print(f"\n{FleetStatusChecker.format_matrix(fleet)}")
+        return
+    
     # Handle --verbose flag as --full --log
     if args.verbose:
         args.full = True
@@ -0,0 +1,277 @@
+#!/usr/bin/env python3
+"""
+Hephaestus UI Front Server Load Test
+
+Simulates browsers against the Hephaestus UI server: each browser holds a
+WebSocket open on /ws and repeatedly loads the page (index.html plus the
+scripts and stylesheets it references) and polls /api/health, over one
+keep-alive connection where the server allows it. The Python handler
+closes connections it announced as HTTP/1.1, so, like a browser, a request
+on a connection closed under it is retried once on a new one.
+
+Servers compared, each on its own port in a child process:
+
+    legacy    the Python server as it was: one socketserver.TCPServer thread
+    threaded  the Python server with a thread per connection
+    front     src/tekton-front in front of the threaded Python server
+
+The legacy server serves nobody else while a WebSocket is open, so its
+browsers load pages without one; the script checks that once and reports it.
+
+    python scripts/hephaestus_front_loadtest.py
+    python scripts/hephaestus_front_loadtest.py --browsers 50 --seconds 10
+
+The front server is built into a temporary directory, so the tree is untouched.
+"""
+import os
+import re
+import sys
+import time
+import base64
+import json
+import socket
+import argparse
+import http.client
+import importlib.util
+import subprocess
+import tempfile
+import threading
+from typing import Dict, List
+
+script_path = os.path.realpath(__file__)
+tekton_root = os.path.dirname(os.path.dirname(script_path))
+
+UI_DIRECTORY = os.path.join(tekton_root, "Hephaestus", "ui")
+SERVER = os.path.join(UI_DIRECTORY, "server", "server.py")
+FRONT_SOURCE = os.path.join(tekton_root, "src", "tekton-front")
+ENV_EXAMPLE = os.path.join(tekton_root, ".env.local.example")
+
+
+def load_server():
+    """The UI server module, loaded by path"""
+    sys.path.insert(0, tekton_root)
+    spec = importlib.util.spec_from_file_location("hephaestus_ui_server", SERVER)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+def serve(mode: str, port: int, front: str) -> None:
+    """Child process: run one kind of server until killed"""
+    import socketserver
+
+    server = load_server()
+    server.run_websocket_server(port)
+    if mode == "legacy":
+        class TektonTCPServer(socketserver.TCPServer):
+            allow_reuse_address = True
+
+        handler = lambda *args, **kwargs: server.TektonUIRequestHandler(
+            *args, directory=UI_DIRECTORY, **kwargs)
+        TektonTCPServer(("", port), handler).serve_forever()
+    elif mode == "threaded":
+        server.make_http_server(UI_DIRECTORY, port).serve_forever()
+    else:
+        server.FRONT_SERVER = front
+        server.run_http_server(UI_DIRECTORY, port)
+
+
+def page_assets() -> List[str]:
+    """index.html and the local scripts and stylesheets it references"""
+    with open(os.path.join(UI_DIRECTORY, "index.html")) as f:
+        html = f.read()
+    assets = ["/index.html"]
+    for ref in re.findall(r'(?:src|href)="([^"#?]+\.(?:js|css))"', html):
+        path = "/" + ref.lstrip("./")
+        if os.path.isfile(os.path.join(UI_DIRECTORY, path.lstrip("/"))) and path not in assets:
+            assets.append(path)
+    return assets
+
+
+def open_websocket(port: int, timeout: float = 10) -> socket.socket:
+    """A WebSocket on /ws, past the handshake and the server's welcome frame"""
+    s = socket.create_connection(("127.0.0.1", port), timeout=timeout)
+    key = base64.b64encode(os.urandom(16)).decode()
+    s.sendall((f"GET /ws HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+               f"Sec-WebSocket-Key: {key}\r\nSec-WebSocket-Version: 13\r\n\r\n").encode())
+    data = b""
+    while b"\r\n\r\n" not in data:
+        chunk = s.recv(4096)
+        if not chunk:
+            raise ConnectionError("WebSocket refused")
+        data += chunk
+    if not data.startswith(b"HTTP/1.1 101"):
+        raise ConnectionError(data.split(b"\r\n", 1)[0].decode())
+    if len(data.split(b"\r\n\r\n", 1)[1]) < 2:
+        s.recv(4096)
+    return s
+
+
+def wait_for(port: int, timeout: float = 30) -> None:
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            conn = http.client.HTTPConnection("127.0.0.1", port, timeout=2)
+            conn.request("GET", "/health")
+            conn.getresponse().read()
+            conn.close()
+            return
+        except OSError:
+            time.sleep(0.1)
+    raise TimeoutError(f"server on port {port} did not come up")
+
+
+def fetch(conn: http.client.HTTPConnection, path: str) -> int:
+    """GET path; like a browser, retry once on a fresh connection if a reused one was closed"""
+    for attempt in (0, 1):
+        try:
+            conn.request("GET", path)
+            response = conn.getresponse()
+            response.read()
+            return response.status
+        except (http.client.RemoteDisconnected, ConnectionResetError, BrokenPipeError):
+            conn.close()
+            if attempt:
+                raise
+
+
+def browser(port: int, assets: List[str], deadline: float, websocket: bool,
+            latencies: List[float], errors: List[int]) -> None:
+    ws = None
+    try:
+        if websocket:
+            ws = open_websocket(port)
+        conn = http.client.HTTPConnection("127.0.0.1", port, timeout=10)
+        while time.monotonic() < deadline:
+            for path in assets + ["/api/health"]:
+                start = time.perf_counter()
+                try:
+                    if fetch(conn, path) >= 500:
+                        errors[0] += 1
+                        continue
+                except (OSError, http.client.HTTPException):
+                    errors[0] += 1
+                    conn.close()
+                    continue
+                latencies.append(time.perf_counter() - start)
+        conn.close()
+    except OSError:
+        errors[0] += 1
+    finally:
+        if ws is not None:
+            ws.close()
+
+
+def percentile(values: List[float], p: float) -> float:
+    if not values:
+        return float("nan")
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(p * len(ordered)))]
+
+
+def run(mode: str, port: int, front: str, args, env: Dict[str, str]) -> Dict:
+    process = subprocess.Popen([sys.executable, script_path, "--serve", mode, "--port", str(port),
+                                "--front", front], env=env,
+                               stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    try:
+        wait_for(port)
+        result = {}
+        if mode == "legacy":
+            # One open WebSocket holds the only thread
+            ws = open_websocket(port)
+            try:
+                conn = http.client.HTTPConnection("127.0.0.1", port, timeout=2)
+                conn.request("GET", "/index.html")
+                conn.getresponse().read()
+                result["served_during_websocket"] = True
+            except OSError:
+                result["served_during_websocket"] = False
+            finally:
+                ws.close()
+            time.sleep(0.5)
+
+        latencies: List[float] = []
+        errors = [0]
+        deadline = time.monotonic() + args.seconds
+        threads = [threading.Thread(target=browser, args=(port, page_assets(), deadline,
+                                                          mode != "legacy", latencies, errors))
+                   for _ in range(args.browsers)]
+        start = time.perf_counter()
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        elapsed = time.perf_counter() - start
+        result.update({
+            "requests": len(latencies),
+            "errors": errors[0],
+            "requests_per_sec": len(latencies) / elapsed,
+            "p50_ms": percentile(latencies, 0.50) * 1000,
+            "p99_ms": percentile(latencies, 0.99) * 1000,
+            "websockets": mode != "legacy",
+        })
+        return result
+    finally:
+        process.terminate()
+        try:
+            process.wait(timeout=10)
+        except subprocess.TimeoutExpired:
+            process.kill()
+
+
+def free_port() -> int:
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Load test the Hephaestus UI server")
+    parser.add_argument("--browsers", type=int, default=20, help="Concurrent browsers (default: 20)")
+    parser.add_argument("--seconds", type=float, default=5, help="Duration per server (default: 5)")
+    parser.add_argument("--modes", default="legacy,threaded,front",
+                        help="Servers to test (default: legacy,threaded,front)")
+    parser.add_argument("--json", metavar="FILE", help="Also write results as JSON")
+    parser.add_argument("--serve", help=argparse.SUPPRESS)
+    parser.add_argument("--port", type=int, help=argparse.SUPPRESS)
+    parser.add_argument("--front", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.serve:
+        serve(args.serve, args.port, args.front)
+        return 0
+
+    # Component ports the server reads at import, from the example environment
+    env = dict(os.environ)
+    with open(ENV_EXAMPLE) as f:
+        for line in f:
+            name, _, value = line.strip().partition("=")
+            if re.fullmatch(r"[A-Z_]+", name) and value:
+                env.setdefault(name, value)
+    env.setdefault("TEKTON_ROOT", tekton_root)
+
+    assets = page_assets()
+    results = {}
+    with tempfile.TemporaryDirectory(prefix="hephaestus-front-") as work:
+        front = os.path.join(work, "tekton-front")
+        subprocess.run(["make", "-s", "-C", FRONT_SOURCE, f"TARGET={front}"], check=True)
+        for mode in args.modes.split(","):
+            results[mode] = run(mode, free_port(), front, args, env)
+
+    print(f"{args.browsers} browsers x {args.seconds:g}s, page of {len(assets)} files + /api/health, "
+          f"{os.cpu_count()} CPUs")
+    for mode, r in results.items():
+        note = "" if r["websockets"] else "  (no WebSockets)"
+        print(f"  {mode:<9} {r['requests_per_sec']:>9,.0f} req/s  p50 {r['p50_ms']:>7.1f} ms"
+              f"  p99 {r['p99_ms']:>7.1f} ms  {r['errors']:>4} errors{note}")
+    if "legacy" in results and not results["legacy"]["served_during_websocket"]:
+        print("  legacy served nothing else while one WebSocket was open")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
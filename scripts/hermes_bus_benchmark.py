@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""
+Hermes Message Bus Benchmark
+
+Compares MessageBus publishing in-process (the previous implementation,
+and the current one without a broker) against the shared-memory bus
+(src/tekton-bus), and measures delivery to a subscriber in another process,
+which only the shared bus can do.
+
+    python scripts/hermes_bus_benchmark.py
+    python scripts/hermes_bus_benchmark.py -n 200000 --size 512 --rate 2000
+
+The bus library and broker are built into a temporary directory and the
+broker serves a private socket, so a running Tekton is not disturbed.
+
+Reported:
+    publish     messages/s through MessageBus.publish with one local subscriber
+                (legacy: json.dumps + list history re-sliced on every publish)
+    raw         messages/s through SharedBus.publish alone (no envelope)
+    remote      one-way latency to a subscriber process at a fixed rate, and
+                messages/s it receives when the publisher does not pace (a
+                subscriber that falls a full ring behind skips ahead)
+"""
+import os
+import sys
+import json
+import time
+import argparse
+import importlib.util
+import statistics
+import subprocess
+import tempfile
+from typing import Dict, List
+
+script_path = os.path.realpath(__file__)
+tekton_root = os.path.dirname(os.path.dirname(script_path))
+sys.path.insert(0, tekton_root)
+
+from shared.utils.shm_bus import BUS_LIBRARY_ENV, BUS_SOCKET_ENV, SharedBus  # noqa: E402
+
+BUS_SOURCE = os.path.join(tekton_root, "src", "tekton-bus")
+MESSAGE_BUS = os.path.join(tekton_root, "Hermes", "hermes", "core", "message_bus.py")
+
+
+def load_message_bus():
+    """MessageBus without importing the hermes package (and its heavy dependencies)"""
+    spec = importlib.util.spec_from_file_location("hermes_message_bus", MESSAGE_BUS)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module.MessageBus
+
+
+MessageBus = load_message_bus()
+
+
+class LegacyMessageBus(MessageBus):
+    """Publishing as it was before the shared bus: serialize, then re-slice list history"""
+
+    def _record(self, topic, message, headers):
+        headers = headers or {}
+        headers["timestamp"] = time.time()
+        headers["topic"] = topic
+        envelope = {"headers": headers, "payload": message}
+        try:
+            json.dumps(envelope)
+        except TypeError:
+            return None
+        history = self.history.setdefault(topic, [])
+        history.append(envelope)
+        if len(history) > self.history_size:
+            self.history[topic] = history[-self.history_size:]
+        return envelope
+
+
+def build(directory: str):
+    subprocess.run(["make", "-s", "-C", BUS_SOURCE,
+                    f"LIBRARY={os.path.join(directory, 'libtekton-bus.so')}",
+                    f"BROKER={os.path.join(directory, 'tekton-busd')}"], check=True)
+
+
+def percentile(values: List[float], p: float) -> float:
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p))]
+
+
+def bench_publish(bus, count: int, payload: Dict) -> float:
+    received = []
+    bus.subscribe("bench.local", received.append)
+    start = time.perf_counter()
+    for _ in range(count):
+        bus.publish("bench.local", payload)
+    elapsed = time.perf_counter() - start
+    assert len(received) == count
+    bus.close()
+    return count / elapsed
+
+
+def bench_raw(count: int, size: int) -> float:
+    bus = SharedBus.connect()
+    data = b"x" * size
+    start = time.perf_counter()
+    for _ in range(count):
+        bus.publish("bench.raw", data)
+    elapsed = time.perf_counter() - start
+    bus.close()
+    return count / elapsed
+
+
+def subscriber_main(count: int):
+    """Child: receive up to count messages on bench.remote, report latencies as JSON"""
+    import asyncio
+
+    async def run():
+        done = asyncio.get_running_loop().create_future()
+        latencies = []
+        first = [0.0]
+
+        def on_message(envelope):
+            now = time.monotonic_ns()
+            if not latencies:
+                first[0] = time.perf_counter()
+            latencies.append((now - envelope["payload"]["sent"]) / 1000.0)
+            if len(latencies) == count and not done.done():
+                done.set_result(time.perf_counter() - first[0])
+
+        def on_done(envelope):
+            # Unpaced runs overrun the ring; the end marker has a topic of its own
+            if not done.done():
+                done.set_result(time.perf_counter() - first[0] if latencies else None)
+
+        bus = MessageBus()
+        bus.subscribe("bench.remote", on_message)
+        bus.subscribe("bench.done", on_done)
+        print("ready", flush=True)
+        try:
+            elapsed = await asyncio.wait_for(done, timeout=120)
+        except asyncio.TimeoutError:
+            elapsed = None
+        bus.close()
+        print(json.dumps({"latencies_us": latencies, "elapsed": elapsed}), flush=True)
+
+    asyncio.run(run())
+
+
+def bench_remote(count: int, size: int, rate: float) -> Dict:
+    child = subprocess.Popen([sys.executable, script_path, "--subscriber", str(count)],
+                             stdout=subprocess.PIPE, text=True)
+    assert child.stdout.readline().strip() == "ready"
+    bus = MessageBus()
+    filler = "x" * size
+    interval = 1.0 / rate if rate else 0
+    next_send = time.perf_counter()
+    for i in range(count):
+        if interval:
+            while time.perf_counter() < next_send:
+                pass
+            next_send += interval
+        bus.publish("bench.remote", {"sent": time.monotonic_ns(), "i": i, "data": filler})
+    bus.publish("bench.done", {})
+    result = json.loads(child.stdout.readline())
+    child.wait()
+    bus.close()
+    latencies = result["latencies_us"]
+    report = {"sent": count, "received": len(latencies)}
+    if latencies:
+        report.update(p50_us=statistics.median(latencies), p99_us=percentile(latencies, 0.99),
+                      max_us=max(latencies))
+    if result["elapsed"]:
+        report["msgs_per_sec"] = len(latencies) / result["elapsed"]
+    return report
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark the Hermes message bus")
+    parser.add_argument("-n", "--count", type=int, default=50000, help="Messages per run (default: 50000)")
+    parser.add_argument("--size", type=int, default=256, help="Payload filler bytes (default: 256)")
+    parser.add_argument("--rate", type=float, default=1000, help="Paced rate for the latency run, msgs/s")
+    parser.add_argument("--json", metavar="FILE", help="Also write results as JSON")
+    parser.add_argument("--subscriber", type=int, help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.subscriber:
+        subscriber_main(args.subscriber)
+        return 0
+
+    payload = {"data": "x" * args.size}
+    results = {}
+    with tempfile.TemporaryDirectory(prefix="hermes-bus-bench-") as work:
+        build(work)
+        socket_path = os.path.join(work, "bus.sock")
+        os.environ[BUS_LIBRARY_ENV] = os.path.join(work, "libtekton-bus.so")
+        broker = subprocess.Popen([os.path.join(work, "tekton-busd"), "--socket", socket_path],
+                                  stderr=subprocess.DEVNULL)
+        try:
+            while not os.path.exists(socket_path):
+                time.sleep(0.01)
+
+            os.environ.pop(BUS_SOCKET_ENV, None)
+            results["publish_legacy"] = bench_publish(LegacyMessageBus(), args.count, payload)
+            results["publish_in_process"] = bench_publish(MessageBus(), args.count, payload)
+
+            os.environ[BUS_SOCKET_ENV] = socket_path
+            results["publish_shared"] = bench_publish(MessageBus(), args.count, payload)
+            results["raw_shared"] = bench_raw(args.count, args.size)
+            paced = min(args.count, int(args.rate * 5)) or args.count
+            results["remote_paced"] = bench_remote(paced, args.size, args.rate)
+            results["remote_burst"] = bench_remote(args.count, args.size, 0)
+        finally:
+            broker.terminate()
+            broker.wait()
+
+    print(f"{args.count} messages, {args.size}-byte payload")
+    for name in ("publish_legacy", "publish_in_process", "publish_shared", "raw_shared"):
+        print(f"  {name:<20} {results[name]:>12,.0f} msgs/s")
+    for name in ("remote_paced", "remote_burst"):
+        r = results[name]
+        line = f"  {name:<20} received {r['received']}/{r['sent']}"
+        if "p50_us" in r:
+            line += f", latency p50 {r['p50_us']:.0f} us, p99 {r['p99_us']:.0f} us, max {r['max_us']:.0f} us"
+        if "msgs_per_sec" in r:
+            line += f", {r['msgs_per_sec']:,.0f} msgs/s"
+        print(line)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
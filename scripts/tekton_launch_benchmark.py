@@ -0,0 +1,295 @@
+#!/usr/bin/env python3
+"""
+Tekton Launch/Stop Benchmark
+
+Times the launcher, status and killer against N native stub components
+(src/tekton-stub) instead of the real Python components, so the numbers
+measure the tooling rather than component imports.
+
+    python scripts/tekton_launch_benchmark.py -n 100
+    python scripts/tekton_launch_benchmark.py -n 300 --startup-delay 500 --log-rate 20
+    python scripts/tekton_launch_benchmark.py -n 50 --native src/tekton-launcher/tekton-clean-launch
+
+The harness builds a throwaway Tekton root: copies of the launcher, status
+and killer scripts (they locate the root from their own path), links to
+shared/, tekton/ and landmarks/, a config/tekton_components.yaml listing the
+stubs, .env.tekton/.env.local with their ports, and a run_<stub>.sh per
+component that execs the stub. CI launch/kill scripts are no-ops there
+because every stub already answers the CI protocol on its CI port.
+
+Reported per phase:
+    start   time until every stub answers /health, and until the launcher exits
+    status  wall time of each `tekton status` run
+    stop    time until every port is closed, and until the killer exits
+"""
+import os
+import sys
+import json
+import time
+import shutil
+import socket
+import argparse
+import statistics
+import subprocess
+import tempfile
+from concurrent.futures import ThreadPoolExecutor
+from typing import Dict, List, Optional
+
+script_path = os.path.realpath(__file__)
+tekton_root = os.path.dirname(os.path.dirname(script_path))
+
+STUB_SOURCE = os.path.join(tekton_root, "src", "tekton-stub")
+BENCH_SCRIPTS = ["enhanced_tekton_launcher.py", "enhanced_tekton_status.py", "enhanced_tekton_killer.py"]
+# Root-level entries the scripts import from or use as root markers
+LINKED = ["shared", "tekton", "landmarks", "setup.py", "README.md"]
+
+NOOP_CI_SCRIPT = '''#!/usr/bin/env python3
+"""Benchmark root: stubs serve their own CI port"""
+print("CI specialist already running")
+'''
+
+POLL_INTERVAL = 0.05
+
+
+def stub_name(i: int) -> str:
+    return f"stub_{i:03d}"
+
+
+def build_stub(bench_root: str) -> str:
+    """Compile the stub into the benchmark root"""
+    target = os.path.join(bench_root, "bin", "tekton-stub")
+    os.makedirs(os.path.dirname(target), exist_ok=True)
+    subprocess.run(["make", "-s", "-C", STUB_SOURCE, f"TARGET={target}"], check=True)
+    return target
+
+
+def create_bench_root(bench_root: str, stub: str, args) -> Dict[str, int]:
+    """Lay out a Tekton root whose components are all stubs; returns name -> port"""
+    ports = {stub_name(i): args.port_base + i for i in range(args.count)}
+
+    os.makedirs(os.path.join(bench_root, "scripts"), exist_ok=True)
+    for script in BENCH_SCRIPTS:
+        shutil.copy2(os.path.join(tekton_root, "scripts", script),
+                     os.path.join(bench_root, "scripts", script))
+    for script in ["enhanced_tekton_ai_launcher.py", "enhanced_tekton_ai_killer.py"]:
+        with open(os.path.join(bench_root, "scripts", script), "w") as f:
+            f.write(NOOP_CI_SCRIPT)
+    for entry in LINKED:
+        os.symlink(os.path.join(tekton_root, entry), os.path.join(bench_root, entry))
+
+    os.makedirs(os.path.join(bench_root, "config"), exist_ok=True)
+    display_names = os.path.join(tekton_root, "config", "ai_model_display_names.json")
+    if os.path.exists(display_names):
+        shutil.copy2(display_names, os.path.join(bench_root, "config"))
+    with open(os.path.join(bench_root, "config", "tekton_components.yaml"), "w") as f:
+        f.write("# Generated by tekton_launch_benchmark.py\n\ncomponents:\n")
+        for name in ports:
+            f.write(f"  {name}:\n")
+            f.write(f"    name: \"{name}\"\n")
+            f.write(f"    description: \"Benchmark stub\"\n")
+            f.write(f"    category: \"benchmark\"\n")
+            f.write(f"    startup_priority: 2\n")
+            f.write(f"    dependencies: []\n")
+
+    stub_args = (f"--startup-delay {args.startup_delay} --memory {args.memory} "
+                 f"--log-rate {args.log_rate}")
+    for name, port in ports.items():
+        # Same directory naming the launcher derives: stub_000 -> Stub-000
+        component_dir = os.path.join(bench_root, name.replace("_", "-").capitalize())
+        os.makedirs(component_dir, exist_ok=True)
+        run_script = os.path.join(component_dir, f"run_{name}.sh")
+        with open(run_script, "w") as f:
+            f.write("#!/bin/bash\n")
+            f.write(f"exec {stub} --name {name} --port {port} "
+                    f"--ai-port {args.ai_port_base + port - args.port_base} {stub_args}\n")
+        os.chmod(run_script, 0o755)
+
+    env = bench_env_values(bench_root, ports, args)
+    with open(os.path.join(bench_root, ".env.tekton"), "w") as f:
+        f.write("# Generated by tekton_launch_benchmark.py\n")
+        for key, value in env.items():
+            f.write(f"{key}={value}\n")
+    with open(os.path.join(bench_root, ".env.local"), "w") as f:
+        # Keep the generated ports; don't lease a host-wide block for a benchmark
+        f.write("TEKTON_PORT_ALLOCATOR=0\n")
+    return ports
+
+
+def bench_env_values(bench_root: str, ports: Dict[str, int], args) -> Dict[str, str]:
+    env = {
+        "TEKTON_ROOT": bench_root,
+        "TEKTON_PORT_BASE": str(args.port_base),
+        "TEKTON_AI_PORT_BASE": str(args.ai_port_base),
+        # Nothing listens here: Hermes lookups fail fast instead of timing out
+        "HERMES_PORT": str(args.port_base + args.count),
+    }
+    for name, port in ports.items():
+        env[f"{name.upper()}_PORT"] = str(port)
+    return env
+
+
+def process_env(bench_root: str, ports: Dict[str, int], args) -> Dict[str, str]:
+    """Frozen environment for the scripts, as the C launcher would hand over"""
+    env = dict(os.environ)
+    env.pop("PYTHONPATH", None)
+    env.update(bench_env_values(bench_root, ports, args))
+    env["TEKTON_PORT_ALLOCATOR"] = "0"
+    env["_TEKTON_ENV_FROZEN"] = "1"
+    return env
+
+
+def port_open(port: int) -> bool:
+    try:
+        with socket.create_connection(("127.0.0.1", port), timeout=0.5):
+            return True
+    except OSError:
+        return False
+
+
+def health_ok(port: int) -> bool:
+    try:
+        with socket.create_connection(("127.0.0.1", port), timeout=0.5) as sock:
+            sock.sendall(b"GET /health HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n")
+            return sock.recv(64).startswith(b"HTTP/1.1 200")
+    except OSError:
+        return False
+
+
+def wait_all(ports: List[int], check, timeout: float, executor) -> Optional[float]:
+    """Seconds until check() holds for every port, or None on timeout"""
+    start = time.monotonic()
+    pending = list(ports)
+    while pending:
+        if time.monotonic() - start > timeout:
+            return None
+        results = list(executor.map(check, pending))
+        pending = [port for port, done in zip(pending, results) if not done]
+        if pending:
+            time.sleep(POLL_INTERVAL)
+    return time.monotonic() - start
+
+
+def command(args, bench_root: str, tool: str, tool_args: List[str]) -> List[str]:
+    """Invocation of a Tekton command, through the native launcher if given"""
+    if args.native:
+        subcommand = {"launcher": "start", "status": "status", "killer": "stop"}[tool]
+        return [args.native, subcommand, bench_root] + tool_args
+    script = {"launcher": "enhanced_tekton_launcher.py", "status": "enhanced_tekton_status.py",
+              "killer": "enhanced_tekton_killer.py"}[tool]
+    return [sys.executable, os.path.join(bench_root, "scripts", script)] + tool_args
+
+
+def run_timed(cmd: List[str], env: Dict[str, str], log, wait_for=None):
+    """Run cmd; returns (exit seconds, wait_for() result, return code)"""
+    start = time.monotonic()
+    proc = subprocess.Popen(cmd, env=env, stdout=log, stderr=subprocess.STDOUT,
+                            stdin=subprocess.DEVNULL)
+    waited = wait_for() if wait_for else None
+    returncode = proc.wait()
+    return time.monotonic() - start, waited, returncode
+
+
+def kill_leftover_stubs(stub: str):
+    subprocess.run(["pkill", "-f", stub], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+def summarize(samples: List[float]) -> Dict[str, float]:
+    ordered = sorted(samples)
+    return {
+        "min": ordered[0],
+        "median": statistics.median(ordered),
+        "p95": ordered[min(len(ordered) - 1, int(round(0.95 * (len(ordered) - 1))))],
+        "max": ordered[-1],
+    }
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Benchmark tekton start/status/stop against stub components")
+    parser.add_argument("--count", "-n", type=int, default=18, help="Number of stub components (default: 18)")
+    parser.add_argument("--startup-delay", type=int, default=0, metavar="MS",
+                        help="Stub startup delay before binding, in ms")
+    parser.add_argument("--memory", type=int, default=0, metavar="MB", help="Resident memory per stub")
+    parser.add_argument("--log-rate", type=float, default=0, metavar="LINES",
+                        help="Log lines per second per stub")
+    parser.add_argument("--port-base", type=int, default=30000, help="First stub port (default: 30000)")
+    parser.add_argument("--ai-port-base", type=int, default=40000, help="First stub CI port (default: 40000)")
+    parser.add_argument("--status-runs", type=int, default=5, help="tekton status runs to time (default: 5)")
+    parser.add_argument("--timeout", type=float, default=300, help="Per-phase timeout in seconds")
+    parser.add_argument("--native", metavar="LAUNCHER",
+                        help="Go through a built tekton-clean-launch instead of the Python scripts")
+    parser.add_argument("--keep", action="store_true", help="Keep the benchmark root for inspection")
+    parser.add_argument("--json", metavar="FILE", help="Also write results as JSON")
+    args = parser.parse_args()
+
+    if args.native:
+        args.native = os.path.abspath(args.native)
+    bench_root = tempfile.mkdtemp(prefix="tekton-bench-")
+    stub = build_stub(bench_root)
+    ports = create_bench_root(bench_root, stub, args)
+    env = process_env(bench_root, ports, args)
+    port_list = list(ports.values())
+    busy = [p for p in port_list if port_open(p)]
+    if busy:
+        print(f"Ports already in use: {busy[:5]}; choose another --port-base", file=sys.stderr)
+        shutil.rmtree(bench_root, ignore_errors=True)
+        return 1
+
+    results: Dict[str, object] = {
+        "components": args.count,
+        "startup_delay_ms": args.startup_delay,
+        "memory_mb": args.memory,
+        "log_rate": args.log_rate,
+        "path": "native" if args.native else "python",
+    }
+    print(f"Benchmark root: {bench_root}")
+    print(f"{args.count} stubs on ports {port_list[0]}-{port_list[-1]}")
+
+    log = open(os.path.join(bench_root, "benchmark.log"), "wb")
+    executor = ThreadPoolExecutor(max_workers=min(64, max(4, args.count)))
+    try:
+        launcher_exit, healthy, code = run_timed(
+            command(args, bench_root, "launcher", ["-c", "all", "--no-populate-athena"]), env, log,
+            lambda: wait_all(port_list, health_ok, args.timeout, executor)
+        )
+        results["start"] = {"all_healthy_s": healthy, "launcher_exit_s": launcher_exit, "exit_code": code}
+        print(f"start:  all healthy {healthy:.3f}s, launcher exited {launcher_exit:.3f}s (rc {code})"
+              if healthy is not None else f"start:  not all healthy within {args.timeout:.0f}s (rc {code})")
+
+        samples, failed = [], 0
+        for _ in range(args.status_runs):
+            elapsed, _, code = run_timed(
+                command(args, bench_root, "status", ["--json", "--no-storage"]), env, log
+            )
+            samples.append(elapsed)
+            failed += code != 0
+        if samples:
+            status = summarize(samples)
+            results["status"] = dict(status, runs=len(samples), failed=failed)
+            print(f"status: median {status['median']:.3f}s, p95 {status['p95']:.3f}s, "
+                  f"min {status['min']:.3f}s, max {status['max']:.3f}s over {len(samples)} runs"
+                  + (f" ({failed} failed)" if failed else ""))
+
+        killer_exit, stopped, code = run_timed(
+            command(args, bench_root, "killer", ["-c", "all", "--force", "--yes"]), env, log,
+            lambda: wait_all(port_list, lambda p: not port_open(p), args.timeout, executor)
+        )
+        results["stop"] = {"all_stopped_s": stopped, "killer_exit_s": killer_exit, "exit_code": code}
+        print(f"stop:   all stopped {stopped:.3f}s, killer exited {killer_exit:.3f}s (rc {code})"
+              if stopped is not None else f"stop:   ports still open after {args.timeout:.0f}s (rc {code})")
+    finally:
+        executor.shutdown()
+        log.close()
+        kill_leftover_stubs(stub)
+        if args.keep:
+            print(f"Kept {bench_root} (tool output in benchmark.log, component logs in .tekton/logs)")
+        else:
+            shutil.rmtree(bench_root, ignore_errors=True)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+WebSocket Framing Benchmark
+
+Compares the Hephaestus socket bridge's frame handling as it was (a per-byte
+unmask loop, the receive buffer re-sliced after every frame) against
+shared.utils.ws_frames, in Python and with the native library
+(src/tekton-ws), on a synthetic stream of browser traffic: chat messages,
+terminal output and the occasional large paste.
+
+    python scripts/websocket_framing_benchmark.py
+    python scripts/websocket_framing_benchmark.py -n 5000 --paste 1048576
+
+The library is built into a temporary directory, so the tree is untouched.
+
+Reported per decoder: MB/s of masked client frames decoded, and per encoder
+MB/s of server messages framed, with and without permessage-deflate.
+"""
+import os
+import sys
+import time
+import random
+import argparse
+import json
+import struct
+import subprocess
+import tempfile
+from typing import Dict, List, Tuple
+
+script_path = os.path.realpath(__file__)
+tekton_root = os.path.dirname(os.path.dirname(script_path))
+sys.path.insert(0, tekton_root)
+
+from shared.utils import ws_frames  # noqa: E402
+from shared.utils.ws_frames import (OP_BINARY, OP_TEXT, DeflateParams, FrameDecoder,  # noqa: E402
+                                    FrameEncoder)
+
+WS_SOURCE = os.path.join(tekton_root, ws_frames.WS_SOURCE)
+RECV_SIZE = 65536
+
+
+class LegacyDecoder:
+    """decode_websocket_frame and its receive loop as they were in server.py"""
+
+    def __init__(self):
+        self.buffer = bytearray()
+
+    @staticmethod
+    def decode(data):
+        if len(data) < 2:
+            return None, None, 0
+        opcode = data[0] & 0x0F
+        masked = (data[1] & 0x80) != 0
+        payload_length = data[1] & 0x7F
+        header_length = 2
+        if payload_length == 126:
+            if len(data) < 4:
+                return None, None, 0
+            payload_length = struct.unpack("!H", data[2:4])[0]
+            header_length = 4
+        elif payload_length == 127:
+            if len(data) < 10:
+                return None, None, 0
+            payload_length = struct.unpack("!Q", data[2:10])[0]
+            header_length = 10
+        mask_key = None
+        if masked:
+            if len(data) < header_length + 4:
+                return None, None, 0
+            mask_key = data[header_length:header_length + 4]
+            header_length += 4
+        if len(data) < header_length + payload_length:
+            return None, None, 0
+        payload = data[header_length:header_length + payload_length]
+        if masked and mask_key:
+            payload = bytearray(payload)
+            for i in range(len(payload)):
+                payload[i] ^= mask_key[i % 4]
+        return opcode, payload, header_length + payload_length
+
+    def feed(self, data: bytes) -> None:
+        self.buffer.extend(data)
+
+    def messages(self):
+        while self.buffer:
+            opcode, payload, consumed = self.decode(self.buffer)
+            if opcode is None:
+                break
+            self.buffer = self.buffer[consumed:]
+            yield opcode, payload
+
+
+def traffic(count: int, paste: int, seed: int = 7) -> List[Tuple[int, bytes]]:
+    """Browser messages: mostly chat JSON and terminal output, one paste in a hundred"""
+    rng = random.Random(seed)
+    words = [f"word{i}" for i in range(2000)]
+    messages = []
+    for i in range(count):
+        kind = rng.random()
+        if kind < 0.01:
+            messages.append((OP_BINARY, rng.randbytes(paste)))
+        elif kind < 0.5:
+            text = " ".join(rng.choices(words, k=rng.randint(5, 60)))
+            messages.append((OP_TEXT, json.dumps({"type": "CHAT", "source": "UI", "payload": {"message": text}}).encode()))
+        else:
+            lines = [f"$ {' '.join(rng.choices(words, k=8))}\r\n" for _ in range(rng.randint(10, 100))]
+            messages.append((OP_TEXT, json.dumps({"type": "TERMINAL", "payload": {"data": "".join(lines)}}).encode()))
+    return messages
+
+
+def bench_decode(make_decoder, stream: bytes, expected: int) -> Dict:
+    decoder = make_decoder()
+    received = 0
+    start = time.perf_counter()
+    for first in range(0, len(stream), RECV_SIZE):
+        decoder.feed(stream[first:first + RECV_SIZE])
+        received += sum(1 for _ in decoder.messages())
+    elapsed = time.perf_counter() - start
+    assert received == expected, (received, expected)
+    return {"mb_per_sec": len(stream) / elapsed / 1e6, "seconds": elapsed}
+
+
+def bench_encode(make_encoder, messages: List[Tuple[int, bytes]]) -> Dict:
+    encoder = make_encoder()
+    size = sum(len(payload) for _, payload in messages)
+    start = time.perf_counter()
+    wire = sum(len(encoder.encode(opcode, payload)) for opcode, payload in messages)
+    elapsed = time.perf_counter() - start
+    return {"mb_per_sec": size / elapsed / 1e6, "seconds": elapsed, "wire_ratio": wire / size}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark WebSocket frame handling")
+    parser.add_argument("-n", "--count", type=int, default=2000, help="Messages (default: 2000)")
+    parser.add_argument("--paste", type=int, default=262144, help="Size of a large paste (default: 262144)")
+    parser.add_argument("--json", metavar="FILE", help="Also write results as JSON")
+    args = parser.parse_args()
+
+    messages = traffic(args.count, args.paste)
+    results = {}
+    with tempfile.TemporaryDirectory(prefix="tekton-ws-bench-") as work:
+        library = os.path.join(work, ws_frames.LIBRARY_NAME)
+        subprocess.run(["make", "-s", "-C", WS_SOURCE, f"LIBRARY={library}"], check=True)
+
+        for name, path in (("python", os.path.join(work, "missing.so")), ("native", library)):
+            os.environ[ws_frames.WS_LIBRARY_ENV] = path
+            ws_frames._lib = None
+            client = FrameEncoder(server=False)
+            stream = b"".join(client.encode(opcode, payload) for opcode, payload in messages)
+            if name == "python":
+                results["decode_legacy"] = bench_decode(LegacyDecoder, stream, len(messages))
+            results[f"decode_{name}"] = bench_decode(FrameDecoder, stream, len(messages))
+            results[f"encode_{name}"] = bench_encode(FrameEncoder, messages)
+            results[f"encode_{name}_deflate"] = bench_encode(
+                lambda: FrameEncoder(deflate=DeflateParams()), messages)
+
+    size = sum(len(payload) for _, payload in messages)
+    print(f"{args.count} messages, {size / 1e6:.1f} MB, pastes of {args.paste} bytes, {os.cpu_count()} CPUs")
+    legacy = results["decode_legacy"]["mb_per_sec"]
+    for name, r in results.items():
+        speedup = f"  {r['mb_per_sec'] / legacy:>6.1f}x" if name.startswith("decode") else ""
+        ratio = f"  wire {r['wire_ratio']:.2f}" if "wire_ratio" in r else ""
+        print(f"  {name:<22} {r['mb_per_sec']:>10,.1f} MB/s{speedup}{ratio}")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
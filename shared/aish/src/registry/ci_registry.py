@@ -101,7 +101,7 @@ class _CIRegistryArchitecture:
     state_type="persistent",
     persistence=True,
     consistency_requirements="Thread-safe file locking prevents concurrent write corruption",
-    recovery_strategy="Reload from registry.json on startup"
+    recovery_strategy="Reload from registry.kv on startup"
 )
 class CIRegistry:
     """Unified CI Registry with file-based persistence."""
@@ -205,13 +205,15 @@ class CIRegistry:
         tekton_root = TektonEnviron.get('TEKTON_ROOT', '/tmp')
         self._file_registry = FileRegistry(tekton_root)
         
-        # Load context state from file
-        self._context_state = self._file_registry.get('context_state', {})
+        # One registry key per CI, so an update rewrites only that CI's state
+        for group in ('context_state', 'memory_metadata', 'forwards'):
+            self._file_registry.split_group(group)
+        self._context_state = self._file_registry.get_group('context_state')
         
         # Initialize ESR client for memory services
         self._esr_client = None
         self._esr_url = engram_url('/api/esr')
-        self._memory_metadata = self._file_registry.get('memory_metadata', {})
+        self._memory_metadata = self._file_registry.get_group('memory_metadata')
         
         # Component aliases
         self.ALIASES = {
@@ -226,9 +228,9 @@ class CIRegistry:
         self._load_forwards()
         self._load_and_validate_wrapped_cis()  # Load and validate wrapped CIs
     
-    def _save_context_state(self):
-        """Save context state to file."""
-        self._file_registry.update('context_state', self._context_state)
+    def _save_context_state(self, ci_name: str):
+        """Save one CI's context state to file."""
+        self._file_registry.update(f'context_state/{ci_name}', self._context_state[ci_name])
     
     def get_ai_port(self, component_name: str) -> int:
         """Calculate CI port based on component port and environment settings."""
@@ -431,7 +433,7 @@ class CIRegistry:
     def _load_forwards(self):
         """Load forwarding configurations."""
         # Load saved forwards from file
-        forwards = self._file_registry.get('forwards', {})
+        forwards = self._file_registry.get_group('forwards')
         for ci_name, forward_config in forwards.items():
             if ci_name in self._registry:
                 self._registry[ci_name].update(forward_config)
@@ -541,7 +543,7 @@ class CIRegistry:
         state_type="coordination",
         persistence=True,
         consistency_requirements="File locking ensures consistency",
-        recovery_strategy="State persists in registry.json"
+        recovery_strategy="State persists in registry.kv"
     )
     def set_ci_staged_context_prompt(self, ci_name: str, prompt_data: Optional[List[Dict]]) -> bool:
         """Apollo sets staged prompts for future scenarios."""
@@ -553,7 +555,7 @@ class CIRegistry:
             self._context_state[ci_name] = {}
             
         self._context_state[ci_name]['staged_context_prompt'] = prompt_data
-        self._save_context_state()
+        self._save_context_state(ci_name)
         return True
     
     def set_ci_next_context_prompt(self, ci_name: str, prompt_data: Optional[List[Dict]]) -> bool:
@@ -566,7 +568,7 @@ class CIRegistry:
             self._context_state[ci_name] = {}
             
         self._context_state[ci_name]['next_context_prompt'] = prompt_data
-        self._save_context_state()
+        self._save_context_state(ci_name)
         return True
     
     def get_ci_last_output(self, ci_name: str) -> Optional[Union[str, Dict]]:
@@ -593,7 +595,7 @@ class CIRegistry:
             self._context_state[ci_name] = {}
         
         self._context_state[ci_name]['next_prompt'] = prompt
-        self._save_context_state()  # Uses FileRegistry with locks
+        self._save_context_state(ci_name)  # Uses FileRegistry with locks
         return True
 
     def get_next_prompt(self, ci_name: str) -> Optional[str]:
@@ -615,7 +617,7 @@ class CIRegistry:
         
         if 'next_prompt' in self._context_state[ci_name]:
             self._context_state[ci_name]['next_prompt'] = None
-            self._save_context_state()
+            self._save_context_state(ci_name)
             return True
         return False
 
@@ -631,7 +633,7 @@ class CIRegistry:
             self._context_state[ci_name] = {}
         
         self._context_state[ci_name]['sunrise_context'] = context
-        self._save_context_state()
+        self._save_context_state(ci_name)
         return True
 
     def get_sunrise_context(self, ci_name: str) -> Optional[str]:
@@ -682,7 +684,7 @@ class CIRegistry:
         
         if 'sunrise_context' in self._context_state[ci_name]:
             self._context_state[ci_name]['sunrise_context'] = None
-            self._save_context_state()
+            self._save_context_state(ci_name)
             return True
         return False
     
@@ -702,7 +704,7 @@ class CIRegistry:
             self._context_state[ci_name] = {}
         
         self._context_state[ci_name]['needs_fresh_start'] = needs_fresh
-        self._save_context_state()
+        self._save_context_state(ci_name)
         return True
     
     def get_needs_fresh_start(self, ci_name: str) -> bool:
@@ -725,7 +727,7 @@ class CIRegistry:
         description="Stores complete user message and CI response exchanges with ESR memory integration",
         target_component="CI Specialists + Engram ESR",
         protocol="Socket JSON messages + ESR HTTP API",
-        data_flow="CI Specialist → update_ci_last_output → registry.json + ESR memory",
+        data_flow="CI Specialist → update_ci_last_output → registry.kv + ESR memory",
         integration_date="2025-09-10"
     )
     def update_ci_last_output(self, ci_name: str, output: Union[str, Dict]) -> bool:
@@ -817,7 +819,7 @@ class CIRegistry:
             except:
                 pass
         
-        self._save_context_state()
+        self._save_context_state(ci_name)
         return True
     
     def _is_sunset_response(self, output: Union[str, Dict]) -> bool:
@@ -869,9 +871,9 @@ class CIRegistry:
             self._esr_client = httpx.AsyncClient(timeout=30.0)
         return self._esr_client
     
-    def _save_memory_metadata(self):
-        """Save memory metadata to file."""
-        self._file_registry.update('memory_metadata', self._memory_metadata)
+    def _save_memory_metadata(self, ci_name: str):
+        """Save one CI's memory metadata to file."""
+        self._file_registry.update(f'memory_metadata/{ci_name}', self._memory_metadata[ci_name])
     
     async def store_ci_memory(self, ci_name: str, content: str, 
                              thought_type: str = "MEMORY",
@@ -922,7 +924,7 @@ class CIRegistry:
                 
                 self._memory_metadata[ci_name]['memory_count'] += 1
                 self._memory_metadata[ci_name]['last_stored'] = datetime.now().isoformat()
-                self._save_memory_metadata()
+                self._save_memory_metadata(ci_name)
                 
                 return memory_id
                 
@@ -1011,7 +1013,7 @@ class CIRegistry:
                     self._memory_metadata[ci_name] = {}
                 
                 self._memory_metadata[ci_name]['last_reflection'] = datetime.now().isoformat()
-                self._save_memory_metadata()
+                self._save_memory_metadata(ci_name)
                 
                 return True
                 
@@ -1443,7 +1445,7 @@ class CIRegistry:
     def get_all_context_states(self) -> Dict[str, Dict[str, Any]]:
         """Get context states for all CIs."""
         # Reload context state from file to get latest
-        self._context_state = self._file_registry.get('context_state', {})
+        self._context_state = self._file_registry.get_group('context_state')
         return self._context_state.copy()
     
     def set_ci_next_from_staged(self, ci_name: str) -> bool:
@@ -1459,7 +1461,7 @@ class CIRegistry:
         # Move staged to next and clear staged
         self._context_state[ci_name]['next_context_prompt'] = staged
         self._context_state[ci_name]['staged_context_prompt'] = None
-        self._save_context_state()
+        self._save_context_state(ci_name)
         return True
     
     # Terminal forwarding methods
@@ -1476,12 +1478,10 @@ class CIRegistry:
         self._registry[ai_name]['forward_json'] = json_mode
         
         # Save to file
-        forwards = self._file_registry.get('forwards', {})
-        forwards[ai_name] = {
+        self._file_registry.update(f'forwards/{ai_name}', {
             'forward_to': terminal_name,
             'forward_json': json_mode
-        }
-        self._file_registry.update('forwards', forwards)
+        })
         return True
     
     def remove_forward(self, ai_name: str) -> bool:
@@ -1494,9 +1494,7 @@ class CIRegistry:
         self._registry[ai_name].pop('forward_json', None)
         
         # Remove from file
-        forwards = self._file_registry.get('forwards', {})
-        forwards.pop(ai_name, None)
-        self._file_registry.update('forwards', forwards)
+        self._file_registry.delete(f'forwards/{ai_name}')
         return True
     
     def get_forwards(self) -> Dict[str, Dict[str, Any]]:
@@ -1,15 +1,21 @@
 #!/usr/bin/env python3
 """
-Thread-safe file-based CI registry using file locking.
+Thread-safe file-based CI registry backed by a shared memory-mapped store.
 """
 
 import os
 import json
-import fcntl
 import time
-import hashlib
-from contextlib import contextmanager
-from typing import Dict, Any, Optional
+from typing import Dict, Any
+
+try:
+    from .kv_store import RegistryStore
+except ImportError:
+    # Run as a script
+    from kv_store import RegistryStore
+
+# Per-member keys look like 'context_state/apollo'
+GROUP_SEPARATOR = '/'
 
 # Try to import landmarks if available
 try:
@@ -43,11 +49,11 @@ except ImportError:
 
 @state_checkpoint(
     title="Thread-Safe File Registry",
-    description="File-based registry with exclusive locking for concurrent access",
+    description="Memory-mapped key/value registry shared by every aish process",
     state_type="persistent",
     persistence=True,
-    consistency_requirements="fcntl file locking ensures atomic operations",
-    recovery_strategy="Lock acquisition with timeout prevents deadlocks"
+    consistency_requirements="Per-key seqlock reads, flock-serialized writers",
+    recovery_strategy="Writers publish by flipping a version, so a crash leaves the previous value current"
 )
 class FileRegistry:
     def __init__(self, tekton_root: str):
@@ -55,117 +61,76 @@ class FileRegistry:
         self.registry_dir = os.path.join(tekton_root, '.tekton', 'aish', 'ci-registry')
         os.makedirs(self.registry_dir, exist_ok=True)
         
-        self.data_file = os.path.join(self.registry_dir, 'registry.json')
+        self.data_file = os.path.join(self.registry_dir, 'registry.kv')
         self.lock_file = os.path.join(self.registry_dir, 'registry.lock')
+        # Where the registry lived before it was memory-mapped
+        self.json_file = os.path.join(self.registry_dir, 'registry.json')
+        self._store = RegistryStore(self.data_file, self.lock_file, initial=self._migrate_json)
     
-    @danger_zone(
-        title="File Lock Acquisition",
-        description="Critical section for acquiring exclusive file lock for concurrent access",
-        risk_level="high",
-        risks=["deadlock if process crashes", "timeout on high contention", "race conditions"],
-        mitigation="Timeout mechanism, automatic lock release on process exit",
-        review_required=True
-    )
-    @contextmanager
-    def _file_lock(self, timeout=5):
-        """Acquire exclusive lock for file operations."""
-        lock_fd = None
+    def _migrate_json(self) -> Dict[str, Any]:
+        """Contents of the old registry.json, once, when the store is first created."""
+        if not os.path.exists(self.json_file):
+            return {}
         try:
-            # Open lock file
-            lock_fd = os.open(self.lock_file, os.O_CREAT | os.O_WRONLY)
-            
-            # Try to acquire exclusive lock with timeout
-            start_time = time.time()
-            while True:
-                try:
-                    fcntl.flock(lock_fd, fcntl.LOCK_EX | fcntl.LOCK_NB)
-                    break
-                except IOError:
-                    if time.time() - start_time > timeout:
-                        raise TimeoutError(f"Could not acquire lock within {timeout} seconds")
-                    time.sleep(0.01)
-            
-            yield
-            
-        finally:
-            if lock_fd is not None:
-                # Release lock and close
-                fcntl.flock(lock_fd, fcntl.LOCK_UN)
-                os.close(lock_fd)
+            with open(self.json_file, 'r') as f:
+                data = json.load(f)
+        except (OSError, ValueError):
+            return {}
+        os.replace(self.json_file, self.json_file + '.migrated')
+        return data
     
     def read(self) -> Dict[str, Any]:
-        """Read registry data with shared lock."""
-        with self._file_lock():
-            if os.path.exists(self.data_file):
-                with open(self.data_file, 'r') as f:
-                    return json.load(f)
-            return {}
+        """Read all registry data without locking."""
+        return self._store.to_dict()
     
     @danger_zone(
-        title="Atomic File Write",
-        description="Writes registry data atomically using temp file and rename",
+        title="Registry Replace",
+        description="Replaces the whole registry contents key by key",
         risk_level="medium",
-        risks=["partial writes if interrupted", "disk full conditions"],
-        mitigation="Write to temp file first, then atomic rename",
+        risks=["concurrent readers see a mix of old and new keys until it finishes"],
+        mitigation="Each key is published atomically; values are never torn",
         review_required=False
     )
     def write(self, data: Dict[str, Any]):
         """Write registry data with exclusive lock."""
-        with self._file_lock():
-            # Write to temp file first then rename (atomic operation)
-            temp_file = self.data_file + '.tmp'
-            with open(temp_file, 'w') as f:
-                json.dump(data, f, indent=2)
-            os.replace(temp_file, self.data_file)
+        self._store.replace(data)
     
     @performance_boundary(
         title="Registry Key Update",
-        description="Read-modify-write operation for single key updates",
-        sla="<10ms typical, <100ms under contention",
-        optimization_notes="Uses file locking to prevent concurrent modifications",
+        description="In-place update of a single key in the shared map",
+        sla="<1ms typical, writers serialized by flock",
+        optimization_notes="Only the key's own value is encoded and written; readers never lock",
         measured_impact="Critical for CI state updates during Apollo-Rhetor coordination"
     )
     def update(self, key: str, value: Any):
         """Update a single key in the registry."""
-        with self._file_lock():
-            # Read current data
-            if os.path.exists(self.data_file):
-                with open(self.data_file, 'r') as f:
-                    data = json.load(f)
-            else:
-                data = {}
-            
-            # Update
-            data[key] = value
-            
-            # Write back atomically
-            temp_file = self.data_file + '.tmp'
-            with open(temp_file, 'w') as f:
-                json.dump(data, f, indent=2)
-            os.replace(temp_file, self.data_file)
+        self._store.set(key, value)
     
     def get(self, key: str, default=None) -> Any:
         """Get a value from the registry."""
-        data = self.read()
-        return data.get(key, default)
+        return self._store.get(key, default)
     
     def delete(self, key: str):
         """Delete a key from the registry."""
-        with self._file_lock():
-            # Read current data
-            if os.path.exists(self.data_file):
-                with open(self.data_file, 'r') as f:
-                    data = json.load(f)
-                
-                # Delete key if exists
-                if key in data:
-                    del data[key]
-                    
-                    # Write back
-                    temp_file = self.data_file + '.tmp'
-                    with open(temp_file, 'w') as f:
-                        json.dump(data, f, indent=2)
-                    os.replace(temp_file, self.data_file)
+        self._store.delete(key)
+    
+    def get_group(self, group: str) -> Dict[str, Any]:
+        """Values stored one key per member ('group/member'), by member name."""
+        prefix = group + GROUP_SEPARATOR
+        return {key[len(prefix):]: value for key, value in self._store.items()
+                if key.startswith(prefix)}
+    
+    def split_group(self, group: str):
+        """Move a dict stored under group into one 'group/member' key per entry."""
+        with self._store.locked():
+            legacy = self._store.get(group)
+            if legacy is None:
+                return
+            for member, value in (legacy if isinstance(legacy, dict) else {}).items():
+                key = group + GROUP_SEPARATOR + member
+                if self._store.get(key) is None:
+                    self._store.set(key, value)
+            self._store.delete(group)
 
 
 # Test script
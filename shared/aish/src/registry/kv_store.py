@@ -0,0 +1,376 @@
+#!/usr/bin/env python3
+"""
+Shared memory-mapped key/value store behind FileRegistry.
+
+Every aish process maps the same file. Readers never lock: each key's
+slot holds two versions of its value and a sequence number whose low bit
+selects the current one. A reader copies the current version and accepts
+it if the sequence number has not moved meanwhile and the bytes match the
+version's crc32. Writers take an flock, write the value into the version
+that is not current, then bump the sequence number, so a reader racing a
+writer retries instead of seeing a torn value, and a writer that dies
+mid-update leaves the previous value current.
+
+File layout:
+
+    header   64 bytes
+    slots    slot_count x 128 bytes: seq, key, two versions
+             (offset, capacity, length, crc32) of its JSON value
+    data     value extents, allocated by bumping header.alloc
+
+A version whose value outgrows its extent gets a new one and the old
+extent is dead. When dead space outweighs live values, or the slots run
+out, the writer copies the live values into a fresh file, renames it into
+place and marks the old file retired; everyone else notices that on their
+next access and maps the new file.
+"""
+
+import os
+import json
+import mmap
+import fcntl
+import struct
+import zlib
+import threading
+from contextlib import contextmanager
+from typing import Any, Callable, Dict, Iterator, List, Optional
+
+MAGIC = b"TKKV"
+VERSION = 1
+
+# magic, version, slot_count, used_slots, retired, file_size, alloc, dead_bytes, data_start
+HEADER = struct.Struct("<4sIIII4xQQQQ")
+HEADER_SIZE = 64
+SLOT_SIZE = 128
+KEY_MAX = 64
+# seq, key length
+SLOT_HEAD = struct.Struct("<QI4x")
+# offset, capacity, length (-1 = absent), crc32
+SLOT_VERSION = struct.Struct("<QIiI4x")
+KEY_OFFSET = SLOT_HEAD.size
+VERSIONS_OFFSET = KEY_OFFSET + KEY_MAX
+SEQ = struct.Struct("<Q")
+
+DEFAULT_SLOTS = 256
+MIN_EXTENT = 256
+GROW_BYTES = 1 << 20
+COMPACT_MIN_DEAD_BYTES = 1 << 20
+READ_RETRIES = 1000
+
+
+class _Mapping:
+    """One mapping of the store file, with the key -> slot index read from it"""
+
+    def __init__(self, path: str):
+        fd = os.open(path, os.O_RDWR)
+        try:
+            self.map = mmap.mmap(fd, 0)
+            self.inode = os.fstat(fd).st_ino
+        finally:
+            os.close(fd)
+        magic, version, self.slot_count = HEADER.unpack_from(self.map)[:3]
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f"{path} is not a version {VERSION} registry store")
+        self.slots: Dict[str, int] = {}
+
+    def header(self) -> tuple:
+        return HEADER.unpack_from(self.map)
+
+    def stale(self) -> bool:
+        """Retired by a compaction, or grown by another process"""
+        _, _, _, _, retired, file_size, _, _, _ = self.header()
+        return bool(retired) or file_size > len(self.map)
+
+    def index_slots(self) -> Dict[str, int]:
+        used = self.header()[3]
+        for index in range(len(self.slots), used):
+            base = _slot_offset(index)
+            length = SLOT_HEAD.unpack_from(self.map, base)[1]
+            key = bytes(self.map[base + KEY_OFFSET:base + KEY_OFFSET + length]).decode("utf-8")
+            self.slots[key] = index
+        return self.slots
+
+    def find(self, key: str) -> Optional[int]:
+        index = self.slots.get(key)
+        return index if index is not None else self.index_slots().get(key)
+
+    def seq(self, index: int) -> int:
+        return SEQ.unpack_from(self.map, _slot_offset(index))[0]
+
+    def version(self, index: int, which: int) -> tuple:
+        return SLOT_VERSION.unpack_from(self.map, _version_offset(index, which))
+
+    def read(self, index: int) -> tuple:
+        """(complete, value bytes or None): one optimistic read of a slot's current value"""
+        seq = self.seq(index)
+        offset, _, length, crc = self.version(index, seq & 1)
+        if length < 0:
+            data = None
+        elif offset + length > len(self.map):
+            return False, None
+        else:
+            data = self.map[offset:offset + length]
+        return self.seq(index) == seq and (data is None or zlib.crc32(data) == crc), data
+
+
+class RegistryStore:
+    """Keys to JSON values in a file shared by every process that opens it"""
+
+    def __init__(self, path: str, lock_path: Optional[str] = None, slots: int = DEFAULT_SLOTS,
+                 initial: Optional[Callable[[], Dict[str, Any]]] = None):
+        """
+        Map the store at path, creating it if needed
+
+        Args:
+            path: The store file
+            lock_path: The writers' flock file (default: path + ".lock")
+            slots: Keys a new store has room for before it is compacted into a larger one
+            initial: Called with the writer lock held, only by the process that creates
+                the store, for its initial contents (e.g. to migrate an older format)
+        """
+        self.path = path
+        self.lock_path = lock_path or path + ".lock"
+        self._default_slots = slots
+        self._initial = initial
+        self._thread_lock = threading.RLock()
+        self._lock_depth = 0
+        if not os.path.exists(path):
+            with self.locked():
+                pass
+        # Replaced, never mutated, so a reader keeps a consistent mapping
+        self._view = _Mapping(path)
+
+    def _current(self) -> _Mapping:
+        view = self._view
+        if view.stale():
+            view = self._view = _Mapping(self.path)
+        return view
+
+    # -- reading (lock-free) ---------------------------------------------------
+
+    def _read(self, key: str) -> Optional[bytes]:
+        """The current value bytes of key, or None if absent"""
+        for _ in range(READ_RETRIES):
+            view = self._current()
+            index = view.find(key)
+            if index is None:
+                return None
+            complete, data = view.read(index)
+            if complete:
+                return data
+        # Hammered by writers for this long: wait our turn instead
+        with self.locked():
+            view = self._view
+            index = view.find(key)
+            return None if index is None else view.read(index)[1]
+
+    def get(self, key: str, default=None) -> Any:
+        data = self._read(key)
+        return default if data is None else json.loads(data)
+
+    def keys(self) -> List[str]:
+        view = self._current()
+        return [key for key, index in list(view.index_slots().items())
+                if view.version(index, view.seq(index) & 1)[2] >= 0]
+
+    def items(self) -> Iterator[tuple]:
+        """(key, value) per key; each value is consistent, the set as a whole is not a snapshot"""
+        for key in self.keys():
+            data = self._read(key)
+            if data is not None:
+                yield key, json.loads(data)
+
+    def to_dict(self) -> Dict[str, Any]:
+        return dict(self.items())
+
+    # -- writing (one writer at a time) -----------------------------------------
+
+    @contextmanager
+    def locked(self):
+        """Hold the writer lock (reentrant); creates the file on first use"""
+        with self._thread_lock:
+            if self._lock_depth:
+                self._lock_depth += 1
+                try:
+                    yield
+                finally:
+                    self._lock_depth -= 1
+                return
+            fd = os.open(self.lock_path, os.O_CREAT | os.O_WRONLY, 0o644)
+            try:
+                fcntl.flock(fd, fcntl.LOCK_EX)
+                self._lock_depth = 1
+                if not os.path.exists(self.path):
+                    values = {key: json.dumps(value).encode("utf-8")
+                              for key, value in (self._initial() if self._initial else {}).items()}
+                    _create(self.path + ".tmp", max(self._default_slots, 2 * len(values)), values)
+                    os.replace(self.path + ".tmp", self.path)
+                elif hasattr(self, "_view"):
+                    self._recover()
+                yield
+            finally:
+                self._lock_depth = 0
+                fcntl.flock(fd, fcntl.LOCK_UN)
+                os.close(fd)
+
+    def _recover(self) -> None:
+        """With the lock held: map the file now in place, and finish a compaction that died"""
+        view = self._current()
+        if view.inode != os.stat(self.path).st_ino:
+            view = self._view = _Mapping(self.path)
+        if view.header()[4]:
+            # Retired but never replaced: the compacting writer died in between
+            self._set_header(retired=0)
+
+    def _set_header(self, **fields) -> None:
+        names = ("magic", "version", "slot_count", "used_slots", "retired",
+                 "file_size", "alloc", "dead_bytes", "data_start")
+        values = dict(zip(names, self._view.header()))
+        values.update(fields)
+        HEADER.pack_into(self._view.map, 0, *(values[name] for name in names))
+
+    def _allocate(self, size: int) -> int:
+        _, _, _, _, _, file_size, alloc, _, _ = self._view.header()
+        if alloc + size > file_size:
+            file_size = alloc + size + GROW_BYTES
+            with open(self.path, "r+b") as f:
+                f.truncate(file_size)
+            self._set_header(file_size=file_size)
+            self._current()
+        self._set_header(alloc=alloc + size)
+        return alloc
+
+    def _claim_slot(self, key: str) -> Optional[int]:
+        encoded = key.encode("utf-8")
+        if len(encoded) > KEY_MAX:
+            raise ValueError(f"registry key longer than {KEY_MAX} bytes: {key}")
+        view = self._view
+        used = view.header()[3]
+        if used == view.slot_count:
+            return None
+        base = _slot_offset(used)
+        SLOT_HEAD.pack_into(view.map, base, 0, len(encoded))
+        view.map[base + KEY_OFFSET:base + KEY_OFFSET + len(encoded)] = encoded
+        for which in (0, 1):
+            SLOT_VERSION.pack_into(view.map, _version_offset(used, which), 0, 0, -1, 0)
+        # Readers only look at slots below used_slots
+        self._set_header(used_slots=used + 1)
+        return used
+
+    def _store(self, key: str, data: Optional[bytes]) -> None:
+        """Make data (None = absent) the current value of key; writer lock held"""
+        index = self._view.find(key)
+        if index is None:
+            if data is None:
+                return
+            index = self._claim_slot(key)
+            if index is None:
+                self.compact(slot_count=2 * self._view.slot_count)
+                index = self._claim_slot(key)
+        seq = self._view.seq(index)
+        which = 1 - (seq & 1)
+        offset, capacity, _, _ = self._view.version(index, which)
+        if data is None:
+            length, crc = -1, 0
+        else:
+            if len(data) > capacity:
+                if capacity:
+                    self._set_header(dead_bytes=self._view.header()[7] + capacity)
+                capacity = _extent_size(len(data))
+                offset = self._allocate(capacity)
+            self._view.map[offset:offset + len(data)] = data
+            length, crc = len(data), zlib.crc32(data)
+        view = self._view
+        SLOT_VERSION.pack_into(view.map, _version_offset(index, which), offset, capacity, length, crc)
+        # Publish: readers now take the version just written
+        SEQ.pack_into(view.map, _slot_offset(index), seq + 1)
+
+    def set(self, key: str, value: Any) -> None:
+        data = json.dumps(value).encode("utf-8")
+        with self.locked():
+            self._store(key, data)
+            self._maybe_compact()
+
+    def delete(self, key: str) -> None:
+        with self.locked():
+            self._store(key, None)
+
+    def replace(self, values: Dict[str, Any]) -> None:
+        """Make values the whole contents of the store"""
+        encoded = {key: json.dumps(value).encode("utf-8") for key, value in values.items()}
+        with self.locked():
+            for key in self.keys():
+                if key not in encoded:
+                    self._store(key, None)
+            for key, data in encoded.items():
+                self._store(key, data)
+            self._maybe_compact()
+
+    # -- compaction -------------------------------------------------------------
+
+    def _maybe_compact(self) -> None:
+        _, _, _, _, _, _, alloc, dead, data_start = self._view.header()
+        if dead >= COMPACT_MIN_DEAD_BYTES and dead > alloc - data_start - dead:
+            self.compact()
+
+    def compact(self, slot_count: Optional[int] = None) -> None:
+        """Copy the live values into a fresh file and retire this one"""
+        with self.locked():
+            old = self._view
+            values = {}
+            for key in self.keys():
+                data = old.read(old.find(key))[1]
+                if data is not None:
+                    values[key] = data
+            temp = self.path + ".tmp"
+            _create(temp, max(slot_count or old.slot_count, len(values)), values)
+            # Retire first: readers that look between the two steps just map the old file again
+            self._set_header(retired=1)
+            os.replace(temp, self.path)
+            self._view = _Mapping(self.path)
+
+
+def _slot_offset(index: int) -> int:
+    return HEADER_SIZE + index * SLOT_SIZE
+
+
+def _version_offset(index: int, which: int) -> int:
+    return _slot_offset(index) + VERSIONS_OFFSET + which * SLOT_VERSION.size
+
+
+def _create(path: str, slot_count: int, values: Dict[str, bytes]) -> None:
+    """Write a new store holding values (already encoded) to path"""
+    data_start = HEADER_SIZE + slot_count * SLOT_SIZE
+    data = bytearray()
+    slots = bytearray(slot_count * SLOT_SIZE)
+    for index, (key, value) in enumerate(values.items()):
+        encoded = key.encode("utf-8")
+        capacity = _extent_size(len(value))
+        base = index * SLOT_SIZE
+        SLOT_HEAD.pack_into(slots, base, 0, len(encoded))
+        slots[base + KEY_OFFSET:base + KEY_OFFSET + len(encoded)] = encoded
+        SLOT_VERSION.pack_into(slots, base + VERSIONS_OFFSET, data_start + len(data),
+                               capacity, len(value), zlib.crc32(value))
+        SLOT_VERSION.pack_into(slots, base + VERSIONS_OFFSET + SLOT_VERSION.size, 0, 0, -1, 0)
+        data += value
+        data += bytes(capacity - len(value))
+    alloc = data_start + len(data)
+    file_size = alloc + GROW_BYTES
+    header = bytearray(HEADER_SIZE)
+    HEADER.pack_into(header, 0, MAGIC, VERSION, slot_count, len(values), 0,
+                     file_size, alloc, 0, data_start)
+    with open(path, "wb") as f:
+        f.write(header)
+        f.write(slots)
+        f.write(data)
+        f.truncate(file_size)
+        f.flush()
+        os.fsync(f.fileno())
+
+
+def _extent_size(length: int) -> int:
+    """Room for a value to grow: the next power of two, at least MIN_EXTENT"""
+    size = MIN_EXTENT
+    while size < length:
+        size *= 2
+    return size
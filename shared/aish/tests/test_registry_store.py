@@ -0,0 +1,101 @@
+"""
+Tests for the memory-mapped store behind aish's FileRegistry.
+"""
+import json
+import multiprocessing
+import sys
+from pathlib import Path
+
+import pytest
+
+# Add parent paths for imports
+sys.path.insert(0, str(Path(__file__).parent.parent.parent.parent))
+
+from shared.aish.src.registry import kv_store
+from shared.aish.src.registry.file_registry import FileRegistry
+from shared.aish.src.registry.kv_store import RegistryStore
+
+
+def test_values_survive_reopen_and_migrate_once(tmp_path):
+    path = str(tmp_path / "registry.kv")
+    calls = []
+
+    def initial():
+        calls.append(1)
+        return {"context_state": {"apollo": {"turns": 3}}}
+
+    store = RegistryStore(path, initial=initial)
+    store.set("forwards", {"apollo": "term-1"})
+    store.set("context_state", {"apollo": {"turns": 4, "last": "x" * 1000}})
+    store.delete("forwards")
+    store.delete("missing")
+
+    again = RegistryStore(path, initial=initial)
+    assert calls == [1]
+    assert again.to_dict() == {"context_state": {"apollo": {"turns": 4, "last": "x" * 1000}}}
+    assert again.get("forwards", {}) == {}
+    with pytest.raises(ValueError):
+        again.set("k" * 65, 1)
+
+
+def test_other_processes_follow_growth_and_compaction(tmp_path, monkeypatch):
+    """Another mapping sees new keys, a grown file, and a file replaced by compaction."""
+    monkeypatch.setattr(kv_store, "COMPACT_MIN_DEAD_BYTES", 0)
+    path = str(tmp_path / "registry.kv")
+    writer = RegistryStore(path, slots=2)
+    reader = RegistryStore(path)
+    writer.set("a", 1)
+    assert reader.get("a") == 1
+
+    for size in (100, 1000, 10000, 2000000):
+        writer.set("a", "x" * size)
+        assert reader.get("a") == "x" * size
+    writer.set("b", 2)
+    writer.set("c", 3)  # a third key needs more slots than the file has
+    assert sorted(reader.keys()) == ["a", "b", "c"]
+    assert reader.get("c") == 3
+    assert reader._view.slot_count == 4
+
+
+def _hammer(path, count):
+    store = RegistryStore(path)
+    for i in range(count):
+        store.set(f"key{i % 5}", {"i": i, "pad": "p" * (i * 131 % 3000)})
+
+
+def test_readers_never_see_torn_values(tmp_path):
+    path = str(tmp_path / "registry.kv")
+    RegistryStore(path).set("key0", {"i": 0, "pad": ""})
+    writers = [multiprocessing.Process(target=_hammer, args=(path, 1500)) for _ in range(2)]
+    for process in writers:
+        process.start()
+    reader = RegistryStore(path)
+    seen = 0
+    while any(process.is_alive() for process in writers):
+        value = reader.get("key0")
+        assert len(value["pad"]) == value["i"] * 131 % 3000
+        seen += 1
+    for process in writers:
+        process.join()
+    assert seen
+    assert json.loads(json.dumps(reader.to_dict()))
+
+
+def test_groups_split_into_one_key_per_member(tmp_path):
+    """A legacy whole-dict value becomes per-member keys; updating one leaves the others' bytes alone."""
+    registry = FileRegistry(str(tmp_path))
+    registry.update("context_state", {"apollo": {"turns": 3}, "rhetor": {"turns": 5}})
+    registry.update("context_state/rhetor", {"turns": 6})
+    registry.split_group("context_state")
+    registry.split_group("context_state")
+
+    assert registry.get("context_state") is None
+    # A member already split out wins over the legacy copy
+    assert registry.get_group("context_state") == {"apollo": {"turns": 3}, "rhetor": {"turns": 6}}
+
+    store = registry._store
+    apollo = store._view.find("context_state/apollo")
+    before = store._view.seq(apollo)
+    registry.update("context_state/rhetor", {"turns": 7, "last": "x" * 5000})
+    assert store._view.seq(apollo) == before
+    assert FileRegistry(str(tmp_path)).get_group("context_state")["rhetor"]["turns"] == 7
@@ -15,6 +15,12 @@ from datetime import datetime
 _frozen_env: Dict[str, str] = {}
 _is_loaded: bool = False
 
+# Keys read through TektonEnviron.get(), appended once each to the file the
+# launcher names in TEKTON_ENV_READS_FILE so `tekton reload` knows what to restart.
+# all() records "*" and with_prefix() records "PREFIX*": reads of whole key sets
+_read_keys: set = set()
+_reads_fd: Optional[int] = None
+
 # Setup logging
 logger = logging.getLogger(__name__)
 
@@ -141,14 +147,31 @@ class TektonEnviron:
         if not _is_loaded and os.environ.get('_TEKTON_ENV_FROZEN') != '1':
             # If accessed before load AND not in a subprocess with frozen env
             logger.warning("TektonEnviron accessed before TektonEnvironLock.load() - returning current os.environ")
+        if '*' not in _read_keys:
+            _record_read('*')
         return dict(os.environ)  # Always return current environment
     
+    @staticmethod
+    def with_prefix(prefix: str) -> Dict[str, str]:
+        """
+        Get the variables whose names start with prefix.
+        
+        Prefer this to filtering all(): reload then restarts the caller only
+        when one of these keys changes, not on any change.
+        """
+        pattern = f"{prefix}*"
+        if pattern not in _read_keys:
+            _record_read(pattern)
+        return {key: value for key, value in os.environ.items() if key.startswith(prefix)}
+    
     @staticmethod
     def get(key: str, default: Optional[str] = None) -> Optional[str]:
         """Get a single environment variable."""
         if not _is_loaded and os.environ.get('_TEKTON_ENV_FROZEN') != '1':
             # If accessed before load AND not in a subprocess with frozen env
             logger.warning(f"TektonEnviron.get('{key}') called before TektonEnvironLock.load()")
+        if key not in _read_keys:
+            _record_read(key)
         return os.environ.get(key, default)  # Always use current environment
     
     @staticmethod
@@ -206,6 +229,26 @@ class TektonEnvironUpdate:
 
 
 
+def _record_read(key: str) -> None:
+    """Note the first read of a key (covers every config _get_env_value too)"""
+    global _reads_fd
+    _read_keys.add(key)
+    if _reads_fd is None:
+        path = os.environ.get('TEKTON_ENV_READS_FILE')
+        if not path:
+            return
+        try:
+            _reads_fd = os.open(path, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o644)
+        except OSError:
+            # Tracking is best effort; stop trying for this process
+            os.environ.pop('TEKTON_ENV_READS_FILE', None)
+            return
+    try:
+        os.write(_reads_fd, f"{key}\n".encode('utf-8'))
+    except OSError:
+        pass
+
+
 def _load_env_file(filepath: Path, env_dict: Dict[str, str]) -> None:
     """Load a .env file and update the environment dictionary."""
     try:
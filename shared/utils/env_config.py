@@ -477,12 +477,41 @@ class TektonConfig(BaseModel):
         return BaseComponentConfig._get_env_value(key, default, value_type)
 
 
+# ComponentConfig attribute -> config class. Each is read from the
+# environment on first access, so a component records reads (for
+# `tekton reload`, see shared.utils.env_tracking) of only the settings it uses.
+_CONFIG_CLASSES = {
+    'vector': VectorDBConfig,
+    'hermes': HermesConfig,
+    'engram': EngramConfig,
+    'rhetor': RhetorConfig,
+    'athena': AthenaConfig,
+    'apollo': ApolloConfig,
+    'budget': BudgetConfig,
+    'penia': PeniaConfig,
+    'ergon': ErgonConfig,
+    'harmonia': HarmoniaConfig,
+    'hephaestus': HephaestusConfig,
+    'metis': MetisConfig,
+    'prometheus': PrometheusConfig,
+    'sophia': SophiaConfig,
+    'synthesis': SynthesisConfig,
+    'telos': TelosConfig,
+    'terma': TermaConfig,
+    'tekton_core': TektonCoreConfig,
+    'numa': NumaConfig,
+    'noesis': NoesisConfig,
+    'tekton': TektonConfig,
+}
+
+
 class ComponentConfig:
     """
     Central configuration object for all Tekton components.
     
     Provides typed access to all component configurations and
-    global Tekton settings.
+    global Tekton settings. Each configuration is loaded when it is
+    first accessed.
     """
     
     def __init__(self):
@@ -492,35 +521,22 @@ class ComponentConfig:
         if TektonEnviron.get('_TEKTON_ENV_FROZEN') != '1':
             self.env_manager.load_environment()
         
-        # Load all component configs
+        # Component configs are loaded on first access
         self._load_configs()
     
     def _load_configs(self):
-        """Load all component configurations from environment."""
-        # System configurations
-        self.vector = VectorDBConfig.from_env()
-        
-        # Component configurations
-        self.hermes = HermesConfig.from_env()
-        self.engram = EngramConfig.from_env()
-        self.rhetor = RhetorConfig.from_env()
-        self.athena = AthenaConfig.from_env()
-        self.apollo = ApolloConfig.from_env()
-        self.budget = BudgetConfig.from_env()
-        self.penia = PeniaConfig.from_env()
-        self.ergon = ErgonConfig.from_env()
-        self.harmonia = HarmoniaConfig.from_env()
-        self.hephaestus = HephaestusConfig.from_env()
-        self.metis = MetisConfig.from_env()
-        self.prometheus = PrometheusConfig.from_env()
-        self.sophia = SophiaConfig.from_env()
-        self.synthesis = SynthesisConfig.from_env()
-        self.telos = TelosConfig.from_env()
-        self.terma = TermaConfig.from_env()
-        self.tekton_core = TektonCoreConfig.from_env()
-        self.numa = NumaConfig.from_env()
-        self.noesis = NoesisConfig.from_env()
-        self.tekton = TektonConfig.from_env()
+        """Forget loaded configurations; each is read again on its next access."""
+        for name in _CONFIG_CLASSES:
+            self.__dict__.pop(name, None)
+    
+    def __getattr__(self, name: str):
+        """Load a component configuration from environment on first access."""
+        config_class = _CONFIG_CLASSES.get(name)
+        if config_class is None:
+            raise AttributeError(f"{type(self).__name__!r} object has no attribute {name!r}")
+        config = config_class.from_env()
+        self.__dict__[name] = config
+        return config
     
     def refresh(self):
         """Refresh configuration from environment."""
@@ -539,32 +555,17 @@ class ComponentConfig:
         """
         component_lower = component.lower()
         
-        # Map component names to config attributes
-        component_map = {
-            'hermes': self.hermes,
-            'engram': self.engram,
-            'rhetor': self.rhetor,
-            'athena': self.athena,
-            'apollo': self.apollo,
-            'budget': self.budget,
-            'penia': self.budget,  # Penia is the CI name for budget component
-            'ergon': self.ergon,
-            'harmonia': self.harmonia,
-            'hephaestus': self.hephaestus,
-            'metis': self.metis,
-            'prometheus': self.prometheus,
-            'sophia': self.sophia,
-            'synthesis': self.synthesis,
-            'telos': self.telos,
-            'terma': self.terma,
-            'tekton-core': self.tekton_core,
-            'tekton_core': self.tekton_core,
-            'numa': self.numa,
-            'noesis': self.noesis,
+        # Component names that differ from their config attributes
+        aliases = {
+            'penia': 'budget',  # Penia is the CI name for budget component
+            'tekton-core': 'tekton_core',
         }
+        attribute = aliases.get(component_lower, component_lower)
+        if attribute in ('vector', 'tekton') or attribute not in _CONFIG_CLASSES:
+            return None
         
-        config = component_map.get(component_lower)
-        if config and hasattr(config, 'port'):
+        config = getattr(self, attribute)
+        if hasattr(config, 'port'):
             return config.port
         
         return None
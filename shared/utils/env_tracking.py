@@ -0,0 +1,128 @@
+"""
+Environment Dependency Tracking
+
+Lets `tekton reload` restart only the components an env file edit affects.
+
+When the launcher starts a component it points TEKTON_ENV_READS_FILE at
+$TEKTON_ROOT/.tekton/run/env-reads/<component>.keys. shared.env appends each
+key the component reads through TektonEnviron.get() to that file, once per
+key (config classes read through _get_env_value, which goes through get).
+TektonEnviron.all() records "*", a read of every key, and with_prefix()
+records "PREFIX*", a read of every key starting with PREFIX.
+The launcher also writes the values it handed that component for every key
+defined in the env files to .tekton/run/env-snapshot/<component>.json, so
+starting one component never changes what the others are judged against.
+
+Reload compares a fresh merge of the env files against each running
+component's snapshot and intersects the changed keys with its read set.
+Reads that bypass TektonEnviron (os.environ directly) are not seen, and a
+key first read after the reload is judged by the set recorded so far.
+"""
+import json
+import os
+from pathlib import Path
+from typing import Dict, Iterable, List, Mapping, Optional, Set
+
+READS_FILE_ENV = "TEKTON_ENV_READS_FILE"
+RUN_DIR = os.path.join(".tekton", "run")
+READS_DIR = os.path.join(RUN_DIR, "env-reads")
+SNAPSHOT_DIR = os.path.join(RUN_DIR, "env-snapshot")
+
+
+def reads_path(tekton_root: str, component: str) -> str:
+    return os.path.join(tekton_root, READS_DIR, f"{component}.keys")
+
+
+def reset_reads(tekton_root: str, component: str) -> str:
+    """Start a fresh read set for a component about to launch; returns its path"""
+    path = reads_path(tekton_root, component)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    open(path, "w").close()
+    return path
+
+
+def read_component_keys(tekton_root: str, component: str) -> Optional[Set[str]]:
+    """Keys a component has read, or None if it was never tracked"""
+    try:
+        with open(reads_path(tekton_root, component)) as f:
+            return {line.strip() for line in f if line.strip()}
+    except OSError:
+        return None
+
+
+def env_file_keys(tekton_root: str) -> Set[str]:
+    """Keys defined in ~/.env, .env.tekton and .env.local"""
+    from shared.env import _load_env_file
+
+    merged: Dict[str, str] = {}
+    for path in (Path.home() / ".env", Path(tekton_root) / ".env.tekton",
+                 Path(tekton_root) / ".env.local"):
+        if path.exists():
+            _load_env_file(path, merged)
+    return set(merged)
+
+
+def env_snapshot(tekton_root: str, env: Mapping[str, str]) -> Dict[str, str]:
+    """Values of the env-file keys as components see them (after port remapping)"""
+    return {key: env[key] for key in sorted(env_file_keys(tekton_root)) if key in env}
+
+
+def snapshot_path(tekton_root: str, component: str) -> str:
+    return os.path.join(tekton_root, SNAPSHOT_DIR, f"{component}.json")
+
+
+def write_snapshot(tekton_root: str, component: str, env: Mapping[str, str]) -> str:
+    """Record the settings a component is being launched with"""
+    return restore_snapshot(tekton_root, component, env_snapshot(tekton_root, env))
+
+
+def restore_snapshot(tekton_root: str, component: str, snapshot: Mapping[str, str]) -> str:
+    """Put back a snapshot read earlier, e.g. when a replacement failed to start"""
+    path = snapshot_path(tekton_root, component)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    tmp = f"{path}.{os.getpid()}.tmp"
+    with open(tmp, "w") as f:
+        json.dump(snapshot, f, indent=1, sort_keys=True)
+    os.replace(tmp, path)
+    return path
+
+
+def read_snapshot(tekton_root: str, component: str) -> Optional[Dict[str, str]]:
+    """Settings a component was launched with, or None if never recorded"""
+    try:
+        with open(snapshot_path(tekton_root, component)) as f:
+            return json.load(f)
+    except (OSError, ValueError):
+        return None
+
+
+def keys_read(read: Set[str], keys: Iterable[str]) -> Set[str]:
+    """The keys a read set covers, counting "PREFIX*" entries as patterns"""
+    prefixes = [entry[:-1] for entry in read if entry.endswith("*")]
+    return {key for key in keys
+            if key in read or any(key.startswith(prefix) for prefix in prefixes)}
+
+
+def changed_keys(old: Mapping[str, str], new: Mapping[str, str]) -> Set[str]:
+    """Keys added, removed or changed between two snapshots"""
+    return {key for key in set(old) | set(new) if old.get(key) != new.get(key)}
+
+
+def affected_components(tekton_root: str, components: Iterable[str],
+                        current: Mapping[str, str]) -> Dict[str, List[str]]:
+    """
+    component -> the keys it read that differ in current from what it was
+    launched with. Components with no read set or no snapshot (started
+    before tracking, or by hand) get ["*"]: they may depend on anything.
+    """
+    affected = {}
+    for component in components:
+        keys = read_component_keys(tekton_root, component)
+        previous = read_snapshot(tekton_root, component)
+        if keys is None or previous is None:
+            affected[component] = ["*"]
+            continue
+        changed = keys_read(keys, changed_keys(previous, current))
+        if changed:
+            affected[component] = sorted(changed)
+    return affected
@@ -0,0 +1,443 @@
+"""
+Graph Index
+
+ctypes binding for src/tekton-graph: the topology of a property graph kept
+in compressed-sparse-row arrays of typed edges. Node, edge and type ids are
+strings here and are interned onto the library's dense indices, so
+adjacency, bounded path and neighbourhood queries run without touching a
+Python object per edge. Athena's in-memory adapter keeps its entities and
+relationships in dicts and their structure in one of these.
+
+Without the library the same index is kept in Python lists and answers
+every query the same way, only more slowly.
+
+    index = GraphIndex()
+    index.add_edge("r1", "alice", "acme", "works_at")
+    index.edges("alice", "outgoing")          # ["r1"]
+    index.paths("alice", "acme", max_hops=3)  # [["r1"]]
+"""
+import ctypes
+import os
+from array import array
+from typing import Dict, Iterable, List, Optional, Sequence, Tuple
+
+GRAPH_LIBRARY_ENV = "TEKTON_GRAPH_LIBRARY"
+GRAPH_SOURCE = os.path.join("src", "tekton-graph")
+LIBRARY_NAME = "libtekton-graph.so"
+
+DIRECTIONS = {"outgoing": 1, "incoming": 2, "both": 3}
+ANY_TYPE = 0xFFFFFFFF
+# Path queries stop after this many paths unless asked for more
+PATH_LIMIT = 10000
+
+_lib = None
+
+
+def _default_root() -> str:
+    return os.environ.get("TEKTON_ROOT") or os.path.dirname(
+        os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+
+def _load(library: Optional[str] = None):
+    """The graph library, or None if it has not been built"""
+    global _lib
+    if _lib is not None and library is None:
+        return _lib
+    path = library or os.environ.get(GRAPH_LIBRARY_ENV) or os.path.join(
+        _default_root(), GRAPH_SOURCE, LIBRARY_NAME)
+    try:
+        lib = ctypes.CDLL(path)
+    except OSError:
+        return None
+    u32, u64, i64 = ctypes.c_uint32, ctypes.c_uint64, ctypes.c_int64
+    lib.tg_new.restype = ctypes.c_void_p
+    lib.tg_new.argtypes = []
+    lib.tg_free.argtypes = [ctypes.c_void_p]
+    lib.tg_add_nodes.restype = i64
+    lib.tg_add_nodes.argtypes = [ctypes.c_void_p, u32]
+    lib.tg_remove_node.restype = i64
+    lib.tg_remove_node.argtypes = [ctypes.c_void_p, u32]
+    lib.tg_add_edges.restype = i64
+    lib.tg_add_edges.argtypes = [ctypes.c_void_p, u64, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]
+    lib.tg_remove_edge.argtypes = [ctypes.c_void_p, u32]
+    lib.tg_node_count.restype = u64
+    lib.tg_node_count.argtypes = [ctypes.c_void_p]
+    lib.tg_edge_count.restype = u64
+    lib.tg_edge_count.argtypes = [ctypes.c_void_p]
+    lib.tg_compact.argtypes = [ctypes.c_void_p]
+    lib.tg_edges_of.restype = i64
+    lib.tg_edges_of.argtypes = [ctypes.c_void_p, u32, ctypes.c_int, u32]
+    lib.tg_paths.restype = i64
+    lib.tg_paths.argtypes = [ctypes.c_void_p, u32, u32, u32, u64]
+    lib.tg_expand.restype = i64
+    lib.tg_expand.argtypes = [ctypes.c_void_p, ctypes.c_void_p, u32, u32, ctypes.c_int, u32,
+                              ctypes.c_int, ctypes.POINTER(u64)]
+    lib.tg_result.restype = ctypes.POINTER(u32)
+    lib.tg_result.argtypes = [ctypes.c_void_p, ctypes.POINTER(u64)]
+    if library is None:
+        _lib = lib
+    return lib
+
+
+def native_available() -> bool:
+    return _load() is not None
+
+
+def _address(values: array) -> int:
+    return values.buffer_info()[0] if values else 0
+
+
+class _NativeGraph:
+    def __init__(self, lib, threads: int):
+        self.lib = lib
+        self.threads = threads
+        self.g = lib.tg_new()
+        if not self.g:
+            raise MemoryError("tg_new failed")
+        self._len = ctypes.c_uint64()
+
+    def _check(self, result: int) -> int:
+        if result < 0:
+            raise MemoryError("tekton-graph ran out of memory")
+        return result
+
+    def _result(self) -> List[int]:
+        data = self.lib.tg_result(self.g, ctypes.byref(self._len))
+        return data[:self._len.value] if self._len.value else []
+
+    def add_nodes(self, count: int) -> int:
+        return self._check(self.lib.tg_add_nodes(self.g, count))
+
+    def remove_node(self, n: int) -> List[int]:
+        self._check(self.lib.tg_remove_node(self.g, n))
+        return self._result()
+
+    def add_edges(self, src: array, dst: array, types: array) -> int:
+        return self._check(self.lib.tg_add_edges(self.g, len(src), _address(src), _address(dst),
+                                                 _address(types)))
+
+    def remove_edge(self, e: int) -> None:
+        self.lib.tg_remove_edge(self.g, e)
+
+    def counts(self) -> Tuple[int, int]:
+        return self.lib.tg_node_count(self.g), self.lib.tg_edge_count(self.g)
+
+    def edges_of(self, n: int, direction: int, edge_type: int) -> List[int]:
+        self._check(self.lib.tg_edges_of(self.g, n, direction, edge_type))
+        return self._result()
+
+    def paths(self, src: int, dst: int, max_hops: int, limit: int) -> List[List[int]]:
+        self._check(self.lib.tg_paths(self.g, src, dst, max_hops, limit))
+        flat = self._result()
+        paths, i = [], 0
+        while i < len(flat):
+            paths.append(flat[i + 1:i + 1 + flat[i]])
+            i += 1 + flat[i]
+        return paths
+
+    def expand(self, seeds: array, hops: int, direction: int, edge_type: int) -> Tuple[List[int], List[int]]:
+        edges = ctypes.c_uint64()
+        reached = self._check(self.lib.tg_expand(self.g, _address(seeds), len(seeds), hops, direction,
+                                                 edge_type, self.threads, ctypes.byref(edges)))
+        result = self._result()
+        return result[:reached], result[reached:]
+
+    def close(self) -> None:
+        if self.g:
+            self.lib.tg_free(self.g)
+            self.g = None
+
+
+class _PyGraph:
+    """tekton-graph's semantics over per-node lists of edge indices"""
+
+    def __init__(self):
+        self.src = array("I")
+        self.dst = array("I")
+        self.type = array("I")
+        self.dead = bytearray()
+        self.gone = bytearray()
+        self.adj: Tuple[List[List[int]], List[List[int]]] = ([], [])
+        self.live_nodes = 0
+        self.live_edges = 0
+
+    def add_nodes(self, count: int) -> int:
+        first = len(self.gone)
+        self.gone.extend(bytes(count))
+        self.adj[0].extend([] for _ in range(count))
+        self.adj[1].extend([] for _ in range(count))
+        self.live_nodes += count
+        return first
+
+    def remove_node(self, n: int) -> List[int]:
+        removed = list(dict.fromkeys(self.adj[0][n] + self.adj[1][n]))
+        for e in removed:
+            self.remove_edge(e)
+        self.gone[n] = 1
+        self.live_nodes -= 1
+        return removed
+
+    def add_edges(self, src: array, dst: array, types: array) -> int:
+        first = len(self.src)
+        for e, (s, d) in enumerate(zip(src, dst), first):
+            self.adj[0][s].append(e)
+            self.adj[1][d].append(e)
+        self.src.extend(src)
+        self.dst.extend(dst)
+        self.type.extend(types)
+        self.dead.extend(bytes(len(src)))
+        self.live_edges += len(src)
+        return first
+
+    def remove_edge(self, e: int) -> None:
+        if not self.dead[e]:
+            self.dead[e] = 1
+            self.adj[0][self.src[e]].remove(e)
+            self.adj[1][self.dst[e]].remove(e)
+            self.live_edges -= 1
+
+    def counts(self) -> Tuple[int, int]:
+        return self.live_nodes, self.live_edges
+
+    def edges_of(self, n: int, direction: int, edge_type: int) -> List[int]:
+        found = []
+        for d in (0, 1):
+            if direction & (1 << d):
+                found += [e for e in self.adj[d][n] if edge_type == ANY_TYPE or self.type[e] == edge_type]
+        return found
+
+    def paths(self, src: int, dst: int, max_hops: int, limit: int) -> List[List[int]]:
+        if src == dst or self.gone[src] or self.gone[dst] or not max_hops or not limit:
+            return []
+        # Hops to dst, for nodes within max_hops - 1 of it; farther ones cannot be on a path
+        to_dst = {dst: 0}
+        level = [dst]
+        for hops in range(1, max_hops):
+            found = []
+            for v in level:
+                for e in self.adj[1][v]:
+                    if self.src[e] not in to_dst:
+                        to_dst[self.src[e]] = hops
+                        found.append(self.src[e])
+            level = found
+
+        paths: List[List[int]] = []
+        on_path = {src}
+        edges: List[int] = []
+
+        def candidates(u: int, depth: int) -> List[Tuple[int, int]]:
+            taken = {}
+            for e in self.adj[0][u]:
+                v = self.dst[e]
+                if v in taken or v in on_path:
+                    continue
+                taken[v] = e
+            return [(v, e) for v, e in taken.items()
+                    if depth + 1 + (0 if v == dst else to_dst.get(v, max_hops)) <= max_hops]
+
+        stack = [iter(candidates(src, 0))]
+        while stack:
+            for v, e in stack[-1]:
+                if v == dst:
+                    paths.append(edges + [e])
+                    if len(paths) == limit:
+                        return paths
+                    continue
+                edges.append(e)
+                on_path.add(v)
+                stack.append(iter(candidates(v, len(edges))))
+                break
+            else:
+                stack.pop()
+                if edges:
+                    on_path.discard(self.dst[edges.pop()])
+        return paths
+
+    def expand(self, seeds: array, hops: int, direction: int, edge_type: int) -> Tuple[List[int], List[int]]:
+        reached = {n: None for n in seeds if not self.gone[n]}
+        followed: Dict[int, None] = {}
+        frontier = list(reached)
+        for _ in range(hops):
+            if not frontier:
+                break
+            found = []
+            for u in frontier:
+                for d in (0, 1):
+                    if not direction & (1 << d):
+                        continue
+                    for e in self.adj[d][u]:
+                        if edge_type != ANY_TYPE and self.type[e] != edge_type:
+                            continue
+                        followed.setdefault(e)
+                        v = self.src[e] if d else self.dst[e]
+                        if v not in reached:
+                            reached[v] = None
+                            found.append(v)
+            frontier = found
+        return list(reached), list(followed)
+
+    def close(self) -> None:
+        pass
+
+
+class GraphIndex:
+    """Directed multigraph topology with string ids for nodes, edges and edge types"""
+
+    def __init__(self, threads: int = 0, library: Optional[str] = None):
+        """
+        Args:
+            threads: Workers for neighbourhood expansion (0 = one per CPU)
+            library: Path to libtekton-graph.so instead of the default lookup
+        """
+        lib = _load(library)
+        self._graph = _NativeGraph(lib, threads) if lib is not None else _PyGraph()
+        self._node_index: Dict[str, int] = {}
+        self._node_ids: List[Optional[str]] = []
+        self._edge_index: Dict[str, int] = {}
+        self._edge_ids: List[Optional[str]] = []
+        self._type_index: Dict[str, int] = {}
+
+    @property
+    def native(self) -> bool:
+        return isinstance(self._graph, _NativeGraph)
+
+    def node_count(self) -> int:
+        return self._graph.counts()[0]
+
+    def edge_count(self) -> int:
+        return self._graph.counts()[1]
+
+    def has_node(self, node_id: str) -> bool:
+        return node_id in self._node_index
+
+    def has_edge(self, edge_id: str) -> bool:
+        return edge_id in self._edge_index
+
+    def add_node(self, node_id: str) -> None:
+        self.add_nodes((node_id,))
+
+    def add_nodes(self, node_ids: Iterable[str]) -> None:
+        new = [n for n in dict.fromkeys(node_ids) if n not in self._node_index]
+        if new:
+            first = self._graph.add_nodes(len(new))
+            self._node_index.update(zip(new, range(first, first + len(new))))
+            self._node_ids.extend(new)
+
+    def remove_node(self, node_id: str) -> List[str]:
+        """Remove a node and its edges; returns the ids of those edges"""
+        n = self._node_index.pop(node_id, None)
+        if n is None:
+            return []
+        self._node_ids[n] = None
+        removed = []
+        for e in self._graph.remove_node(n):
+            edge_id = self._edge_ids[e]
+            self._edge_ids[e] = None
+            del self._edge_index[edge_id]
+            removed.append(edge_id)
+        return removed
+
+    def add_edge(self, edge_id: str, source: str, target: str, edge_type: str) -> None:
+        self.add_edges([(edge_id, source, target, edge_type)])
+
+    def add_edges(self, edges: Iterable[Tuple[str, str, str, str]]) -> None:
+        """Add (edge id, source, target, type) edges, creating missing nodes and replacing edges with the same id"""
+        batch = {edge_id: (source, target, edge_type) for edge_id, source, target, edge_type in edges}
+        if not batch:
+            return
+        for edge_id in batch.keys() & self._edge_index.keys():
+            self.remove_edge(edge_id)
+        sources, targets, types = zip(*batch.values())
+        self.add_nodes(sources + targets)
+        for edge_type in dict.fromkeys(types):
+            self._type_index.setdefault(edge_type, len(self._type_index))
+        nodes = self._node_index.__getitem__
+        src = array("I", map(nodes, sources))
+        dst = array("I", map(nodes, targets))
+        type_ids = array("I", map(self._type_index.__getitem__, types))
+        first = self._graph.add_edges(src, dst, type_ids)
+        assert first == len(self._edge_ids)
+        self._edge_ids.extend(batch)
+        self._edge_index.update(zip(batch, range(first, first + len(batch))))
+
+    def add_edge_columns(self, edge_ids: Sequence[str], node_ids: Sequence[str], sources: array,
+                         targets: array, type_names: Sequence[str], types: array) -> None:
+        """
+        Add edges given as columns, as a snapshot stores them: edge i runs
+        from node_ids[sources[i]] to node_ids[targets[i]] with type
+        type_names[types[i]]. The edge ids must be distinct. Loading into an
+        empty index skips interning the endpoints one by one.
+        """
+        for edge_id in self._edge_index.keys() & set(edge_ids):
+            self.remove_edge(edge_id)
+        self.add_nodes(node_ids)
+        nodes = array("I", map(self._node_index.__getitem__, node_ids))
+        for edge_type in type_names:
+            self._type_index.setdefault(edge_type, len(self._type_index))
+        type_map = array("I", map(self._type_index.__getitem__, type_names))
+        # Positions that already match the index need no remapping
+        if nodes != array("I", range(len(nodes))):
+            sources = array("I", map(nodes.__getitem__, sources))
+            targets = array("I", map(nodes.__getitem__, targets))
+        if type_map != array("I", range(len(type_map))):
+            types = array("I", map(type_map.__getitem__, types))
+        first = self._graph.add_edges(sources, targets, types)
+        assert first == len(self._edge_ids)
+        self._edge_ids.extend(edge_ids)
+        self._edge_index.update(zip(edge_ids, range(first, first + len(edge_ids))))
+
+    def remove_edge(self, edge_id: str) -> bool:
+        e = self._edge_index.pop(edge_id, None)
+        if e is None:
+            return False
+        self._edge_ids[e] = None
+        self._graph.remove_edge(e)
+        return True
+
+    def _type_filter(self, edge_type: Optional[str]) -> Optional[int]:
+        """The type index to match, ANY_TYPE, or None if no edge has that type"""
+        if edge_type is None:
+            return ANY_TYPE
+        return self._type_index.get(edge_type)
+
+    def edges(self, node_id: str, direction: str = "both", edge_type: Optional[str] = None) -> List[str]:
+        """Ids of a node's edges, outgoing before incoming (a self-loop appears in both)"""
+        n = self._node_index.get(node_id)
+        type_filter = self._type_filter(edge_type)
+        if n is None or type_filter is None:
+            return []
+        ids = self._edge_ids
+        return [ids[e] for e in self._graph.edges_of(n, DIRECTIONS[direction], type_filter)]
+
+    def paths(self, source: str, target: str, max_hops: int, limit: int = PATH_LIMIT) -> List[List[str]]:
+        """
+        Simple directed paths of at most max_hops edges, each a list of edge
+        ids, at most limit of them. Parallel edges count once, by the edge
+        added first.
+        """
+        src, dst = self._node_index.get(source), self._node_index.get(target)
+        if src is None or dst is None or max_hops <= 0:
+            return []
+        ids = self._edge_ids
+        return [[ids[e] for e in path] for path in self._graph.paths(src, dst, max_hops, limit)]
+
+    def neighborhood(self, seeds: Sequence[str], hops: int, direction: str = "both",
+                     edge_type: Optional[str] = None) -> Tuple[List[str], List[str]]:
+        """
+        Node ids within hops of the seeds (seeds first, then nearer before
+        farther) and the ids of the edges followed to reach them.
+        """
+        start = array("I", dict.fromkeys(self._node_index[s] for s in seeds if s in self._node_index))
+        type_filter = self._type_filter(edge_type)
+        if type_filter is None:
+            # No edge has that type: only the seeds are in reach
+            return [self._node_ids[n] for n in start], []
+        nodes, edges = self._graph.expand(start, hops, DIRECTIONS[direction], type_filter)
+        return [self._node_ids[n] for n in nodes], [self._edge_ids[e] for e in edges]
+
+    def close(self) -> None:
+        self._graph.close()
+
+    def __del__(self):
+        if hasattr(self, "_graph"):
+            self._graph.close()
@@ -0,0 +1,163 @@
+"""
+Hashing Text Embeddings
+
+ctypes binding for src/tekton-embed: every token gets a fixed pseudo-random
+vector computed from a hash of its bytes, so no vocabulary is kept and the
+same token maps to the same vector in every process. A text's embedding is
+the sum of its distinct tokens' vectors weighted by 1 / (1 + ln(count)).
+Engram's SimpleEmbedding encodes through this.
+
+The library encodes a batch on all CPUs straight into the caller's float32
+buffer. Without it, the same vectors are computed with NumPy (see
+tekton-embed.h for the definition both follow).
+
+    out = numpy.empty((len(texts), 128), dtype=numpy.float32)
+    encode_into(texts, out, 128)
+"""
+import ctypes
+import math
+import os
+import re
+from array import array
+from functools import lru_cache
+from itertools import accumulate
+from typing import List, Optional, Sequence
+
+EMBED_LIBRARY_ENV = "TEKTON_EMBED_LIBRARY"
+EMBED_SOURCE = os.path.join("src", "tekton-embed")
+LIBRARY_NAME = "libtekton-embed.so"
+
+# Word characters as the library sees them, for text that is already lower case
+TOKEN_PATTERN = re.compile("[0-9a-z_\u00c0-\u1fff\u2070-\U0010ffff]+")
+
+FNV_OFFSET = 0xcbf29ce484222325
+FNV_PRIME = 0x100000001b3
+MASK64 = (1 << 64) - 1
+COMPONENT_SCALE = math.sqrt(6) / 65536
+
+_lib = None
+
+
+def _default_root() -> str:
+    return os.environ.get("TEKTON_ROOT") or os.path.dirname(
+        os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+
+def _load(library: Optional[str] = None):
+    """The encoder library, or None if it has not been built"""
+    global _lib
+    if _lib is not None and library is None:
+        return _lib
+    path = library or os.environ.get(EMBED_LIBRARY_ENV) or os.path.join(
+        _default_root(), EMBED_SOURCE, LIBRARY_NAME)
+    try:
+        lib = ctypes.CDLL(path)
+    except OSError:
+        return None
+    lib.te_encode.restype = ctypes.c_int
+    lib.te_encode.argtypes = [ctypes.c_char_p, ctypes.c_void_p, ctypes.c_uint32, ctypes.c_uint32,
+                              ctypes.c_uint64, ctypes.c_int, ctypes.c_int, ctypes.c_void_p]
+    lib.te_token_hash.restype = ctypes.c_uint64
+    lib.te_token_hash.argtypes = [ctypes.c_char_p, ctypes.c_uint32, ctypes.c_uint64]
+    if library is None:
+        _lib = lib
+    return lib
+
+
+def native_available() -> bool:
+    return _load() is not None
+
+
+def _encode(text: str) -> bytes:
+    # surrogatepass keeps lone surrogates as word characters, as TOKEN_PATTERN does
+    return text.lower().encode("utf-8", "surrogatepass")
+
+
+def tokenize(text: str) -> List[bytes]:
+    """Tokens of a text as the encoder hashes them"""
+    return [token.encode("utf-8", "surrogatepass") for token in TOKEN_PATTERN.findall(text.lower())]
+
+
+@lru_cache(maxsize=65536)
+def token_hash(token: bytes, seed: int = 42) -> int:
+    h = FNV_OFFSET
+    for b in token:
+        h = ((h ^ b) * FNV_PRIME) & MASK64
+    h ^= (seed * 0x9E3779B97F4A7C15) & MASK64
+    h ^= h >> 30
+    h = (h * 0xbf58476d1ce4e5b9) & MASK64
+    h ^= h >> 27
+    h = (h * 0x94d049bb133111eb) & MASK64
+    return h ^ (h >> 31)
+
+
+def token_component(h: int, j: int) -> float:
+    """Component j of the vector for token hash h"""
+    x = (h & 0xffffffff) ^ ((j * 0x9E3779B9 + (h >> 32)) & 0xffffffff)
+    x ^= x >> 16
+    x = (x * 0x85ebca6b) & 0xffffffff
+    x ^= x >> 13
+    x = (x * 0xc2b2ae35) & 0xffffffff
+    x ^= x >> 16
+    return ((x & 0xffff) + (x >> 16) - 65535) * COMPONENT_SCALE
+
+
+def encode_into(texts: Sequence[str], out, dim: int, seed: int = 42,
+                normalize: bool = True, threads: int = 0,
+                library: Optional[str] = None) -> None:
+    """
+    Embed texts into out, a writable C-contiguous buffer of len(texts) x dim
+    float32 (a NumPy array or an array('f')). threads = 0 uses every CPU.
+    """
+    view = memoryview(out).cast("B")
+    if view.nbytes != len(texts) * dim * 4:
+        raise ValueError(f"output buffer holds {view.nbytes} bytes, "
+                         f"expected {len(texts)} x {dim} float32")
+    if not texts:
+        return
+    lib = _load(library)
+    if lib is None:
+        _encode_numpy(texts, out, dim, seed, normalize)
+        return
+
+    encoded = [_encode(text) for text in texts]
+    offsets = array("Q", [0])
+    offsets.extend(accumulate(len(e) for e in encoded))
+    offsets_address, _ = offsets.buffer_info()
+    target = (ctypes.c_char * view.nbytes).from_buffer(view)
+    result = lib.te_encode(b"".join(encoded), offsets_address, len(texts), dim,
+                           seed & MASK64, int(normalize), threads, ctypes.addressof(target))
+    del target
+    if result < 0:
+        raise OSError(-result, f"te_encode: {os.strerror(-result)}")
+
+
+def _encode_numpy(texts: Sequence[str], out, dim: int, seed: int, normalize: bool) -> None:
+    import numpy as np
+
+    rows = np.frombuffer(memoryview(out).cast("B"), dtype=np.float32).reshape(len(texts), dim)
+    j = np.arange(dim, dtype=np.uint32) * np.uint32(0x9E3779B9)
+    for i, text in enumerate(texts):
+        counts = {}
+        for token in tokenize(text):
+            counts[token] = counts.get(token, 0) + 1
+        if not counts:
+            rows[i] = 0
+            continue
+        hashes = np.array([token_hash(token, seed) for token in counts], dtype=np.uint64)
+        weights = np.array([1.0 / (1.0 + math.log(c)) for c in counts.values()],
+                           dtype=np.float64).astype(np.float32)
+        lo = (hashes & np.uint64(0xffffffff)).astype(np.uint32)
+        hi = (hashes >> np.uint64(32)).astype(np.uint32)
+        x = lo[:, None] ^ (j[None, :] + hi[:, None])
+        x ^= x >> np.uint32(16)
+        x *= np.uint32(0x85ebca6b)
+        x ^= x >> np.uint32(13)
+        x *= np.uint32(0xc2b2ae35)
+        x ^= x >> np.uint32(16)
+        t = (x & np.uint32(0xffff)).astype(np.int32) + (x >> np.uint32(16)).astype(np.int32) - 65535
+        vectors = t.astype(np.float32) * np.float32(COMPONENT_SCALE)
+        rows[i] = weights @ vectors
+    if normalize:
+        norms = np.linalg.norm(rows, axis=1, keepdims=True)
+        rows /= np.maximum(norms, 1e-10)
@@ -6,6 +6,7 @@ Provides standard registration functionality for components to register with Her
 import asyncio
 import aiohttp
 import logging
+import os
 from typing import Dict, Any, Optional, List
 from datetime import datetime
 
@@ -14,8 +15,20 @@ try:
 except ImportError:
     get_hermes_url = None
 
+from shared.utils.supervisor_channel import HEARTBEAT_INTERVAL, SupervisorChannel
+from shared.utils.launch_trace import component_trace
+
 logger = logging.getLogger(__name__)
 
+# Set by the launcher when it pre-registered this component in bulk
+PREREGISTERED_NAME_ENV = "TEKTON_HERMES_PREREGISTERED"
+PREREGISTERED_ID_ENV = "TEKTON_HERMES_COMPONENT_ID"
+PREREGISTERED_TOKEN_ENV = "TEKTON_HERMES_TOKEN"
+
+
+def _normalize_name(name: str) -> str:
+    return name.lower().replace('-', '_')
+
 
 class HermesRegistration:
     """Handles component registration with Hermes"""
@@ -29,7 +42,55 @@ class HermesRegistration:
             self.hermes_url = "http://localhost:8001"
         self.registration_data: Optional[Dict[str, Any]] = None
         self.is_registered = False
+        self.component_id: Optional[str] = None
+        self.token: Optional[str] = None
+        # Liveness goes to the launcher's supervisor when we were started by it
+        self.supervisor = SupervisorChannel.from_env()
+        # Reused for direct heartbeats so each tick doesn't open a new connection
+        self._session: Optional[aiohttp.ClientSession] = None
+        
+    async def confirm_preregistration(
+        self,
+        component_name: str,
+        version: str,
+        capabilities: List[str],
+        metadata: Optional[Dict[str, Any]] = None
+    ) -> bool:
+        """Confirm a registration the launcher made for us, if there is one"""
+        preregistered = os.environ.get(PREREGISTERED_NAME_ENV)
+        component_id = os.environ.get(PREREGISTERED_ID_ENV)
+        token = os.environ.get(PREREGISTERED_TOKEN_ENV)
+        if not (preregistered and component_id and token):
+            return False
+        if _normalize_name(preregistered) != _normalize_name(component_name):
+            return False
+        
+        try:
+            async with aiohttp.ClientSession() as session:
+                async with session.post(
+                    f"{self.hermes_url}/api/register/confirm",
+                    json={
+                        "component_id": component_id,
+                        "version": version,
+                        "capabilities": capabilities,
+                        "metadata": metadata or {}
+                    },
+                    headers={"X-Authentication-Token": token},
+                    timeout=5
+                ) as resp:
+                    if resp.status != 200:
+                        logger.info(f"Pre-registration for {component_name} not accepted (HTTP {resp.status})")
+                        return False
+        except Exception as e:
+            logger.debug(f"Could not confirm pre-registration: {e}")
+            return False
         
+        self.component_id = component_id
+        self.token = token
+        self.is_registered = True
+        logger.info(f"Confirmed launcher pre-registration of {component_name} with Hermes")
+        return True
+    
     async def register_component(
         self,
         component_name: str,
@@ -40,6 +101,20 @@ class HermesRegistration:
         metadata: Optional[Dict[str, Any]] = None
     ) -> bool:
         """Register a component with Hermes"""
+        with component_trace().span("hermes registration", cat="component", component=component_name):
+            return await self._register_component(
+                component_name, port, version, capabilities, health_endpoint, metadata
+            )
+    
+    async def _register_component(
+        self,
+        component_name: str,
+        port: int,
+        version: str,
+        capabilities: List[str],
+        health_endpoint: str,
+        metadata: Optional[Dict[str, Any]]
+    ) -> bool:
         try:
             # Prepare registration data matching the API schema
             registration_request = {
@@ -60,6 +135,10 @@ class HermesRegistration:
                 "registered_at": datetime.now().isoformat()
             }
             
+            # The launcher may already have registered us in bulk
+            if await self.confirm_preregistration(component_name, version, capabilities, metadata):
+                return True
+            
             registration_url = f"{self.hermes_url}/api/register"
             logger.info(f"Attempting to register {component_name} with Hermes at: {registration_url}")
             logger.debug(f"Registration data: {registration_request}")
@@ -78,6 +157,8 @@ class HermesRegistration:
                     if resp.status == 200:
                         result = await resp.json()
                         self.is_registered = True
+                        self.component_id = result.get("component_id", component_name)
+                        self.token = result.get("token")
                         logger.info(f"Successfully registered {component_name} with Hermes")
                         # DEBUG: Write to file
                         with open(f"/tmp/{component_name}_registration_debug.txt", "a") as f:
@@ -105,28 +186,47 @@ class HermesRegistration:
             return False
     
     async def heartbeat(self, component_name: str, status: str = "healthy") -> bool:
-        """Send heartbeat to Hermes"""
+        """Send heartbeat to Hermes (relayed through the supervisor when available)"""
         if not self.is_registered:
             return False
+        
+        if self.supervisor and self.supervisor.report(
+            component_name,
+            status=status,
+            component_id=self.component_id,
+            token=self.token
+        ):
+            return True
             
         try:
             heartbeat_data = {
-                "component_id": component_name,
+                "component_id": self.component_id or component_name,
                 "status": {"health": status}
             }
+            headers = {"X-Authentication-Token": self.token} if self.token else {}
             
-            async with aiohttp.ClientSession() as session:
-                async with session.post(
-                    f"{self.hermes_url}/api/heartbeat",
-                    json=heartbeat_data,
-                    timeout=2
-                ) as resp:
-                    return resp.status == 200
+            if self._session is None or self._session.closed:
+                self._session = aiohttp.ClientSession()
+            async with self._session.post(
+                f"{self.hermes_url}/api/heartbeat",
+                json=heartbeat_data,
+                headers=headers,
+                timeout=2
+            ) as resp:
+                return resp.status == 200
                     
         except Exception as e:
             logger.debug(f"Heartbeat failed: {e}")
             return False
     
+    async def close(self):
+        """Release the heartbeat session and supervisor channel"""
+        if self._session and not self._session.closed:
+            await self._session.close()
+        self._session = None
+        if self.supervisor:
+            self.supervisor.close()
+    
     async def deregister(self, component_name: str) -> bool:
         """Deregister from Hermes"""
         if not self.is_registered:
@@ -148,6 +248,8 @@ class HermesRegistration:
         except Exception as e:
             logger.debug(f"Deregistration failed: {e}")
             return False
+        finally:
+            await self.close()
 
 
 async def register_with_hermes(
@@ -174,7 +276,7 @@ async def register_with_hermes(
 async def heartbeat_loop(
     registration: HermesRegistration,
     component_name: str,
-    interval: int = 30
+    interval: float = HEARTBEAT_INTERVAL
 ):
     """Send periodic heartbeats to Hermes"""
     while registration.is_registered:
@@ -0,0 +1,256 @@
+"""
+Streaming Reverse Proxy
+
+Forwards requests received by an http.server handler to HTTP backends:
+
+- Routes are matched by longest prefix (or exactly), optionally rewriting
+  the prefix, so a table of them replaces a chain of startswith() checks.
+- Each backend keeps a small pool of idle keep-alive connections. One that
+  the backend closed while idle is noticed on reuse and the request is sent
+  again on a new connection, provided its body was small enough to keep and
+  either the request was not fully written yet or its method is idempotent:
+  a POST the backend may already have processed is never sent twice.
+- Request bodies and responses are copied in pieces as they arrive. A
+  response without a Content-Length (chunked, server-sent events) is passed
+  on chunk by chunk, so streamed tokens reach the browser as the backend
+  produces them.
+
+    proxy = StreamingProxy(RouteTable([Route("/api/ai/", "localhost", 8003)]))
+    route = proxy.routes.match(handler.path)
+    if route:
+        proxy.forward(handler, route)
+"""
+import http.client
+import logging
+import threading
+import time
+from dataclasses import dataclass
+from typing import Dict, Iterable, Iterator, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+# Headers that describe one connection, not the message
+HOP_HEADERS = frozenset(("connection", "keep-alive", "proxy-connection", "proxy-authenticate",
+                         "proxy-authorization", "te", "trailer", "transfer-encoding", "upgrade"))
+STREAM_CHUNK = 65536
+# Request bodies up to this size are read before sending, so they can be resent
+REPLAYABLE_BODY = 65536
+# Safe to send again after the backend may have processed them (RFC 9110 9.2.2)
+IDEMPOTENT_METHODS = frozenset(("GET", "HEAD", "OPTIONS", "PUT", "DELETE"))
+
+
+@dataclass(frozen=True)
+class Route:
+    """Requests under prefix go to host:port, with prefix replaced by rewrite if given"""
+    prefix: str
+    host: str
+    port: int
+    rewrite: Optional[str] = None
+    exact: bool = False
+
+    def matches(self, path: str) -> bool:
+        if self.exact:
+            return path.split("?", 1)[0] == self.prefix
+        return path.startswith(self.prefix)
+
+    def target(self, path: str) -> str:
+        """The path to request from the backend"""
+        if self.rewrite is None:
+            return path
+        return self.rewrite + path[len(self.prefix):]
+
+
+class RouteTable:
+    """Routes tried longest prefix first"""
+
+    def __init__(self, routes: Iterable[Route]):
+        self._routes: List[Route] = sorted(routes, key=lambda r: (len(r.prefix), r.exact), reverse=True)
+
+    def match(self, path: str) -> Optional[Route]:
+        for route in self._routes:
+            if route.matches(path):
+                return route
+        return None
+
+    def __iter__(self) -> Iterator[Route]:
+        return iter(self._routes)
+
+
+class ConnectionPool:
+    """Idle keep-alive connections to one backend"""
+
+    def __init__(self, host: str, port: int, max_idle: int = 8,
+                 idle_timeout: float = 4.0, timeout: Optional[float] = 300.0):
+        """
+        Args:
+            max_idle: Connections kept for reuse; more are closed on release
+            idle_timeout: Seconds a connection may sit idle before it is
+                discarded (below uvicorn's 5 s keep-alive)
+            timeout: Socket timeout for requests
+        """
+        self.host = host
+        self.port = port
+        self.max_idle = max_idle
+        self.idle_timeout = idle_timeout
+        self.timeout = timeout
+        self._idle: List[Tuple[float, http.client.HTTPConnection]] = []
+        self._lock = threading.Lock()
+
+    def connect(self) -> http.client.HTTPConnection:
+        return http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+
+    def acquire(self) -> Tuple[http.client.HTTPConnection, bool]:
+        """A connection and whether it was reused"""
+        now = time.monotonic()
+        with self._lock:
+            while self._idle:
+                since, conn = self._idle.pop()
+                if now - since < self.idle_timeout:
+                    return conn, True
+                conn.close()
+        return self.connect(), False
+
+    def release(self, conn: http.client.HTTPConnection) -> None:
+        with self._lock:
+            if len(self._idle) < self.max_idle:
+                self._idle.append((time.monotonic(), conn))
+                return
+        conn.close()
+
+    def close(self) -> None:
+        with self._lock:
+            idle, self._idle = self._idle, []
+        for _, conn in idle:
+            conn.close()
+
+
+class StreamingProxy:
+    """Forwards handler requests along a route table, one pool per backend"""
+
+    def __init__(self, routes: RouteTable, max_idle: int = 8, timeout: Optional[float] = 300.0):
+        self.routes = routes
+        self.max_idle = max_idle
+        self.timeout = timeout
+        self._pools: Dict[Tuple[str, int], ConnectionPool] = {}
+        self._lock = threading.Lock()
+
+    def pool(self, host: str, port: int) -> ConnectionPool:
+        with self._lock:
+            pool = self._pools.get((host, port))
+            if pool is None:
+                pool = self._pools[(host, port)] = ConnectionPool(
+                    host, port, self.max_idle, timeout=self.timeout)
+            return pool
+
+    def close(self) -> None:
+        with self._lock:
+            pools, self._pools = list(self._pools.values()), {}
+        for pool in pools:
+            pool.close()
+
+    def forward(self, handler, route: Route) -> None:
+        """
+        Send handler's request to route's backend and stream the response
+        back. Answers 502 itself if the backend cannot be reached.
+        """
+        if "chunked" in handler.headers.get("Transfer-Encoding", "").lower():
+            handler.send_error(411, "Length Required")
+            return
+        length = int(handler.headers.get("Content-Length") or 0)
+        headers = [(name, value) for name, value in handler.headers.items()
+                   if name.lower() not in HOP_HEADERS
+                   and name.lower() not in ("host", "content-length", "x-forwarded-for")]
+        headers.append(("Host", f"{route.host}:{route.port}"))
+        forwarded = handler.headers.get("X-Forwarded-For")
+        client = handler.client_address[0]
+        headers.append(("X-Forwarded-For", f"{forwarded}, {client}" if forwarded else client))
+        if length:
+            headers.append(("Content-Length", str(length)))
+        body = handler.rfile.read(length) if length <= REPLAYABLE_BODY else None
+
+        pool = self.pool(route.host, route.port)
+        path = route.target(handler.path)
+        try:
+            conn, response = self._send(pool, handler, path, headers, body, length)
+        except (OSError, http.client.HTTPException) as e:
+            logger.warning(f"Backend {route.host}:{route.port} failed for {handler.command} {path}: {e}")
+            handler.close_connection = True
+            handler.send_error(502, f"Backend unavailable: {e}")
+            return
+        self._relay(handler, pool, conn, response)
+
+    def _send(self, pool: ConnectionPool, handler, path: str, headers: List[Tuple[str, str]],
+              body: Optional[bytes], length: int):
+        """Send the request, moving on to another connection if a pooled one had gone stale"""
+        while True:
+            conn, reused = pool.acquire() if body is not None else (pool.connect(), False)
+            written = False
+            try:
+                conn.putrequest(handler.command, path, skip_host=True, skip_accept_encoding=True)
+                for name, value in headers:
+                    conn.putheader(name, value)
+                conn.endheaders()
+                if body:
+                    conn.send(body)
+                elif length:
+                    remaining = length
+                    while remaining:
+                        data = handler.rfile.read(min(STREAM_CHUNK, remaining))
+                        if not data:
+                            raise ConnectionError("client closed during the request body")
+                        conn.send(data)
+                        remaining -= len(data)
+                written = True
+                return conn, conn.getresponse()
+            except (http.client.RemoteDisconnected, ConnectionResetError, BrokenPipeError):
+                conn.close()
+                if not reused or (written and handler.command not in IDEMPOTENT_METHODS):
+                    raise
+            except BaseException:
+                conn.close()
+                raise
+
+    def _relay(self, handler, pool: ConnectionPool, conn: http.client.HTTPConnection,
+               response: http.client.HTTPResponse) -> None:
+        status = response.status
+        no_body = handler.command == "HEAD" or status in (204, 304) or 100 <= status < 200
+        # Chunking needs both ends on HTTP/1.1: the client's request and the status line we send
+        chunked = (not no_body and response.length is None and handler.request_version == "HTTP/1.1"
+                   and handler.protocol_version == "HTTP/1.1")
+        if not no_body and response.length is None and not chunked:
+            handler.close_connection = True  # the body ends when the connection does
+
+        handler.log_request(status)
+        handler.send_response_only(status, response.reason)
+        for name, value in response.getheaders():
+            if name.lower() not in HOP_HEADERS:
+                handler.send_header(name, value)
+        if chunked:
+            handler.send_header("Transfer-Encoding", "chunked")
+        if handler.close_connection:
+            handler.send_header("Connection", "close")
+        handler.end_headers()
+
+        try:
+            while True:
+                data = response.read1(STREAM_CHUNK)
+                if not data:
+                    break
+                if chunked:
+                    handler.wfile.write(b"%x\r\n%s\r\n" % (len(data), data))
+                else:
+                    handler.wfile.write(data)
+            if chunked:
+                handler.wfile.write(b"0\r\n\r\n")
+        except (OSError, http.client.HTTPException) as e:
+            # Either side went away mid-response; neither connection can be reused
+            logger.info(f"Proxied response cut short: {e}")
+            conn.close()
+            handler.close_connection = True
+            return
+        # read1() leaves a drained Content-Length response open, which blocks the next request
+        response.close()
+        if response.will_close:
+            conn.close()
+        else:
+            pool.release(conn)
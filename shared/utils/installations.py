@@ -0,0 +1,163 @@
+"""
+Tekton Installation Registry
+
+Read-only access to the till registry of Tekton installations on this host
+(~/.till/tekton/till-private.json) and to each installation's environment
+files. Lets host-wide tools look at every installation from one process
+instead of running `tekton <name> ...` once per installation.
+"""
+import json
+import logging
+import os
+import struct
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional
+
+import yaml
+
+from shared.env import _load_env_file
+
+logger = logging.getLogger(__name__)
+
+TILL_REGISTRY_FILE = Path("tekton") / "till-private.json"
+
+# Host-wide port block leases maintained by the C launcher (tekton-clean-launch.c)
+PORT_BLOCK_FILE = Path(".till") / "tekton" / "port-blocks.bin"
+PORT_BLOCK_MAGIC = b"TKPB"
+PORT_BLOCK_VERSION = 2
+_PORT_TABLE_HEADER = struct.Struct("<4sIII")
+_PORT_LEASE = struct.Struct("<iIIIIiq1024s")
+
+
+@dataclass
+class PortLease:
+    """Blocks leased to an installation, and the configured blocks they replace"""
+    port_base: int
+    ai_port_base: int
+    configured_base: int
+    configured_ai_base: int
+
+
+@dataclass
+class Installation:
+    """A registered Tekton installation"""
+    name: str
+    root: str
+
+    @property
+    def short_name(self) -> str:
+        """Registry names look like coder-a.tekton.development.us"""
+        return self.name.split('.')[0]
+
+
+def till_registry_path() -> Path:
+    """Registry location, honoring a .till symlink in the current directory like the C launcher"""
+    local_till = Path(".till")
+    if local_till.is_symlink():
+        return Path(os.readlink(local_till)) / TILL_REGISTRY_FILE
+    return Path.home() / ".till" / TILL_REGISTRY_FILE
+
+
+def list_installations(registry_path: Optional[Path] = None) -> List[Installation]:
+    """All installations in the till registry that still exist on disk"""
+    path = registry_path or till_registry_path()
+    try:
+        with open(path) as f:
+            registry = json.load(f)
+    except (OSError, ValueError) as e:
+        logger.debug(f"Could not read till registry {path}: {e}")
+        return []
+
+    installations = []
+    for name, info in (registry.get("installations") or {}).items():
+        root = info.get("root") if isinstance(info, dict) else None
+        if root and os.path.exists(os.path.join(root, ".env.tekton")):
+            installations.append(Installation(name=name, root=root))
+    return sorted(installations, key=lambda inst: inst.name)
+
+
+def read_port_leases() -> Dict[str, PortLease]:
+    """Installation root -> its lease from the host lease table"""
+    path = Path.home() / PORT_BLOCK_FILE
+    try:
+        data = path.read_bytes()
+    except OSError:
+        return {}
+    if len(data) < _PORT_TABLE_HEADER.size:
+        return {}
+    magic, version, slot_count, _block_size = _PORT_TABLE_HEADER.unpack_from(data, 0)
+    if magic != PORT_BLOCK_MAGIC or version != PORT_BLOCK_VERSION:
+        return {}
+
+    leases = {}
+    for i in range(slot_count):
+        offset = _PORT_TABLE_HEADER.size + i * _PORT_LEASE.size
+        if offset + _PORT_LEASE.size > len(data):
+            break
+        (in_use, port_base, ai_port_base, configured_base, configured_ai_base,
+         _pid, _last_used, root) = _PORT_LEASE.unpack_from(data, offset)
+        if in_use:
+            leases[root.split(b"\0", 1)[0].decode("utf-8", "replace")] = PortLease(
+                port_base, ai_port_base, configured_base, configured_ai_base)
+    return leases
+
+
+def _apply_port_lease(env: Dict[str, str], lease: PortLease, block_size: int = 100):
+    """
+    Shift configured ports into the leased blocks, mirroring remap_block_ports() in C.
+
+    A lease granted for other configured blocks is ignored, as the launcher
+    does until the next `tekton start` leases again.
+    """
+    try:
+        cfg_base = int(env["TEKTON_PORT_BASE"])
+        cfg_ai_base = int(env["TEKTON_AI_PORT_BASE"])
+    except (KeyError, ValueError):
+        return
+    if (lease.configured_base, lease.configured_ai_base) != (cfg_base, cfg_ai_base):
+        return
+    port_base, ai_port_base = lease.port_base, lease.ai_port_base
+    if (port_base, ai_port_base) == (cfg_base, cfg_ai_base):
+        return
+    for key, value in list(env.items()):
+        if not key.endswith("_PORT") or not value.isdigit():
+            continue
+        port = int(value)
+        if cfg_ai_base <= port < cfg_ai_base + block_size:
+            env[key] = str(ai_port_base + port - cfg_ai_base)
+        elif cfg_base <= port < cfg_base + block_size:
+            env[key] = str(port_base + port - cfg_base)
+    env["TEKTON_PORT_BASE"] = str(port_base)
+    env["TEKTON_AI_PORT_BASE"] = str(ai_port_base)
+
+
+def load_installation_env(root: str, leases: Optional[Dict[str, PortLease]] = None) -> Dict[str, str]:
+    """
+    Merge an installation's environment files the same way the launcher does:
+    ~/.env, then $root/.env.tekton, then $root/.env.local, then the host
+    port block lease if the launcher had to move this installation.
+    """
+    env: Dict[str, str] = {"TEKTON_ROOT": root}
+    for env_file in (Path.home() / ".env",
+                     Path(root) / ".env.tekton",
+                     Path(root) / ".env.local"):
+        if env_file.exists():
+            _load_env_file(env_file, env)
+    if leases is None:
+        leases = read_port_leases()
+    if root in leases and env.get("TEKTON_PORT_ALLOCATOR") != "0":
+        _apply_port_lease(env, leases[root])
+    return env
+
+
+def load_installation_components(root: str) -> List[str]:
+    """Component ids from an installation's tekton_components.yaml"""
+    config_path = Path(root) / "config" / "tekton_components.yaml"
+    try:
+        with open(config_path) as f:
+            config = yaml.safe_load(f) or {}
+    except (OSError, yaml.YAMLError) as e:
+        logger.debug(f"Could not read {config_path}: {e}")
+        return []
+    return list((config.get("components") or {}).keys())
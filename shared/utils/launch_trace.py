@@ -0,0 +1,165 @@
+"""
+Launch Timeline Tracing
+
+`tekton start --trace trace.json` records what the launcher and the
+components it starts spend their time on, in Chrome trace-event format
+(open in Perfetto or chrome://tracing).
+
+The launcher keeps its own events in memory. Components it starts find
+TEKTON_TRACE_FILE in their environment and append their events to that
+file as one JSON object per line; small O_APPEND writes keep concurrent
+writers from interleaving. When the launch finishes the launcher merges
+both into the output file.
+
+Timestamps come from CLOCK_MONOTONIC, which every process on the host
+shares, so launcher and component events line up without clock exchange.
+When tracing is off every call is a cheap no-op.
+"""
+import json
+import os
+import threading
+import time
+from contextlib import contextmanager
+from typing import Any, Dict, List, Optional
+
+TRACE_FILE_ENV = "TEKTON_TRACE_FILE"
+# When the launcher forked the component, for the component's import span
+TRACE_SPAWN_ENV = "TEKTON_TRACE_SPAWN_US"
+
+LAUNCHER_TRACK = "launcher"
+
+
+def now_us() -> int:
+    return time.monotonic_ns() // 1000
+
+
+class LaunchTrace:
+    """
+    Trace event recorder.
+
+    In the launcher (output_path set) events are buffered and tracks are
+    named per component. In a component (events_path from the
+    environment) events are appended to the shared events file.
+    """
+
+    def __init__(self, output_path: Optional[str] = None, events_path: Optional[str] = None,
+                 process_name: Optional[str] = None):
+        self.output_path = output_path
+        self.events_path = events_path or (output_path + ".events" if output_path else None)
+        self.enabled = self.events_path is not None
+        self.pid = os.getpid()
+        self.events: List[Dict[str, Any]] = []
+        self.tracks: Dict[str, int] = {}
+        self.lock = threading.Lock()
+        self.fd: Optional[int] = None
+
+        if not self.enabled:
+            return
+        if output_path:
+            # Fresh events file for this launch
+            open(self.events_path, "w").close()
+            self._metadata("process_name", {"name": "tekton launcher"})
+            self.track(LAUNCHER_TRACK)
+        else:
+            self.fd = os.open(self.events_path, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o644)
+            self._metadata("process_name", {"name": process_name or f"pid {self.pid}"})
+
+    @classmethod
+    def from_env(cls, process_name: Optional[str] = None) -> "LaunchTrace":
+        """Component-side tracer; disabled unless the launcher is tracing"""
+        return cls(events_path=os.environ.get(TRACE_FILE_ENV), process_name=process_name)
+
+    def child_env(self) -> Dict[str, str]:
+        """Variables that let a child process join the trace"""
+        if not self.enabled:
+            return {}
+        return {TRACE_FILE_ENV: self.events_path, TRACE_SPAWN_ENV: str(now_us())}
+
+    def track(self, name: str) -> int:
+        """Thread id of the named track (one per component in the launcher)"""
+        if self.fd is not None:
+            return threading.get_native_id()
+        with self.lock:
+            if name not in self.tracks:
+                self.tracks[name] = len(self.tracks) + 1
+                self.events.append({"ph": "M", "name": "thread_name", "pid": self.pid,
+                                    "tid": self.tracks[name], "args": {"name": name}})
+            return self.tracks[name]
+
+    def _metadata(self, name: str, args: Dict[str, Any]):
+        self._emit({"ph": "M", "name": name, "pid": self.pid, "tid": 0, "args": args})
+
+    def _emit(self, event: Dict[str, Any]):
+        if self.fd is not None:
+            try:
+                os.write(self.fd, (json.dumps(event) + "\n").encode("utf-8"))
+            except OSError:
+                pass
+        else:
+            with self.lock:
+                self.events.append(event)
+
+    def complete(self, name: str, start_us: int, end_us: Optional[int] = None,
+                 cat: str = "launch", track: str = LAUNCHER_TRACK, **args):
+        """A finished span"""
+        if not self.enabled:
+            return
+        end_us = now_us() if end_us is None else end_us
+        self._emit({"ph": "X", "name": name, "cat": cat, "ts": start_us,
+                    "dur": max(0, end_us - start_us), "pid": self.pid,
+                    "tid": self.track(track), "args": args})
+
+    def instant(self, name: str, cat: str = "launch", track: str = LAUNCHER_TRACK, **args):
+        """A point in time, such as a first log line"""
+        if not self.enabled:
+            return
+        self._emit({"ph": "i", "s": "t", "name": name, "cat": cat, "ts": now_us(),
+                    "pid": self.pid, "tid": self.track(track), "args": args})
+
+    @contextmanager
+    def span(self, name: str, cat: str = "launch", track: str = LAUNCHER_TRACK, **args):
+        """Time the enclosed block; usable around awaits as well"""
+        if not self.enabled:
+            yield
+            return
+        start = now_us()
+        try:
+            yield
+        finally:
+            self.complete(name, start, cat=cat, track=track, **args)
+
+    def write(self) -> Optional[str]:
+        """Merge component events into the launcher's and write the trace"""
+        if not self.output_path:
+            return None
+        events = list(self.events)
+        try:
+            with open(self.events_path) as f:
+                for line in f:
+                    try:
+                        events.append(json.loads(line))
+                    except ValueError:
+                        continue
+            os.remove(self.events_path)
+        except OSError:
+            pass
+        with open(self.output_path, "w") as f:
+            json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
+        return self.output_path
+
+    def close(self):
+        if self.fd is not None:
+            os.close(self.fd)
+            self.fd = None
+            self.enabled = False
+
+
+_component_trace: Optional[LaunchTrace] = None
+
+
+def component_trace() -> LaunchTrace:
+    """Process-wide tracer for component code"""
+    global _component_trace
+    if _component_trace is None:
+        _component_trace = LaunchTrace.from_env(os.environ.get("TEKTON_NAME"))
+    return _component_trace
@@ -0,0 +1,434 @@
+"""
+Component Log Segment Index
+
+The launcher's log writer splits each component log into segments of about
+SEGMENT_BYTES and appends one fixed-size record per closed segment to
+<component>.log.idx next to the log:
+
+    header   magic "TKLI", version, record size, log file inode
+    record   start offset, end offset, first/last timestamp (epoch),
+             line count, DEBUG/INFO/WARNING/ERROR/CRITICAL line counts,
+             BLOOM_BYTES bloom filter over lowercased byte trigrams
+
+`tekton logs --grep PATTERN --since 1h --level ERROR` uses the records to
+skip segments that cannot contain a match (too old, no lines at the
+requested level, or missing one of the pattern's required trigrams) and
+scans the rest. Bytes not covered by a record, such as the segment still
+being written or logs from before indexing, are always scanned.
+
+One writer per log is assumed, which is how the launcher writes them.
+"""
+import os
+import re
+import struct
+import threading
+import time
+import zlib
+from concurrent.futures import ProcessPoolExecutor
+from datetime import datetime
+from typing import List, Optional, Set, Tuple
+
+try:
+    import re._parser as sre_parse
+    from re._constants import LITERAL, SUBPATTERN, MAX_REPEAT, MIN_REPEAT
+except ImportError:  # Python < 3.11
+    import sre_parse
+    from sre_constants import LITERAL, SUBPATTERN, MAX_REPEAT, MIN_REPEAT
+
+INDEX_MAGIC = b"TKLI"
+INDEX_VERSION = 2
+INDEX_SUFFIX = ".idx"
+
+SEGMENT_BYTES = 1 << 20
+# Also close quiet segments so slow logs become searchable
+SEGMENT_MAX_AGE = 300.0
+BLOOM_BYTES = 32 * 1024
+BLOOM_BITS = BLOOM_BYTES * 8
+
+LEVELS = ("DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL")
+_LEVEL_ALIASES = {b"WARN": 2, b"FATAL": 4}
+_LEVEL_RE = re.compile(rb"\b(DEBUG|INFO|WARNING|WARN|ERROR|CRITICAL|FATAL)\b")
+# Levels appear near the start of launcher and Python logging lines
+_LEVEL_SCAN = 96
+
+_TIMESTAMP = re.compile(rb"^(\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2})")
+
+_HEADER = struct.Struct("<4sHHQ")
+_RECORD = struct.Struct("<QQddI5I")
+RECORD_SIZE = _RECORD.size + BLOOM_BYTES
+
+
+def index_path(log_path: str) -> str:
+    return log_path + INDEX_SUFFIX
+
+
+def line_level(line: bytes) -> int:
+    """Index into LEVELS for a log line, or -1 if it names none"""
+    match = _LEVEL_RE.search(line, 0, _LEVEL_SCAN)
+    if not match:
+        return -1
+    word = match.group(1)
+    if word in _LEVEL_ALIASES:
+        return _LEVEL_ALIASES[word]
+    return LEVELS.index(word.decode("ascii"))
+
+
+def _stamp_epoch(stamp: Optional[bytes]) -> float:
+    if not stamp:
+        return 0.0
+    return datetime.strptime(stamp.decode("ascii"), "%Y-%m-%d %H:%M:%S").timestamp()
+
+
+def _bloom_positions(trigram: bytes) -> Tuple[int, int]:
+    """Two bit positions per trigram; stable across processes, unlike hash()"""
+    # crc32 and FNV-1a over the bytes, each with its high bits folded into
+    # the low ones the modulus keeps
+    h1 = zlib.crc32(trigram)
+    h2 = 0x811C9DC5
+    for byte in trigram:
+        h2 = ((h2 ^ byte) * 0x01000193) & 0xFFFFFFFF
+    return (h1 ^ (h1 >> 18)) % BLOOM_BITS, (h2 ^ (h2 >> 18)) % BLOOM_BITS
+
+
+def trigrams(data: bytes) -> Set[bytes]:
+    data = data.lower()
+    return {data[i:i + 3] for i in range(len(data) - 2)}
+
+
+class LogIndexWriter:
+    """
+    Writes log lines and maintains the segment index for one log file.
+
+    Shared by a component's stdout and stderr readers, so writes go
+    through a lock to keep offsets and segment contents in step.
+    """
+
+    def __init__(self, log_file, log_path: str):
+        self.log_file = log_file
+        self.log_path = log_path
+        self.lock = threading.Lock()
+        self.log_file.flush()
+        st = os.stat(log_path)
+        self.offset = st.st_size
+        self.index_file = self._open_index(st)
+        self._reset_segment()
+
+    def _open_index(self, st):
+        path = index_path(self.log_path)
+        f = open(path, "a+b")
+        f.seek(0)
+        header = f.read(_HEADER.size)
+        valid = False
+        if len(header) == _HEADER.size:
+            magic, version, record_size, inode = _HEADER.unpack(header)
+            valid = (magic == INDEX_MAGIC and version == INDEX_VERSION
+                     and record_size == RECORD_SIZE and inode == st.st_ino)
+            if valid:
+                # Records must not claim bytes the log no longer has
+                size = f.seek(0, os.SEEK_END)
+                if size > _HEADER.size and (size - _HEADER.size) % RECORD_SIZE == 0:
+                    f.seek(size - RECORD_SIZE)
+                    _start, end = struct.unpack("<QQ", f.read(16))
+                    valid = end <= st.st_size
+                else:
+                    valid = size == _HEADER.size
+        if not valid:
+            f.truncate(0)
+            f.write(_HEADER.pack(INDEX_MAGIC, INDEX_VERSION, RECORD_SIZE, st.st_ino))
+            f.flush()
+        f.seek(0, os.SEEK_END)
+        return f
+
+    def _reset_segment(self):
+        self.segment_start = self.offset
+        self.segment_opened = time.time()
+        self.first_stamp = None
+        self.last_stamp = None
+        self.line_count = 0
+        self.level_counts = [0] * len(LEVELS)
+        self.last_level = -1
+        self.grams: Set[bytes] = set()
+
+    def write(self, text: str):
+        """Append a line (with its newline) to the log and index it"""
+        raw = text.encode("utf-8")
+        with self.lock:
+            self.log_file.write(text)
+            self.log_file.flush()
+            self.offset += len(raw)
+            stripped = raw.rstrip(b"\n")
+            if stripped:
+                self._observe(stripped)
+            if (self.offset - self.segment_start >= SEGMENT_BYTES or
+                    time.time() - self.segment_opened >= SEGMENT_MAX_AGE):
+                self._close_segment()
+
+    def _observe(self, line: bytes):
+        self.line_count += 1
+        match = _TIMESTAMP.match(line)
+        if match:
+            if self.first_stamp is None:
+                self.first_stamp = match.group(1)
+            self.last_stamp = match.group(1)
+            self.last_level = line_level(line)
+        # Continuation lines (tracebacks) belong to the record before them
+        if self.last_level >= 0:
+            self.level_counts[self.last_level] += 1
+        lowered = line.lower()
+        self.grams.update(lowered[i:i + 3] for i in range(len(lowered) - 2))
+
+    def _close_segment(self):
+        if self.offset == self.segment_start:
+            self.segment_opened = time.time()
+            return
+        bloom = bytearray(BLOOM_BYTES)
+        for gram in self.grams:
+            for bit in _bloom_positions(gram):
+                bloom[bit >> 3] |= 1 << (bit & 7)
+        record = _RECORD.pack(
+            self.segment_start, self.offset,
+            _stamp_epoch(self.first_stamp), _stamp_epoch(self.last_stamp),
+            self.line_count, *self.level_counts
+        )
+        self.index_file.write(record + bytes(bloom))
+        self.index_file.flush()
+        self._reset_segment()
+
+    def flush(self):
+        """Index whatever has been written so far; writing may continue"""
+        with self.lock:
+            self._close_segment()
+
+    def close(self):
+        self.flush()
+        self.index_file.close()
+
+
+class SegmentRecord:
+    """One indexed segment as read back by the searcher"""
+
+    __slots__ = ("start", "end", "first_ts", "last_ts", "lines", "levels", "bloom")
+
+    def __init__(self, data: bytes):
+        fields = _RECORD.unpack_from(data, 0)
+        self.start, self.end, self.first_ts, self.last_ts, self.lines = fields[:5]
+        self.levels = fields[5:]
+        self.bloom = data[_RECORD.size:_RECORD.size + BLOOM_BYTES]
+
+    def may_contain(self, grams: Set[bytes]) -> bool:
+        bloom = self.bloom
+        for gram in grams:
+            for bit in _bloom_positions(gram):
+                if not bloom[bit >> 3] & (1 << (bit & 7)):
+                    return False
+        return True
+
+
+def read_index(log_path: str) -> List[SegmentRecord]:
+    """Segment records for a log, or [] if missing or not for this file"""
+    try:
+        st = os.stat(log_path)
+        with open(index_path(log_path), "rb") as f:
+            data = f.read()
+    except OSError:
+        return []
+    if len(data) < _HEADER.size:
+        return []
+    magic, version, record_size, inode = _HEADER.unpack_from(data, 0)
+    if magic != INDEX_MAGIC or version != INDEX_VERSION or record_size != RECORD_SIZE or inode != st.st_ino:
+        return []
+    records = []
+    for offset in range(_HEADER.size, len(data) - RECORD_SIZE + 1, RECORD_SIZE):
+        record = SegmentRecord(data[offset:offset + RECORD_SIZE])
+        if record.end > st.st_size:
+            break
+        records.append(record)
+    return records
+
+
+def required_literals(pattern: str, ignore_case: bool = False) -> List[bytes]:
+    """
+    Literal runs every match of a regex must contain.
+
+    Only top-level concatenation is considered; anything inside
+    alternation or optional repeats just ends the current run, so the
+    result is always safe to filter on.
+    """
+    try:
+        parsed = sre_parse.parse(pattern, re.IGNORECASE if ignore_case else 0)
+    except re.error:
+        return []
+
+    runs, current = [], []
+
+    def end_run():
+        if current:
+            runs.append("".join(current))
+            current.clear()
+
+    def walk(items):
+        for op, arg in items:
+            if op is LITERAL:
+                current.append(chr(arg))
+            elif op is SUBPATTERN:
+                walk(arg[-1])
+            elif op in (MAX_REPEAT, MIN_REPEAT) and arg[0] >= 1:
+                # x+ / x{2,}: the body is required once, the rest is not adjacent
+                end_run()
+                walk(arg[2])
+                end_run()
+            else:
+                end_run()
+
+    walk(parsed)
+    end_run()
+    # The index lowercases ASCII only; other case folding could hide a match
+    if ignore_case:
+        runs = [run for run in runs if run.isascii()]
+    return [run.encode("utf-8") for run in runs if len(run.encode("utf-8")) >= 3]
+
+
+def parse_since(value: str, now: Optional[float] = None) -> float:
+    """'90s', '30m', '1h', '2d' or an ISO timestamp to epoch seconds"""
+    now = time.time() if now is None else now
+    match = re.fullmatch(r"(\d+(?:\.\d+)?)([smhd])", value.strip())
+    if match:
+        scale = {"s": 1, "m": 60, "h": 3600, "d": 86400}[match.group(2)]
+        return now - float(match.group(1)) * scale
+    return datetime.fromisoformat(value.strip()).timestamp()
+
+
+def plan_scan(log_path: str, grams: Set[bytes], since: Optional[float],
+              min_level: int) -> Tuple[List[Tuple[int, int]], int]:
+    """
+    Byte ranges of a log that must be scanned, and how many indexed
+    segments were skipped.
+    """
+    try:
+        size = os.path.getsize(log_path)
+    except OSError:
+        return [], 0
+    ranges, skipped, covered = [], 0, 0
+    for record in read_index(log_path):
+        if record.start > covered:
+            ranges.append((covered, record.start))
+        covered = record.end
+        if since is not None and record.last_ts and record.last_ts < since:
+            skipped += 1
+            continue
+        if min_level > 0 and not any(record.levels[min_level:]):
+            skipped += 1
+            continue
+        if grams and not record.may_contain(grams):
+            skipped += 1
+            continue
+        ranges.append((record.start, record.end))
+    if covered < size:
+        ranges.append((covered, size))
+
+    # Adjacent ranges read better as one
+    merged = []
+    for start, end in ranges:
+        if merged and merged[-1][1] == start:
+            merged[-1] = (merged[-1][0], end)
+        else:
+            merged.append((start, end))
+    return merged, skipped
+
+
+def _read_lines_range(log_path: str, start: int, end: int) -> bytes:
+    """Bytes of [start, end) widened to whole lines: a line cut at start
+    belongs to the previous range, a line cut at end is finished here"""
+    with open(log_path, "rb") as f:
+        if start > 0:
+            f.seek(start - 1)
+            if f.read(1) != b"\n":
+                f.readline()
+                start = f.tell()
+        if start >= end:
+            return b""
+        data = f.read(end - start)
+        if data and not data.endswith(b"\n"):
+            data += f.readline()
+    return data
+
+
+def _record_line(data: bytes, line_start: int) -> bytes:
+    """The timestamped line a (possibly continuation) line belongs to"""
+    pos = line_start
+    while not _TIMESTAMP.match(data, pos) and pos > 0:
+        pos = data.rfind(b"\n", 0, pos - 1) + 1
+    end = data.find(b"\n", pos)
+    return data[pos:end if end >= 0 else len(data)]
+
+
+def scan_range(log_path: str, start: int, end: int, pattern: Optional[str],
+               ignore_case: bool, since_stamp: Optional[bytes],
+               min_level: int) -> List[Tuple[bytes, bytes]]:
+    """
+    Matching (timestamp, line) pairs in one byte range.
+
+    The regex runs over the whole buffer in a single pass rather than line
+    by line, so the C matcher's literal prefix search does the skipping.
+    """
+    data = _read_lines_range(log_path, start, end)
+    if pattern:
+        flags = re.MULTILINE | (re.IGNORECASE if ignore_case else 0)
+        regex = re.compile(pattern.encode("utf-8"), flags)
+        line_starts = []
+        next_line = 0
+        for match in regex.finditer(data):
+            if match.start() < next_line:
+                continue
+            line_start = data.rfind(b"\n", 0, match.start()) + 1
+            line_starts.append(line_start)
+            line_end = data.find(b"\n", match.start())
+            next_line = len(data) if line_end < 0 else line_end + 1
+    else:
+        line_starts = [0] + [m.end() for m in re.finditer(rb"\n(?=.)", data, re.DOTALL)]
+
+    results = []
+    for line_start in line_starts:
+        line_end = data.find(b"\n", line_start)
+        line = data[line_start:line_end if line_end >= 0 else len(data)]
+        # Continuation lines take the timestamp and level of their record
+        record = line if _TIMESTAMP.match(line) else _record_line(data, line_start)
+        stamp_match = _TIMESTAMP.match(record)
+        stamp = stamp_match.group(1) if stamp_match else b""
+        if since_stamp is not None and stamp and stamp < since_stamp:
+            continue
+        if min_level > 0 and line_level(record) < min_level:
+            continue
+        results.append((stamp, line))
+    return results
+
+
+SCAN_CHUNK = 4 * SEGMENT_BYTES
+
+
+def search_log(log_path: str, pattern: Optional[str], ignore_case: bool = False,
+               since: Optional[float] = None, min_level: int = 0,
+               executor: Optional[ProcessPoolExecutor] = None) -> Tuple[List[Tuple[bytes, bytes]], int]:
+    """Matches in one log in file order, and the number of segments skipped"""
+    grams: Set[bytes] = set()
+    if pattern:
+        for literal in required_literals(pattern, ignore_case):
+            # Lines are indexed one at a time, so trigrams never span a newline
+            grams |= {g for g in trigrams(literal) if b"\n" not in g}
+    ranges, skipped = plan_scan(log_path, grams, since, min_level)
+    since_stamp = (datetime.fromtimestamp(since).strftime("%Y-%m-%d %H:%M:%S").encode("ascii")
+                   if since is not None else None)
+    # Split long unindexed stretches so they scan in parallel too
+    args = []
+    for start, end in ranges:
+        for chunk_start in range(start, end, SCAN_CHUNK):
+            chunk_end = min(chunk_start + SCAN_CHUNK, end)
+            args.append((log_path, chunk_start, chunk_end, pattern, ignore_case, since_stamp, min_level))
+    if executor and len(args) > 1:
+        chunks = executor.map(scan_range, *zip(*args))
+    else:
+        chunks = (scan_range(*a) for a in args)
+    results = []
+    for chunk in chunks:
+        results.extend(chunk)
+    return results, skipped
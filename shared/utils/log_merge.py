@@ -0,0 +1,259 @@
+"""
+Merged Component Log Reading
+
+Reads several component logs under $TEKTON_ROOT/.tekton/logs/ as one
+time-ordered stream. Each log is consumed through a buffered reader that
+hands out complete lines with a sort key; a heap over those readers
+yields the globally oldest line next. Following uses inotify on the log
+directory on Linux and falls back to polling elsewhere.
+
+Launcher log lines start with "YYYY-mm-dd HH:MM:SS" (optionally followed
+by ",mmm" from Python logging). That prefix sorts correctly as text, so
+keys are byte slices rather than parsed datetimes. Lines without a
+timestamp (tracebacks, launch headers) keep the key of the line before
+them so multi-line records stay together.
+"""
+import ctypes
+import ctypes.util
+import errno
+import heapq
+import os
+import re
+import select
+import sys
+import time
+from typing import Iterator, List, Optional, Tuple
+
+READ_CHUNK = 1 << 20
+TAIL_BLOCK = 64 * 1024
+
+_TIMESTAMP = re.compile(rb"^\d{4}-\d{2}-\d{2} \d{2}:\d{2}:\d{2}(?:[,.]\d{1,6})?")
+# Sorts before any real timestamp: header lines at the top of a file go first
+_NO_TIMESTAMP = b""
+
+
+def line_key(line: bytes, previous: bytes) -> bytes:
+    """Sort key for a log line: its timestamp, or the previous line's"""
+    match = _TIMESTAMP.match(line)
+    if not match:
+        return previous
+    stamp = match.group(0)
+    # Pad the fraction so "12:00:00", "12:00:00,5" and "12:00:00,123" compare as text
+    if len(stamp) == 19:
+        return stamp + b",000000"
+    return stamp[:19] + b"," + stamp[20:].ljust(6, b"0")
+
+
+def tail_offset(path: str, lines: int) -> int:
+    """Byte offset where the last `lines` lines of a file start"""
+    if lines <= 0:
+        return 0
+    with open(path, "rb") as f:
+        end = f.seek(0, os.SEEK_END)
+        pos = end
+        found = 0
+        # Ignore the newline that terminates the last line
+        skip_last = True
+        while pos > 0:
+            step = min(TAIL_BLOCK, pos)
+            pos -= step
+            f.seek(pos)
+            block = f.read(step)
+            idx = len(block)
+            while True:
+                idx = block.rfind(b"\n", 0, idx)
+                if idx < 0:
+                    break
+                if skip_last and pos + idx == end - 1:
+                    skip_last = False
+                    continue
+                found += 1
+                if found == lines:
+                    return pos + idx + 1
+        return 0
+
+
+class LogSource:
+    """Buffered reader over one component log, following growth and truncation"""
+
+    def __init__(self, component: str, path: str, start_lines: int = 0):
+        self.component = component
+        self.path = path
+        self.start_lines = start_lines
+        self.file = None
+        self.inode = None
+        self.partial = b""
+        self.last_key = _NO_TIMESTAMP
+        self._open(initial=True)
+
+    def _open(self, initial: bool = False):
+        try:
+            f = open(self.path, "rb", buffering=0)
+        except OSError:
+            self.file = None
+            return
+        st = os.fstat(f.fileno())
+        if initial and self.start_lines:
+            f.seek(tail_offset(self.path, self.start_lines))
+        self.file = f
+        self.inode = st.st_ino
+        self.partial = b""
+
+    def _check_rotation(self):
+        """Reopen if the file was replaced or truncated underneath us"""
+        try:
+            st = os.stat(self.path)
+        except OSError:
+            return
+        if self.file is None or st.st_ino != self.inode:
+            if self.file:
+                self.file.close()
+            self._open()
+        elif st.st_size < self.file.tell():
+            self.file.seek(0)
+            self.partial = b""
+
+    def read_lines(self, max_bytes: Optional[int] = None) -> List[Tuple[bytes, bytes]]:
+        """Complete (key, line) pairs appended since the last call
+
+        Reads to end of file, or roughly max_bytes. A trailing line without
+        its newline is held back until the writer finishes it.
+        """
+        self._check_rotation()
+        if self.file is None:
+            return []
+        chunks = [self.partial] if self.partial else []
+        read = 0
+        while max_bytes is None or read < max_bytes:
+            chunk = self.file.read(READ_CHUNK)
+            if not chunk:
+                break
+            chunks.append(chunk)
+            read += len(chunk)
+        data = b"".join(chunks)
+        if not data:
+            return []
+        lines = data.split(b"\n")
+        self.partial = lines.pop()
+        out = []
+        key = self.last_key
+        for line in lines:
+            key = line_key(line, key)
+            out.append((key, line))
+        self.last_key = key
+        return out
+
+    def iter_lines(self) -> Iterator[Tuple[bytes, bytes]]:
+        """Stream the rest of the file in READ_CHUNK pieces, including a final unterminated line"""
+        while True:
+            lines = self.read_lines(max_bytes=READ_CHUNK)
+            if not lines:
+                break
+            yield from lines
+        if self.partial:
+            self.last_key = line_key(self.partial, self.last_key)
+            yield self.last_key, self.partial
+            self.partial = b""
+
+    def close(self):
+        if self.file:
+            self.file.close()
+            self.file = None
+
+
+def merge_sources(sources: List[LogSource]) -> Iterator[Tuple[int, bytes]]:
+    """
+    Lazily k-way merge whole files by key; heapq.merge keeps one line per
+    source in its heap, so memory stays bounded by the read buffers.
+    """
+    def tagged(index: int, source: LogSource):
+        for key, line in source.iter_lines():
+            yield key, index, line
+
+    streams = [tagged(index, source) for index, source in enumerate(sources)]
+    for _key, index, line in heapq.merge(*streams, key=lambda item: item[0]):
+        yield index, line
+
+
+def merge_batches(batches: List[Tuple[int, List[Tuple[bytes, bytes]]]]) -> Iterator[Tuple[int, bytes]]:
+    """
+    K-way merge of per-source line batches by key.
+
+    batches holds (source index, [(key, line), ...]) with each list already
+    in file order. Ties keep source order, and each source's own order is
+    always preserved.
+    """
+    heap = []
+    for index, lines in batches:
+        if lines:
+            heap.append((lines[0][0], index, 0, lines))
+    heapq.heapify(heap)
+    while heap:
+        key, index, pos, lines = heap[0]
+        yield index, lines[pos][1]
+        pos += 1
+        if pos < len(lines):
+            heapq.heapreplace(heap, (lines[pos][0], index, pos, lines))
+        else:
+            heapq.heappop(heap)
+
+
+class _Inotify:
+    """Minimal ctypes inotify binding: wake when anything in a directory changes"""
+
+    IN_MODIFY = 0x00000002
+    IN_CLOSE_WRITE = 0x00000008
+    IN_MOVED_TO = 0x00000080
+    IN_CREATE = 0x00000100
+    IN_NONBLOCK = 0o4000
+    IN_CLOEXEC = 0o2000000
+
+    def __init__(self, directory: str):
+        libc = ctypes.CDLL(ctypes.util.find_library("c") or "libc.so.6", use_errno=True)
+        self.fd = libc.inotify_init1(self.IN_NONBLOCK | self.IN_CLOEXEC)
+        if self.fd < 0:
+            raise OSError(ctypes.get_errno(), "inotify_init1 failed")
+        mask = self.IN_MODIFY | self.IN_CLOSE_WRITE | self.IN_MOVED_TO | self.IN_CREATE
+        if libc.inotify_add_watch(self.fd, os.fsencode(directory), mask) < 0:
+            err = ctypes.get_errno()
+            os.close(self.fd)
+            raise OSError(err, f"inotify_add_watch failed for {directory}")
+
+    def wait(self, timeout: float) -> bool:
+        """Block until events arrive or timeout; drains the queue"""
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        if not ready:
+            return False
+        try:
+            while os.read(self.fd, 64 * 1024):
+                pass
+        except OSError as e:
+            if e.errno != errno.EAGAIN:
+                raise
+        return True
+
+    def close(self):
+        os.close(self.fd)
+
+
+class DirectoryWatcher:
+    """inotify on Linux, fixed-interval polling elsewhere"""
+
+    def __init__(self, directory: str, poll_interval: float = 0.25):
+        self.poll_interval = poll_interval
+        self.inotify: Optional[_Inotify] = None
+        if sys.platform.startswith("linux"):
+            try:
+                self.inotify = _Inotify(directory)
+            except (OSError, AttributeError):
+                self.inotify = None
+
+    def wait(self, timeout: float = 1.0):
+        if self.inotify:
+            self.inotify.wait(timeout)
+        else:
+            time.sleep(self.poll_interval)
+
+    def close(self):
+        if self.inotify:
+            self.inotify.close()
@@ -0,0 +1,289 @@
+"""
+Host Pressure Signals for the Supervisor
+
+Reads Linux pressure stall information (/proc/pressure/{memory,cpu,io})
+and turns it into supervisor decisions.
+
+MemoryGuard sheds components under memory pressure. When PSI "some"
+avg10 stays above a threshold, or this installation's components
+together exceed a PSS budget, the guard picks the least important running
+component (highest startup_priority in tekton_components.yaml, largest
+PSS within a priority) and suspends or stops it. A suspended process
+keeps its PSS resident, so suspended components still count against the
+budget and a budget overrun is always met by stopping a component, a
+suspended one if it is the least important; suspend only answers PSI
+pressure. Shed components come back in reverse
+order once pressure has stayed low for a while and the budget has room
+for them again. Only one action is taken per cooldown
+period, so the kernel's view of pressure can settle between decisions.
+
+LaunchWindow sizes launch concurrency: it widens while CPU and IO stall
+rates (from StallSampler) stay low and halves when they climb.
+
+PSI is host-wide: with two installations on one machine, both
+supervisors see the same pressure and shed their own components, while
+the budget covers only the components this supervisor manages.
+
+Everything here is policy over plain numbers; the launcher samples the
+inputs and carries out the decisions.
+"""
+import os
+import re
+from dataclasses import dataclass
+from typing import Dict, List, Optional
+
+PSI_DIR = "/proc/pressure"
+
+# Never shed these; everything else depends on them
+PROTECTED_COMPONENTS = ("hermes",)
+
+_SIZE = re.compile(r"^\s*(\d+(?:\.\d+)?)\s*([kmgt]?)i?b?\s*$", re.IGNORECASE)
+
+
+def read_psi(resource: str, psi_dir: str = PSI_DIR) -> Optional[Dict[str, Dict[str, float]]]:
+    """
+    Parse /proc/pressure/<resource> into {"some": {...}, "full": {...}}.
+
+    Each line reads "some avg10=0.00 avg60=0.00 avg300=0.00 total=0".
+    Returns None where PSI is unavailable (non-Linux, kernels before 4.20,
+    or psi=0 on the kernel command line).
+    """
+    try:
+        with open(os.path.join(psi_dir, resource)) as f:
+            text = f.read()
+    except OSError:
+        return None
+    result = {}
+    for line in text.splitlines():
+        kind, _, fields = line.partition(" ")
+        values = {}
+        for field in fields.split():
+            key, _, value = field.partition("=")
+            try:
+                values[key] = float(value)
+            except ValueError:
+                continue
+        if kind:
+            result[kind] = values
+    return result or None
+
+
+def psi_some_avg10(resource: str, psi_dir: str = PSI_DIR) -> Optional[float]:
+    """Share of the last 10s in which some task stalled on resource, in percent"""
+    psi = read_psi(resource, psi_dir)
+    if not psi or "some" not in psi:
+        return None
+    return psi["some"].get("avg10")
+
+
+def parse_size(text: str) -> int:
+    """Bytes in "6G", "512M", "6GiB" or a plain byte count"""
+    match = _SIZE.match(text)
+    if not match:
+        raise ValueError(f"Invalid size: {text!r}")
+    number, unit = match.groups()
+    scale = 1024 ** " kmgt".index(unit.lower() or " ")
+    return int(float(number) * scale)
+
+
+@dataclass
+class GuardDecision:
+    """One action for the launcher: suspend, stop or resume a component"""
+    action: str
+    component: str
+    reason: str
+
+
+class MemoryGuard:
+    """Decides which component to shed or bring back from pressure and PSS samples"""
+
+    def __init__(self, budget_bytes: Optional[int] = None, mode: str = "suspend",
+                 psi_high: float = 10.0, psi_low: float = 2.0,
+                 sustain: float = 30.0, clear: float = 60.0, cooldown: float = 15.0,
+                 protected=PROTECTED_COMPONENTS):
+        if mode not in ("suspend", "stop"):
+            raise ValueError(f"Unknown shed mode: {mode}")
+        self.budget = budget_bytes
+        self.mode = mode
+        self.psi_high = psi_high
+        self.psi_low = psi_low
+        self.sustain = sustain
+        self.clear = clear
+        self.cooldown = cooldown
+        self.protected = set(protected)
+        # Shed components, most recent last, with their PSS and action when shed
+        self.shed: List[str] = []
+        self.shed_pss: Dict[str, float] = {}
+        self.shed_action: Dict[str, str] = {}
+        self.pressure_since: Optional[float] = None
+        self.calm_since: Optional[float] = None
+        self.last_action: Optional[float] = None
+
+    @classmethod
+    def from_env(cls, env, budget: Optional[str] = None, mode: Optional[str] = None) -> "MemoryGuard":
+        """Guard configured from TEKTON_MEMORY_* settings; arguments take precedence"""
+        budget = budget or env.get("TEKTON_MEMORY_BUDGET")
+        return cls(
+            budget_bytes=parse_size(budget) if budget else None,
+            mode=mode or env.get("TEKTON_MEMORY_SHED", "suspend"),
+            psi_high=float(env.get("TEKTON_MEMORY_PSI_HIGH", "10")),
+            psi_low=float(env.get("TEKTON_MEMORY_PSI_LOW", "2")),
+            sustain=float(env.get("TEKTON_MEMORY_SUSTAIN", "30")),
+            clear=float(env.get("TEKTON_MEMORY_CLEAR", "60")),
+        )
+
+    def describe(self, psi: Optional[float], active_pss: float) -> str:
+        parts = [f"memory PSI {psi:.1f}%" if psi is not None else "memory PSI unavailable"]
+        used = f"PSS {active_pss / 2**20:.0f} MB"
+        if self.budget:
+            used += f" of {self.budget / 2**20:.0f} MB budget"
+        parts.append(used)
+        return ", ".join(parts)
+
+    def evaluate(self, now: float, psi: Optional[float], pss: Dict[str, float],
+                 priorities: Dict[str, int]) -> Optional[GuardDecision]:
+        """
+        Next action given PSI some avg10 (percent, None if unavailable),
+        PSS per running component and startup priorities, or None.
+        """
+        active = {c: v for c, v in pss.items() if c not in self.shed}
+        # Suspended processes free nothing: their PSS stays resident
+        suspended = sum(pss.get(c, self.shed_pss.get(c, 0.0)) for c in self.shed
+                        if self.shed_action.get(c) == "suspend")
+        total = sum(active.values()) + suspended
+        over_budget = bool(self.budget) and total > self.budget
+        pressured = psi is not None and psi >= self.psi_high
+        cooling = self.last_action is not None and now - self.last_action < self.cooldown
+
+        if pressured or over_budget:
+            self.calm_since = None
+            if self.pressure_since is None:
+                self.pressure_since = now
+            # A budget overrun is a measurement; PSI spikes have to persist
+            if cooling or (not over_budget and now - self.pressure_since < self.sustain):
+                return None
+            candidates = dict(active)
+            if over_budget:
+                # A suspended component less important than every running one is stopped first
+                candidates.update((c, pss.get(c, self.shed_pss.get(c, 0.0))) for c in self.shed
+                                  if self.shed_action.get(c) == "suspend")
+            victim = self._pick(candidates, priorities)
+            if victim is None:
+                return None
+            action = "stop" if over_budget else self.mode
+            if victim not in self.shed:
+                self.shed.append(victim)
+            self.shed_pss[victim] = candidates[victim]
+            self.shed_action[victim] = action
+            self.last_action = now
+            return GuardDecision(action, victim, self.describe(psi, total))
+
+        self.pressure_since = None
+        if not self.shed:
+            self.calm_since = None
+            return None
+        if psi is not None and psi >= self.psi_low:
+            self.calm_since = None
+            return None
+        if self.calm_since is None:
+            self.calm_since = now
+        if cooling or now - self.calm_since < self.clear:
+            return None
+        candidate = self.shed[-1]
+        returning = 0.0 if self.shed_action.get(candidate) == "suspend" else self.shed_pss.get(candidate, 0.0)
+        if self.budget and total + returning > self.budget:
+            return None
+        self.shed.pop()
+        self.shed_pss.pop(candidate, None)
+        self.shed_action.pop(candidate, None)
+        self.last_action = now
+        return GuardDecision("resume", candidate, self.describe(psi, total))
+
+    def _pick(self, active: Dict[str, float], priorities: Dict[str, int]) -> Optional[str]:
+        """Least important unprotected component; the larger one within a priority"""
+        candidates = [c for c in active if c not in self.protected]
+        if not candidates:
+            return None
+        return max(candidates, key=lambda c: (priorities.get(c, 0), active[c]))
+
+    def forget(self, component: str):
+        """Drop a shed component the supervisor no longer manages"""
+        if component in self.shed:
+            self.shed.remove(component)
+        self.shed_pss.pop(component, None)
+        self.shed_action.pop(component, None)
+
+
+class StallSampler:
+    """
+    Stall rate over the interval since the previous sample, from PSI totals.
+
+    avg10 trails by seconds, too slow for launch decisions; the cumulative
+    "total" (microseconds stalled) differenced between samples tracks what
+    is happening now.
+    """
+
+    def __init__(self, resources=("cpu", "io"), psi_dir: str = PSI_DIR):
+        self.resources = resources
+        self.psi_dir = psi_dir
+        self.previous: Optional[Dict[str, float]] = None
+        self.previous_at: Optional[float] = None
+
+    def _totals(self) -> Optional[Dict[str, float]]:
+        totals = {}
+        for resource in self.resources:
+            psi = read_psi(resource, self.psi_dir)
+            if psi and "some" in psi and "total" in psi["some"]:
+                totals[resource] = psi["some"]["total"]
+        return totals or None
+
+    @property
+    def available(self) -> bool:
+        return self._totals() is not None
+
+    def sample(self, now: float) -> Optional[float]:
+        """Worst "some" stall percentage across resources since the last call"""
+        totals = self._totals()
+        if totals is None:
+            return None
+        previous, previous_at = self.previous, self.previous_at
+        self.previous, self.previous_at = totals, now
+        if previous is None or now <= previous_at:
+            return None
+        elapsed_us = (now - previous_at) * 1e6
+        return max(100.0 * (totals[r] - previous.get(r, totals[r])) / elapsed_us for r in totals)
+
+
+class LaunchWindow:
+    """
+    How many components may be starting at once.
+
+    Additive increase while stalls stay low, multiplicative decrease when
+    they rise: imports that contend for CPU and disk all finish later than
+    the same imports run a few at a time.
+    """
+
+    def __init__(self, initial: int = 2, maximum: int = 16, low: float = 10.0, high: float = 40.0):
+        self.size = max(1, min(initial, maximum))
+        self.maximum = max(1, maximum)
+        self.low = low
+        self.high = high
+
+    @classmethod
+    def from_env(cls, env) -> "LaunchWindow":
+        return cls(
+            initial=int(env.get("TEKTON_LAUNCH_WINDOW", "2")),
+            maximum=int(env.get("TEKTON_LAUNCH_WINDOW_MAX", str(max(4, 2 * (os.cpu_count() or 2))))),
+            low=float(env.get("TEKTON_LAUNCH_STALL_LOW", "10")),
+            high=float(env.get("TEKTON_LAUNCH_STALL_HIGH", "40")),
+        )
+
+    def update(self, stall: Optional[float]) -> int:
+        """Adjust for the latest stall percentage (None: no signal, hold)"""
+        if stall is None:
+            return self.size
+        if stall >= self.high:
+            self.size = max(1, self.size // 2)
+        elif stall < self.low:
+            self.size = min(self.maximum, self.size + 1)
+        return self.size
@@ -0,0 +1,256 @@
+"""
+Shared-Memory Message Bus
+
+ctypes binding for src/tekton-bus: per-topic ring buffers in a memfd shared
+by every process on the bus, with eventfd wakeups for subscribers. The
+launcher starts the broker (tekton-busd) before the components and points
+them at its socket through TEKTON_BUS_SOCKET; Hermes' MessageBus publishes
+through it when it can connect and stays in-process otherwise.
+
+Payloads are opaque bytes of at most max_payload; each topic keeps the last
+ring_slots messages as history. A subscriber that falls further behind
+skips ahead and counts the loss in Subscription.dropped.
+
+    bus = SharedBus.connect()
+    sub = bus.subscribe("events.*")
+    loop.add_reader(sub.fileno(), lambda: handle(sub.drain()))
+    bus.publish("events.user", b'{"id": 1}')
+"""
+import ctypes
+import errno
+import os
+import signal
+import socket
+import struct
+import subprocess
+import time
+from typing import Dict, List, Optional, Tuple
+
+BUS_SOCKET_ENV = "TEKTON_BUS_SOCKET"
+BUS_LIBRARY_ENV = "TEKTON_BUS_LIBRARY"
+# Size of the broker's topic table; topics are never reclaimed
+BUS_TOPICS_ENV = "TEKTON_BUS_TOPICS"
+BUS_SOURCE = os.path.join("src", "tekton-bus")
+LIBRARY_NAME = "libtekton-bus.so"
+BROKER_NAME = "tekton-busd"
+TOPIC_NAME_MAX = 64
+# Encoded topic names kept per connection
+TOPIC_CACHE_SIZE = 1024
+
+_lib = None
+
+
+def socket_path(tekton_root: str) -> str:
+    return os.path.join(tekton_root, ".tekton", "run", "bus.sock")
+
+
+def _default_root() -> str:
+    return os.environ.get("TEKTON_ROOT") or os.path.dirname(
+        os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+
+def _load(library: Optional[str] = None):
+    """The client library, or None if it has not been built"""
+    global _lib
+    if _lib is not None and library is None:
+        return _lib
+    path = library or os.environ.get(BUS_LIBRARY_ENV) or os.path.join(
+        _default_root(), BUS_SOURCE, LIBRARY_NAME)
+    try:
+        lib = ctypes.CDLL(path, use_errno=True)
+    except OSError:
+        return None
+
+    vp, cp, u32, u64 = ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint32, ctypes.c_uint64
+    for name, restype, argtypes in (
+        ("tb_connect", vp, [cp]),
+        ("tb_close", None, [vp]),
+        ("tb_origin", u64, [vp]),
+        ("tb_max_payload", u32, [vp]),
+        ("tb_ring_slots", u32, [vp]),
+        ("tb_publish", ctypes.c_int64, [vp, cp, cp, u32]),
+        ("tb_subscribe", vp, [vp, cp]),
+        ("tb_sub_fd", ctypes.c_int, [vp]),
+        ("tb_sub_dropped", u64, [vp]),
+        ("tb_unsubscribe", None, [vp]),
+        ("tb_next", ctypes.c_int, [vp, cp, vp, u32, ctypes.POINTER(u64)]),
+        ("tb_history", ctypes.c_int, [vp, cp, u32, vp, u32]),
+        ("tb_match", ctypes.c_int, [cp, cp]),
+    ):
+        function = getattr(lib, name)
+        function.restype = restype
+        function.argtypes = argtypes
+    if library is None:
+        _lib = lib
+    return lib
+
+
+def _check(result: int, what: str) -> int:
+    if result < 0:
+        raise OSError(-result, f"{what}: {os.strerror(-result)}")
+    return result
+
+
+class Subscription:
+    """One pattern's feed; poll fileno() for readability, then drain()"""
+
+    def __init__(self, bus: "SharedBus", handle: int, pattern: str):
+        self.bus = bus
+        self.handle = handle
+        self.pattern = pattern
+        self._buffer = ctypes.create_string_buffer(bus.max_payload)
+        self._topic = ctypes.create_string_buffer(TOPIC_NAME_MAX)
+        self._origin = ctypes.c_uint64()
+
+    def fileno(self) -> int:
+        return self.bus.lib.tb_sub_fd(self.handle)
+
+    @property
+    def dropped(self) -> int:
+        return self.bus.lib.tb_sub_dropped(self.handle)
+
+    def drain(self, limit: Optional[int] = None) -> List[Tuple[str, bytes, int]]:
+        """(topic, payload, origin) for each waiting message, oldest first per topic"""
+        messages = []
+        next_message = self.bus.lib.tb_next
+        while limit is None or len(messages) < limit:
+            length = next_message(self.handle, self._topic, self._buffer,
+                                  len(self._buffer), ctypes.byref(self._origin))
+            if length == -errno.EAGAIN:
+                break
+            _check(length, "tb_next")
+            messages.append((self._topic.value.decode("utf-8"),
+                             self._buffer.raw[:length], self._origin.value))
+        return messages
+
+    def close(self):
+        if self.handle:
+            self.bus.lib.tb_unsubscribe(self.handle)
+            self.handle = None
+
+
+class SharedBus:
+    """A connection to the bus broker and its shared region"""
+
+    def __init__(self, lib, handle: int):
+        self.lib = lib
+        self.handle = handle
+        self.origin = lib.tb_origin(handle)
+        self.max_payload = lib.tb_max_payload(handle)
+        self.ring_slots = lib.tb_ring_slots(handle)
+        # publish is the hot path: skip the attribute lookups and re-encoding
+        self._publish = lib.tb_publish
+        self._topics: Dict[str, bytes] = {}
+
+    @classmethod
+    def connect(cls, path: Optional[str] = None, library: Optional[str] = None) -> Optional["SharedBus"]:
+        """Connect to the broker, or None if it is not running or the library is not built"""
+        path = path or os.environ.get(BUS_SOCKET_ENV)
+        if not path:
+            return None
+        lib = _load(library)
+        if lib is None:
+            return None
+        handle = lib.tb_connect(os.fsencode(path))
+        if not handle:
+            return None
+        return cls(lib, handle)
+
+    def publish(self, topic: str, data: bytes) -> int:
+        """Sequence number of the message within its topic"""
+        encoded = self._topics.get(topic)
+        if encoded is None:
+            encoded = topic.encode("utf-8")
+            if len(self._topics) < TOPIC_CACHE_SIZE:
+                self._topics[topic] = encoded
+        result = self._publish(self.handle, encoded, data, len(data))
+        if result < 0:
+            _check(result, f"publish to {topic}")
+        return result
+
+    def subscribe(self, pattern: str) -> Subscription:
+        handle = self.lib.tb_subscribe(self.handle, pattern.encode("utf-8"))
+        if not handle:
+            err = ctypes.get_errno()
+            raise OSError(err, f"subscribe to {pattern}: {os.strerror(err)}")
+        return Subscription(self, handle, pattern)
+
+    def history(self, topic: str, limit: Optional[int] = None) -> List[bytes]:
+        """Up to limit of the newest messages on a topic, oldest first"""
+        count = self.ring_slots if limit is None else min(limit, self.ring_slots)
+        buffer = ctypes.create_string_buffer(self.max_payload)
+        encoded = topic.encode("utf-8")
+        messages = []
+        for back in range(count):
+            length = self.lib.tb_history(self.handle, encoded, back, buffer, len(buffer))
+            if length == -errno.ENOENT:
+                break
+            if length >= 0:
+                messages.append(buffer.raw[:length])
+        messages.reverse()
+        return messages
+
+    def close(self):
+        if self.handle:
+            self.lib.tb_close(self.handle)
+            self.handle = None
+
+
+def start_broker(tekton_root: str, log_path: Optional[str] = None,
+                 timeout: float = 2.0) -> Optional[str]:
+    """
+    Start tekton-busd for an installation unless one is already serving.
+
+    Returns the socket path once it accepts connections, or None if the
+    broker has not been built (make -C src/tekton-bus) or did not come up.
+    """
+    path = socket_path(tekton_root)
+    if _answers(path):
+        return path
+    broker = os.path.join(tekton_root, BUS_SOURCE, BROKER_NAME)
+    if not os.access(broker, os.X_OK):
+        return None
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    command = [broker, "--socket", path]
+    if os.environ.get(BUS_TOPICS_ENV):
+        command += ["--topics", os.environ[BUS_TOPICS_ENV]]
+    log = open(log_path, "a") if log_path else subprocess.DEVNULL
+    try:
+        # Its own session: the broker outlives a non-monitoring launcher
+        subprocess.Popen(command, stdin=subprocess.DEVNULL,
+                         stdout=log, stderr=log, start_new_session=True)
+    finally:
+        if log_path:
+            log.close()
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        if _answers(path):
+            return path
+        time.sleep(0.02)
+    return None
+
+
+def stop_broker(tekton_root: str) -> bool:
+    """SIGTERM the broker serving an installation's socket; False if none was"""
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+    try:
+        sock.connect(socket_path(tekton_root))
+        cred = sock.getsockopt(socket.SOL_SOCKET, socket.SO_PEERCRED, struct.calcsize("3i"))
+        pid = struct.unpack("3i", cred)[0]
+        os.kill(pid, signal.SIGTERM)
+        return True
+    except OSError:
+        return False
+    finally:
+        sock.close()
+
+
+def _answers(path: str) -> bool:
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+    try:
+        sock.connect(path)
+        return True
+    except OSError:
+        return False
+    finally:
+        sock.close()
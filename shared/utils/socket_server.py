@@ -3,30 +3,52 @@ Socket reuse utility for uvicorn servers.
 
 Provides a wrapper to enable SO_REUSEADDR for uvicorn servers,
 fixing the port binding issues during rapid restarts.
+
+Also supports overlapping restarts (`tekton restart <component> --overlap`):
+each server offers a duplicate of its listening socket on a unix socket
+under $TEKTON_ROOT/.tekton/run/, and a replacement instance started with
+TEKTON_LISTEN_FD serves from that same socket. Both processes accept from
+one queue until the old one drains, so the port is never closed.
 """
 import os
 import sys
+import json
 import socket
 import signal
 import asyncio
 import struct
+import threading
+from typing import Optional, Tuple
 import uvicorn
 from uvicorn.config import Config
 from uvicorn.server import Server
 
+from shared.utils.launch_trace import TRACE_SPAWN_ENV, component_trace, now_us
+
+
+LISTEN_FD_ENV = "TEKTON_LISTEN_FD"
+HANDOFF_DIR = os.path.join(".tekton", "run")
+
+
+def handoff_socket_path(component_name: str, tekton_root: Optional[str] = None) -> str:
+    """Unix socket a running component offers its listening fd on."""
+    root = tekton_root or os.environ.get("TEKTON_ROOT") or os.getcwd()
+    name = component_name.lower().replace("-", "_")
+    return os.path.join(root, HANDOFF_DIR, f"{name}.sock")
 
-async def run_with_socket_reuse_async(app, host: str = "0.0.0.0", port: int = 8000, **kwargs):
+
+def create_listen_socket(host: str, port: int) -> socket.socket:
     """
-    Run uvicorn with socket reuse enabled (async version).
-    
-    This properly configures socket reuse for immediate port rebinding on macOS.
-    
-    Args:
-        app: Either a string (e.g., "module:app") or an app instance
-        host: Host to bind to
-        port: Port to bind to
-        **kwargs: Additional arguments for uvicorn Config
+    Listening socket for a server: the one inherited from the launcher
+    during an overlapping restart, otherwise a freshly bound one.
     """
+    inherited = os.environ.pop(LISTEN_FD_ENV, None)
+    if inherited:
+        sock = socket.socket(fileno=int(inherited))
+        sock.set_inheritable(False)
+        component_trace().instant("listen socket inherited", cat="component", port=port)
+        return sock
+
     # Create socket with proper reuse options
     sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
     
@@ -41,6 +63,140 @@ async def run_with_socket_reuse_async(app, host: str = "0.0.0.0", port: int = 80
     # Bind and listen
     sock.bind((host, port))
     sock.listen(128)
+    component_trace().instant("port bind", cat="component", port=port)
+    return sock
+
+
+class HandoffListener:
+    """Hands a duplicate of the listening fd to whoever connects (the launcher)."""
+
+    def __init__(self, listen_sock: socket.socket, path: str):
+        self.listen_sock = listen_sock
+        self.path = path
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        # A replacement instance takes the path over from its predecessor
+        try:
+            os.unlink(path)
+        except FileNotFoundError:
+            pass
+        self.server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.server.bind(path)
+        os.chmod(path, 0o600)
+        self.server.listen(1)
+        self.inode = os.stat(path).st_ino
+        self.thread = threading.Thread(target=self._serve, daemon=True)
+        self.thread.start()
+
+    def _serve(self):
+        while True:
+            try:
+                conn, _ = self.server.accept()
+            except OSError:
+                return
+            with conn:
+                info = json.dumps({
+                    "pid": os.getpid(),
+                    "port": self.listen_sock.getsockname()[1]
+                }).encode("utf-8")
+                try:
+                    socket.send_fds(conn, [info], [self.listen_sock.fileno()])
+                except OSError:
+                    pass
+
+    def close(self):
+        self.server.close()
+        # Leave the path alone if a replacement instance already owns it
+        try:
+            if os.stat(self.path).st_ino == self.inode:
+                os.unlink(self.path)
+        except OSError:
+            pass
+
+
+def start_handoff_listener(sock: socket.socket,
+                           component_name: Optional[str] = None) -> Optional[HandoffListener]:
+    """Offer the listening socket for overlapping restarts; None if unnamed or unsupported."""
+    component_name = component_name or os.environ.get("TEKTON_NAME")
+    if not component_name or not hasattr(socket, "send_fds"):
+        return None
+    try:
+        return HandoffListener(sock, handoff_socket_path(component_name))
+    except OSError:
+        return None
+
+
+def request_listen_socket(component_name: str, tekton_root: Optional[str] = None,
+                          timeout: float = 2.0) -> Optional[Tuple[socket.socket, dict]]:
+    """
+    Ask a running component for its listening socket.
+
+    Returns (socket, {"pid": ..., "port": ...}) or None if the component
+    isn't running or predates handoff support.
+    """
+    path = handoff_socket_path(component_name, tekton_root)
+    if not os.path.exists(path) or not hasattr(socket, "recv_fds"):
+        return None
+    try:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+            client.settimeout(timeout)
+            client.connect(path)
+            data, fds, _, _ = socket.recv_fds(client, 4096, 1)
+    except OSError:
+        return None
+    if not fds:
+        return None
+    try:
+        info = json.loads(data.decode("utf-8"))
+    except ValueError:
+        os.close(fds[0])
+        return None
+    return socket.socket(fileno=fds[0]), info
+
+
+async def _serve_with_handoff(server: Server, sock: socket.socket, component_name: Optional[str]):
+    """
+    Serve, offering the socket for handoff only once startup has finished.
+
+    The launcher treats the handoff socket answering with the new PID as
+    the replacement being ready, so it must not appear before lifespan
+    startup completes.
+    """
+    trace = component_trace()
+    startup_begin = None
+    if trace.enabled:
+        # Everything between the launcher's fork and here is imports and app setup
+        spawned = os.environ.get(TRACE_SPAWN_ENV)
+        startup_begin = now_us()
+        if spawned:
+            trace.complete("imports and setup", int(spawned), startup_begin, cat="component")
+    serve_task = asyncio.ensure_future(server.serve())
+    while not server.started and not serve_task.done():
+        await asyncio.sleep(0.05)
+    if startup_begin is not None:
+        trace.complete("app startup", startup_begin, cat="component", ready=server.started)
+    handoff = start_handoff_listener(sock, component_name) if server.started else None
+    try:
+        await serve_task
+    finally:
+        if handoff:
+            handoff.close()
+
+
+async def run_with_socket_reuse_async(app, host: str = "0.0.0.0", port: int = 8000,
+                                      component_name: Optional[str] = None, **kwargs):
+    """
+    Run uvicorn with socket reuse enabled (async version).
+    
+    This properly configures socket reuse for immediate port rebinding on macOS.
+    
+    Args:
+        app: Either a string (e.g., "module:app") or an app instance
+        host: Host to bind to
+        port: Port to bind to
+        component_name: Name for the restart handoff socket (defaults to TEKTON_NAME)
+        **kwargs: Additional arguments for uvicorn Config
+    """
+    sock = create_listen_socket(host, port)
     
     # Configure uvicorn with our socket
     kwargs.pop('host', None)
@@ -62,12 +218,13 @@ async def run_with_socket_reuse_async(app, host: str = "0.0.0.0", port: int = 80
         signal.signal(sig, signal_handler)
     
     try:
-        await server.serve()
+        await _serve_with_handoff(server, sock, component_name)
     finally:
         sock.close()
 
 
-def run_with_socket_reuse(app, host: str = "0.0.0.0", port: int = 8000, **kwargs):
+def run_with_socket_reuse(app, host: str = "0.0.0.0", port: int = 8000,
+                          component_name: Optional[str] = None, **kwargs):
     """
     Run uvicorn with socket reuse enabled.
     
@@ -77,22 +234,10 @@ def run_with_socket_reuse(app, host: str = "0.0.0.0", port: int = 8000, **kwargs
         app: Either a string (e.g., "module:app") or an app instance
         host: Host to bind to
         port: Port to bind to
+        component_name: Name for the restart handoff socket (defaults to TEKTON_NAME)
         **kwargs: Additional arguments for uvicorn Config
     """
-    # Create socket with proper reuse options
-    sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-    
-    # Enable reuse options BEFORE binding
-    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
-    # REMOVED SO_REUSEPORT - we don't want multiple processes on same port
-    
-    # Set SO_LINGER to 2 seconds for graceful close
-    linger_struct = struct.pack('ii', 1, 2)  # onoff=1, linger time=2 seconds
-    sock.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, linger_struct)
-    
-    # Bind and listen
-    sock.bind((host, port))
-    sock.listen(128)
+    sock = create_listen_socket(host, port)
     
     # Configure uvicorn with our socket
     kwargs.pop('host', None)
@@ -118,7 +263,7 @@ def run_with_socket_reuse(app, host: str = "0.0.0.0", port: int = 8000, **kwargs
         signal.signal(sig, signal_handler)
     
     try:
-        loop.run_until_complete(server.serve())
+        loop.run_until_complete(_serve_with_handoff(server, sock, component_name))
     finally:
         sock.close()
         loop.close()
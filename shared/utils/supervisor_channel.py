@@ -0,0 +1,239 @@
+"""
+Supervisor Channel for Tekton Components
+
+Lets components report liveness to the launcher's supervisor over an inherited
+control fd instead of opening a new connection to Hermes on every heartbeat.
+The supervisor (the launcher) aggregates reports and forwards them to Hermes
+in batches over its persistent HTTP session, several times per heartbeat
+interval so relaying adds little to a heartbeat's age.
+
+Only a launcher that stays up (`tekton start --monitor`) creates the
+channel; a launcher that exits after starting components would take its
+relay with it, so those components get no fd and heartbeat directly.
+
+Component side:  SupervisorChannel.from_env().report(...)
+Launcher side:   HeartbeatRelay - creates the channel and forwards batches
+"""
+import asyncio
+import json
+import logging
+import os
+import socket
+import time
+from typing import Dict, Any, Optional
+
+logger = logging.getLogger(__name__)
+
+# Environment variable carrying the inherited control fd number
+SUPERVISOR_FD_ENV = "TEKTON_SUPERVISOR_FD"
+
+# Datagrams are small JSON records; anything larger is a bug
+MAX_RECORD_SIZE = 4096
+
+# Seconds between a component's heartbeats (heartbeat_loop's default)
+HEARTBEAT_INTERVAL = 30.0
+
+# Batches go out this many times per heartbeat interval, so relaying delays
+# a heartbeat by a fraction of the interval rather than up to a whole one
+RELAYS_PER_HEARTBEAT = 4
+
+
+class SupervisorChannel:
+    """Component-side end of the supervisor control channel."""
+
+    def __init__(self, fd: int):
+        self.fd = fd
+        self._sock: Optional[socket.socket] = None
+        self.available = True
+
+    @classmethod
+    def from_env(cls) -> Optional['SupervisorChannel']:
+        """Return a channel for the inherited fd, or None if not launched under a supervisor."""
+        fd_str = os.environ.get(SUPERVISOR_FD_ENV)
+        if not fd_str:
+            return None
+        try:
+            fd = int(fd_str)
+            os.fstat(fd)
+        except (ValueError, OSError):
+            return None
+        return cls(fd)
+
+    def _socket(self) -> socket.socket:
+        if self._sock is None:
+            # Work on a dup so the inherited fd stays valid for our own children
+            self._sock = socket.socket(fileno=os.dup(self.fd))
+            self._sock.setblocking(False)
+        return self._sock
+
+    def report(self,
+               component_name: str,
+               status: str = "healthy",
+               component_id: Optional[str] = None,
+               token: Optional[str] = None) -> bool:
+        """
+        Report liveness to the supervisor.
+
+        Never blocks. Returns False if the supervisor is gone or not keeping
+        up, in which case the caller should fall back to a direct heartbeat.
+        """
+        if not self.available:
+            return False
+
+        record = {
+            "component": component_name,
+            "component_id": component_id or component_name,
+            "token": token,
+            "status": status,
+            "pid": os.getpid(),
+            "timestamp": time.time()
+        }
+        try:
+            self._socket().send(json.dumps(record).encode('utf-8'))
+            return True
+        except (ConnectionRefusedError, BrokenPipeError, ConnectionResetError):
+            # Supervisor exited - stop trying for the rest of this process
+            logger.debug("Supervisor channel closed, falling back to direct heartbeats")
+            self.available = False
+            self.close()
+            return False
+        except (BlockingIOError, OSError) as e:
+            logger.debug(f"Supervisor channel busy: {e}")
+            return False
+
+    def close(self):
+        if self._sock is not None:
+            try:
+                self._sock.close()
+            except OSError:
+                pass
+            self._sock = None
+
+
+class HeartbeatRelay:
+    """
+    Launcher-side end of the supervisor control channel.
+
+    Owns one AF_UNIX datagram socketpair. Every launched component inherits
+    the child end; the relay reads liveness records from the parent end,
+    keeps the latest per component, and posts what arrived since the last
+    batch to Hermes' /api/heartbeat/batch endpoint RELAYS_PER_HEARTBEAT
+    times per heartbeat interval.
+    """
+
+    def __init__(self, hermes_url: str, heartbeat_interval: float = HEARTBEAT_INTERVAL):
+        self.hermes_url = hermes_url.rstrip('/')
+        self.interval = heartbeat_interval / RELAYS_PER_HEARTBEAT
+        self.liveness: Dict[str, Dict[str, Any]] = {}
+        self._pending: Dict[str, Dict[str, Any]] = {}
+        self._parent, self._child = socket.socketpair(socket.AF_UNIX, socket.SOCK_DGRAM)
+        self._parent.setblocking(False)
+        self._child.set_inheritable(True)
+        self._task: Optional[asyncio.Task] = None
+        self._loop: Optional[asyncio.AbstractEventLoop] = None
+        self.batches_sent = 0
+
+    @property
+    def child_fd(self) -> int:
+        """Fd to pass to component processes (pass_fds)."""
+        return self._child.fileno()
+
+    def child_env(self) -> Dict[str, str]:
+        """Environment entries a component needs to find the channel."""
+        return {SUPERVISOR_FD_ENV: str(self.child_fd)}
+
+    def _drain(self):
+        """Read every queued record; called by the event loop when readable."""
+        while True:
+            try:
+                data = self._parent.recv(MAX_RECORD_SIZE)
+            except (BlockingIOError, InterruptedError):
+                return
+            except OSError as e:
+                logger.debug(f"Heartbeat relay read error: {e}")
+                return
+            try:
+                record = json.loads(data)
+                component = record["component"]
+            except (ValueError, KeyError, TypeError):
+                continue
+            record["received_at"] = time.time()
+            self.liveness[component] = record
+            self._pending[component] = record
+
+    def snapshot(self) -> Dict[str, Dict[str, Any]]:
+        """Latest liveness record per component (tokens stripped)."""
+        return {
+            name: {k: v for k, v in rec.items() if k != "token"}
+            for name, rec in self.liveness.items()
+        }
+
+    async def flush(self, session) -> bool:
+        """
+        Forward pending liveness records to Hermes as one batch.
+
+        Records stay pending until Hermes has answered 200, so a failed post
+        is retried on the next flush with whatever is newest per component.
+        Entries Hermes rejects (bad token, unknown component) are dropped.
+        """
+        for name in [name for name, rec in self._pending.items() if not rec.get("token")]:
+            # Hermes would reject it anyway
+            del self._pending[name]
+        if not self._pending:
+            return True
+        sent = dict(self._pending)
+        batch = [
+            {
+                "component_id": rec.get("component_id"),
+                "token": rec.get("token"),
+                "status": {"health": rec.get("status", "healthy"), "pid": rec.get("pid")}
+            }
+            for rec in sent.values()
+        ]
+        try:
+            async with session.post(
+                f"{self.hermes_url}/api/heartbeat/batch",
+                json={"heartbeats": batch},
+                timeout=5
+            ) as resp:
+                self.batches_sent += 1
+                if resp.status != 200:
+                    logger.debug(f"Batched heartbeat answered {resp.status}; retrying next flush")
+                    return False
+                try:
+                    rejected = (await resp.json()).get("rejected") or []
+                except Exception:
+                    rejected = []
+        except Exception as e:
+            logger.debug(f"Batched heartbeat failed: {e}")
+            return False
+        for name, rec in sent.items():
+            # A record that arrived during the post is newer; it goes next time
+            if self._pending.get(name) is rec:
+                del self._pending[name]
+        if rejected:
+            logger.debug(f"Hermes rejected heartbeats for {', '.join(map(str, rejected))}")
+        return not rejected
+
+    def start(self, session):
+        """Start reading records and forwarding batches on the running loop."""
+        self._loop = asyncio.get_running_loop()
+        self._loop.add_reader(self._parent.fileno(), self._drain)
+
+        async def forward():
+            while True:
+                await asyncio.sleep(self.interval)
+                await self.flush(session)
+
+        self._task = asyncio.create_task(forward())
+
+    def stop(self):
+        if self._loop is not None:
+            try:
+                self._loop.remove_reader(self._parent.fileno())
+            except Exception:
+                pass
+        if self._task:
+            self._task.cancel()
+        self._parent.close()
+        self._child.close()
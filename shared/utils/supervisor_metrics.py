@@ -0,0 +1,332 @@
+"""
+Supervisor Metrics
+
+While the launcher supervises components (`tekton start --monitor`) it
+keeps per-component counters in memory and serves them in OpenMetrics
+text format, on $TEKTON_ROOT/.tekton/run/metrics.sock and optionally on a
+localhost port:
+
+    curl --unix-socket .tekton/run/metrics.sock http://localhost/metrics
+    curl http://127.0.0.1:$TEKTON_METRICS_PORT/metrics
+
+Values live in preallocated arrays with one slot per component. Every slot
+has a single writer (the supervisor's event loop, or the one log reader
+thread for a stream), so updates are plain in-place stores and the scrape
+thread reads them without taking a lock; a scrape never blocks supervision.
+Process sampling blocks, so it reads /proc in an executor and hands the
+samples back to the event loop, which stores them.
+
+Restarts are counted on disk, one file per component under
+.tekton/run/restarts, because `tekton restart` and `tekton reload` restart
+components from processes of their own. The sampler reads the counts
+along with /proc.
+"""
+import fcntl
+import http.server
+import os
+import socketserver
+import threading
+import time
+from array import array
+from typing import Dict, List, Optional, Tuple
+
+CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8"
+METRICS_SOCKET = os.path.join(".tekton", "run", "metrics.sock")
+RESTARTS_DIR = os.path.join(".tekton", "run", "restarts")
+
+MAX_COMPONENTS = 64
+HEALTH_BUCKETS = (0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0)
+LOG_STREAMS = ("stdout", "stderr")
+
+# name -> (type, help); counters are exposed with a _total suffix
+_SCALARS = {
+    "up": ("gauge", "1 if the last health check passed"),
+    "start_time_seconds": ("gauge", "Unix time the current process was started"),
+    "restarts": ("counter", "Restarts by the supervisor, tekton restart or tekton reload"),
+    "memory_rss_bytes": ("gauge", "Resident set size of the component process"),
+    "memory_pss_bytes": ("gauge", "Proportional set size of the component process"),
+    "cpu_seconds": ("counter", "User plus system CPU time of the component process"),
+    "readiness_seconds": ("gauge", "Time from launch until the component first passed a health check"),
+}
+
+# (pid, (rss, pss, cpu_seconds) or None once the process is gone)
+ProcessSample = Tuple[int, Optional[Tuple[float, Optional[float], float]]]
+
+
+class SupervisorMetrics:
+    """Per-component counters, written by the supervisor and read by scrapes"""
+
+    def __init__(self, components: Optional[List[str]] = None):
+        self.components: List[str] = []
+        self.index: Dict[str, int] = {}
+        self.values = {name: array("d", bytes(8 * MAX_COMPONENTS)) for name in _SCALARS}
+        width = len(HEALTH_BUCKETS) + 1
+        self.health_buckets = array("d", bytes(8 * MAX_COMPONENTS * width))
+        self.health_sum = array("d", bytes(8 * MAX_COMPONENTS))
+        self.health_count = array("d", bytes(8 * MAX_COMPONENTS))
+        self.log_lines = {stream: array("d", bytes(8 * MAX_COMPONENTS)) for stream in LOG_STREAMS}
+        self.pids: Dict[str, int] = {}
+        self.started = time.time()
+        for component in components or []:
+            self.slot(component)
+
+    def slot(self, component: str) -> int:
+        """Slot for a component, assigned on first use"""
+        index = self.index.get(component)
+        if index is None:
+            if len(self.components) >= MAX_COMPONENTS:
+                raise ValueError(f"At most {MAX_COMPONENTS} components can be tracked")
+            index = len(self.components)
+            # Publish the name before the index so readers never see a gap
+            self.components.append(component)
+            self.index[component] = index
+        return index
+
+    # Supervisor-side updates
+
+    def component_started(self, component: str, pid: Optional[int], readiness: Optional[float] = None):
+        i = self.slot(component)
+        if pid:
+            self.pids[component] = pid
+        self.values["start_time_seconds"][i] = time.time()
+        self.values["cpu_seconds"][i] = 0.0
+        if readiness is not None:
+            self.values["readiness_seconds"][i] = readiness
+
+    def component_restarted(self, component: str):
+        self.values["restarts"][self.slot(component)] += 1
+
+    def record_restarts(self, counts: Dict[str, int]):
+        """Store restart counts read by read_restarts, for the components tracked here"""
+        for component, count in counts.items():
+            i = self.index.get(component)
+            if i is not None:
+                self.values["restarts"][i] = count
+
+    def observe_health(self, component: str, seconds: float, healthy: bool):
+        i = self.slot(component)
+        self.values["up"][i] = 1.0 if healthy else 0.0
+        width = len(HEALTH_BUCKETS) + 1
+        bucket = next((b for b, bound in enumerate(HEALTH_BUCKETS) if seconds <= bound), len(HEALTH_BUCKETS))
+        self.health_buckets[i * width + bucket] += 1
+        self.health_sum[i] += seconds
+        self.health_count[i] += 1
+
+    def sample_process(self, component: str, rss: float, pss: Optional[float], cpu_seconds: float):
+        i = self.slot(component)
+        self.values["memory_rss_bytes"][i] = rss
+        if pss is not None:
+            self.values["memory_pss_bytes"][i] = pss
+        self.values["cpu_seconds"][i] = cpu_seconds
+
+    def record_samples(self, samples: Dict[str, ProcessSample]):
+        """Store what sample_processes read; samples of a PID since replaced are dropped"""
+        for component, (pid, usage) in samples.items():
+            if self.pids.get(component) != pid:
+                continue
+            if usage is None:
+                del self.pids[component]
+                self.values["up"][self.slot(component)] = 0.0
+            else:
+                self.sample_process(component, *usage)
+
+    def log_line(self, component: str, stream: str):
+        """Called by the log reader thread for that stream only"""
+        self.log_lines[stream][self.slot(component)] += 1
+
+    # Scrape side
+
+    def render(self) -> str:
+        """OpenMetrics text exposition of every tracked component"""
+        count = len(self.components)
+        names = self.components[:count]
+        out = []
+        for name, (kind, help_text) in _SCALARS.items():
+            family = f"tekton_component_{name}"
+            out.append(f"# TYPE {family} {kind}")
+            out.append(f"# HELP {family} {help_text}")
+            sample = f"{family}_total" if kind == "counter" else family
+            values = self.values[name]
+            for i, component in enumerate(names):
+                out.append(f'{sample}{{component="{component}"}} {_fmt(values[i])}')
+
+        family = "tekton_component_uptime_seconds"
+        out.append(f"# TYPE {family} gauge")
+        out.append(f"# HELP {family} Seconds since the current process was started")
+        now = time.time()
+        starts = self.values["start_time_seconds"]
+        for i, component in enumerate(names):
+            if starts[i]:
+                out.append(f'{family}{{component="{component}"}} {_fmt(round(now - starts[i], 3))}')
+
+        family = "tekton_component_health_check_duration_seconds"
+        out.append(f"# TYPE {family} histogram")
+        out.append(f"# HELP {family} Health check latency seen by the supervisor")
+        width = len(HEALTH_BUCKETS) + 1
+        for i, component in enumerate(names):
+            cumulative = 0.0
+            for b, bound in enumerate(HEALTH_BUCKETS + (float("inf"),)):
+                cumulative += self.health_buckets[i * width + b]
+                le = "+Inf" if bound == float("inf") else repr(bound)
+                out.append(f'{family}_bucket{{component="{component}",le="{le}"}} {_fmt(cumulative)}')
+            out.append(f'{family}_count{{component="{component}"}} {_fmt(self.health_count[i])}')
+            out.append(f'{family}_sum{{component="{component}"}} {_fmt(self.health_sum[i])}')
+
+        family = "tekton_component_log_lines"
+        out.append(f"# TYPE {family} counter")
+        out.append(f"# HELP {family} Log lines written by the component")
+        for stream in LOG_STREAMS:
+            values = self.log_lines[stream]
+            for i, component in enumerate(names):
+                out.append(f'{family}_total{{component="{component}",stream="{stream}"}} {_fmt(values[i])}')
+
+        out.append("# TYPE tekton_supervisor_uptime_seconds gauge")
+        out.append(f"tekton_supervisor_uptime_seconds {_fmt(time.time() - self.started)}")
+        out.append("# EOF")
+        return "\n".join(out) + "\n"
+
+
+def _fmt(value: float) -> str:
+    return str(int(value)) if value.is_integer() else repr(value)
+
+
+def count_restart(tekton_root: str, component: str) -> int:
+    """Add a restart to a component's count on disk; returns the new count"""
+    path = os.path.join(tekton_root, RESTARTS_DIR, component)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    fd = os.open(path, os.O_RDWR | os.O_CREAT, 0o644)
+    try:
+        fcntl.flock(fd, fcntl.LOCK_EX)
+        try:
+            count = int(os.read(fd, 32) or 0) + 1
+        except ValueError:
+            count = 1
+        # Counts only grow, so the new one always covers the old
+        os.pwrite(fd, b"%d\n" % count, 0)
+        return count
+    finally:
+        os.close(fd)
+
+
+def read_restarts(tekton_root: str) -> Dict[str, int]:
+    """Restart counts of every component restarted so far"""
+    directory = os.path.join(tekton_root, RESTARTS_DIR)
+    counts = {}
+    try:
+        names = os.listdir(directory)
+    except OSError:
+        return counts
+    for name in names:
+        try:
+            with open(os.path.join(directory, name)) as f:
+                counts[name] = int(f.read() or 0)
+        except (OSError, ValueError):
+            continue
+    return counts
+
+
+def sample_processes(pids: Dict[str, int]) -> Dict[str, ProcessSample]:
+    """
+    Read memory and CPU for each component's PID (blocking; run in an executor)
+
+    Only reads: the event loop stores the result with record_samples, so
+    the metrics keep one writer. A usage of None means the process is gone.
+    """
+    import psutil
+
+    samples = {}
+    for component, pid in pids.items():
+        try:
+            proc = psutil.Process(pid)
+            with proc.oneshot():
+                cpu = proc.cpu_times()
+                try:
+                    mem = proc.memory_full_info()
+                    pss = getattr(mem, "pss", None)
+                except psutil.AccessDenied:
+                    mem = proc.memory_info()
+                    pss = None
+            samples[component] = (pid, (mem.rss, pss, cpu.user + cpu.system))
+        except psutil.NoSuchProcess:
+            samples[component] = (pid, None)
+        except psutil.Error:
+            continue
+    return samples
+
+
+class _MetricsHandler(http.server.BaseHTTPRequestHandler):
+    def do_GET(self):
+        if self.path.split("?")[0] not in ("/", "/metrics"):
+            self.send_error(404)
+            return
+        body = self.server.metrics.render().encode("utf-8")
+        self.send_response(200)
+        self.send_header("Content-Type", CONTENT_TYPE)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def address_string(self):
+        # Unix socket peers have no address
+        return "local"
+
+    def log_message(self, format, *args):
+        pass
+
+
+class _TCPMetricsServer(socketserver.ThreadingMixIn, http.server.HTTPServer):
+    daemon_threads = True
+
+
+class _UnixMetricsServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+    def get_request(self):
+        request, _ = super().get_request()
+        return request, ("local", 0)
+
+
+class MetricsServer:
+    """Serves SupervisorMetrics from background threads"""
+
+    def __init__(self, metrics: SupervisorMetrics, unix_path: Optional[str] = None,
+                 port: Optional[int] = None):
+        self.metrics = metrics
+        self.unix_path = unix_path
+        self.port = port
+        self.servers = []
+
+    def start(self) -> List[str]:
+        """Start listening; returns where metrics are served"""
+        endpoints = []
+        if self.unix_path:
+            os.makedirs(os.path.dirname(self.unix_path), exist_ok=True)
+            try:
+                os.unlink(self.unix_path)
+            except FileNotFoundError:
+                pass
+            server = _UnixMetricsServer(self.unix_path, _MetricsHandler)
+            endpoints.append(f"unix:{self.unix_path}")
+            self._serve(server)
+        if self.port:
+            server = _TCPMetricsServer(("127.0.0.1", self.port), _MetricsHandler)
+            endpoints.append(f"http://127.0.0.1:{server.server_address[1]}/metrics")
+            self._serve(server)
+        return endpoints
+
+    def _serve(self, server):
+        server.metrics = self.metrics
+        threading.Thread(target=server.serve_forever, daemon=True,
+                         name="metrics-server").start()
+        self.servers.append(server)
+
+    def stop(self):
+        for server in self.servers:
+            server.shutdown()
+            server.server_close()
+        self.servers.clear()
+        if self.unix_path:
+            try:
+                os.unlink(self.unix_path)
+            except OSError:
+                pass
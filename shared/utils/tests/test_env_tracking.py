@@ -0,0 +1,136 @@
+"""
+Tests for env read tracking and reload impact analysis.
+"""
+import os
+
+from shared import env as tekton_env
+from shared.utils.env_tracking import (
+    READS_FILE_ENV, affected_components, changed_keys, env_snapshot,
+    read_component_keys, read_snapshot, reset_reads, write_snapshot
+)
+
+
+def test_reads_are_recorded_once(tmp_path, monkeypatch):
+    """TektonEnviron.get appends each key to the reads file the first time only."""
+    path = reset_reads(str(tmp_path), "rhetor")
+    monkeypatch.setenv(READS_FILE_ENV, path)
+    monkeypatch.setattr(tekton_env, "_read_keys", set())
+    monkeypatch.setattr(tekton_env, "_reads_fd", None)
+    try:
+        for key in ("RHETOR_PORT", "TEKTON_DEBUG", "RHETOR_PORT"):
+            tekton_env.TektonEnviron.get(key)
+    finally:
+        os.close(tekton_env._reads_fd)
+    with open(path) as f:
+        assert f.read().split() == ["RHETOR_PORT", "TEKTON_DEBUG"]
+    assert read_component_keys(str(tmp_path), "rhetor") == {"RHETOR_PORT", "TEKTON_DEBUG"}
+    assert read_component_keys(str(tmp_path), "apollo") is None
+
+
+def test_snapshot_diff_selects_readers(tmp_path, monkeypatch):
+    """Only components that read a changed key restart; untracked ones always do."""
+    monkeypatch.setenv("HOME", str(tmp_path / "home"))
+    root = str(tmp_path)
+    (tmp_path / ".env.tekton").write_text("RHETOR_PORT=8003\nAPOLLO_PORT=8012\n")
+    (tmp_path / ".env.local").write_text("TEKTON_DEBUG=false\n")
+
+    env = {"RHETOR_PORT": "8003", "APOLLO_PORT": "8012", "TEKTON_DEBUG": "false", "PATH": "/bin"}
+    for component in ("rhetor", "apollo"):
+        write_snapshot(root, component, env)
+    assert read_snapshot(root, "rhetor") == {"RHETOR_PORT": "8003", "APOLLO_PORT": "8012", "TEKTON_DEBUG": "false"}
+
+    (tmp_path / ".env.local").write_text("TEKTON_DEBUG=false\nRHETOR_MODEL=big\n")
+    env.update(RHETOR_PORT="8103", RHETOR_MODEL="big")
+    current = env_snapshot(root, env)
+    assert changed_keys(read_snapshot(root, "rhetor"), current) == {"RHETOR_PORT", "RHETOR_MODEL"}
+
+    for component, keys in (("rhetor", "RHETOR_PORT"), ("apollo", "APOLLO_PORT\nTEKTON_DEBUG"),
+                            ("hermes", "HERMES_PORT")):
+        with open(reset_reads(root, component), "w") as f:
+            f.write(keys + "\n")
+    # Hermes reads its settings but has no snapshot: launched before tracking
+    assert affected_components(root, ["rhetor", "apollo", "hermes"], current) == {
+        "rhetor": ["RHETOR_PORT"],
+        "hermes": ["*"],
+    }
+
+
+def test_launching_one_component_keeps_the_others_snapshots(tmp_path, monkeypatch):
+    """`tekton start -c X` after an edit must not hide the edit from the others."""
+    monkeypatch.setenv("HOME", str(tmp_path / "home"))
+    root = str(tmp_path)
+    (tmp_path / ".env.tekton").write_text("TEKTON_DEBUG=false\n")
+    env = {"TEKTON_DEBUG": "false"}
+    for component in ("rhetor", "apollo"):
+        with open(reset_reads(root, component), "w") as f:
+            f.write("TEKTON_DEBUG\n")
+        write_snapshot(root, component, env)
+
+    (tmp_path / ".env.tekton").write_text("TEKTON_DEBUG=true\n")
+    env["TEKTON_DEBUG"] = "true"
+    write_snapshot(root, "rhetor", env)
+    assert affected_components(root, ["rhetor", "apollo"], env_snapshot(root, env)) == {
+        "apollo": ["TEKTON_DEBUG"]
+    }
+
+
+def test_whole_environment_reads_cover_their_keys(tmp_path, monkeypatch):
+    """all() depends on every key and with_prefix() on its prefix; both restart on a matching change."""
+    monkeypatch.setenv("HOME", str(tmp_path / "home"))
+    root = str(tmp_path)
+    monkeypatch.setattr(tekton_env, "_read_keys", set())
+    monkeypatch.setattr(tekton_env, "_reads_fd", None)
+    monkeypatch.setenv("RHETOR_MODEL", "small")
+    monkeypatch.setenv(READS_FILE_ENV, reset_reads(root, "rhetor"))
+    try:
+        settings = tekton_env.TektonEnviron.with_prefix("RHETOR_")
+        assert settings["RHETOR_MODEL"] == "small" and all(key.startswith("RHETOR_") for key in settings)
+    finally:
+        os.close(tekton_env._reads_fd)
+    monkeypatch.setattr(tekton_env, "_read_keys", set())
+    monkeypatch.setattr(tekton_env, "_reads_fd", None)
+    monkeypatch.setenv(READS_FILE_ENV, reset_reads(root, "aish"))
+    try:
+        assert tekton_env.TektonEnviron.all()["RHETOR_MODEL"] == "small"
+    finally:
+        os.close(tekton_env._reads_fd)
+    assert read_component_keys(root, "rhetor") == {"RHETOR_*"}
+    assert read_component_keys(root, "aish") == {"*"}
+
+    (tmp_path / ".env.tekton").write_text("RHETOR_MODEL=small\nTEKTON_DEBUG=false\n")
+    env = {"RHETOR_MODEL": "small", "TEKTON_DEBUG": "false"}
+    for component in ("rhetor", "aish"):
+        write_snapshot(root, component, env)
+    env["TEKTON_DEBUG"] = "true"
+    assert affected_components(root, ["rhetor", "aish"], env_snapshot(root, env)) == {
+        "aish": ["TEKTON_DEBUG"]
+    }
+    env["RHETOR_MODEL"] = "big"
+    assert affected_components(root, ["rhetor", "aish"], env_snapshot(root, env)) == {
+        "rhetor": ["RHETOR_MODEL"],
+        "aish": ["RHETOR_MODEL", "TEKTON_DEBUG"],
+    }
+
+
+def test_global_config_records_only_the_settings_used(tmp_path, monkeypatch):
+    """A component built on GlobalConfig does not depend on other components' settings."""
+    from shared.utils import env_config, global_config
+
+    path = reset_reads(str(tmp_path), "apollo")
+    for key, value in (("APOLLO_PORT", "8012"), ("RHETOR_PORT", "8003"), ("RHETOR_TIMEOUT", "30"),
+                       ("ENGRAM_PORT", "8000"), ("_TEKTON_ENV_FROZEN", "1")):
+        monkeypatch.setenv(key, value)
+    monkeypatch.setenv(READS_FILE_ENV, path)
+    monkeypatch.setattr(tekton_env, "_read_keys", set())
+    monkeypatch.setattr(tekton_env, "_reads_fd", None)
+    monkeypatch.setattr(env_config, "_global_component_config", None)
+    monkeypatch.setattr(global_config.GlobalConfig, "_instance", None)
+    try:
+        config = global_config.GlobalConfig.get_instance()
+        assert config.get_component_config("apollo").port == 8012
+    finally:
+        if tekton_env._reads_fd is not None:
+            os.close(tekton_env._reads_fd)
+    keys = read_component_keys(str(tmp_path), "apollo")
+    assert "APOLLO_PORT" in keys
+    assert not {key for key in keys if key.startswith(("RHETOR_", "ENGRAM_", "HERMES_"))}
@@ -0,0 +1,173 @@
+"""
+Tests for the Hephaestus UI front server (src/tekton-front) against a stdlib upstream.
+"""
+import http.client
+import json
+import os
+import shutil
+import socket
+import subprocess
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+import pytest
+
+SOURCE = os.path.join(os.path.dirname(__file__), "..", "..", "..", "src", "tekton-front")
+
+
+class Upstream(BaseHTTPRequestHandler):
+    """Echoes API requests as JSON; answers an Upgrade with 101 and then echoes raw bytes"""
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, *args):
+        pass
+
+    def do_GET(self):
+        if self.headers.get("Upgrade", "").lower() == "websocket":
+            self.send_response(101)
+            self.send_header("Upgrade", "websocket")
+            self.send_header("Connection", "Upgrade")
+            self.end_headers()
+            self.wfile.flush()
+            while True:
+                data = self.connection.recv(65536)
+                if not data or data == b"bye":
+                    self.close_connection = True
+                    return
+                self.connection.sendall(data)
+        self.answer(b"")
+
+    def do_POST(self):
+        self.answer(self.rfile.read(int(self.headers["Content-Length"])))
+
+    def answer(self, body):
+        payload = json.dumps({"path": self.path, "body": body.decode(),
+                              "forwarded": self.headers.get("X-Forwarded-For"),
+                              "connection": self.headers.get("Connection")}).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(payload)))
+        self.end_headers()
+        self.wfile.write(payload)
+
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+def wait_for(port):
+    for _ in range(100):
+        try:
+            socket.create_connection(("127.0.0.1", port), timeout=0.1).close()
+            return
+        except OSError:
+            time.sleep(0.02)
+    raise TimeoutError(f"nothing listening on {port}")
+
+
+@pytest.fixture
+def binary(tmp_path):
+    if not shutil.which("make") or not shutil.which("cc"):
+        pytest.skip("no C toolchain")
+    path = str(tmp_path / "tekton-front")
+    subprocess.run(["make", "-s", "-C", SOURCE, f"TARGET={path}"], check=True)
+    return path
+
+
+@pytest.fixture
+def front(binary, tmp_path):
+    root = tmp_path / "ui"
+    (root / "scripts").mkdir(parents=True)
+    (root / "index.html").write_text("<html>index</html>")
+    (root / "scripts" / "app.js").write_bytes(b"x" * 200000)
+
+    upstream = ThreadingHTTPServer(("127.0.0.1", 0), Upstream)
+    upstream.daemon_threads = True
+    threading.Thread(target=upstream.serve_forever, daemon=True).start()
+    port = free_port()
+    process = subprocess.Popen([binary, "--port", str(port), "--bind", "127.0.0.1", "--root", str(root),
+                                "--upstream", f"127.0.0.1:{upstream.server_address[1]}",
+                                "--route", f"/api/down/=127.0.0.1:{free_port()}"])
+    wait_for(port)
+    yield port
+    process.terminate()
+    process.wait()
+    upstream.shutdown()
+    upstream.server_close()
+
+
+def test_static_and_proxied_requests_share_a_keep_alive_connection(front):
+    conn = http.client.HTTPConnection("127.0.0.1", front, timeout=5)
+    conn.request("GET", "/")
+    response = conn.getresponse()
+    assert response.status == 200 and response.read() == b"<html>index</html>"
+    assert response.getheader("Content-Type") == "text/html"
+    modified = response.getheader("Last-Modified")
+
+    conn.request("GET", "/scripts/app.js?v=2")
+    response = conn.getresponse()
+    assert response.read() == b"x" * 200000
+    assert response.getheader("Content-Type") == "application/javascript"
+
+    conn.request("GET", "/scripts/app.js", headers={"If-Modified-Since": modified})
+    response = conn.getresponse()
+    assert response.status == 304 and response.read() == b""
+
+    conn.request("POST", "/api/settings", body=b"a" * 50000)
+    response = conn.getresponse()
+    echoed = json.loads(response.read())
+    assert echoed["path"] == "/api/settings" and echoed["body"] == "a" * 50000
+    assert echoed["forwarded"] == "127.0.0.1" and echoed["connection"] == "close"
+
+    # Missing files and traversal attempts are the upstream's to answer
+    conn.request("GET", "/scripts/../../secret")
+    assert json.loads(conn.getresponse().read())["path"] == "/scripts/../../secret"
+    conn.request("GET", "/missing.js")
+    assert json.loads(conn.getresponse().read())["path"] == "/missing.js"
+    conn.close()
+
+
+def test_pipelined_requests_are_answered_in_order(front):
+    with socket.create_connection(("127.0.0.1", front), timeout=5) as s:
+        s.sendall(b"GET /api/one HTTP/1.1\r\nHost: x\r\n\r\n"
+                  b"GET /index.html HTTP/1.1\r\nHost: x\r\n\r\n"
+                  b"GET /api/two HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n")
+        data = b""
+        while chunk := s.recv(65536):
+            data += chunk
+    assert data.count(b"HTTP/1") == 3
+    assert data.index(b"/api/one") < data.index(b"index</html>") < data.index(b"/api/two")
+
+
+def test_upgrade_becomes_a_tunnel(front):
+    with socket.create_connection(("127.0.0.1", front), timeout=5) as s:
+        s.sendall(b"GET /ws HTTP/1.1\r\nHost: x\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n\r\n")
+        head = b""
+        while b"\r\n\r\n" not in head:
+            head += s.recv(4096)
+        assert head.startswith(b"HTTP/1.1 101")
+        for size in (5, 100000):
+            s.sendall(b"m" * size)
+            echoed = b""
+            while len(echoed) < size:
+                echoed += s.recv(65536)
+            assert echoed == b"m" * size
+        # Other clients are served while the tunnel is open
+        conn = http.client.HTTPConnection("127.0.0.1", front, timeout=5)
+        conn.request("GET", "/api/health")
+        assert conn.getresponse().status == 200
+        s.sendall(b"bye")
+        assert s.recv(10) == b""
+
+
+def test_unreachable_backend_is_a_502(front):
+    conn = http.client.HTTPConnection("127.0.0.1", front, timeout=5)
+    conn.request("GET", "/api/down/status")
+    response = conn.getresponse()
+    assert response.status == 502
+    response.read()
+    conn.request("GET", "/index.html")
+    assert conn.getresponse().status == 200
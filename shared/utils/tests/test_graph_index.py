@@ -0,0 +1,177 @@
+"""
+Tests for the CSR graph index, natively and in Python.
+"""
+import os
+import random
+import shutil
+import subprocess
+
+import pytest
+
+from shared.utils import graph_index
+from shared.utils.graph_index import GraphIndex
+
+GRAPH_SOURCE = os.path.join(os.path.dirname(__file__), "..", "..", "..", "src", "tekton-graph")
+
+
+@pytest.fixture(scope="module")
+def library(tmp_path_factory):
+    if not shutil.which("make") or not shutil.which("cc"):
+        return None
+    path = str(tmp_path_factory.mktemp("tekton-graph") / graph_index.LIBRARY_NAME)
+    subprocess.run(["make", "-s", "-C", GRAPH_SOURCE, f"LIBRARY={path}"], check=True)
+    return path
+
+
+@pytest.fixture(params=["python", "native"])
+def backend(request, library, monkeypatch, tmp_path):
+    if request.param == "native" and library is None:
+        pytest.skip("no C toolchain")
+    path = library if request.param == "native" else str(tmp_path / "missing.so")
+    monkeypatch.setenv(graph_index.GRAPH_LIBRARY_ENV, path)
+    monkeypatch.setattr(graph_index, "_lib", None)
+    assert graph_index.native_available() == (request.param == "native")
+    return request.param
+
+
+def reference_paths(edges, source, target, max_hops):
+    """Brute force: every simple path, the lowest-numbered edge between consecutive nodes"""
+    first = {}
+    for edge_id, (s, t, _) in sorted(edges.items(), key=lambda item: int(item[0][1:])):
+        first.setdefault((s, t), edge_id)
+    found = set()
+
+    def walk(node, seen, path):
+        if node == target:
+            found.add(tuple(path))
+            return
+        if len(path) == max_hops:
+            return
+        for (s, t), edge_id in first.items():
+            if s == node and t not in seen:
+                walk(t, seen | {t}, path + [edge_id])
+
+    if source != target:
+        walk(source, {source}, [])
+    return found
+
+
+def test_edges_by_direction_and_type(backend):
+    index = GraphIndex()
+    index.add_edges([("r1", "a", "b", "knows"), ("r2", "b", "a", "likes"), ("r3", "a", "a", "knows")])
+    assert index.edges("a", "outgoing") == ["r1", "r3"]
+    assert index.edges("a", "incoming") == ["r2", "r3"]
+    assert index.edges("a", "both", "knows") == ["r1", "r3", "r3"]
+    assert index.edges("a", "both", "unknown") == []
+    assert index.edges("missing") == []
+    # Re-adding an edge id moves it
+    index.add_edge("r1", "b", "c", "knows")
+    assert index.edges("a", "outgoing") == ["r3"] and index.edges("c", "incoming") == ["r1"]
+    assert (index.node_count(), index.edge_count()) == (3, 3)
+
+
+def test_removing_a_node_removes_its_edges(backend):
+    index = GraphIndex()
+    index.add_edges([("r1", "a", "b", "t"), ("r2", "b", "c", "t"), ("r3", "b", "b", "t"), ("r4", "a", "c", "t")])
+    assert sorted(index.remove_node("b")) == ["r1", "r2", "r3"]
+    assert not index.has_node("b") and not index.has_edge("r2")
+    assert index.paths("a", "c", 3) == [["r4"]]
+    assert (index.node_count(), index.edge_count()) == (2, 1)
+
+
+def test_paths_match_brute_force(backend):
+    rng = random.Random(5)
+    for _ in range(40):
+        index, edges = GraphIndex(), {}
+        nodes = [f"n{i}" for i in range(rng.randint(3, 12))]
+        for i in range(rng.randint(5, 60)):
+            edges[f"e{i}"] = (rng.choice(nodes), rng.choice(nodes), "t")
+        index.add_edges((edge_id, s, t, kind) for edge_id, (s, t, kind) in edges.items())
+        for edge_id in rng.sample(sorted(edges), len(edges) // 5):
+            index.remove_edge(edge_id)
+            del edges[edge_id]
+        for _ in range(10):
+            source, target = rng.choice(nodes), rng.choice(nodes)
+            max_hops = rng.randint(1, 5)
+            if not index.has_node(source) or not index.has_node(target):
+                continue
+            found = index.paths(source, target, max_hops)
+            assert len(found) == len(set(map(tuple, found)))
+            assert set(map(tuple, found)) == reference_paths(edges, source, target, max_hops)
+
+
+def test_path_limit(backend):
+    index = GraphIndex()
+    # Two layers of ten nodes between a and z: 100 paths of three hops
+    index.add_edges([(f"a{i}", "a", f"m{i}", "t") for i in range(10)] +
+                    [(f"m{i}{j}", f"m{i}", f"k{j}", "t") for i in range(10) for j in range(10)] +
+                    [(f"z{j}", f"k{j}", "z", "t") for j in range(10)])
+    assert len(index.paths("a", "z", 3)) == 100
+    assert index.paths("a", "z", 2) == []
+    assert len(index.paths("a", "z", 3, limit=7)) == 7
+
+
+def test_neighborhood_levels(backend):
+    index = GraphIndex()
+    index.add_edges([("r1", "a", "b", "x"), ("r2", "b", "c", "x"), ("r3", "d", "a", "y"), ("r4", "c", "e", "x")])
+    nodes, edges = index.neighborhood(["a"], 2)
+    assert nodes[0] == "a" and set(nodes[1:3]) == {"b", "d"} and nodes[3:] == ["c"]
+    assert sorted(edges) == ["r1", "r2", "r3"]
+    assert index.neighborhood(["a"], 5, "outgoing", "x") == (["a", "b", "c", "e"], ["r1", "r2", "r4"])
+    assert index.neighborhood(["a"], 0) == (["a"], [])
+
+
+def test_parallel_expansion_matches_one_thread(library, monkeypatch):
+    if library is None:
+        pytest.skip("no C toolchain")
+    monkeypatch.setenv(graph_index.GRAPH_LIBRARY_ENV, library)
+    monkeypatch.setattr(graph_index, "_lib", None)
+    rng = random.Random(9)
+    edges = [(f"e{i}", f"n{rng.randrange(20000)}", f"n{rng.randrange(20000)}", "t") for i in range(100000)]
+    results = []
+    for threads in (1, 4):
+        index = GraphIndex(threads=threads)
+        index.add_edges(edges)
+        nodes, followed = index.neighborhood(["n1", "n2"], 4)
+        results.append((set(nodes), set(followed), len(nodes), len(followed)))
+    assert results[0] == results[1]
+    assert results[0][2] == len(results[0][0]) and results[0][2] > 4096
+
+
+def test_many_mutations_across_rebuilds(backend):
+    rng = random.Random(2)
+    index, live = GraphIndex(), {}
+    for step in range(20000):
+        if live and rng.random() < 0.3:
+            edge_id = rng.choice(list(live)) if step % 100 == 0 else next(iter(live))
+            index.remove_edge(edge_id)
+            del live[edge_id]
+        else:
+            live[f"e{step}"] = (f"n{rng.randrange(500)}", f"n{rng.randrange(500)}")
+            index.add_edge(f"e{step}", *live[f"e{step}"], "t")
+    assert index.edge_count() == len(live)
+    for node in ("n0", "n1", "n2"):
+        assert sorted(index.edges(node, "outgoing")) == sorted(e for e, (s, _) in live.items() if s == node)
+
+
+def test_edge_columns(backend):
+    from array import array
+    index = GraphIndex()
+    # Into an empty index the positions are used as they are
+    index.add_edge_columns(["r1", "r2"], ["a", "b", "c"], array("I", [0, 1]), array("I", [1, 2]),
+                           ["x", "y"], array("I", [0, 1]))
+    assert index.paths("a", "c", 2) == [["r1", "r2"]]
+    assert index.edges("b", "both", "y") == ["r2"]
+    # Into a populated one they are remapped, and existing ids are replaced
+    index.add_edge_columns(["r2", "r3"], ["d", "c"], array("I", [1, 0]), array("I", [0, 1]),
+                           ["y", "z"], array("I", [1, 0]))
+    assert index.edges("c", "outgoing") == ["r2"] and index.edges("c", "incoming", "z") == []
+    assert index.edges("c", "incoming", "y") == ["r3"] and index.edges("d", "incoming", "z") == ["r2"]
+    assert (index.node_count(), index.edge_count()) == (4, 3)
+
+
+def test_neighborhood_of_an_unknown_type(backend):
+    index = GraphIndex()
+    index.add_edges([("r1", "a", "b", "knows"), ("r2", "b", "c", "knows")])
+    assert index.neighborhood(["a", "missing", "a"], 2, "both", "works_at") == (["a"], [])
+    assert index.neighborhood(["a"], 2, "both", "knows") == (["a", "b", "c"], ["r1", "r2"])
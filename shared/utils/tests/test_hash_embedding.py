@@ -0,0 +1,74 @@
+"""
+Tests for the hashing text embedder (src/tekton-embed) through its binding.
+"""
+import math
+import os
+import shutil
+import subprocess
+from array import array
+
+import pytest
+
+from shared.utils import hash_embedding
+from shared.utils.hash_embedding import encode_into, token_component, token_hash, tokenize
+
+SOURCE = os.path.join(os.path.dirname(__file__), "..", "..", "..", "src", "tekton-embed")
+
+TEXTS = ["Hello, world! hello again", "Café—naïve “quoted” don’t", "", "!!!",
+         "a_b 12 3x", "the " * 50 + "end"]
+
+
+@pytest.fixture
+def library(tmp_path):
+    if not shutil.which("make") or not shutil.which("cc"):
+        pytest.skip("no C toolchain")
+    path = str(tmp_path / "libtekton-embed.so")
+    subprocess.run(["make", "-s", "-C", SOURCE, f"LIBRARY={path}"], check=True)
+    return path
+
+
+def reference(text, dim, seed=42):
+    counts = {}
+    for token in tokenize(text):
+        counts[token] = counts.get(token, 0) + 1
+    row = [0.0] * dim
+    for token, count in counts.items():
+        h = token_hash(token, seed)
+        for j in range(dim):
+            row[j] += token_component(h, j) / (1.0 + math.log(count))
+    norm = max(math.sqrt(sum(v * v for v in row)), 1e-10)
+    return [v / norm for v in row]
+
+
+def test_native_matches_definition(library):
+    """Tokens split on ASCII and Unicode punctuation; repeats are damped, empty texts stay zero."""
+    assert tokenize(TEXTS[1]) == [t.encode() for t in ("café", "naïve", "quoted", "don", "t")]
+    dim = 24
+    out = array("f", bytes(4 * dim * len(TEXTS)))
+    encode_into(TEXTS, out, dim, library=library)
+    for i, text in enumerate(TEXTS):
+        row = out[i * dim:(i + 1) * dim]
+        assert row == pytest.approx(reference(text, dim), abs=1e-5)
+    assert not any(out[2 * dim:4 * dim])
+
+
+def test_threads_do_not_change_vectors(library):
+    texts = [f"memory {i} about topic {i % 7}" for i in range(500)]
+    single = array("f", bytes(4 * 16 * len(texts)))
+    threaded = array("f", bytes(4 * 16 * len(texts)))
+    encode_into(texts, single, 16, threads=1, library=library)
+    encode_into(texts, threaded, 16, threads=4, library=library)
+    assert single == threaded
+    with pytest.raises(ValueError):
+        encode_into(texts, single, 17, library=library)
+
+
+def test_numpy_fallback_matches_native(library, monkeypatch):
+    np = pytest.importorskip("numpy")
+    native = np.empty((len(TEXTS), 32), dtype=np.float32)
+    encode_into(TEXTS, native, 32, library=library)
+    monkeypatch.setattr(hash_embedding, "_lib", None)
+    monkeypatch.setenv("TEKTON_EMBED_LIBRARY", os.path.join(os.path.dirname(library), "missing.so"))
+    fallback = np.empty((len(TEXTS), 32), dtype=np.float32)
+    encode_into(TEXTS, fallback, 32)
+    assert np.allclose(native, fallback, atol=1e-5)
@@ -0,0 +1,178 @@
+"""
+Tests for the streaming reverse proxy.
+"""
+import http.client
+import json
+import socket
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+import pytest
+
+from shared.utils.http_proxy import REPLAYABLE_BODY, Route, RouteTable, StreamingProxy
+
+
+class Backend(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    connections = 0
+    dropped = 0
+    release = threading.Event()
+
+    def log_message(self, *args):
+        pass
+
+    def setup(self):
+        super().setup()
+        type(self).connections += 1
+
+    def do_GET(self):
+        if self.path == "/api/stream":
+            self.stream()
+        elif self.path == "/api/stale":
+            # Claims keep-alive, then closes anyway
+            self.answer({"path": self.path})
+            self.close_connection = True
+        else:
+            self.answer({"path": self.path, "forwarded": self.headers.get("X-Forwarded-For")})
+
+    def do_POST(self):
+        body = self.rfile.read(int(self.headers["Content-Length"]))
+        if self.path == "/api/stream":
+            self.stream()
+        elif self.path == "/api/dropped":
+            # Processes the message, then goes away before answering
+            type(self).dropped += 1
+            self.close_connection = True
+        else:
+            self.answer({"length": len(body), "ok": body == b"b" * len(body)})
+
+    def stream(self):
+        """Server-sent events, the second held back until the test has seen the first"""
+        self.send_response(200)
+        self.send_header("Content-Type", "text/event-stream")
+        self.send_header("Transfer-Encoding", "chunked")
+        self.end_headers()
+        for event in (b"data: one\n\n", b"data: two\n\n"):
+            self.wfile.write(b"%x\r\n%s\r\n" % (len(event), event))
+            self.wfile.flush()
+            self.release.wait(5)
+        self.wfile.write(b"0\r\n\r\n")
+
+    def answer(self, obj):
+        payload = json.dumps(obj).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(payload)))
+        self.end_headers()
+        self.wfile.write(payload)
+
+
+def serve(server):
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server
+
+
+@pytest.fixture
+def proxy_port():
+    Backend.connections = 0
+    Backend.dropped = 0
+    Backend.release.clear()
+    backend = serve(ThreadingHTTPServer(("127.0.0.1", 0), Backend))
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        dead_port = s.getsockname()[1]
+    proxy = StreamingProxy(RouteTable([
+        Route("/api/", "127.0.0.1", backend.server_address[1]),
+        Route("/api/terminal/", "127.0.0.1", backend.server_address[1], rewrite="/terminal/"),
+        Route("/api/down/", "127.0.0.1", dead_port),
+    ]))
+
+    class Front(BaseHTTPRequestHandler):
+        """Like TektonUIRequestHandler, which speaks HTTP/1.1 only from do_GET"""
+
+        def log_message(self, *args):
+            pass
+
+        def do_GET(self):
+            self.protocol_version = "HTTP/1.1"
+            proxy.forward(self, proxy.routes.match(self.path))
+
+        def do_POST(self):
+            proxy.forward(self, proxy.routes.match(self.path))
+
+    front = serve(ThreadingHTTPServer(("127.0.0.1", 0), Front))
+    yield front.server_address[1]
+    for server in (front, backend):
+        server.shutdown()
+        server.server_close()
+    proxy.close()
+
+
+def test_longest_prefix_and_exact_routes():
+    table = RouteTable([Route("/api/", "a", 1), Route("/api/ai/", "b", 2),
+                        Route("/api/status", "c", 3, exact=True),
+                        Route("/api/terminal/", "d", 4, rewrite="/terminal/")])
+    assert table.match("/api/ai/chat").host == "b"
+    assert table.match("/api/status?x=1").host == "c"
+    assert table.match("/api/statuses").host == "a"
+    assert table.match("/api/terminal/run?q").target("/api/terminal/run?q") == "/terminal/run?q"
+    assert table.match("/other") is None
+
+
+def test_requests_reuse_one_backend_connection(proxy_port):
+    conn = http.client.HTTPConnection("127.0.0.1", proxy_port, timeout=5)
+    for i in range(5):
+        conn.request("GET", f"/api/terminal/{i}")
+        reply = json.loads(conn.getresponse().read())
+        assert reply == {"path": f"/terminal/{i}", "forwarded": "127.0.0.1"}
+    for size in (10, REPLAYABLE_BODY * 4):
+        conn.request("POST", "/api/upload", body=b"b" * size)
+        assert json.loads(conn.getresponse().read()) == {"length": size, "ok": True}
+    # The large body is streamed on a connection of its own
+    assert Backend.connections == 2
+
+
+def test_stale_pooled_connection_is_retried(proxy_port):
+    conn = http.client.HTTPConnection("127.0.0.1", proxy_port, timeout=5)
+    for _ in range(3):
+        conn.request("GET", "/api/stale")
+        assert json.loads(conn.getresponse().read()) == {"path": "/api/stale"}
+    assert Backend.connections == 3
+
+
+def test_post_the_backend_may_have_processed_is_not_resent(proxy_port):
+    conn = http.client.HTTPConnection("127.0.0.1", proxy_port, timeout=5)
+    conn.request("GET", "/api/pooled")
+    conn.getresponse().read()
+    # Goes out on the pooled connection, which the backend drops after reading
+    conn.request("POST", "/api/dropped", body=b"b" * 10)
+    assert conn.getresponse().status == 502
+    assert Backend.dropped == 1
+
+
+def test_event_stream_is_relayed_as_it_arrives(proxy_port):
+    conn = http.client.HTTPConnection("127.0.0.1", proxy_port, timeout=5)
+    conn.request("GET", "/api/stream")
+    response = conn.getresponse()
+    assert response.getheader("Content-Type") == "text/event-stream"
+    # The first event is readable while the backend is still holding the second
+    assert response.read1(100) == b"data: one\n\n"
+    Backend.release.set()
+    assert response.read() == b"data: two\n\n"
+
+
+def test_event_stream_answering_a_post(proxy_port):
+    # The front answers this as HTTP/1.0, so the stream is sent as it is and ends with the connection
+    conn = http.client.HTTPConnection("127.0.0.1", proxy_port, timeout=5)
+    conn.request("POST", "/api/stream", body=b"{}")
+    response = conn.getresponse()
+    assert response.version == 10 and response.getheader("Transfer-Encoding") is None
+    assert response.read1(100) == b"data: one\n\n"
+    Backend.release.set()
+    assert response.read() == b"data: two\n\n"
+
+
+def test_unreachable_backend_is_a_502(proxy_port):
+    conn = http.client.HTTPConnection("127.0.0.1", proxy_port, timeout=5)
+    conn.request("GET", "/api/down/x")
+    assert conn.getresponse().status == 502
@@ -0,0 +1,112 @@
+"""
+Tests for the till installation registry helpers.
+"""
+import json
+import os
+import shutil
+import subprocess
+from unittest.mock import patch
+
+import pytest
+
+from shared.utils.installations import (
+    Installation,
+    PortLease,
+    list_installations,
+    load_installation_env,
+    load_installation_components,
+    read_port_leases
+)
+
+LAUNCHER_SOURCE = os.path.join(os.path.dirname(__file__), "..", "..", "..", "src", "tekton-launcher")
+
+
+def _make_installation(tmp_path, name, port_base):
+    root = tmp_path / name
+    (root / "config").mkdir(parents=True)
+    (root / ".env.tekton").write_text("TEKTON_LOG_LEVEL=INFO\n")
+    (root / ".env.local").write_text(f"TEKTON_PORT_BASE={port_base}\nHERMES_PORT={port_base + 1}\n")
+    (root / "config" / "tekton_components.yaml").write_text(
+        "components:\n  hermes:\n    name: Hermes\n  rhetor:\n    name: Rhetor\n"
+    )
+    return root
+
+
+def test_list_installations_skips_missing_roots(tmp_path):
+    """Only registry entries that point at a real Tekton directory are returned."""
+    primary = _make_installation(tmp_path, "primary", 8000)
+    registry = tmp_path / "till-private.json"
+    registry.write_text(json.dumps({"installations": {
+        "primary.tekton.development.us": {"root": str(primary)},
+        "coder-z.tekton.development.us": {"root": str(tmp_path / "gone")},
+    }}))
+
+    installations = list_installations(registry)
+    assert installations == [Installation("primary.tekton.development.us", str(primary))]
+    assert installations[0].short_name == "primary"
+
+
+def test_list_installations_without_registry(tmp_path):
+    """A missing registry yields no installations rather than an error."""
+    assert list_installations(tmp_path / "missing.json") == []
+
+
+def test_load_installation_env_and_components(tmp_path):
+    """Each installation's env files are merged independently of our own environment."""
+    root = _make_installation(tmp_path, "coder-b", 8200)
+    with patch.dict(os.environ, {"HOME": str(tmp_path / "nohome")}):
+        env = load_installation_env(str(root))
+    assert env["HERMES_PORT"] == "8201"
+    assert env["TEKTON_LOG_LEVEL"] == "INFO"
+    assert env["TEKTON_ROOT"] == str(root)
+    assert load_installation_components(str(root)) == ["hermes", "rhetor"]
+
+
+def test_env_follows_port_lease(tmp_path):
+    """Ports are shifted into the block the launcher leased for the installation."""
+    root = _make_installation(tmp_path, "coder-c", 8100)
+    with open(root / ".env.local", "a") as f:
+        f.write("TEKTON_AI_PORT_BASE=44000\nHERMES_AI_PORT=44001\nPOSTGRES_PORT=5432\n")
+    with patch.dict(os.environ, {"HOME": str(tmp_path / "nohome")}):
+        env = load_installation_env(str(root), leases={str(root): PortLease(8300, 42000, 8100, 44000)})
+    assert env["TEKTON_PORT_BASE"] == "8300"
+    assert env["HERMES_PORT"] == "8301"
+    assert env["HERMES_AI_PORT"] == "42001"
+    assert env["POSTGRES_PORT"] == "5432"
+
+
+def test_lease_for_other_configured_blocks_is_ignored(tmp_path):
+    """After the base is reconfigured, the old lease no longer moves the ports."""
+    root = _make_installation(tmp_path, "coder-d", 8500)
+    with open(root / ".env.local", "a") as f:
+        f.write("TEKTON_AI_PORT_BASE=44000\n")
+    with patch.dict(os.environ, {"HOME": str(tmp_path / "nohome")}):
+        env = load_installation_env(str(root), leases={str(root): PortLease(8300, 42000, 8100, 44000)})
+    assert env["TEKTON_PORT_BASE"] == "8500"
+    assert env["HERMES_PORT"] == "8501"
+
+
+def test_leased_blocks_never_overlap_past_the_ci_floor(tmp_path):
+    """Filling the lease table past slot 34 keeps CI blocks out of every component block."""
+    if not shutil.which("make") or not shutil.which("cc"):
+        pytest.skip("no C toolchain")
+    launcher = str(tmp_path / "tekton-clean-launch")
+    subprocess.run(["make", "-s", "-C", LAUNCHER_SOURCE, f"TARGET={launcher}", "USDT=0"], check=True)
+    home = tmp_path / "home"
+    home.mkdir()
+    env = {"HOME": str(home), "PATH": os.environ.get("PATH", "")}
+
+    for i in range(38):
+        root = tmp_path / f"coder-{i}"
+        root.mkdir()
+        (root / ".env.tekton").write_text("TEKTON_PORT_BASE=8000\nTEKTON_AI_PORT_BASE=45000\n")
+        # start leases a block, then fails to exec the missing launcher script
+        subprocess.run([launcher, str(root), "start"], env=env, capture_output=True)
+
+    with patch.dict(os.environ, {"HOME": str(home)}):
+        leases = list(read_port_leases().values())
+    assert len(leases) == 34
+    blocks = [lease.port_base for lease in leases] + [lease.ai_port_base for lease in leases]
+    blocks.sort()
+    assert all(b - a >= 100 for a, b in zip(blocks, blocks[1:]))
+    assert min(lease.ai_port_base for lease in leases) >= 12000
@@ -0,0 +1,50 @@
+"""
+Tests for the launch timeline trace.
+"""
+import json
+import os
+import subprocess
+import sys
+
+from shared.utils.launch_trace import LaunchTrace, TRACE_FILE_ENV, TRACE_SPAWN_ENV
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
+
+
+def test_disabled_trace_is_noop(tmp_path):
+    """Without --trace nothing is recorded or written."""
+    trace = LaunchTrace()
+    with trace.span("fork", track="rhetor"):
+        pass
+    trace.instant("first line")
+    assert not trace.enabled
+    assert trace.events == []
+    assert trace.child_env() == {}
+    assert trace.write() is None
+
+
+def test_component_events_merge_into_trace(tmp_path):
+    """Spans from a child process land in the launcher's trace file."""
+    output = str(tmp_path / "trace.json")
+    trace = LaunchTrace(output)
+    with trace.span("fork", track="rhetor"):
+        env = dict(os.environ, PYTHONPATH=REPO_ROOT, TEKTON_NAME="rhetor", **trace.child_env())
+        assert TRACE_FILE_ENV in env and TRACE_SPAWN_ENV in env
+        subprocess.run([sys.executable, "-c", (
+            "from shared.utils.launch_trace import component_trace\n"
+            "with component_trace().span('hermes registration', cat='component'):\n"
+            "    pass\n"
+            "component_trace().instant('port bind', cat='component', port=8003)\n"
+        )], env=env, check=True)
+    trace.write()
+
+    with open(output) as f:
+        events = json.load(f)["traceEvents"]
+    names = {e["name"] for e in events}
+    assert {"fork", "hermes registration", "port bind", "process_name", "thread_name"} <= names
+    fork = next(e for e in events if e["name"] == "fork")
+    registration = next(e for e in events if e["name"] == "hermes registration")
+    # Same clock in both processes: the child's span sits inside the fork span
+    assert fork["ts"] <= registration["ts"] <= fork["ts"] + fork["dur"]
+    assert registration["pid"] != fork["pid"]
+    assert not os.path.exists(output + ".events")
@@ -0,0 +1,98 @@
+"""
+Tests for the component log segment index and indexed search.
+"""
+from datetime import datetime, timedelta
+
+from shared.utils import log_index
+from shared.utils.log_index import (
+    LogIndexWriter,
+    read_index,
+    required_literals,
+    search_log,
+    parse_since
+)
+
+
+def write_log(tmp_path, monkeypatch, lines, segment_bytes=200):
+    """Write lines through the index writer with small segments."""
+    monkeypatch.setattr(log_index, "SEGMENT_BYTES", segment_bytes)
+    path = str(tmp_path / "rhetor.log")
+    with open(path, "a", encoding="utf-8") as f:
+        writer = LogIndexWriter(f, path)
+        for line in lines:
+            writer.write(line + "\n")
+        writer.close()
+    return path
+
+
+def stamp(minutes_ago):
+    return (datetime.now() - timedelta(minutes=minutes_ago)).strftime("%Y-%m-%d %H:%M:%S")
+
+
+def test_required_literals_are_safe():
+    """Only text every match must contain is used for filtering."""
+    assert required_literals("connection refused") == [b"connection refused"]
+    assert required_literals(r"port \d+ in use") == [b"port ", b" in use"]
+    assert required_literals("timeout|refused") == []
+    assert required_literals("(abc)?def") == [b"def"]
+
+
+def test_segments_skipped_by_trigrams_level_and_time(tmp_path, monkeypatch):
+    """Segments that cannot match are not scanned, matches are still found."""
+    lines = [f"{stamp(120)} - rhetor - INFO - old request {i}" for i in range(20)]
+    lines += [f"{stamp(5)} - rhetor - ERROR - upstream timeout talking to engram"]
+    lines += ["Traceback (most recent call last):", "TimeoutError: engram"]
+    lines += [f"{stamp(1)} - rhetor - INFO - new request {i}" for i in range(20)]
+    path = write_log(tmp_path, monkeypatch, lines)
+    assert len(read_index(path)) > 3
+
+    results, skipped = search_log(path, "upstream timeout")
+    assert [line for _, line in results] == [lines[20].encode()]
+    assert skipped == len(read_index(path)) - 1
+
+    # Continuation lines inherit the level of their record
+    results, _ = search_log(path, "TimeoutError", min_level=3)
+    assert [line for _, line in results] == [b"TimeoutError: engram"]
+
+    results, skipped = search_log(path, None, since=parse_since("1h"), min_level=3)
+    assert [line for _, line in results][0] == lines[20].encode()
+    assert skipped > 0
+
+
+def test_unindexed_tail_is_scanned(tmp_path, monkeypatch):
+    """Lines written after the last closed segment are still searched."""
+    path = write_log(tmp_path, monkeypatch, [f"{stamp(1)} - x - INFO - indexed"], segment_bytes=1 << 20)
+    with open(path, "a") as f:
+        f.write(f"{stamp(0)} - x - INFO - written without the index\n")
+    results, _ = search_log(path, "without the index")
+    assert len(results) == 1
+
+
+def test_index_reset_for_replaced_log(tmp_path, monkeypatch):
+    """A fresh log file does not inherit the old index."""
+    path = write_log(tmp_path, monkeypatch, [f"{stamp(1)} - x - INFO - first run {i}" for i in range(20)])
+    assert read_index(path)
+    open(path, "w").close()
+    with open(path, "a") as f:
+        LogIndexWriter(f, path).close()
+    assert read_index(path) == []
+
+
+def test_segment_offsets_with_non_ascii_lines(tmp_path, monkeypatch):
+    """Offsets are UTF-8 byte offsets, so segments end on line boundaries."""
+    lines = [f"{stamp(1)} - x - INFO - caf\u00e9 \u2713 request {i}" for i in range(30)]
+    path = write_log(tmp_path, monkeypatch, lines)
+    with open(path, "rb") as f:
+        data = f.read()
+    segments = read_index(path)
+    assert len(segments) > 3
+    assert all(data[s.end - 1:s.end] == b"\n" for s in segments)
+    results, _ = search_log(path, "\u2713 request 17")
+    assert [line for _, line in results] == [lines[17].encode()]
+
+
+def test_bloom_positions_use_every_byte():
+    """Trigrams differing only in their last byte's high bits spread out."""
+    positions = [log_index._bloom_positions(b"ab" + bytes([c])) for c in range(256)]
+    assert len({h1 for h1, _ in positions}) > 250
+    assert len({h2 for _, h2 in positions}) > 250
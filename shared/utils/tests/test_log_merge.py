@@ -0,0 +1,64 @@
+"""
+Tests for merged component log reading.
+"""
+from shared.utils.log_merge import LogSource, line_key, merge_sources, merge_batches, tail_offset
+
+
+def write(path, text):
+    path.write_bytes(text.encode("utf-8"))
+    return str(path)
+
+
+def test_line_key_orders_fractional_timestamps():
+    """Second, millisecond and microsecond stamps compare correctly as bytes."""
+    plain = line_key(b"2025-01-01 10:00:02 [STDOUT] x", b"")
+    millis = line_key(b"2025-01-01 10:00:02,050 - x - INFO - y", b"")
+    later = line_key(b"2025-01-01 10:00:02.5 z", b"")
+    assert plain < millis < later
+    # Continuation lines inherit the previous key
+    assert line_key(b"  File \"x.py\", line 1", millis) == millis
+
+
+def test_merge_orders_across_components(tmp_path):
+    """Lines from several logs come out in timestamp order, tracebacks attached."""
+    apollo = write(tmp_path / "apollo.log",
+                   "2025-01-01 10:00:00 a1\n2025-01-01 10:00:02 a2\nTraceback:\n  frame\n")
+    rhetor = write(tmp_path / "rhetor.log",
+                   "2025-01-01 10:00:01 r1\n2025-01-01 10:00:03 r2")
+    sources = [LogSource("apollo", apollo), LogSource("rhetor", rhetor)]
+    merged = [(i, line.decode()) for i, line in merge_sources(sources)]
+    assert merged == [
+        (0, "2025-01-01 10:00:00 a1"),
+        (1, "2025-01-01 10:00:01 r1"),
+        (0, "2025-01-01 10:00:02 a2"),
+        (0, "Traceback:"),
+        (0, "  frame"),
+        (1, "2025-01-01 10:00:03 r2"),
+    ]
+
+
+def test_follow_holds_partial_lines(tmp_path):
+    """A line is only emitted once its newline has been written."""
+    path = tmp_path / "engram.log"
+    write(path, "2025-01-01 10:00:00 first\n2025-01-01 10:00:01 sec")
+    source = LogSource("engram", str(path))
+    assert [l for _, l in source.read_lines()] == [b"2025-01-01 10:00:00 first"]
+    with open(path, "ab") as f:
+        f.write(b"ond\n")
+    assert [l for _, l in source.read_lines()] == [b"2025-01-01 10:00:01 second"]
+    # Truncation by a fresh launch starts over
+    write(path, "2025-01-01 11:00:00 restarted\n")
+    assert [l for _, l in source.read_lines()] == [b"2025-01-01 11:00:00 restarted"]
+    source.close()
+
+
+def test_tail_offset_and_batches(tmp_path):
+    """Tailing starts at the last N lines; batch merge interleaves by key."""
+    path = write(tmp_path / "hermes.log", "".join(f"2025-01-01 10:00:0{i} h{i}\n" for i in range(5)))
+    source = LogSource("hermes", path, start_lines=2)
+    assert tail_offset(path, 2) == len("2025-01-01 10:00:00 h0\n") * 3
+    batch = source.read_lines()
+    assert [l for _, l in batch] == [b"2025-01-01 10:00:03 h3", b"2025-01-01 10:00:04 h4"]
+    other = [(line_key(b"2025-01-01 10:00:03,5 x", b""), b"2025-01-01 10:00:03,5 x")]
+    assert [i for i, _ in merge_batches([(0, batch), (1, other)])] == [0, 1, 0]
+    source.close()
@@ -0,0 +1,126 @@
+"""
+Tests for PSI parsing, memory shedding and the adaptive launch window.
+"""
+from shared.utils.pressure import LaunchWindow, MemoryGuard, StallSampler, parse_size, read_psi
+
+MB = 2 ** 20
+
+
+def test_read_psi_and_sizes(tmp_path):
+    """PSI files parse into some/full averages; sizes accept unit suffixes."""
+    (tmp_path / "memory").write_text(
+        "some avg10=12.50 avg60=4.00 avg300=1.00 total=123456\n"
+        "full avg10=3.25 avg60=1.00 avg300=0.20 total=6543\n"
+    )
+    psi = read_psi("memory", str(tmp_path))
+    assert psi["some"]["avg10"] == 12.5
+    assert psi["full"]["total"] == 6543
+    assert read_psi("cpu", str(tmp_path)) is None
+
+    assert parse_size("6G") == 6 * 1024 ** 3
+    assert parse_size("512MiB") == 512 * MB
+    assert parse_size("4096") == 4096
+
+
+def test_guard_sheds_by_priority_and_resumes_in_reverse():
+    """Sustained pressure sheds the least important components first; calm brings them back."""
+    guard = MemoryGuard(mode="suspend", psi_high=10, psi_low=2, sustain=30, clear=60, cooldown=10)
+    pss = {"hermes": 100 * MB, "engram": 900 * MB, "sophia": 600 * MB, "rhetor": 800 * MB}
+    priorities = {"hermes": 1, "engram": 2, "sophia": 4, "rhetor": 3}
+
+    # A short spike is ignored
+    assert guard.evaluate(0, 25.0, pss, priorities) is None
+    assert guard.evaluate(20, 25.0, pss, priorities) is None
+    first = guard.evaluate(30, 25.0, pss, priorities)
+    assert (first.action, first.component) == ("suspend", "sophia")
+    # Cooldown between actions, then the next lowest priority
+    assert guard.evaluate(35, 25.0, pss, priorities) is None
+    assert guard.evaluate(40, 25.0, pss, priorities).component == "rhetor"
+
+    # Pressure clears; resumes wait for the clear period and come back last-shed first
+    assert guard.evaluate(50, 1.0, pss, priorities) is None
+    assert guard.evaluate(109, 1.0, pss, priorities) is None
+    assert guard.evaluate(110, 1.0, pss, priorities).component == "rhetor"
+    assert guard.evaluate(115, 1.0, pss, priorities) is None
+    resumed = guard.evaluate(120, 1.0, pss, priorities)
+    assert (resumed.action, resumed.component) == ("resume", "sophia")
+    assert guard.shed == []
+
+
+def test_guard_enforces_budget_without_psi():
+    """Over budget sheds immediately; resume waits until the component fits again."""
+    guard = MemoryGuard(budget_bytes=1500 * MB, mode="stop", clear=0, cooldown=0)
+    pss = {"hermes": 200 * MB, "engram": 800 * MB, "sophia": 700 * MB}
+    priorities = {"hermes": 1, "engram": 2, "sophia": 4}
+
+    decision = guard.evaluate(0, None, pss, priorities)
+    assert (decision.action, decision.component) == ("stop", "sophia")
+    # Stopped components drop out of the samples
+    del pss["sophia"]
+    assert guard.evaluate(1, None, pss, priorities) is None
+
+    # Engram grows: bringing Sophia back would exceed the budget
+    pss["engram"] = 900 * MB
+    assert guard.evaluate(2, None, pss, priorities) is None
+    pss["engram"] = 500 * MB
+    assert guard.evaluate(3, None, pss, priorities).action == "resume"
+
+
+def test_suspended_components_still_count_against_the_budget():
+    """A suspend frees no memory, so suspended PSS stays in the total and the budget is met by stopping."""
+    guard = MemoryGuard(budget_bytes=2000 * MB, mode="suspend", sustain=0, clear=0, cooldown=0)
+    pss = {"hermes": 100 * MB, "engram": 800 * MB, "sophia": 600 * MB, "rhetor": 400 * MB}
+    priorities = {"hermes": 1, "engram": 2, "sophia": 4, "rhetor": 3}
+
+    # PSI pressure alone suspends; the suspended process keeps its samples
+    assert guard.evaluate(0, 25.0, pss, priorities).action == "suspend"
+    pss["engram"] = 1000 * MB
+    # Suspended Sophia ranks below everything running, so it is the one stopped
+    decision = guard.evaluate(1, 1.0, pss, priorities)
+    assert (decision.action, decision.component) == ("stop", "sophia")
+    assert "PSS 2100 MB" in decision.reason
+    assert guard.shed == ["sophia"]
+    del pss["sophia"]
+
+    # Sophia's 600 MB would not fit until Engram shrinks
+    assert guard.evaluate(2, 1.0, pss, priorities) is None
+    pss["engram"] = 800 * MB
+    resumed = guard.evaluate(3, 1.0, pss, priorities)
+    assert (resumed.action, resumed.component) == ("resume", "sophia")
+    assert guard.shed == []
+
+
+def test_suspended_component_is_not_stopped_before_a_less_important_one():
+    """Over budget, a running component less important than the suspended one goes first."""
+    guard = MemoryGuard(budget_bytes=2000 * MB, mode="suspend", sustain=0, clear=0, cooldown=0)
+    pss = {"hermes": 100 * MB, "engram": 800 * MB, "sophia": 600 * MB}
+    priorities = {"hermes": 1, "engram": 2, "sophia": 4, "rhetor": 5}
+
+    assert guard.evaluate(0, 25.0, pss, priorities).component == "sophia"
+    # Rhetor started later and ranks below Sophia
+    pss["rhetor"] = 600 * MB
+    decision = guard.evaluate(1, 1.0, pss, priorities)
+    assert (decision.action, decision.component) == ("stop", "rhetor")
+    assert guard.shed_action == {"sophia": "suspend", "rhetor": "stop"}
+
+
+def test_launch_window_follows_stall_rate(tmp_path):
+    """Stall rates come from PSI total deltas; the window grows additively and halves on stalls."""
+    def write_totals(cpu_us, io_us):
+        (tmp_path / "cpu").write_text(f"some avg10=0.00 avg60=0.00 avg300=0.00 total={cpu_us}\n")
+        (tmp_path / "io").write_text(f"some avg10=0.00 avg60=0.00 avg300=0.00 total={io_us}\n")
+
+    sampler = StallSampler(psi_dir=str(tmp_path))
+    write_totals(0, 0)
+    assert sampler.sample(10.0) is None
+    # 0.5s later: 50ms of CPU stall (10%), 300ms of IO stall (60%)
+    write_totals(50_000, 300_000)
+    assert abs(sampler.sample(10.5) - 60.0) < 1e-6
+
+    window = LaunchWindow(initial=2, maximum=4, low=10, high=40)
+    assert [window.update(s) for s in (0, 5, 5, 5)] == [3, 4, 4, 4]
+    assert window.update(60) == 2
+    assert window.update(20) == 2
+    assert window.update(None) == 2
+    assert window.update(90) == 1
+    assert window.update(90) == 1
@@ -0,0 +1,164 @@
+"""
+Tests for the shared-memory message bus (src/tekton-bus) through its binding.
+"""
+import asyncio
+import errno
+import importlib.util
+import os
+import select
+import shutil
+import subprocess
+import threading
+import time
+
+import pytest
+
+from shared.utils import shm_bus
+from shared.utils.shm_bus import BUS_LIBRARY_ENV, BUS_SOCKET_ENV, SharedBus, stop_broker
+
+SOURCE = os.path.join(os.path.dirname(__file__), "..", "..", "..", "src", "tekton-bus")
+MESSAGE_BUS = os.path.join(os.path.dirname(__file__), "..", "..", "..", "Hermes", "hermes", "core", "message_bus.py")
+
+
+@pytest.fixture
+def broker(tmp_path, request):
+    """Build the library and broker into tmp_path and serve a private socket"""
+    if not shutil.which("make") or not shutil.which("cc"):
+        pytest.skip("no C toolchain")
+    library = str(tmp_path / "libtekton-bus.so")
+    subprocess.run(["make", "-s", "-C", SOURCE, f"LIBRARY={library}",
+                    f"BROKER={tmp_path / 'tekton-busd'}"], check=True)
+    root = tmp_path / "root"
+    path = root / ".tekton" / "run" / "bus.sock"
+    path.parent.mkdir(parents=True)
+    options = getattr(request, "param", ["--ring", "4"])
+    process = subprocess.Popen([str(tmp_path / "tekton-busd"), "--socket", str(path)] + options,
+                               stderr=subprocess.DEVNULL)
+    while not path.exists():
+        time.sleep(0.01)
+    yield str(path), library, str(root)
+    process.terminate()
+    process.wait()
+
+
+def test_publish_wakes_matching_subscribers(broker):
+    """Patterns follow MessageBus; a bus neither hears nor wakes itself."""
+    path, library, _ = broker
+    publisher = SharedBus.connect(path, library)
+    listener = SharedBus.connect(path, library)
+    events = listener.subscribe("events.*")
+    exact = listener.subscribe("other")
+    own = publisher.subscribe("events.*")
+
+    publisher.publish("events.user", b"one")
+    publisher.publish("events.user", b"two")
+    ready, _, _ = select.select([events, exact, own], [], [], 1.0)
+    assert ready == [events]
+    assert [(t, d) for t, d, _ in events.drain()] == [("events.user", b"one"), ("events.user", b"two")]
+    assert events.drain() == [] and exact.drain() == [] and own.drain() == []
+
+    # Caught up and armed again: the next message wakes it
+    listener.publish("events.system", b"three")
+    ready, _, _ = select.select([events, own], [], [], 1.0)
+    assert ready == [own]
+    assert own.drain()[0][1:] == (b"three", listener.origin)
+    for bus in (publisher, listener):
+        bus.close()
+
+
+def test_bounded_history_and_overrun(broker):
+    """Each topic keeps ring-size history; a lagging subscriber skips ahead and counts the loss."""
+    path, library, root = broker
+    publisher = SharedBus.connect(path, library)
+    listener = SharedBus.connect(path, library)
+    sub = listener.subscribe("metrics")
+    for i in range(10):
+        publisher.publish("metrics", b"m%d" % i)
+
+    assert [d for _, d, _ in sub.drain()] == [b"m6", b"m7", b"m8", b"m9"]
+    assert sub.dropped == 6
+    assert publisher.history("metrics", 2) == [b"m8", b"m9"]
+    assert publisher.history("unknown") == []
+    with pytest.raises(OSError):
+        publisher.publish("metrics", b"x" * (publisher.max_payload + 1))
+
+    for bus in (publisher, listener):
+        bus.close()
+    assert stop_broker(root)
+
+
+@pytest.mark.parametrize("broker", [["--topics", "2"]], indirect=True)
+def test_full_topic_table_is_an_error(broker):
+    """Topics are never reclaimed; a new one past the table fails instead of vanishing."""
+    path, library, _ = broker
+    bus = SharedBus.connect(path, library)
+    bus.publish("a", b"1")
+    bus.publish("b", b"2")
+    with pytest.raises(OSError) as failure:
+        bus.publish("c", b"3")
+    assert failure.value.errno == errno.ENOSPC
+    assert bus.publish("a", b"4") == 1
+    bus.close()
+
+
+def test_coroutine_callbacks_run_on_the_subscribers_loop(broker, monkeypatch):
+    """The feed thread hands coroutine callbacks back to the bus's event loop."""
+    path, library, _ = broker
+    message_bus = _load_message_bus(monkeypatch, path, library)
+
+    async def main():
+        loop = asyncio.get_running_loop()
+        seen = loop.create_future()
+
+        async def on_event(envelope):
+            seen.set_result((threading.current_thread(), envelope["payload"]))
+
+        bus = message_bus.MessageBus()
+        bus.subscribe("status", lambda envelope: None)
+        # Subscribed off the loop, so the feed thread waits on this pattern
+        await asyncio.to_thread(bus.subscribe, "events.*", on_event)
+        publisher = SharedBus.connect(path, library)
+        publisher.publish("events.user", b'{"headers": {}, "payload": "hello"}')
+        result = await asyncio.wait_for(seen, 5)
+        publisher.close()
+        bus.close()
+        return result
+
+    thread, payload = asyncio.run(main())
+    assert thread is threading.main_thread() and payload == "hello"
+
+
+def _load_message_bus(monkeypatch, path, library):
+    monkeypatch.setenv(BUS_SOCKET_ENV, path)
+    monkeypatch.setenv(BUS_LIBRARY_ENV, library)
+    monkeypatch.setattr(shm_bus, "_lib", None)
+    spec = importlib.util.spec_from_file_location("hermes_message_bus", MESSAGE_BUS)
+    message_bus = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(message_bus)
+    return message_bus
+
+
+def test_oversized_messages_stay_in_history(broker, monkeypatch, caplog):
+    """Messages over the slot payload are kept locally and still show up in get_history, warned about once."""
+    path, library, _ = broker
+    message_bus = _load_message_bus(monkeypatch, path, library)
+    bus = message_bus.MessageBus()
+    big = "x" * bus.connection.max_payload
+    with caplog.at_level("WARNING"):
+        assert bus.publish("status", "small one")
+        assert bus.publish("status", big)
+        assert bus.publish("status", big)
+        assert bus.publish("status", "small two")
+    assert [e["payload"] for e in bus.get_history("status")] == ["small one", big, big, "small two"]
+    assert [e["payload"] for e in bus.get_history("status", 2)] == [big, "small two"]
+    assert len([r for r in caplog.records if "rejected" in r.getMessage()]) == 1
+    bus.close()
+
+
+def test_unserializable_message_fails_without_a_broker(tmp_path, monkeypatch):
+    message_bus = _load_message_bus(monkeypatch, str(tmp_path / "none.sock"), str(tmp_path / "none.so"))
+    bus = message_bus.MessageBus()
+    assert bus.connection is None
+    assert not bus.publish("status", {"not json": object()})
+    assert bus.get_history("status") == []
+    assert bus.publish("status", {"ok": 1})
@@ -0,0 +1,62 @@
+"""
+Tests for listening socket handoff used by overlapping restarts.
+"""
+import os
+import socket
+from unittest.mock import patch
+
+import pytest
+
+pytest.importorskip("uvicorn")
+
+from shared.utils.socket_server import (
+    create_listen_socket,
+    start_handoff_listener,
+    request_listen_socket,
+    handoff_socket_path,
+    LISTEN_FD_ENV
+)
+
+
+def test_handoff_shares_listening_socket(tmp_path):
+    """The launcher receives the same socket the component listens on."""
+    with patch.dict(os.environ, {"TEKTON_ROOT": str(tmp_path)}):
+        sock = create_listen_socket("127.0.0.1", 0)
+        port = sock.getsockname()[1]
+        handoff = start_handoff_listener(sock, "rhetor")
+        try:
+            received, info = request_listen_socket("rhetor")
+            assert info == {"pid": os.getpid(), "port": port}
+            # Closing the original leaves the port open through the duplicate
+            handoff.close()
+            sock.close()
+            client = socket.create_connection(("127.0.0.1", port), timeout=2)
+            conn, _ = received.accept()
+            conn.close()
+            client.close()
+            received.close()
+        finally:
+            handoff.close()
+            sock.close()
+        assert not os.path.exists(handoff_socket_path("rhetor"))
+
+
+def test_inherited_fd_is_used(tmp_path):
+    """A replacement started with TEKTON_LISTEN_FD does not bind again."""
+    original = create_listen_socket("127.0.0.1", 0)
+    fd = os.dup(original.fileno())
+    try:
+        with patch.dict(os.environ, {LISTEN_FD_ENV: str(fd)}):
+            inherited = create_listen_socket("127.0.0.1", original.getsockname()[1])
+            assert LISTEN_FD_ENV not in os.environ
+        assert inherited.fileno() == fd
+        assert inherited.getsockname() == original.getsockname()
+        inherited.close()
+    finally:
+        original.close()
+
+
+def test_no_handoff_when_not_running(tmp_path):
+    """Components that never offered a socket fall back to stop/start."""
+    with patch.dict(os.environ, {"TEKTON_ROOT": str(tmp_path)}):
+        assert request_listen_socket("apollo") is None
@@ -0,0 +1,131 @@
+"""
+Tests for the supervisor control channel used for relayed heartbeats.
+"""
+import asyncio
+import os
+from unittest.mock import patch
+
+from shared.utils.supervisor_channel import (
+    SupervisorChannel,
+    HeartbeatRelay,
+    HEARTBEAT_INTERVAL,
+    SUPERVISOR_FD_ENV
+)
+
+
+def test_channel_absent_without_env():
+    """Components not started by the launcher have no channel."""
+    with patch.dict(os.environ, {}, clear=True):
+        assert SupervisorChannel.from_env() is None
+
+
+def test_report_reaches_relay():
+    """Liveness records sent on the inherited fd show up in the relay snapshot."""
+    relay = HeartbeatRelay("http://localhost:8001")
+    try:
+        with patch.dict(os.environ, relay.child_env()):
+            channel = SupervisorChannel.from_env()
+        assert channel is not None
+        assert channel.report("rhetor", component_id="rhetor-abc", token="t0k")
+        relay._drain()
+        snapshot = relay.snapshot()
+        assert snapshot["rhetor"]["component_id"] == "rhetor-abc"
+        assert "token" not in snapshot["rhetor"]
+        channel.close()
+    finally:
+        relay.stop()
+
+
+def test_relay_forwards_well_within_a_heartbeat_interval():
+    """A relayed heartbeat reaches Hermes long before the next one is due."""
+    relays = [HeartbeatRelay("http://localhost:8001"),
+              HeartbeatRelay("http://localhost:8001", heartbeat_interval=8)]
+    try:
+        assert relays[0].interval <= HEARTBEAT_INTERVAL / 2
+        assert relays[1].interval == 2
+    finally:
+        for relay in relays:
+            relay.stop()
+
+
+def test_report_fails_when_supervisor_gone():
+    """Once the supervisor exits, report() returns False so callers fall back."""
+    relay = HeartbeatRelay("http://localhost:8001")
+    fd = os.dup(relay.child_fd)
+    relay.stop()
+    channel = SupervisorChannel(fd)
+    assert channel.report("engram") is False
+    assert channel.available is False
+    os.close(fd)
+
+
+class FakeResponse:
+    def __init__(self, status, rejected=()):
+        self.status = status
+        self.rejected = list(rejected)
+
+    async def __aenter__(self):
+        return self
+
+    async def __aexit__(self, *args):
+        return False
+
+    async def json(self):
+        return {"success": not self.rejected, "rejected": self.rejected}
+
+
+def test_flush_sends_single_batch():
+    """Pending records from many components are forwarded in one request."""
+    posted = []
+
+    class FakeSession:
+        def post(self, url, json=None, timeout=None):
+            posted.append((url, json))
+            return FakeResponse(200)
+
+    relay = HeartbeatRelay("http://localhost:8001/")
+    try:
+        channel = SupervisorChannel(relay.child_fd)
+        for name in ("apollo", "athena", "sophia"):
+            channel.report(name, component_id=f"{name}-1", token="tok")
+        relay._drain()
+        assert asyncio.run(relay.flush(FakeSession()))
+        assert len(posted) == 1
+        url, body = posted[0]
+        assert url == "http://localhost:8001/api/heartbeat/batch"
+        assert len(body["heartbeats"]) == 3
+        channel.close()
+    finally:
+        relay.stop()
+
+
+def test_failed_batch_is_retried_on_the_next_flush():
+    """A batch Hermes did not take stays pending; the next flush carries the newest record."""
+    posted = []
+    answers = [FakeResponse(503), FakeResponse(200, rejected=["athena-1"]), FakeResponse(200)]
+
+    class FakeSession:
+        def post(self, url, json=None, timeout=None):
+            posted.append({hb["component_id"]: hb["status"]["health"] for hb in json["heartbeats"]})
+            return answers.pop(0)
+
+    relay = HeartbeatRelay("http://localhost:8001")
+    try:
+        channel = SupervisorChannel(relay.child_fd)
+        channel.report("apollo", component_id="apollo-1", token="tok")
+        channel.report("athena", component_id="athena-1", token="tok")
+        relay._drain()
+        assert not asyncio.run(relay.flush(FakeSession()))
+        # Apollo reports again before the retry
+        channel.report("apollo", status="degraded", component_id="apollo-1", token="tok")
+        relay._drain()
+        # Delivered this time; Hermes rejects Athena's entry
+        assert not asyncio.run(relay.flush(FakeSession()))
+        assert posted == [{"apollo-1": "healthy", "athena-1": "healthy"},
+                          {"apollo-1": "degraded", "athena-1": "healthy"}]
+        # Nothing is left pending, the rejected entry included
+        assert asyncio.run(relay.flush(FakeSession()))
+        assert len(posted) == 2
+        channel.close()
+    finally:
+        relay.stop()
@@ -0,0 +1,86 @@
+"""
+Tests for the supervisor's OpenMetrics exposition.
+"""
+import socket
+
+from shared.utils.supervisor_metrics import SupervisorMetrics, MetricsServer, count_restart, read_restarts
+
+
+def sample_lines(text):
+    return [line for line in text.splitlines() if not line.startswith("#")]
+
+
+def test_render_openmetrics():
+    """Counters, gauges and the health histogram render in OpenMetrics form."""
+    metrics = SupervisorMetrics(["hermes", "rhetor"])
+    metrics.component_started("rhetor", pid=1234, readiness=2.5)
+    metrics.component_restarted("rhetor")
+    metrics.observe_health("rhetor", 0.02, True)
+    metrics.observe_health("rhetor", 3.0, False)
+    for _ in range(3):
+        metrics.log_line("rhetor", "stderr")
+
+    text = metrics.render()
+    assert text.endswith("# EOF\n")
+    lines = sample_lines(text)
+    assert 'tekton_component_restarts_total{component="rhetor"} 1' in lines
+    assert 'tekton_component_readiness_seconds{component="rhetor"} 2.5' in lines
+    assert 'tekton_component_up{component="rhetor"} 0' in lines
+    assert 'tekton_component_log_lines_total{component="rhetor",stream="stderr"} 3' in lines
+    assert 'tekton_component_health_check_duration_seconds_bucket{component="rhetor",le="0.025"} 1' in lines
+    assert 'tekton_component_health_check_duration_seconds_bucket{component="rhetor",le="+Inf"} 2' in lines
+    assert 'tekton_component_health_check_duration_seconds_count{component="rhetor"} 2' in lines
+    # Hermes never started, so it has no uptime sample
+    assert not any(line.startswith('tekton_component_uptime_seconds{component="hermes"}') for line in lines)
+
+
+def test_scrape_over_unix_socket(tmp_path):
+    """The metrics socket answers plain HTTP GETs."""
+    metrics = SupervisorMetrics(["engram"])
+    metrics.observe_health("engram", 0.004, True)
+    path = str(tmp_path / "run" / "metrics.sock")
+    server = MetricsServer(metrics, unix_path=path)
+    server.start()
+    try:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as client:
+            client.connect(path)
+            client.sendall(b"GET /metrics HTTP/1.0\r\nHost: localhost\r\n\r\n")
+            response = b""
+            while chunk := client.recv(65536):
+                response += chunk
+    finally:
+        server.stop()
+    head, body = response.split(b"\r\n\r\n", 1)
+    assert b"200" in head.split(b"\r\n")[0]
+    assert b"application/openmetrics-text" in head
+    assert b'tekton_component_up{component="engram"} 1' in body
+
+
+def test_recorded_samples_skip_replaced_pids():
+    """Samples are stored by the event loop; a restart in between makes them stale."""
+    metrics = SupervisorMetrics(["hermes", "rhetor"])
+    metrics.component_started("hermes", pid=100)
+    metrics.component_started("rhetor", pid=200)
+    metrics.observe_health("rhetor", 0.01, True)
+    samples = {"hermes": (100, (4096.0, None, 1.5)), "rhetor": (200, None)}
+    metrics.component_started("hermes", pid=101)
+    metrics.record_samples(samples)
+    assert metrics.values["memory_rss_bytes"][0] == 0 and metrics.pids["hermes"] == 101
+    assert "rhetor" not in metrics.pids and metrics.values["up"][1] == 0
+    metrics.record_samples({"hermes": (101, (4096.0, 2048.0, 0.5))})
+    assert (metrics.values["memory_pss_bytes"][0], metrics.values["cpu_seconds"][0]) == (2048.0, 0.5)
+
+
+def test_restarts_from_other_processes_reach_the_supervisor(tmp_path):
+    """`tekton restart` counts on disk; the supervisor picks the counts up for the components it tracks."""
+    root = str(tmp_path)
+    assert read_restarts(root) == {}
+    assert [count_restart(root, "rhetor") for _ in range(11)][-1] == 11
+    count_restart(root, "apollo")
+    assert read_restarts(root) == {"rhetor": 11, "apollo": 1}
+
+    metrics = SupervisorMetrics(["rhetor"])
+    metrics.record_restarts(read_restarts(root))
+    lines = sample_lines(metrics.render())
+    assert 'tekton_component_restarts_total{component="rhetor"} 11' in lines
+    assert not any('component="apollo"' in line for line in lines)
@@ -0,0 +1,143 @@
+"""
+Tests for WebSocket framing, natively and in Python.
+"""
+import os
+import shutil
+import socket
+import struct
+import subprocess
+
+import pytest
+
+from shared.utils import ws_frames
+from shared.utils.ws_frames import (CLOSE_INVALID_DATA, CLOSE_PROTOCOL, CLOSE_TOO_BIG, OP_BINARY,
+                                    OP_CLOSE, OP_PING, OP_TEXT, DeflateParams, FrameDecoder,
+                                    FrameEncoder, WebSocketError, frame_header, negotiate_deflate,
+                                    unmask)
+
+WS_SOURCE = os.path.join(os.path.dirname(__file__), "..", "..", "..", "src", "tekton-ws")
+
+
+@pytest.fixture(scope="module")
+def library(tmp_path_factory):
+    if not shutil.which("make") or not shutil.which("cc"):
+        return None
+    path = str(tmp_path_factory.mktemp("tekton-ws") / ws_frames.LIBRARY_NAME)
+    subprocess.run(["make", "-s", "-C", WS_SOURCE, f"LIBRARY={path}"], check=True)
+    return path
+
+
+@pytest.fixture(params=["python", "native"])
+def backend(request, library, monkeypatch, tmp_path):
+    if request.param == "native" and library is None:
+        pytest.skip("no C toolchain")
+    path = library if request.param == "native" else str(tmp_path / "missing.so")
+    monkeypatch.setenv(ws_frames.WS_LIBRARY_ENV, path)
+    monkeypatch.setattr(ws_frames, "_lib", None)
+    assert ws_frames.native_available() == (request.param == "native")
+    return request.param
+
+
+def masked(opcode, payload, fin=True, mask=b"\x01\x02\x03\x04"):
+    return frame_header(opcode, len(payload), fin=fin, mask=mask) + unmask(payload, mask)
+
+
+def decode(decoder, data):
+    decoder.feed(data)
+    return list(decoder.messages())
+
+
+def test_round_trip_in_small_pieces(backend):
+    messages = [(OP_TEXT, "héllo".encode() * n) for n in (0, 1, 30, 20000)] + [
+        (OP_BINARY, os.urandom(70000)), (OP_PING, b"ping")]
+    stream = b"".join(FrameEncoder(server=False).encode(op, data) for op, data in messages)
+    decoder = FrameDecoder(capacity=4096)
+    received = []
+    for first in range(0, len(stream), 999):
+        received += decode(decoder, stream[first:first + 999])
+    assert received == messages
+    assert decoder.pending() == 0
+
+
+def test_fragments_with_interleaved_ping(backend):
+    decoder = FrameDecoder()
+    assert decode(decoder, masked(OP_TEXT, b"frag", fin=False)) == []
+    assert decode(decoder, masked(OP_PING, b"!")) == [(OP_PING, b"!")]
+    assert decode(decoder, masked(0, b"men", fin=False) + masked(0, b"ted")) == [(OP_TEXT, b"fragmented")]
+
+
+@pytest.mark.parametrize("params", [DeflateParams(), DeflateParams(True, True)])
+def test_deflate_both_directions(backend, params):
+    text = b'{"type": "TERMINAL", "data": "' + b"ls -la\r\n" * 500 + b'"}'
+    for server in (True, False):
+        encoder = FrameEncoder(server=not server, deflate=params)
+        decoder = FrameDecoder(server=server, deflate=params)
+        for _ in range(3):
+            frame = encoder.encode(OP_TEXT, text)
+            assert frame[0] & 0x40 and len(frame) < len(text) // 10
+            assert decode(decoder, frame) == [(OP_TEXT, text)]
+        # Short messages go uncompressed
+        assert decode(decoder, encoder.encode(OP_TEXT, b"hi")) == [(OP_TEXT, b"hi")]
+
+
+def test_python_and_native_frames_interoperate(library, monkeypatch, tmp_path):
+    if library is None:
+        pytest.skip("no C toolchain")
+    params = DeflateParams()
+    payload = b"interop " * 1000
+    monkeypatch.setenv(ws_frames.WS_LIBRARY_ENV, library)
+    monkeypatch.setattr(ws_frames, "_lib", None)
+    native_encoder, native_decoder = FrameEncoder(server=False, deflate=params), FrameDecoder(deflate=params)
+    monkeypatch.setenv(ws_frames.WS_LIBRARY_ENV, str(tmp_path / "missing.so"))
+    monkeypatch.setattr(ws_frames, "_lib", None)
+    python_encoder, python_decoder = FrameEncoder(server=False, deflate=params), FrameDecoder(deflate=params)
+    assert decode(python_decoder, native_encoder.encode(OP_TEXT, payload)) == [(OP_TEXT, payload)]
+    assert decode(native_decoder, python_encoder.encode(OP_TEXT, payload)) == [(OP_TEXT, payload)]
+
+
+@pytest.mark.parametrize("frame, code", [
+    (frame_header(OP_TEXT, 2) + b"hi", CLOSE_PROTOCOL),                       # unmasked from a client
+    (b"\xc1" + masked(OP_TEXT, b"x")[1:], CLOSE_PROTOCOL),                   # RSV1 without deflate
+    (masked(0x3, b"x"), CLOSE_PROTOCOL),                                      # reserved opcode
+    (masked(OP_PING, b"x", fin=False), CLOSE_PROTOCOL),                       # fragmented control frame
+    (masked(0, b"x"), CLOSE_PROTOCOL),                                        # continuation of nothing
+    (masked(OP_TEXT, b"\xed\xa0\x80"), CLOSE_INVALID_DATA),                   # encoded surrogate
+    (masked(OP_CLOSE, struct.pack("!H", 1005)), CLOSE_INVALID_DATA),          # reserved close code
+    (masked(OP_BINARY, b"b" * 2000), CLOSE_TOO_BIG),
+])
+def test_protocol_errors(backend, frame, code):
+    with pytest.raises(WebSocketError) as error:
+        decode(FrameDecoder(max_message=1024), frame)
+    assert error.value.code == code
+
+
+def test_fragments_add_up_past_the_limit(backend):
+    decoder = FrameDecoder(max_message=1024)
+    decode(decoder, masked(OP_BINARY, b"a" * 1000, fin=False))
+    with pytest.raises(WebSocketError) as error:
+        decode(decoder, masked(0, b"a" * 100))
+    assert error.value.code == CLOSE_TOO_BIG
+
+
+def test_receives_straight_from_a_socket(backend):
+    left, right = socket.socketpair()
+    with left, right:
+        decoder = FrameDecoder(capacity=4096)
+        payload = os.urandom(100000)
+        left.sendall(masked(OP_BINARY, payload))
+        left.shutdown(socket.SHUT_WR)
+        received = []
+        while decoder.recv_from(right):
+            received += decoder.messages()
+        assert received == [(OP_BINARY, payload)]
+
+
+def test_negotiate_deflate():
+    assert negotiate_deflate(None) is None
+    assert negotiate_deflate("x-webkit-deflate-frame") is None
+    assert negotiate_deflate("permessage-deflate; client_max_window_bits").header() == "permessage-deflate"
+    # An 8-bit server window cannot be honoured, so the next offer is taken
+    offer = "permessage-deflate; server_max_window_bits=8, permessage-deflate; client_no_context_takeover"
+    assert negotiate_deflate(offer).header() == "permessage-deflate; client_no_context_takeover"
+    assert negotiate_deflate("permessage-deflate; server_max_window_bits=10").server_max_window_bits == 10
+    assert negotiate_deflate("permessage-deflate; bogus") is None
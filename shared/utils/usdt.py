@@ -0,0 +1,75 @@
+"""
+USDT Probes for the Supervisor
+
+The launcher supervises components from Python, so its static tracepoints
+are created at runtime through libstapsdt when the python-stapsdt package
+is installed; without it every probe is a no-op. The provider is "tekton",
+the same as the probes compiled into tekton-clean-launch, so one bpftrace
+session can attach to both (see src/tekton-launcher/bpftrace/).
+
+Probes and arguments:
+
+    component_spawn    (component, pid, port)
+    component_exit     (component, pid, exit status or -1 if unknown)
+    component_ready    (component, pid, spawn-to-healthy latency in us)
+    component_restart  (component, old pid, new pid)
+
+Component names are passed as C strings; read them with str(arg0).
+"""
+import os
+from typing import Optional
+
+PROVIDER = "tekton"
+
+_PROBES = {
+    "component_spawn": 3,
+    "component_exit": 3,
+    "component_ready": 3,
+    "component_restart": 3,
+}
+
+
+class SupervisorProbes:
+    """Fires the supervisor's USDT probes; cheap no-ops when they can't exist"""
+
+    def __init__(self):
+        self.provider = None
+        self.probes = {}
+        if os.environ.get("TEKTON_USDT", "1") == "0":
+            return
+        try:
+            import stapsdt
+        except ImportError:
+            return
+        try:
+            provider = stapsdt.Provider(PROVIDER)
+            for name, argc in _PROBES.items():
+                self.probes[name] = provider.add_probe(name, *([stapsdt.ArgTypes.uint64] * argc))
+            provider.load()
+            self.provider = provider
+        except Exception:
+            # libstapsdt missing or memfd/ELF load refused; tracing just stays off
+            self.probes = {}
+
+    @property
+    def enabled(self) -> bool:
+        return self.provider is not None
+
+    def _fire(self, name: str, component: str, a: int, b: int):
+        probe = self.probes.get(name)
+        if probe is None or not probe.is_enabled:
+            return
+        # bytes go through ctypes as char *, which bpftrace's str() reads
+        probe.fire(component.encode("utf-8"), a & 0xFFFFFFFFFFFFFFFF, b & 0xFFFFFFFFFFFFFFFF)
+
+    def spawn(self, component: str, pid: int, port: Optional[int]):
+        self._fire("component_spawn", component, pid, port or 0)
+
+    def exit(self, component: str, pid: int, status: Optional[int]):
+        self._fire("component_exit", component, pid, -1 if status is None else status)
+
+    def ready(self, component: str, pid: Optional[int], latency: float):
+        self._fire("component_ready", component, pid or 0, int(latency * 1_000_000))
+
+    def restart(self, component: str, old_pid: Optional[int], new_pid: Optional[int]):
+        self._fire("component_restart", component, old_pid or 0, new_pid or 0)
@@ -0,0 +1,434 @@
+"""
+WebSocket Framing
+
+ctypes binding for src/tekton-ws: RFC 6455 frames parsed where they lie in
+a ring buffer that the socket receives into, unmasked with SIMD,
+fragmented messages joined, and permessage-deflate (RFC 7692) in both
+directions. Without the library the same decoder and encoder run in
+Python, unmasking a payload as one integer XOR rather than byte by byte.
+
+    deflate = negotiate_deflate(headers.get("Sec-WebSocket-Extensions"))
+    decoder, encoder = FrameDecoder(deflate=deflate), FrameEncoder(deflate=deflate)
+    while decoder.recv_from(sock):
+        for opcode, payload in decoder.messages():
+            sock.sendall(encoder.encode(OP_TEXT, payload))
+"""
+import ctypes
+import os
+import struct
+import zlib
+from dataclasses import dataclass
+from typing import Iterator, Optional, Tuple
+
+WS_LIBRARY_ENV = "TEKTON_WS_LIBRARY"
+WS_SOURCE = os.path.join("src", "tekton-ws")
+LIBRARY_NAME = "libtekton-ws.so"
+
+OP_CONTINUATION = 0x0
+OP_TEXT = 0x1
+OP_BINARY = 0x2
+OP_CLOSE = 0x8
+OP_PING = 0x9
+OP_PONG = 0xA
+
+CLOSE_NORMAL = 1000
+CLOSE_PROTOCOL = 1002
+CLOSE_INVALID_DATA = 1007
+CLOSE_TOO_BIG = 1009
+
+# Flags shared with tekton-ws.h
+REQUIRE_MASK = 0x1
+MASK = 0x1
+DEFLATE = 0x2
+NO_CONTEXT_TAKEOVER = 0x4
+
+DEFLATE_TAIL = b"\x00\x00\xff\xff"
+MAX_MESSAGE = 16 << 20
+# Messages shorter than this are not worth compressing
+MIN_COMPRESS = 256
+
+_lib = None
+
+
+class WebSocketError(Exception):
+    """A protocol violation; code is the close code to send"""
+
+    def __init__(self, code: int, reason: str = ""):
+        super().__init__(f"WebSocket close {code}{': ' + reason if reason else ''}")
+        self.code = code
+
+
+@dataclass
+class DeflateParams:
+    """Agreed permessage-deflate parameters"""
+    server_no_context_takeover: bool = False
+    client_no_context_takeover: bool = False
+    server_max_window_bits: Optional[int] = None
+
+    def header(self) -> str:
+        """The Sec-WebSocket-Extensions value accepting these parameters"""
+        value = "permessage-deflate"
+        if self.server_no_context_takeover:
+            value += "; server_no_context_takeover"
+        if self.client_no_context_takeover:
+            value += "; client_no_context_takeover"
+        if self.server_max_window_bits:
+            value += f"; server_max_window_bits={self.server_max_window_bits}"
+        return value
+
+
+def negotiate_deflate(offers: Optional[str]) -> Optional[DeflateParams]:
+    """The first acceptable permessage-deflate offer in a Sec-WebSocket-Extensions header"""
+    for offer in (offers or "").split(","):
+        name, *params = [part.strip() for part in offer.split(";")]
+        if name != "permessage-deflate":
+            continue
+        result, seen = DeflateParams(), set()
+        for param in params:
+            key, _, value = (s.strip().strip('"') for s in param.partition("="))
+            if key in seen:
+                break
+            seen.add(key)
+            if key in ("server_no_context_takeover", "client_no_context_takeover") and not value:
+                setattr(result, key, True)
+            elif key == "server_max_window_bits" and value.isdigit() and 9 <= int(value) <= 15:
+                # zlib cannot compress with an 8-bit window, so such offers are declined
+                result.server_max_window_bits = int(value)
+            elif key == "client_max_window_bits" and (not value or (value.isdigit() and 8 <= int(value) <= 15)):
+                pass  # inflating with the full window accepts any smaller one
+            else:
+                break
+        else:
+            return result
+    return None
+
+
+def _flags(server: bool, deflate: Optional[DeflateParams], decoding: bool) -> Tuple[int, int]:
+    """(flags, window bits) for one direction of a connection"""
+    peer_is_client = server == decoding
+    flags = REQUIRE_MASK if (decoding and server) or (not decoding and not server) else 0
+    bits = 15
+    if deflate is not None:
+        flags |= DEFLATE
+        if deflate.client_no_context_takeover if peer_is_client else deflate.server_no_context_takeover:
+            flags |= NO_CONTEXT_TAKEOVER
+        if not peer_is_client and deflate.server_max_window_bits and not decoding:
+            bits = deflate.server_max_window_bits
+    return flags, bits
+
+
+def _default_root() -> str:
+    return os.environ.get("TEKTON_ROOT") or os.path.dirname(
+        os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+
+
+class _Message(ctypes.Structure):
+    _fields_ = [("opcode", ctypes.c_int), ("data", ctypes.c_void_p), ("len", ctypes.c_uint64)]
+
+
+def _load(library: Optional[str] = None):
+    """The framing library, or None if it has not been built"""
+    global _lib
+    if _lib is not None and library is None:
+        return _lib
+    path = library or os.environ.get(WS_LIBRARY_ENV) or os.path.join(
+        _default_root(), WS_SOURCE, LIBRARY_NAME)
+    try:
+        lib = ctypes.CDLL(path)
+    except OSError:
+        return None
+    lib.tw_decoder_new.restype = ctypes.c_void_p
+    lib.tw_decoder_new.argtypes = [ctypes.c_size_t, ctypes.c_int, ctypes.c_uint64, ctypes.c_int]
+    lib.tw_decoder_free.argtypes = [ctypes.c_void_p]
+    lib.tw_decoder_space.restype = ctypes.c_void_p
+    lib.tw_decoder_space.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_size_t)]
+    lib.tw_decoder_commit.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+    lib.tw_decoder_feed.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_size_t]
+    lib.tw_decoder_pending.restype = ctypes.c_size_t
+    lib.tw_decoder_pending.argtypes = [ctypes.c_void_p]
+    lib.tw_decoder_next.argtypes = [ctypes.c_void_p, ctypes.POINTER(_Message)]
+    lib.tw_encoder_new.restype = ctypes.c_void_p
+    lib.tw_encoder_new.argtypes = [ctypes.c_int, ctypes.c_int]
+    lib.tw_encoder_free.argtypes = [ctypes.c_void_p]
+    lib.tw_encode.restype = ctypes.c_int64
+    lib.tw_encode.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_char_p, ctypes.c_uint64,
+                              ctypes.c_int, ctypes.POINTER(ctypes.c_void_p)]
+    lib.tw_unmask.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_char_p, ctypes.c_uint64]
+    if library is None:
+        _lib = lib
+    return lib
+
+
+def native_available() -> bool:
+    return _load() is not None
+
+
+def unmask(data: bytes, mask: bytes) -> bytes:
+    """data XORed with the repeating 4-byte mask (a whole-payload XOR, not a byte loop)"""
+    n = len(data)
+    key = (mask * (n // 4 + 1))[:n]
+    return (int.from_bytes(data, "little") ^ int.from_bytes(key, "little")).to_bytes(n, "little")
+
+
+def frame_header(opcode: int, length: int, fin: bool = True, rsv1: bool = False,
+                 mask: Optional[bytes] = None) -> bytes:
+    first = (0x80 if fin else 0) | (0x40 if rsv1 else 0) | opcode
+    masked = 0x80 if mask else 0
+    if length < 126:
+        header = struct.pack("!BB", first, masked | length)
+    elif length <= 0xffff:
+        header = struct.pack("!BBH", first, masked | 126, length)
+    else:
+        header = struct.pack("!BBQ", first, masked | 127, length)
+    return header + (mask or b"")
+
+
+def _valid_close(payload: bytes) -> bool:
+    if not payload:
+        return True
+    if len(payload) == 1:
+        return False
+    code = struct.unpack("!H", payload[:2])[0]
+    if not (1000 <= code <= 1003 or 1007 <= code <= 1011 or 3000 <= code <= 4999):
+        return False
+    try:
+        payload[2:].decode("utf-8")
+    except UnicodeDecodeError:
+        return False
+    return True
+
+
+class _PyDecoder:
+    """tw_decoder in Python: a bytearray with a read position instead of the ring"""
+
+    def __init__(self, flags: int, max_message: int):
+        self.flags = flags
+        self.max_message = max_message
+        self.buf = bytearray()
+        self.pos = 0
+        self.opcode = 0
+        self.compressed = False
+        self.parts = []
+        self.size = 0
+        self.inflater = None
+
+    def feed(self, data) -> None:
+        if self.pos > 65536 and 2 * self.pos > len(self.buf):
+            del self.buf[:self.pos]
+            self.pos = 0
+        self.buf += data
+
+    def pending(self) -> int:
+        return len(self.buf) - self.pos
+
+    def _inflate(self, data: bytes) -> bytes:
+        if self.inflater is None:
+            self.inflater = zlib.decompressobj(-15)
+        limit = self.max_message - self.size + 1
+        try:
+            out = self.inflater.decompress(data, limit)
+        except zlib.error as e:
+            raise WebSocketError(CLOSE_INVALID_DATA, str(e))
+        if self.inflater.unconsumed_tail or self.size + len(out) > self.max_message:
+            raise WebSocketError(CLOSE_TOO_BIG)
+        return out
+
+    def next(self) -> Optional[Tuple[int, bytes]]:
+        buf = self.buf
+        while True:
+            p = self.pos
+            avail = len(buf) - p
+            if avail < 2:
+                return None
+            b0, b1 = buf[p], buf[p + 1]
+            fin, rsv1, opcode = b0 & 0x80, b0 & 0x40, b0 & 0x0f
+            masked, length = b1 & 0x80, b1 & 0x7f
+            hlen = 2 + (2 if length == 126 else 8 if length == 127 else 0) + (4 if masked else 0)
+            if avail < hlen:
+                return None
+            if length == 126:
+                length = struct.unpack_from("!H", buf, p + 2)[0]
+            elif length == 127:
+                length = struct.unpack_from("!Q", buf, p + 2)[0]
+
+            control = opcode & 0x08
+            if b0 & 0x30 or OP_BINARY < opcode < OP_CLOSE or opcode > OP_PONG:
+                raise WebSocketError(CLOSE_PROTOCOL)
+            if rsv1 and (not self.flags & DEFLATE or control or opcode == OP_CONTINUATION):
+                raise WebSocketError(CLOSE_PROTOCOL)
+            if self.flags & REQUIRE_MASK and not masked:
+                raise WebSocketError(CLOSE_PROTOCOL, "unmasked frame")
+            if control and (not fin or length > 125):
+                raise WebSocketError(CLOSE_PROTOCOL)
+            if length >> 63:
+                raise WebSocketError(CLOSE_PROTOCOL)
+            if length > self.max_message:
+                raise WebSocketError(CLOSE_TOO_BIG)
+            if avail < hlen + length:
+                return None
+
+            payload = bytes(buf[p + hlen:p + hlen + length])
+            if masked:
+                payload = unmask(payload, bytes(buf[p + hlen - 4:p + hlen]))
+            self.pos = p + hlen + length
+
+            if control:
+                if opcode == OP_CLOSE and not _valid_close(payload):
+                    raise WebSocketError(CLOSE_PROTOCOL if len(payload) == 1 else CLOSE_INVALID_DATA)
+                return opcode, payload
+            if opcode != OP_CONTINUATION:
+                if self.opcode:
+                    raise WebSocketError(CLOSE_PROTOCOL, "new message inside a fragmented one")
+                self.opcode, self.compressed, self.parts, self.size = opcode, bool(rsv1), [], 0
+            elif not self.opcode:
+                raise WebSocketError(CLOSE_PROTOCOL, "continuation without a message")
+
+            part = self._inflate(payload) if self.compressed else payload
+            if self.size + len(part) > self.max_message:
+                raise WebSocketError(CLOSE_TOO_BIG)
+            self.parts.append(part)
+            self.size += len(part)
+            if not fin:
+                continue
+
+            if self.compressed:
+                self.parts.append(self._inflate(DEFLATE_TAIL))
+                if self.flags & NO_CONTEXT_TAKEOVER:
+                    self.inflater = None
+            message = b"".join(self.parts)
+            opcode, self.opcode, self.parts = self.opcode, 0, []
+            if opcode == OP_TEXT:
+                try:
+                    message.decode("utf-8")
+                except UnicodeDecodeError:
+                    raise WebSocketError(CLOSE_INVALID_DATA, "invalid UTF-8")
+            return opcode, message
+
+
+class FrameDecoder:
+    """Messages from one side of a WebSocket connection"""
+
+    def __init__(self, server: bool = True, deflate: Optional[DeflateParams] = None,
+                 max_message: int = MAX_MESSAGE, capacity: int = 65536,
+                 library: Optional[str] = None):
+        """
+        Args:
+            server: We are the server, so frames come from a client and must be masked
+            deflate: Negotiated permessage-deflate parameters, if any
+            max_message: Largest message accepted (close code 1009 beyond)
+            capacity: Initial ring size; it grows for larger frames
+        """
+        flags, bits = _flags(server, deflate, decoding=True)
+        self._lib = _load(library)
+        self._py = None
+        self._d = None
+        if self._lib is None:
+            self._py = _PyDecoder(flags, max_message)
+            return
+        self._d = self._lib.tw_decoder_new(capacity, flags, max_message, bits)
+        if not self._d:
+            raise MemoryError("tw_decoder_new failed")
+        self._avail = ctypes.c_size_t()
+        self._msg = _Message()
+
+    def recv_from(self, sock, size: int = 65536) -> int:
+        """Receive once from sock straight into the buffer; 0 at end of stream"""
+        if self._py is not None:
+            data = sock.recv(size)
+            self._py.feed(data)
+            return len(data)
+        space = self._lib.tw_decoder_space(self._d, ctypes.byref(self._avail))
+        if not self._avail.value:
+            data = sock.recv(size)
+            self.feed(data)
+            return len(data)
+        n = sock.recv_into((ctypes.c_char * self._avail.value).from_address(space))
+        self._lib.tw_decoder_commit(self._d, n)
+        return n
+
+    def feed(self, data: bytes) -> None:
+        if self._py is not None:
+            self._py.feed(data)
+        elif self._lib.tw_decoder_feed(self._d, bytes(data), len(data)) < 0:
+            raise MemoryError("tw_decoder_feed failed")
+
+    def pending(self) -> int:
+        """Bytes received but not yet returned as messages"""
+        if self._py is not None:
+            return self._py.pending()
+        return self._lib.tw_decoder_pending(self._d)
+
+    def messages(self) -> Iterator[Tuple[int, bytes]]:
+        """(opcode, payload) for every complete message buffered; raises WebSocketError"""
+        if self._py is not None:
+            while (message := self._py.next()) is not None:
+                yield message
+            return
+        msg = self._msg
+        while True:
+            result = self._lib.tw_decoder_next(self._d, ctypes.byref(msg))
+            if result == 0:
+                return
+            if result == -1:
+                raise MemoryError("tw_decoder_next failed")
+            if result < 0:
+                raise WebSocketError(-result)
+            yield msg.opcode, ctypes.string_at(msg.data, msg.len)
+
+    def close(self) -> None:
+        if self._d:
+            self._lib.tw_decoder_free(self._d)
+            self._d = None
+
+    def __del__(self):
+        self.close()
+
+
+class FrameEncoder:
+    """Frames for one side of a WebSocket connection, one per message"""
+
+    def __init__(self, server: bool = True, deflate: Optional[DeflateParams] = None,
+                 min_compress: int = MIN_COMPRESS, library: Optional[str] = None):
+        flags, bits = _flags(server, deflate, decoding=False)
+        self.flags = flags
+        self.bits = bits
+        self.min_compress = min_compress
+        self._lib = _load(library)
+        self._e = None
+        self._compressor = None
+        if self._lib is not None:
+            self._e = self._lib.tw_encoder_new(flags, bits)
+            if not self._e:
+                raise MemoryError("tw_encoder_new failed")
+            self._out = ctypes.c_void_p()
+
+    def encode(self, opcode: int, payload: bytes) -> bytes:
+        payload = bytes(payload)
+        compress = bool(self.flags & DEFLATE) and not opcode & 0x08 and len(payload) >= self.min_compress
+        if self._e is not None:
+            n = self._lib.tw_encode(self._e, opcode, payload, len(payload), int(compress),
+                                    ctypes.byref(self._out))
+            if n < 0:
+                raise MemoryError("tw_encode failed")
+            return ctypes.string_at(self._out.value, n)
+
+        if compress:
+            if self._compressor is None:
+                self._compressor = zlib.compressobj(1, zlib.DEFLATED, -self.bits)
+            payload = self._compressor.compress(payload) + self._compressor.flush(zlib.Z_SYNC_FLUSH)
+            if payload.endswith(DEFLATE_TAIL):
+                payload = payload[:-4]
+            if self.flags & NO_CONTEXT_TAKEOVER:
+                self._compressor = None
+        if self.flags & MASK:
+            mask = os.urandom(4)
+            return frame_header(opcode, len(payload), rsv1=compress, mask=mask) + unmask(payload, mask)
+        return frame_header(opcode, len(payload), rsv1=compress) + payload
+
+    def close(self) -> None:
+        if self._e:
+            self._lib.tw_encoder_free(self._e)
+            self._e = None
+
+    def __del__(self):
+        self.close()
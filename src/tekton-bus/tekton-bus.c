@@ -0,0 +1,640 @@
+/*
+ * tekton-bus.c - Shared-memory pub/sub rings (client library and region setup)
+ *
+ * Region layout, all offsets from the start of the memfd:
+ *
+ *   header        64 bytes
+ *   subscribers   subscriber_count x 128 bytes
+ *   topics        topic_count x 128 bytes, open addressing on an FNV-1a hash
+ *   rings         topic_count x ring_slots x slot_size
+ *
+ * A slot's seq is 2*(n+1) once message n is committed and odd while a
+ * producer is writing it, so readers copy optimistically and re-check seq
+ * afterwards (a seqlock per slot). Producers claim sequence numbers with
+ * fetch_add on the topic head and never wait for each other except when
+ * one laps a slot another is still writing.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "tekton-bus.h"
+
+#define SUBSCRIBER_SIZE 128
+#define TOPIC_SIZE 128
+/* Yields before a producer takes over a slot whose writer appears to have died */
+#define STUCK_WRITER_YIELDS 10000
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t topic_count;
+    uint32_t ring_slots;
+    uint32_t slot_size;
+    uint32_t subscriber_count;
+    _Atomic uint32_t generation;       /* bumped on every subscribe/unsubscribe */
+    _Atomic uint32_t topics_ready;     /* bumped whenever a topic is claimed */
+    _Atomic uint32_t subscriber_high;  /* highest active subscriber slot + 1 */
+    uint32_t reserved;
+    uint64_t size;
+    uint64_t topics_offset;
+    uint64_t rings_offset;
+} tb_header_t;
+
+typedef struct {
+    _Atomic uint32_t active;
+    _Atomic uint32_t waiting;          /* armed by a subscriber about to sleep */
+    uint32_t pid;
+    uint32_t reserved;
+    char pattern[TB_PATTERN_MAX];
+    _Atomic uint64_t origin;           /* subscribing bus; its own messages never wake it */
+    char pad[SUBSCRIBER_SIZE - 24 - TB_PATTERN_MAX];
+} tb_subscriber_t;
+
+enum { TOPIC_FREE = 0, TOPIC_CLAIMING = 1, TOPIC_READY = 2 };
+
+typedef struct {
+    _Atomic uint32_t state;
+    uint32_t hash;
+    _Atomic uint64_t head;             /* next sequence number to claim */
+    char name[TB_TOPIC_NAME_MAX];
+    char pad[TOPIC_SIZE - 16 - TB_TOPIC_NAME_MAX];
+} tb_topic_t;
+
+typedef struct {
+    _Atomic uint64_t seq;
+    uint64_t origin;
+    uint64_t timestamp_ns;
+    uint32_t len;
+    uint32_t reserved;
+    unsigned char data[];
+} tb_slot_t;
+
+_Static_assert(sizeof(tb_header_t) == 64, "header layout");
+_Static_assert(sizeof(tb_subscriber_t) == SUBSCRIBER_SIZE, "subscriber layout");
+_Static_assert(sizeof(tb_topic_t) == TOPIC_SIZE, "topic layout");
+_Static_assert(sizeof(tb_slot_t) == TB_SLOT_HEADER, "slot layout");
+
+struct tb_bus {
+    int sock;
+    void *map;
+    uint64_t size;
+    tb_header_t *hdr;
+    tb_subscriber_t *subscribers;
+    tb_topic_t *topics;
+    unsigned char *rings;
+    uint64_t origin;
+    pthread_mutex_t lock;              /* broker socket and the eventfd cache */
+    uint32_t fds_generation;
+    int fds[TB_MAX_SUBSCRIBERS];
+    /* Per topic: which subscribers match it, as of mask_generation */
+    uint64_t (*masks)[TB_MAX_SUBSCRIBERS / 64];
+    uint32_t *mask_generation;
+};
+
+struct tb_sub {
+    tb_bus *bus;
+    uint32_t slot;
+    int efd;
+    char pattern[TB_PATTERN_MAX];
+    uint32_t topics_seen;
+    uint32_t next;                     /* topic to look at first */
+    uint64_t dropped;
+    uint64_t *cursors;
+    unsigned char *known;
+    unsigned char *matches;
+};
+
+static _Atomic uint32_t origin_counter;
+
+static uint32_t fnv1a(const char *s) {
+    uint32_t h = 2166136261u;
+    for (; *s; s++) {
+        h ^= (unsigned char)*s;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint64_t realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static tb_slot_t *slot_at(tb_bus *bus, uint32_t topic, uint64_t n) {
+    tb_header_t *h = bus->hdr;
+    size_t index = (size_t)topic * h->ring_slots + (size_t)(n % h->ring_slots);
+    return (tb_slot_t *)(bus->rings + index * h->slot_size);
+}
+
+int tb_match(const char *pattern, const char *topic) {
+    if (!strchr(pattern, '*')) {
+        return strcmp(pattern, topic) == 0;
+    }
+    char stripped[TB_PATTERN_MAX];
+    size_t n = 0;
+    for (const char *p = pattern; *p && n < sizeof(stripped) - 1; p++) {
+        if (*p != '*') stripped[n++] = *p;
+    }
+    stripped[n] = '\0';
+    size_t topic_len = strlen(topic);
+    if (n > topic_len) return 0;
+    return strncmp(topic, stripped, n) == 0 || strcmp(topic + topic_len - n, stripped) == 0;
+}
+
+/* ---- Region setup (broker) ---- */
+
+static void region_views(void *map, tb_header_t **hdr, tb_subscriber_t **subscribers) {
+    *hdr = map;
+    *subscribers = (tb_subscriber_t *)((unsigned char *)map + sizeof(tb_header_t));
+}
+
+int tb_region_create(uint32_t topics, uint32_t ring_slots, uint32_t slot_size, void **map, uint64_t *size) {
+    if (topics == 0 || ring_slots == 0 || slot_size <= TB_SLOT_HEADER || slot_size % 8) {
+        return -EINVAL;
+    }
+    uint64_t topics_offset = sizeof(tb_header_t) + (uint64_t)TB_MAX_SUBSCRIBERS * SUBSCRIBER_SIZE;
+    uint64_t rings_offset = topics_offset + (uint64_t)topics * TOPIC_SIZE;
+    uint64_t total = rings_offset + (uint64_t)topics * ring_slots * slot_size;
+
+    int fd = memfd_create("tekton-bus", MFD_CLOEXEC);
+    if (fd < 0) return -errno;
+    /* Pages are only allocated as topics are used */
+    if (ftruncate(fd, (off_t)total) < 0) {
+        int err = errno;
+        close(fd);
+        return -err;
+    }
+    void *m = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (m == MAP_FAILED) {
+        int err = errno;
+        close(fd);
+        return -err;
+    }
+    tb_header_t *h = m;
+    memcpy(h->magic, TB_MAGIC, 4);
+    h->version = TB_VERSION;
+    h->topic_count = topics;
+    h->ring_slots = ring_slots;
+    h->slot_size = slot_size;
+    h->subscriber_count = TB_MAX_SUBSCRIBERS;
+    h->size = total;
+    h->topics_offset = topics_offset;
+    h->rings_offset = rings_offset;
+    *map = m;
+    *size = total;
+    return fd;
+}
+
+void tb_region_subscribe(void *map, uint32_t slot, const char *pattern, uint32_t pid, uint64_t origin) {
+    tb_header_t *h;
+    tb_subscriber_t *subs;
+    region_views(map, &h, &subs);
+    tb_subscriber_t *s = &subs[slot];
+    memset(s->pattern, 0, sizeof(s->pattern));
+    strncpy(s->pattern, pattern, sizeof(s->pattern) - 1);
+    s->pid = pid;
+    /* Before active: a publisher that sees the slot also sees whose it is */
+    atomic_store(&s->origin, origin);
+    atomic_store(&s->waiting, 0);
+    atomic_store_explicit(&s->active, 1, memory_order_release);
+    if (slot + 1 > atomic_load(&h->subscriber_high)) {
+        atomic_store(&h->subscriber_high, slot + 1);
+    }
+    atomic_fetch_add(&h->generation, 1);
+}
+
+void tb_region_unsubscribe(void *map, uint32_t slot) {
+    tb_header_t *h;
+    tb_subscriber_t *subs;
+    region_views(map, &h, &subs);
+    atomic_store(&subs[slot].active, 0);
+    uint32_t high = atomic_load(&h->subscriber_high);
+    while (high > 0 && !atomic_load(&subs[high - 1].active)) high--;
+    atomic_store(&h->subscriber_high, high);
+    atomic_fetch_add(&h->generation, 1);
+}
+
+uint32_t tb_region_generation(void *map) {
+    return atomic_load(&((tb_header_t *)map)->generation);
+}
+
+/* ---- Broker conversation ---- */
+
+static int send_request(int sock, const tb_request_t *req, int fd) {
+    struct iovec iov = { (void *)req, sizeof(*req) };
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1 };
+    if (fd >= 0) {
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+    while (sendmsg(sock, &msg, MSG_NOSIGNAL) < 0) {
+        if (errno != EINTR) return -errno;
+    }
+    return 0;
+}
+
+/* Receives a reply and up to max_fds attached descriptors; returns how many arrived */
+static int recv_reply(int sock, tb_reply_t *reply, int *fds, int max_fds) {
+    struct iovec iov = { reply, sizeof(*reply) };
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * TB_MAX_SUBSCRIBERS)];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg = {
+        .msg_iov = &iov, .msg_iovlen = 1,
+        .msg_control = control.buf, .msg_controllen = sizeof(control.buf)
+    };
+    ssize_t n;
+    while ((n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC)) < 0) {
+        if (errno != EINTR) return -errno;
+    }
+    if (n != sizeof(*reply)) return -EPROTO;
+    int received = 0;
+    for (struct cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+        int count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (int i = 0; i < count; i++) {
+            int fd;
+            memcpy(&fd, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+            if (received < max_fds) fds[received++] = fd;
+            else close(fd);
+        }
+    }
+    return received;
+}
+
+tb_bus *tb_connect(const char *socket_path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    strcpy(addr.sun_path, socket_path);
+    int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0) return NULL;
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        int err = errno;
+        close(sock);
+        errno = err;
+        return NULL;
+    }
+
+    /* The broker greets every connection with the region's memfd */
+    tb_reply_t hello;
+    int memfd = -1;
+    int got = recv_reply(sock, &hello, &memfd, 1);
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (got == 1 && hello.status == 0 && fstat(memfd, &st) == 0 &&
+        (size_t)st.st_size >= sizeof(tb_header_t)) {
+        map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    }
+    if (memfd >= 0) close(memfd);
+    if (map == MAP_FAILED) {
+        close(sock);
+        errno = EPROTO;
+        return NULL;
+    }
+    tb_header_t *h = map;
+    if (memcmp(h->magic, TB_MAGIC, 4) != 0 || h->version != TB_VERSION || h->size != (uint64_t)st.st_size) {
+        munmap(map, st.st_size);
+        close(sock);
+        errno = EPROTO;
+        return NULL;
+    }
+
+    tb_bus *bus = calloc(1, sizeof(*bus));
+    bus->masks = calloc(h->topic_count, sizeof(*bus->masks));
+    bus->mask_generation = calloc(h->topic_count, sizeof(uint32_t));
+    bus->sock = sock;
+    bus->map = map;
+    bus->size = h->size;
+    bus->hdr = h;
+    bus->subscribers = (tb_subscriber_t *)((unsigned char *)map + sizeof(tb_header_t));
+    bus->topics = (tb_topic_t *)((unsigned char *)map + h->topics_offset);
+    bus->rings = (unsigned char *)map + h->rings_offset;
+    bus->origin = ((uint64_t)getpid() << 32) | (atomic_fetch_add(&origin_counter, 1) + 1);
+    pthread_mutex_init(&bus->lock, NULL);
+    for (int i = 0; i < TB_MAX_SUBSCRIBERS; i++) bus->fds[i] = -1;
+    /* Generation 0 is never current, so the first publish fetches eventfds */
+    bus->fds_generation = atomic_load(&h->generation) - 1;
+    for (uint32_t t = 0; t < h->topic_count; t++) bus->mask_generation[t] = bus->fds_generation;
+    return bus;
+}
+
+void tb_close(tb_bus *bus) {
+    if (!bus) return;
+    for (int i = 0; i < TB_MAX_SUBSCRIBERS; i++) {
+        if (bus->fds[i] >= 0) close(bus->fds[i]);
+    }
+    close(bus->sock);
+    munmap(bus->map, bus->size);
+    pthread_mutex_destroy(&bus->lock);
+    free(bus->masks);
+    free(bus->mask_generation);
+    free(bus);
+}
+
+uint64_t tb_origin(tb_bus *bus) { return bus->origin; }
+uint32_t tb_max_payload(tb_bus *bus) { return bus->hdr->slot_size - TB_SLOT_HEADER; }
+uint32_t tb_ring_slots(tb_bus *bus) { return bus->hdr->ring_slots; }
+
+/* Fetch every subscriber's eventfd from the broker; caller holds bus->lock */
+static void refresh_fds(tb_bus *bus, uint32_t generation) {
+    tb_request_t req = { .op = TB_OP_FDS };
+    tb_reply_t reply;
+    int fds[TB_MAX_SUBSCRIBERS];
+    int got;
+    if (send_request(bus->sock, &req, -1) < 0 ||
+        (got = recv_reply(bus->sock, &reply, fds, TB_MAX_SUBSCRIBERS)) < 0) {
+        /* Broker gone: keep waking whoever we already know about */
+        bus->fds_generation = generation;
+        return;
+    }
+    for (int i = 0; i < TB_MAX_SUBSCRIBERS; i++) {
+        if (bus->fds[i] >= 0) close(bus->fds[i]);
+        bus->fds[i] = -1;
+    }
+    for (uint32_t k = 0; k < reply.count && (int)k < got; k++) {
+        if (reply.slots[k] < TB_MAX_SUBSCRIBERS) bus->fds[reply.slots[k]] = fds[k];
+        else close(fds[k]);
+    }
+    for (int k = reply.count; k < got; k++) close(fds[k]);
+    bus->fds_generation = reply.generation;
+}
+
+static void wake_subscribers(tb_bus *bus, uint32_t topic) {
+    tb_header_t *h = bus->hdr;
+    uint32_t generation = atomic_load(&h->generation);
+    uint64_t *mask = bus->masks[topic];
+
+    if (bus->mask_generation[topic] != generation) {
+        pthread_mutex_lock(&bus->lock);
+        uint32_t high = atomic_load(&h->subscriber_high);
+        memset(mask, 0, sizeof(bus->masks[0]));
+        for (uint32_t i = 0; i < high && i < TB_MAX_SUBSCRIBERS; i++) {
+            tb_subscriber_t *s = &bus->subscribers[i];
+            if (atomic_load_explicit(&s->active, memory_order_acquire) &&
+                atomic_load(&s->origin) != bus->origin &&
+                tb_match(s->pattern, bus->topics[topic].name)) {
+                mask[i / 64] |= 1ull << (i % 64);
+            }
+        }
+        bus->mask_generation[topic] = generation;
+        pthread_mutex_unlock(&bus->lock);
+    }
+
+    for (uint32_t word = 0; word < TB_MAX_SUBSCRIBERS / 64; word++) {
+        uint64_t bits = mask[word];
+        while (bits) {
+            uint32_t i = word * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            tb_subscriber_t *s = &bus->subscribers[i];
+            /* Only sleeping subscribers need a syscall */
+            if (!atomic_load(&s->waiting) || !atomic_exchange(&s->waiting, 0)) continue;
+            pthread_mutex_lock(&bus->lock);
+            if (bus->fds_generation != generation) refresh_fds(bus, generation);
+            int fd = bus->fds[i];
+            if (fd >= 0) {
+                uint64_t one = 1;
+                ssize_t ignored = write(fd, &one, sizeof(one));
+                (void)ignored;
+            }
+            pthread_mutex_unlock(&bus->lock);
+        }
+    }
+}
+
+/* Topic index for a name, claiming a free entry if create is set */
+static int find_topic(tb_bus *bus, const char *name, int create) {
+    tb_header_t *h = bus->hdr;
+    if (strlen(name) >= TB_TOPIC_NAME_MAX) return -ENAMETOOLONG;
+    uint32_t hash = fnv1a(name);
+    for (uint32_t probe = 0; probe < h->topic_count; probe++) {
+        uint32_t index = (hash + probe) % h->topic_count;
+        tb_topic_t *t = &bus->topics[index];
+        uint32_t state = atomic_load_explicit(&t->state, memory_order_acquire);
+        if (state == TOPIC_FREE) {
+            if (!create) return -ENOENT;
+            uint32_t expected = TOPIC_FREE;
+            if (atomic_compare_exchange_strong(&t->state, &expected, TOPIC_CLAIMING)) {
+                strcpy(t->name, name);
+                t->hash = hash;
+                atomic_store_explicit(&t->state, TOPIC_READY, memory_order_release);
+                atomic_fetch_add(&h->topics_ready, 1);
+                return index;
+            }
+            state = expected;
+        }
+        while (state == TOPIC_CLAIMING) {
+            sched_yield();
+            state = atomic_load_explicit(&t->state, memory_order_acquire);
+        }
+        if (t->hash == hash && strcmp(t->name, name) == 0) return index;
+    }
+    return -ENOSPC;
+}
+
+int64_t tb_publish(tb_bus *bus, const char *topic, const void *data, uint32_t len) {
+    if (len > tb_max_payload(bus)) return -EMSGSIZE;
+    int index = find_topic(bus, topic, 1);
+    if (index < 0) return index;
+
+    tb_topic_t *t = &bus->topics[index];
+    uint64_t n = atomic_fetch_add(&t->head, 1);
+    tb_slot_t *s = slot_at(bus, index, n);
+
+    uint64_t current = atomic_load_explicit(&s->seq, memory_order_acquire);
+    for (int yields = 0;; ) {
+        if (current > 2 * n) {
+            /* A newer message already took this slot; ours is out of history */
+            return n;
+        }
+        if ((current & 1) && yields++ < STUCK_WRITER_YIELDS) {
+            sched_yield();
+            current = atomic_load_explicit(&s->seq, memory_order_acquire);
+            continue;
+        }
+        if (atomic_compare_exchange_weak(&s->seq, &current, 2 * n + 1)) break;
+    }
+    s->origin = bus->origin;
+    s->timestamp_ns = realtime_ns();
+    s->len = len;
+    memcpy(s->data, data, len);
+    atomic_store_explicit(&s->seq, 2 * (n + 1), memory_order_release);
+
+    /* Pairs with the subscriber arming "waiting" before its last look */
+    atomic_thread_fence(memory_order_seq_cst);
+    wake_subscribers(bus, index);
+    return n;
+}
+
+/* Copy message n of a topic: length, -EAGAIN if not committed yet, -ESTALE if overwritten */
+static int read_slot(tb_bus *bus, uint32_t topic, uint64_t n, void *buf, uint32_t cap, uint64_t *origin) {
+    tb_slot_t *s = slot_at(bus, topic, n);
+    uint64_t want = 2 * (n + 1);
+    uint64_t before = atomic_load_explicit(&s->seq, memory_order_acquire);
+    if (before < want) return -EAGAIN;
+    if (before != want) return -ESTALE;
+    uint32_t len = s->len;
+    if (len > cap || len > tb_max_payload(bus)) return -ENOBUFS;
+    memcpy(buf, s->data, len);
+    if (origin) *origin = s->origin;
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&s->seq, memory_order_relaxed) != before) return -ESTALE;
+    return (int)len;
+}
+
+int tb_history(tb_bus *bus, const char *topic, uint32_t back, void *buf, uint32_t cap) {
+    int index = find_topic(bus, topic, 0);
+    if (index < 0) return index;
+    uint64_t head = atomic_load(&bus->topics[index].head);
+    if (back >= head || back >= bus->hdr->ring_slots) return -ENOENT;
+    return read_slot(bus, index, head - 1 - back, buf, cap, NULL);
+}
+
+tb_sub *tb_subscribe(tb_bus *bus, const char *pattern) {
+    if (strlen(pattern) >= TB_PATTERN_MAX) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (efd < 0) return NULL;
+
+    tb_request_t req = { .op = TB_OP_SUBSCRIBE, .origin = bus->origin };
+    strcpy(req.pattern, pattern);
+    tb_reply_t reply;
+    pthread_mutex_lock(&bus->lock);
+    int err = send_request(bus->sock, &req, efd);
+    if (err == 0) err = recv_reply(bus->sock, &reply, NULL, 0);
+    pthread_mutex_unlock(&bus->lock);
+    if (err == 0 && reply.status < 0) err = reply.status;
+    if (err < 0) {
+        close(efd);
+        errno = -err;
+        return NULL;
+    }
+
+    tb_header_t *h = bus->hdr;
+    tb_sub *sub = calloc(1, sizeof(*sub));
+    sub->bus = bus;
+    sub->slot = reply.slot;
+    sub->efd = efd;
+    strcpy(sub->pattern, pattern);
+    sub->cursors = calloc(h->topic_count, sizeof(uint64_t));
+    sub->known = calloc(h->topic_count, 1);
+    sub->matches = calloc(h->topic_count, 1);
+    /* Only messages published from now on; topics claimed later start at 0 */
+    sub->topics_seen = atomic_load(&h->topics_ready);
+    for (uint32_t t = 0; t < h->topic_count; t++) {
+        if (atomic_load_explicit(&bus->topics[t].state, memory_order_acquire) == TOPIC_READY) {
+            sub->known[t] = 1;
+            sub->matches[t] = tb_match(pattern, bus->topics[t].name);
+            sub->cursors[t] = atomic_load(&bus->topics[t].head);
+        }
+    }
+    atomic_store(&bus->subscribers[sub->slot].waiting, 1);
+    return sub;
+}
+
+int tb_sub_fd(tb_sub *sub) { return sub->efd; }
+uint64_t tb_sub_dropped(tb_sub *sub) { return sub->dropped; }
+
+void tb_unsubscribe(tb_sub *sub) {
+    if (!sub) return;
+    tb_request_t req = { .op = TB_OP_UNSUBSCRIBE, .slot = sub->slot };
+    tb_reply_t reply;
+    pthread_mutex_lock(&sub->bus->lock);
+    if (send_request(sub->bus->sock, &req, -1) == 0) recv_reply(sub->bus->sock, &reply, NULL, 0);
+    pthread_mutex_unlock(&sub->bus->lock);
+    close(sub->efd);
+    free(sub->cursors);
+    free(sub->known);
+    free(sub->matches);
+    free(sub);
+}
+
+static void refresh_topics(tb_sub *sub) {
+    tb_bus *bus = sub->bus;
+    uint32_t ready = atomic_load(&bus->hdr->topics_ready);
+    if (ready == sub->topics_seen) return;
+    for (uint32_t t = 0; t < bus->hdr->topic_count; t++) {
+        if (!sub->known[t] &&
+            atomic_load_explicit(&bus->topics[t].state, memory_order_acquire) == TOPIC_READY) {
+            sub->known[t] = 1;
+            sub->matches[t] = tb_match(sub->pattern, bus->topics[t].name);
+        }
+    }
+    sub->topics_seen = ready;
+}
+
+static int scan(tb_sub *sub, char *topic_out, void *buf, uint32_t cap, uint64_t *origin_out) {
+    tb_bus *bus = sub->bus;
+    uint32_t count = bus->hdr->topic_count;
+    uint32_t ring = bus->hdr->ring_slots;
+
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t t = (sub->next + k) % count;
+        if (!sub->matches[t]) continue;
+        uint64_t head = atomic_load(&bus->topics[t].head);
+        while (sub->cursors[t] < head) {
+            if (head - sub->cursors[t] > ring) {
+                sub->dropped += head - ring - sub->cursors[t];
+                sub->cursors[t] = head - ring;
+            }
+            uint64_t origin;
+            int len = read_slot(bus, t, sub->cursors[t], buf, cap, &origin);
+            if (len == -EAGAIN) break;  /* still being written; its publisher will wake us */
+            sub->cursors[t]++;
+            if (len == -ESTALE) {
+                sub->dropped++;
+                head = atomic_load(&bus->topics[t].head);
+                continue;
+            }
+            if (origin == bus->origin) continue;
+            if (origin_out) *origin_out = origin;
+            sub->next = t;
+            if (topic_out) memcpy(topic_out, bus->topics[t].name, TB_TOPIC_NAME_MAX);
+            return len;
+        }
+    }
+    return -EAGAIN;
+}
+
+int tb_next(tb_sub *sub, char *topic_out, void *buf, uint32_t cap, uint64_t *origin_out) {
+    refresh_topics(sub);
+    int len = scan(sub, topic_out, buf, cap, origin_out);
+    if (len != -EAGAIN) return len;
+
+    /* Caught up: clear the eventfd, arm the wakeup, then look once more */
+    uint64_t count;
+    ssize_t ignored = read(sub->efd, &count, sizeof(count));
+    (void)ignored;
+    atomic_store(&sub->bus->subscribers[sub->slot].waiting, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    refresh_topics(sub);
+    return scan(sub, topic_out, buf, cap, origin_out);
+}
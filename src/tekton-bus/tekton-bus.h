@@ -0,0 +1,105 @@
+/*
+ * tekton-bus.h - Shared-memory pub/sub for Hermes
+ *
+ * tekton-busd (started by the launcher) owns a memfd holding one ring
+ * buffer per topic and a table of subscribers, and hands the memfd to
+ * every process that connects to its Unix socket. Publishing and reading
+ * happen directly in shared memory; the broker is only involved when a
+ * subscription is added or removed, to pass subscribers' eventfds around.
+ *
+ * Rings are multi-producer, multi-reader and bounded: each topic keeps
+ * its last ring_slots messages as history, and a reader that falls more
+ * than that far behind skips ahead (counted in tb_sub_dropped).
+ *
+ * Wakeups: a subscriber arms a "waiting" flag before it sleeps on its
+ * eventfd; a publisher that sees the flag clears it and writes the
+ * eventfd, so busy subscribers cost publishers no syscalls.
+ *
+ * The Python binding is shared/utils/shm_bus.py.
+ */
+#ifndef TEKTON_BUS_H
+#define TEKTON_BUS_H
+
+#include <stdint.h>
+
+#define TB_MAGIC "TKBS"
+#define TB_VERSION 2
+#define TB_TOPIC_NAME_MAX 64
+#define TB_PATTERN_MAX 64
+#define TB_MAX_SUBSCRIBERS 128
+#define TB_SLOT_HEADER 32
+
+/* Defaults for tekton-busd; a client takes the actual values from the header */
+#define TB_DEFAULT_TOPICS 256
+#define TB_DEFAULT_RING_SLOTS 128
+#define TB_DEFAULT_SLOT_SIZE 2048
+
+/* Broker protocol, one fixed-size SOCK_SEQPACKET message each way */
+enum {
+    TB_OP_SUBSCRIBE = 1,   /* pattern; eventfd attached -> slot */
+    TB_OP_UNSUBSCRIBE = 2, /* slot */
+    TB_OP_FDS = 3          /* -> every active slot, eventfds attached */
+};
+
+typedef struct {
+    uint32_t op;
+    uint32_t slot;
+    uint64_t origin;       /* subscribing bus, in place before the slot goes live */
+    char pattern[TB_PATTERN_MAX];
+} tb_request_t;
+
+typedef struct {
+    int32_t status;        /* 0 or -errno */
+    uint32_t slot;
+    uint32_t generation;
+    uint32_t count;
+    uint32_t slots[TB_MAX_SUBSCRIBERS];
+} tb_reply_t;
+
+typedef struct tb_bus tb_bus;
+typedef struct tb_sub tb_sub;
+
+/* Client side (libtekton-bus.so). Functions returning int return -errno on failure. */
+tb_bus *tb_connect(const char *socket_path);
+void tb_close(tb_bus *bus);
+uint64_t tb_origin(tb_bus *bus);
+uint32_t tb_max_payload(tb_bus *bus);
+uint32_t tb_ring_slots(tb_bus *bus);
+
+/*
+ * Sequence number of the message within its topic. Topics are never
+ * reclaimed: once the table is full, new topic names get -ENOSPC.
+ */
+int64_t tb_publish(tb_bus *bus, const char *topic, const void *data, uint32_t len);
+
+/*
+ * Pattern semantics follow MessageBus: without '*' the topic must match
+ * exactly; with '*', the pattern minus its stars must be a prefix or a
+ * suffix of the topic.
+ */
+int tb_match(const char *pattern, const char *topic);
+
+tb_sub *tb_subscribe(tb_bus *bus, const char *pattern);
+int tb_sub_fd(tb_sub *sub);
+uint64_t tb_sub_dropped(tb_sub *sub);
+void tb_unsubscribe(tb_sub *sub);
+
+/*
+ * Next message for a subscriber: its length, with the topic copied to
+ * topic_out (TB_TOPIC_NAME_MAX bytes) and the publisher's tb_origin to
+ * origin_out. -EAGAIN once caught up, after arming the eventfd wakeup.
+ * Messages the subscriber's own bus published are skipped (and never
+ * wake it). cap must be at least tb_max_payload.
+ */
+int tb_next(tb_sub *sub, char *topic_out, void *buf, uint32_t cap, uint64_t *origin_out);
+
+/* The message `back` positions before the newest on a topic (0 = newest) */
+int tb_history(tb_bus *bus, const char *topic, uint32_t back, void *buf, uint32_t cap);
+
+/* Broker side */
+int tb_region_create(uint32_t topics, uint32_t ring_slots, uint32_t slot_size, void **map, uint64_t *size);
+void tb_region_subscribe(void *map, uint32_t slot, const char *pattern, uint32_t pid, uint64_t origin);
+void tb_region_unsubscribe(void *map, uint32_t slot);
+uint32_t tb_region_generation(void *map);
+
+#endif /* TEKTON_BUS_H */
@@ -0,0 +1,276 @@
+/*
+ * tekton-busd.c - Broker for the Hermes shared-memory message bus
+ *
+ * Creates the bus region (a memfd) and serves a Unix SOCK_SEQPACKET socket.
+ * Every connection is greeted with the memfd; after that clients only talk
+ * to the broker to register a subscription (handing over its eventfd), to
+ * drop one, and to collect every subscriber's eventfd when the subscriber
+ * table's generation changes. A client's subscriptions are dropped when
+ * its connection closes, so crashed processes leave no stale wakeups.
+ *
+ * Started by the launcher with --socket $TEKTON_ROOT/.tekton/run/bus.sock;
+ * exits quietly if a broker already answers on that socket.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "tekton-bus.h"
+
+#define MAX_CLIENTS 256
+
+typedef struct {
+    int fd;
+    uint32_t pid;
+} client_t;
+
+static volatile sig_atomic_t stop_requested = 0;
+static client_t clients[MAX_CLIENTS];
+static int slot_fd[TB_MAX_SUBSCRIBERS];
+static int slot_owner[TB_MAX_SUBSCRIBERS];   /* client index, -1 when free */
+static void *region;
+static int region_fd;
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s --socket PATH [--topics N] [--ring SLOTS] [--slot-size BYTES]\n"
+            "  defaults: %d topics, %d messages of history each, %d-byte slots\n",
+            prog, TB_DEFAULT_TOPICS, TB_DEFAULT_RING_SLOTS, TB_DEFAULT_SLOT_SIZE);
+    exit(2);
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static int send_reply(int fd, tb_reply_t *reply, const int *fds, int nfds) {
+    struct iovec iov = { reply, sizeof(*reply) };
+    union {
+        char buf[CMSG_SPACE(sizeof(int) * TB_MAX_SUBSCRIBERS)];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1 };
+    if (nfds > 0) {
+        msg.msg_control = control.buf;
+        msg.msg_controllen = CMSG_SPACE(sizeof(int) * nfds);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * nfds);
+        memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * nfds);
+    }
+    while (sendmsg(fd, &msg, MSG_NOSIGNAL) < 0) {
+        if (errno != EINTR) return -1;
+    }
+    return 0;
+}
+
+static void release_slot(int slot) {
+    tb_region_unsubscribe(region, slot);
+    close(slot_fd[slot]);
+    slot_fd[slot] = -1;
+    slot_owner[slot] = -1;
+}
+
+static void drop_client(int c) {
+    for (int s = 0; s < TB_MAX_SUBSCRIBERS; s++) {
+        if (slot_owner[s] == c) release_slot(s);
+    }
+    close(clients[c].fd);
+    clients[c].fd = -1;
+}
+
+static void accept_client(int listen_fd) {
+    int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd < 0) return;
+    int c;
+    for (c = 0; c < MAX_CLIENTS && clients[c].fd >= 0; c++) {}
+    tb_reply_t hello = { .status = c < MAX_CLIENTS ? 0 : -EMFILE,
+                         .generation = tb_region_generation(region) };
+    if (c == MAX_CLIENTS) {
+        send_reply(fd, &hello, NULL, 0);
+        close(fd);
+        return;
+    }
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    clients[c].fd = fd;
+    clients[c].pid = getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 ? cred.pid : 0;
+    if (send_reply(fd, &hello, &region_fd, 1) < 0) drop_client(c);
+}
+
+static void handle_request(int c) {
+    tb_request_t req;
+    struct iovec iov = { &req, sizeof(req) };
+    union {
+        char buf[CMSG_SPACE(sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    struct msghdr msg = {
+        .msg_iov = &iov, .msg_iovlen = 1,
+        .msg_control = control.buf, .msg_controllen = sizeof(control.buf)
+    };
+    ssize_t n = recvmsg(clients[c].fd, &msg, MSG_CMSG_CLOEXEC);
+    if (n < 0 && errno == EINTR) return;
+
+    int passed = -1;
+    for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+        if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_RIGHTS) {
+            memcpy(&passed, CMSG_DATA(cm), sizeof(int));
+        }
+    }
+    if (n != sizeof(req)) {
+        if (passed >= 0) close(passed);
+        drop_client(c);
+        return;
+    }
+
+    tb_reply_t reply = { 0 };
+    int fds[TB_MAX_SUBSCRIBERS];
+    int nfds = 0;
+
+    switch (req.op) {
+    case TB_OP_SUBSCRIBE: {
+        int slot;
+        for (slot = 0; slot < TB_MAX_SUBSCRIBERS && slot_owner[slot] >= 0; slot++) {}
+        req.pattern[TB_PATTERN_MAX - 1] = '\0';
+        if (passed < 0) {
+            reply.status = -EINVAL;
+        } else if (slot == TB_MAX_SUBSCRIBERS) {
+            reply.status = -ENOSPC;
+            close(passed);
+        } else {
+            slot_fd[slot] = passed;
+            slot_owner[slot] = c;
+            tb_region_subscribe(region, slot, req.pattern, clients[c].pid, req.origin);
+            reply.slot = slot;
+        }
+        break;
+    }
+    case TB_OP_UNSUBSCRIBE:
+        if (req.slot < TB_MAX_SUBSCRIBERS && slot_owner[req.slot] == c) {
+            release_slot(req.slot);
+        } else {
+            reply.status = -ENOENT;
+        }
+        break;
+    case TB_OP_FDS:
+        for (int s = 0; s < TB_MAX_SUBSCRIBERS; s++) {
+            if (slot_owner[s] >= 0) {
+                reply.slots[nfds] = s;
+                fds[nfds++] = slot_fd[s];
+            }
+        }
+        reply.count = nfds;
+        break;
+    default:
+        reply.status = -EINVAL;
+    }
+    if (passed >= 0 && req.op != TB_OP_SUBSCRIBE) close(passed);
+
+    reply.generation = tb_region_generation(region);
+    if (send_reply(clients[c].fd, &reply, fds, nfds) < 0) drop_client(c);
+}
+
+int main(int argc, char *argv[]) {
+    const char *socket_path = NULL;
+    long topics = TB_DEFAULT_TOPICS;
+    long ring = TB_DEFAULT_RING_SLOTS;
+    long slot_size = TB_DEFAULT_SLOT_SIZE;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        if (strcmp(argv[i], "--socket") == 0) socket_path = argv[++i];
+        else if (strcmp(argv[i], "--topics") == 0) topics = atol(argv[++i]);
+        else if (strcmp(argv[i], "--ring") == 0) ring = atol(argv[++i]);
+        else if (strcmp(argv[i], "--slot-size") == 0) slot_size = atol(argv[++i]);
+        else usage(argv[0]);
+    }
+    if (!socket_path || topics <= 0 || ring <= 0 || slot_size <= TB_SLOT_HEADER) usage(argv[0]);
+    slot_size = (slot_size + 7) & ~7L;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "tekton-busd: socket path too long: %s\n", socket_path);
+        return 1;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    /* One broker per socket: leave a live one alone, replace a stale one */
+    if (connect(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+        fprintf(stderr, "tekton-busd: already running on %s\n", socket_path);
+        return 0;
+    }
+    close(listen_fd);
+    listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    unlink(socket_path);
+    mode_t old_mask = umask(077);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 64) < 0) {
+        fprintf(stderr, "tekton-busd: %s: %s\n", socket_path, strerror(errno));
+        return 1;
+    }
+    umask(old_mask);
+
+    uint64_t size;
+    region_fd = tb_region_create(topics, ring, slot_size, &region, &size);
+    if (region_fd < 0) {
+        fprintf(stderr, "tekton-busd: cannot create region: %s\n", strerror(-region_fd));
+        unlink(socket_path);
+        return 1;
+    }
+
+    for (int c = 0; c < MAX_CLIENTS; c++) clients[c].fd = -1;
+    for (int s = 0; s < TB_MAX_SUBSCRIBERS; s++) {
+        slot_fd[s] = -1;
+        slot_owner[s] = -1;
+    }
+    signal(SIGTERM, on_signal);
+    signal(SIGINT, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    fprintf(stderr, "tekton-busd: serving %s (%ld topics x %ld slots x %ld bytes, %.1f MB reserved)\n",
+            socket_path, topics, ring, slot_size, size / 1048576.0);
+
+    struct pollfd fds[1 + MAX_CLIENTS];
+    int client_of[1 + MAX_CLIENTS];
+    while (!stop_requested) {
+        int nfds = 0;
+        fds[nfds].fd = listen_fd;
+        fds[nfds++].events = POLLIN;
+        for (int c = 0; c < MAX_CLIENTS; c++) {
+            if (clients[c].fd >= 0) {
+                fds[nfds].fd = clients[c].fd;
+                fds[nfds].events = POLLIN;
+                client_of[nfds++] = c;
+            }
+        }
+        if (poll(fds, nfds, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        if (fds[0].revents & POLLIN) accept_client(listen_fd);
+        for (int i = 1; i < nfds; i++) {
+            int c = client_of[i];
+            if (fds[i].revents & POLLIN) handle_request(c);
+            else if (fds[i].revents & (POLLHUP | POLLERR)) drop_client(c);
+        }
+    }
+
+    unlink(socket_path);
+    return 0;
+}
@@ -0,0 +1,272 @@
+/*
+ * tekton-embed.c - Batched feature-hashing text embeddings
+ *
+ * Each worker thread takes chunks of texts from a shared counter and keeps
+ * its own scratch (the distinct token hashes of the current text, their
+ * counts, and an open-addressing index over them), grown to the largest
+ * text it has seen. Nothing survives the call, so memory does not depend
+ * on how many distinct tokens have ever been encoded.
+ *
+ * The inner loop, adding one token's weighted vector to a row, is written
+ * to vectorize: 32-bit integer mixing and a float multiply-add per lane.
+ * On x86-64 it is compiled for AVX2 and baseline SSE2 and picked at load
+ * time.
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "tekton-embed.h"
+
+#define CHUNK_TEXTS 16
+#define COMPONENT_SCALE ((float)(2.449489742783178 / 65536.0))
+
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define VECTOR_CLONES __attribute__((target_clones("avx2", "default")))
+#endif
+#endif
+#ifndef VECTOR_CLONES
+#define VECTOR_CLONES
+#endif
+
+typedef struct {
+    uint64_t *hashes;     /* distinct tokens of the current text, first-seen order */
+    uint32_t *counts;
+    uint32_t *index;      /* open addressing into hashes, 0 = empty, else position + 1 */
+    uint32_t capacity;    /* of hashes and counts; index has 2 * capacity rounded up */
+    uint32_t index_size;
+} scratch_t;
+
+typedef struct {
+    const char *data;
+    const uint64_t *offsets;
+    uint32_t count;
+    uint32_t dim;
+    uint64_t seed;
+    int normalize;
+    float *out;
+    _Atomic uint32_t next;
+    _Atomic int error;
+} job_t;
+
+static inline uint64_t splitmix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static inline uint32_t fmix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85ebca6bU;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35U;
+    return x ^ (x >> 16);
+}
+
+static inline uint64_t finish_hash(uint64_t fnv, uint64_t seed) {
+    return splitmix64(fnv ^ (seed * 0x9E3779B97F4A7C15ULL));
+}
+
+uint64_t te_token_hash(const char *token, uint32_t len, uint64_t seed) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (uint32_t i = 0; i < len; i++) {
+        h ^= (unsigned char)token[i];
+        h *= 0x100000001b3ULL;
+    }
+    return finish_hash(h, seed);
+}
+
+/* row += weight * vector(hash) */
+VECTOR_CLONES
+static void accumulate(float *restrict row, uint32_t dim, uint64_t hash, float weight) {
+    uint32_t lo = (uint32_t)hash, hi = (uint32_t)(hash >> 32);
+    float scale = weight * COMPONENT_SCALE;
+    for (uint32_t j = 0; j < dim; j++) {
+        uint32_t x = fmix32(lo ^ (j * 0x9E3779B9U + hi));
+        int32_t t = (int32_t)(x & 0xffff) + (int32_t)(x >> 16) - 65535;
+        row[j] += (float)t * scale;
+    }
+}
+
+/* Length of the word character starting at p (0 if it is a separator) */
+static inline uint32_t word_char(const unsigned char *p, const unsigned char *end) {
+    unsigned char b = p[0];
+    if (b < 0x80)
+        return (b >= '0' && b <= '9') || (b >= 'a' && b <= 'z') ||
+               (b >= 'A' && b <= 'Z') || b == '_';
+    uint32_t len, cp;
+    if (b >= 0xC0 && b < 0xE0) { len = 2; cp = b & 0x1F; }
+    else if (b >= 0xE0 && b < 0xF0) { len = 3; cp = b & 0x0F; }
+    else if (b >= 0xF0 && b < 0xF8) { len = 4; cp = b & 0x07; }
+    else return 1;  /* stray continuation byte: part of a word */
+    if ((uint32_t)(end - p) < len)
+        return 1;
+    for (uint32_t i = 1; i < len; i++) {
+        if ((p[i] & 0xC0) != 0x80)
+            return 1;
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    if ((cp >= 0x80 && cp <= 0xBF) || (cp >= 0x2000 && cp <= 0x206F))
+        return 0;
+    return len;
+}
+
+static int reserve(scratch_t *s, uint32_t tokens) {
+    if (tokens <= s->capacity)
+        return 0;
+    uint32_t capacity = s->capacity ? s->capacity : 64;
+    while (capacity < tokens)
+        capacity *= 2;
+    uint64_t *hashes = realloc(s->hashes, capacity * sizeof(*hashes));
+    if (!hashes)
+        return -ENOMEM;
+    s->hashes = hashes;
+    uint32_t *counts = realloc(s->counts, capacity * sizeof(*counts));
+    if (!counts)
+        return -ENOMEM;
+    s->counts = counts;
+    uint32_t *index = malloc(2 * capacity * sizeof(*index));
+    if (!index)
+        return -ENOMEM;
+    free(s->index);
+    s->index = index;
+    s->index_size = 2 * capacity;
+    s->capacity = capacity;
+    return 0;
+}
+
+static int encode_text(scratch_t *s, const unsigned char *text, uint64_t len,
+                       uint32_t dim, uint64_t seed, int normalize, float *row) {
+    memset(row, 0, dim * sizeof(float));
+    if (len == 0)
+        return 0;
+    if (len > UINT32_MAX)
+        return -EINVAL;
+    /* Tokens are separated, so there are at most len / 2 + 1 of them */
+    int rc = reserve(s, (uint32_t)(len / 2 + 1));
+    if (rc < 0)
+        return rc;
+
+    uint32_t distinct = 0, mask = s->index_size - 1;
+    memset(s->index, 0, s->index_size * sizeof(uint32_t));
+    const unsigned char *p = text, *end = text + len;
+    while (p < end) {
+        uint32_t step = word_char(p, end);
+        if (!step) {
+            p++;
+            while (p < end && (*p & 0xC0) == 0x80)
+                p++;
+            continue;
+        }
+        uint64_t h = 0xcbf29ce484222325ULL;
+        while (step) {
+            for (uint32_t i = 0; i < step; i++) {
+                unsigned char b = p[i];
+                if (b >= 'A' && b <= 'Z')
+                    b += 'a' - 'A';
+                h ^= b;
+                h *= 0x100000001b3ULL;
+            }
+            p += step;
+            step = p < end ? word_char(p, end) : 0;
+        }
+        h = finish_hash(h, seed);
+
+        uint32_t slot = (uint32_t)h & mask;
+        while (s->index[slot] && s->hashes[s->index[slot] - 1] != h)
+            slot = (slot + 1) & mask;
+        if (s->index[slot]) {
+            s->counts[s->index[slot] - 1]++;
+        } else {
+            s->hashes[distinct] = h;
+            s->counts[distinct] = 1;
+            s->index[slot] = ++distinct;
+        }
+    }
+
+    for (uint32_t i = 0; i < distinct; i++) {
+        float weight = (float)(1.0 / (1.0 + log((double)s->counts[i])));
+        accumulate(row, dim, s->hashes[i], weight);
+    }
+
+    if (normalize) {
+        double sum = 0;
+        for (uint32_t j = 0; j < dim; j++)
+            sum += (double)row[j] * row[j];
+        double norm = sqrt(sum);
+        float inverse = (float)(1.0 / (norm > 1e-10 ? norm : 1e-10));
+        for (uint32_t j = 0; j < dim; j++)
+            row[j] *= inverse;
+    }
+    return 0;
+}
+
+static void *worker(void *arg) {
+    job_t *job = arg;
+    scratch_t scratch = {0};
+    for (;;) {
+        uint32_t first = atomic_fetch_add(&job->next, CHUNK_TEXTS);
+        if (first >= job->count || atomic_load(&job->error))
+            break;
+        uint32_t last = first + CHUNK_TEXTS < job->count ? first + CHUNK_TEXTS : job->count;
+        for (uint32_t i = first; i < last; i++) {
+            uint64_t start = job->offsets[i];
+            int rc = encode_text(&scratch, (const unsigned char *)job->data + start,
+                                 job->offsets[i + 1] - start, job->dim, job->seed,
+                                 job->normalize, job->out + (uint64_t)i * job->dim);
+            if (rc < 0) {
+                atomic_store(&job->error, rc);
+                break;
+            }
+        }
+    }
+    free(scratch.hashes);
+    free(scratch.counts);
+    free(scratch.index);
+    return NULL;
+}
+
+int te_encode(const char *data, const uint64_t *offsets, uint32_t count,
+              uint32_t dim, uint64_t seed, int normalize, int threads, float *out) {
+    if (dim == 0 || threads < 0)
+        return -EINVAL;
+    for (uint32_t i = 0; i < count; i++)
+        if (offsets[i + 1] < offsets[i])
+            return -EINVAL;
+
+    job_t job = {.data = data, .offsets = offsets, .count = count, .dim = dim,
+                 .seed = seed, .normalize = normalize, .out = out};
+    atomic_init(&job.next, 0);
+    atomic_init(&job.error, 0);
+
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    uint32_t useful = (count + TE_MIN_TEXTS_PER_THREAD - 1) / TE_MIN_TEXTS_PER_THREAD;
+    if ((uint32_t)threads > useful)
+        threads = (int)useful;
+    if (threads > TE_MAX_THREADS)
+        threads = TE_MAX_THREADS;
+
+    /* The calling thread is one of the workers */
+    pthread_t ids[TE_MAX_THREADS];
+    int started = 0;
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&ids[started], NULL, worker, &job) != 0)
+            break;
+        started++;
+    }
+    worker(&job);
+    for (int t = 0; t < started; t++)
+        pthread_join(ids[t], NULL);
+    return atomic_load(&job.error);
+}
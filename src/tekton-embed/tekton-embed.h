@@ -0,0 +1,43 @@
+/*
+ * tekton-embed.h - Batched feature-hashing text embeddings for Engram
+ *
+ * Every token gets a fixed pseudo-random vector derived from a hash of its
+ * bytes, so there is no vocabulary to store and the same token maps to the
+ * same vector in every process. A text's embedding is the sum of its
+ * distinct tokens' vectors, each weighted by 1 / (1 + ln(count)), then
+ * optionally scaled to unit length.
+ *
+ * Tokens are runs of ASCII letters, digits and '_' and of non-ASCII code
+ * points outside U+0080-U+00BF and U+2000-U+206F (Latin-1 and general
+ * punctuation), with ASCII folded to lower case. Callers that need full
+ * Unicode case folding lower-case the text first.
+ *
+ * Token hash:    h = splitmix64(fnv1a64(token) ^ seed * 0x9E3779B97F4A7C15)
+ * Component j:   x = murmur3_fmix32(lo32(h) ^ (j * 0x9E3779B9 + hi32(h)))
+ *                v = ((x & 0xffff) + (x >> 16) - 65535) * sqrt(6) / 65536
+ *
+ * v is triangular with mean 0 and variance 1. The Python binding
+ * (shared/utils/hash_embedding.py) implements the same definition when the
+ * library is not built.
+ */
+#ifndef TEKTON_EMBED_H
+#define TEKTON_EMBED_H
+
+#include <stdint.h>
+
+/* Batches smaller than this per thread are not worth a thread */
+#define TE_MIN_TEXTS_PER_THREAD 32
+#define TE_MAX_THREADS 64
+
+/*
+ * Encode count texts into out (count x dim float32, row-major). Text i is
+ * data[offsets[i]] up to data[offsets[i + 1]], UTF-8. threads = 0 uses one
+ * thread per online CPU. Returns 0 or -errno.
+ */
+int te_encode(const char *data, const uint64_t *offsets, uint32_t count,
+              uint32_t dim, uint64_t seed, int normalize, int threads, float *out);
+
+/* The hash te_encode uses for a token (already lower-cased) */
+uint64_t te_token_hash(const char *token, uint32_t len, uint64_t seed);
+
+#endif /* TEKTON_EMBED_H */
@@ -0,0 +1,1075 @@
+/*
+ * tekton-front.c - Event-driven front server for the Hephaestus UI
+ *
+ * One thread, one epoll set. The front owns the public Hephaestus port:
+ *
+ *   - GET/HEAD for a file that exists under --root is answered here, with
+ *     the headers the Python server sends and the body sent with sendfile.
+ *   - Everything else (/api/..., /health, /ready, WebSocket upgrades, and
+ *     paths the Python handler rewrites) is streamed to an upstream: the
+ *     longest matching --route prefix, or the Python handler (--upstream).
+ *
+ * Client connections are kept alive and may pipeline. Each proxied request
+ * gets its own upstream connection with "Connection: close", so a response
+ * ends at the upstream's Content-Length or EOF. A 101 reply turns the pair
+ * into a tunnel that copies bytes both ways until either side closes,
+ * which is how WebSockets reach the Python handler without blocking
+ * anyone else.
+ *
+ * Usage:
+ *   tekton-front --port 8080 --root Hephaestus/ui --upstream 127.0.0.1:PORT
+ *                [--route /api/ai/=127.0.0.1:8003]... [--bind ADDR]
+ *                [--idle-timeout SECONDS] [--parent PID]
+ */
+#define _GNU_SOURCE
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define BUF_SIZE 16384
+#define MAX_EVENTS 256
+#define MAX_ROUTES 32
+#define SENDFILE_CHUNK (1 << 20)
+
+typedef struct {
+    char prefix[128];
+    size_t len;
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+} route_t;
+
+typedef struct {
+    char data[BUF_SIZE];
+    size_t off, len;          /* pending bytes are data[off..len) */
+} buf_t;
+
+enum { ST_REQUEST, ST_STATIC, ST_CONNECTING, ST_PROXY, ST_TUNNEL };
+
+typedef struct conn conn_t;
+
+typedef struct {
+    conn_t *conn;
+    int fd;
+    int upstream;
+    uint32_t events;          /* currently registered interest */
+} handle_t;
+
+struct conn {
+    handle_t client, up;
+    int state;
+    buf_t in;                 /* from the client, up to the end of the current request head */
+    buf_t out;                /* to the client */
+    buf_t up_out;             /* to the upstream */
+
+    int keep_alive;           /* the client may send another request on this connection */
+    int head_only;
+    int upgrade;
+    uint64_t body_left;       /* request body bytes not yet moved to up_out */
+
+    int file_fd;
+    off_t file_off, file_end;
+
+    int resp_head_done;
+    int resp_has_length;
+    uint64_t resp_left;
+    int up_done;              /* upstream finished (EOF or full Content-Length) */
+    int close_after;          /* close the client once out is drained */
+    int client_eof;
+
+    time_t last_active;
+    conn_t *prev, *next;
+};
+
+static int epfd = -1;
+static const char *root = NULL;
+static route_t routes[MAX_ROUTES];
+static int route_count = 0;
+static route_t default_upstream;
+static int idle_timeout = 60;
+static pid_t parent_pid = 0;
+static volatile sig_atomic_t running = 1;
+static conn_t *connections = NULL;
+
+/* ---------------------------------------------------------------- buffers */
+
+static size_t pending(const buf_t *b) { return b->len - b->off; }
+
+static size_t space(buf_t *b) {
+    if (b->off && b->len == BUF_SIZE) {
+        memmove(b->data, b->data + b->off, b->len - b->off);
+        b->len -= b->off;
+        b->off = 0;
+    }
+    if (b->off == b->len)
+        b->off = b->len = 0;
+    return BUF_SIZE - b->len;
+}
+
+static int append(buf_t *b, const char *data, size_t n) {
+    if (space(b) < n) {
+        memmove(b->data, b->data + b->off, b->len - b->off);
+        b->len -= b->off;
+        b->off = 0;
+        if (BUF_SIZE - b->len < n)
+            return -1;
+    }
+    memcpy(b->data + b->len, data, n);
+    b->len += n;
+    return 0;
+}
+
+static int appendf(buf_t *b, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static int appendf(buf_t *b, const char *fmt, ...) {
+    char line[1024];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (n < 0 || (size_t)n >= sizeof(line))
+        return -1;
+    return append(b, line, (size_t)n);
+}
+
+/* Move up to max pending bytes from one buffer to another */
+static size_t transfer(buf_t *from, buf_t *to, uint64_t max) {
+    size_t n = pending(from);
+    if (n > max)
+        n = (size_t)max;
+    size_t room = space(to);
+    if (n > room)
+        n = room;
+    memcpy(to->data + to->len, from->data + from->off, n);
+    to->len += n;
+    from->off += n;
+    return n;
+}
+
+/* ------------------------------------------------------------ connections */
+
+static void watch(handle_t *h, uint32_t events) {
+    if (h->fd < 0 || h->events == events)
+        return;
+    struct epoll_event ev = {.events = events, .data.ptr = h};
+    epoll_ctl(epfd, EPOLL_CTL_MOD, h->fd, &ev);
+    h->events = events;
+}
+
+static int add_fd(handle_t *h, int fd, int upstream, uint32_t events) {
+    h->fd = fd;
+    h->upstream = upstream;
+    h->events = events;
+    struct epoll_event ev = {.events = events, .data.ptr = h};
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void close_handle(handle_t *h) {
+    if (h->fd >= 0) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, h->fd, NULL);
+        close(h->fd);
+        h->fd = -1;
+        h->events = 0;
+    }
+}
+
+static void close_file(conn_t *c) {
+    if (c->file_fd >= 0) {
+        close(c->file_fd);
+        c->file_fd = -1;
+    }
+}
+
+static void destroy(conn_t *c) {
+    close_handle(&c->client);
+    close_handle(&c->up);
+    close_file(c);
+    if (c->prev)
+        c->prev->next = c->next;
+    else
+        connections = c->next;
+    if (c->next)
+        c->next->prev = c->prev;
+    free(c);
+}
+
+static void set_cork(conn_t *c, int on) {
+    setsockopt(c->client.fd, IPPROTO_TCP, TCP_CORK, &on, sizeof(on));
+}
+
+/* ---------------------------------------------------------------- parsing */
+
+static const char *find_head_end(const char *p, size_t n) {
+    const char *end = memmem(p, n, "\r\n\r\n", 4);
+    return end ? end + 4 : NULL;
+}
+
+/* Does a comma-separated header value contain token (case-insensitively)? */
+static int has_token(const char *value, size_t len, const char *token) {
+    size_t tlen = strlen(token);
+    const char *p = value, *end = value + len;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ','))
+            p++;
+        const char *start = p;
+        while (p < end && *p != ',')
+            p++;
+        const char *stop = p;
+        while (stop > start && (stop[-1] == ' ' || stop[-1] == '\t'))
+            stop--;
+        if ((size_t)(stop - start) == tlen && strncasecmp(start, token, tlen) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+typedef struct {
+    const char *name;
+    size_t name_len;
+    const char *value;
+    size_t value_len;
+} header_t;
+
+/* Next header line from *p (just past the previous line); 0 at the end of the head */
+static int next_header(const char **p, const char *end, header_t *h) {
+    const char *line = *p;
+    const char *eol = memmem(line, end - line, "\r\n", 2);
+    if (!eol || eol == line)
+        return 0;
+    *p = eol + 2;
+    const char *colon = memchr(line, ':', eol - line);
+    if (!colon) {
+        h->name = line;
+        h->name_len = 0;
+        return 1;
+    }
+    h->name = line;
+    h->name_len = colon - line;
+    const char *v = colon + 1;
+    while (v < eol && (*v == ' ' || *v == '\t'))
+        v++;
+    const char *ve = eol;
+    while (ve > v && (ve[-1] == ' ' || ve[-1] == '\t'))
+        ve--;
+    h->value = v;
+    h->value_len = ve - v;
+    return 1;
+}
+
+static int header_is(const header_t *h, const char *name) {
+    size_t n = strlen(name);
+    return h->name_len == n && strncasecmp(h->name, name, n) == 0;
+}
+
+/* Headers that describe one hop, not the message */
+static int hop_header(const header_t *h) {
+    return header_is(h, "Connection") || header_is(h, "Keep-Alive") ||
+           header_is(h, "Proxy-Connection") || header_is(h, "TE") || header_is(h, "Trailer");
+}
+
+static uint64_t parse_length(const char *v, size_t n, int *ok) {
+    uint64_t value = 0;
+    *ok = n > 0;
+    for (size_t i = 0; i < n; i++) {
+        if (v[i] < '0' || v[i] > '9' || value > UINT64_MAX / 10) {
+            *ok = 0;
+            return 0;
+        }
+        value = value * 10 + (uint64_t)(v[i] - '0');
+    }
+    return value;
+}
+
+/* --------------------------------------------------------------- responses */
+
+static void http_date(time_t t, char *out, size_t n) {
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    strftime(out, n, "%a, %d %b %Y %H:%M:%S GMT", &tm);
+}
+
+/* A short response generated here; closes the connection afterwards if close_after */
+static void simple_response(conn_t *c, int status, const char *reason, int close_after) {
+    char date[64];
+    http_date(time(NULL), date, sizeof(date));
+    char body[128];
+    int n = snprintf(body, sizeof(body), "%d %s\n", status, reason);
+    c->out.off = c->out.len = 0;
+    appendf(&c->out, "HTTP/1.1 %d %s\r\nServer: tekton-front\r\nDate: %s\r\n"
+            "Content-Type: text/plain\r\nContent-Length: %d\r\nConnection: %s\r\n\r\n",
+            status, reason, date, c->head_only ? 0 : n,
+            close_after || !c->keep_alive ? "close" : "keep-alive");
+    if (!c->head_only)
+        append(&c->out, body, (size_t)n);
+    c->close_after = close_after || !c->keep_alive;
+    c->up_done = 1;
+    c->resp_head_done = 1;
+    c->state = ST_PROXY;
+    close_handle(&c->up);
+}
+
+static const char *content_type(const char *path) {
+    static const struct { const char *ext, *type; } types[] = {
+        {".html", "text/html"}, {".htm", "text/html"},
+        {".js", "application/javascript"}, {".mjs", "application/javascript"},
+        {".css", "text/css"}, {".json", "application/json"}, {".map", "application/json"},
+        {".png", "image/png"}, {".jpg", "image/jpeg"}, {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"}, {".svg", "image/svg+xml"}, {".ico", "image/x-icon"},
+        {".webp", "image/webp"}, {".woff", "font/woff"}, {".woff2", "font/woff2"},
+        {".ttf", "font/ttf"}, {".txt", "text/plain"}, {".md", "text/markdown"},
+        {".wasm", "application/wasm"}, {".xml", "text/xml"},
+    };
+    const char *dot = strrchr(path, '.');
+    if (dot && !strchr(dot, '/'))
+        for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+            if (strcasecmp(dot, types[i].ext) == 0)
+                return types[i].type;
+    return "application/octet-stream";
+}
+
+static int hex(int ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+/*
+ * Serve target from root if it names a regular file (or a directory's
+ * index.html when it ends in '/'). 0 if the request should go upstream.
+ */
+static int try_static(conn_t *c, const char *target, size_t target_len,
+                      const char *if_modified_since, size_t ims_len) {
+    char path[PATH_MAX];
+    size_t rootlen = strlen(root), n = rootlen;
+    if (rootlen >= sizeof(path) - 16)
+        return 0;
+    memcpy(path, root, rootlen);
+    for (size_t i = 0; i < target_len && target[i] != '?' && target[i] != '#'; i++) {
+        int ch = (unsigned char)target[i];
+        if (ch == '%' && i + 2 < target_len && hex(target[i + 1]) >= 0 && hex(target[i + 2]) >= 0) {
+            ch = hex(target[i + 1]) * 16 + hex(target[i + 2]);
+            i += 2;
+        }
+        if (ch == 0 || ch == '\\' || n >= sizeof(path) - 16)
+            return 0;
+        path[n++] = (char)ch;
+    }
+    path[n] = '\0';
+    const char *rel = path + rootlen;
+    if (rel[0] != '/' || strstr(rel, "/../") || (n - rootlen >= 3 && strcmp(path + n - 3, "/..") == 0))
+        return 0;
+    if (path[n - 1] == '/') {
+        memcpy(path + n, "index.html", 11);
+        n += 10;
+    }
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return 0;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return 0;
+    }
+
+    char date[64], modified[64];
+    http_date(time(NULL), date, sizeof(date));
+    http_date(st.st_mtime, modified, sizeof(modified));
+    int not_modified = 0;
+    if (ims_len && ims_len < 64) {
+        char ims[64];
+        struct tm tm = {0};
+        memcpy(ims, if_modified_since, ims_len);
+        ims[ims_len] = '\0';
+        if (strptime(ims, "%a, %d %b %Y %H:%M:%S GMT", &tm) && timegm(&tm) >= st.st_mtime)
+            not_modified = 1;
+    }
+
+    c->out.off = c->out.len = 0;
+    const char *connection = c->keep_alive ? "keep-alive" : "close";
+    if (not_modified) {
+        appendf(&c->out, "HTTP/1.1 304 Not Modified\r\nServer: tekton-front\r\nDate: %s\r\n"
+                "Last-Modified: %s\r\nConnection: %s\r\n\r\n", date, modified, connection);
+        close(fd);
+    } else {
+        appendf(&c->out, "HTTP/1.1 200 OK\r\nServer: tekton-front\r\nDate: %s\r\n"
+                "Content-Type: %s\r\nContent-Length: %lld\r\nLast-Modified: %s\r\n"
+                "Cache-Control: no-cache, no-store, must-revalidate\r\nPragma: no-cache\r\n"
+                "Expires: 0\r\nConnection: %s\r\n\r\n",
+                date, content_type(path), (long long)st.st_size, modified, connection);
+        if (c->head_only) {
+            close(fd);
+        } else {
+            c->file_fd = fd;
+            c->file_off = 0;
+            c->file_end = st.st_size;
+            set_cork(c, 1);
+        }
+    }
+    c->state = ST_STATIC;
+    return 1;
+}
+
+/* ------------------------------------------------------------------ proxy */
+
+static const route_t *pick_route(const char *target, size_t len) {
+    const route_t *best = &default_upstream;
+    size_t best_len = 0;
+    for (int i = 0; i < route_count; i++)
+        if (routes[i].len <= len && routes[i].len > best_len &&
+            memcmp(target, routes[i].prefix, routes[i].len) == 0) {
+            best = &routes[i];
+            best_len = routes[i].len;
+        }
+    return best;
+}
+
+static int start_upstream(conn_t *c, const route_t *route) {
+    int fd = socket(route->addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, (const struct sockaddr *)&route->addr, route->addrlen) < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+    if (add_fd(&c->up, fd, 1, EPOLLOUT) < 0) {
+        close(fd);
+        c->up.fd = -1;
+        return -1;
+    }
+    c->state = ST_CONNECTING;
+    return 0;
+}
+
+static void client_address(conn_t *c, char *out, size_t n) {
+    struct sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+    out[0] = '\0';
+    if (getpeername(c->client.fd, (struct sockaddr *)&addr, &len) < 0)
+        return;
+    if (addr.ss_family == AF_INET)
+        inet_ntop(AF_INET, &((struct sockaddr_in *)&addr)->sin_addr, out, n);
+    else if (addr.ss_family == AF_INET6)
+        inet_ntop(AF_INET6, &((struct sockaddr_in6 *)&addr)->sin6_addr, out, n);
+}
+
+/* Parse the request head at in[off..head_end) and start answering it */
+static void handle_request(conn_t *c, const char *head, const char *head_end) {
+    const char *line_end = memmem(head, head_end - head, "\r\n", 2);
+    const char *sp1 = memchr(head, ' ', line_end - head);
+    const char *sp2 = sp1 ? memchr(sp1 + 1, ' ', line_end - sp1 - 1) : NULL;
+    c->keep_alive = 0;
+    c->head_only = 0;
+    if (!sp1 || !sp2 || strncmp(sp2 + 1, "HTTP/1.", 7) != 0) {
+        simple_response(c, 400, "Bad Request", 1);
+        return;
+    }
+    const char *method = head, *target = sp1 + 1;
+    size_t method_len = sp1 - head, target_len = sp2 - target;
+    int http11 = line_end - sp2 - 1 == 8 && sp2[8] == '1';
+    int is_get = method_len == 3 && memcmp(method, "GET", 3) == 0;
+    c->head_only = method_len == 4 && memcmp(method, "HEAD", 4) == 0;
+
+    int conn_close = 0, conn_keep = 0, conn_upgrade = 0, upgrade_ws = 0, chunked = 0, length_ok = 1;
+    uint64_t length = 0;
+    const char *ims = NULL;
+    size_t ims_len = 0;
+    header_t h;
+    const char *p = line_end + 2;
+    while (next_header(&p, head_end, &h)) {
+        if (header_is(&h, "Connection")) {
+            conn_close |= has_token(h.value, h.value_len, "close");
+            conn_keep |= has_token(h.value, h.value_len, "keep-alive");
+            conn_upgrade |= has_token(h.value, h.value_len, "upgrade");
+        } else if (header_is(&h, "Upgrade")) {
+            upgrade_ws = has_token(h.value, h.value_len, "websocket");
+        } else if (header_is(&h, "Content-Length")) {
+            length = parse_length(h.value, h.value_len, &length_ok);
+        } else if (header_is(&h, "Transfer-Encoding")) {
+            chunked = 1;
+        } else if (header_is(&h, "If-Modified-Since")) {
+            ims = h.value;
+            ims_len = h.value_len;
+        }
+    }
+    c->keep_alive = http11 ? !conn_close : conn_keep;
+    c->upgrade = conn_upgrade && upgrade_ws;
+    if (!length_ok) {
+        simple_response(c, 400, "Bad Request", 1);
+        return;
+    }
+    if (chunked) {
+        /* Browsers do not send chunked request bodies; forwarding them would need a parser */
+        simple_response(c, 411, "Length Required", 1);
+        return;
+    }
+
+    const route_t *route = pick_route(target, target_len);
+    if ((is_get || c->head_only) && !c->upgrade && route == &default_upstream &&
+        !(target_len >= 5 && memcmp(target, "/api/", 5) == 0) &&
+        try_static(c, target, target_len, ims, ims_len))
+        return;
+
+    /* Forward: same request line and headers, one request per upstream connection */
+    c->up_out.off = c->up_out.len = 0;
+    c->out.off = c->out.len = 0;
+    append(&c->up_out, head, line_end + 2 - head);
+    p = line_end + 2;
+    while (next_header(&p, head_end, &h)) {
+        if (!c->upgrade && hop_header(&h))
+            continue;
+        if (header_is(&h, "X-Forwarded-For"))
+            continue;
+        if (append(&c->up_out, h.name, p - h.name) < 0) {
+            simple_response(c, 431, "Request Header Fields Too Large", 1);
+            return;
+        }
+    }
+    char peer[INET6_ADDRSTRLEN];
+    client_address(c, peer, sizeof(peer));
+    if (peer[0])
+        appendf(&c->up_out, "X-Forwarded-For: %s\r\n", peer);
+    if (!c->upgrade)
+        append(&c->up_out, "Connection: close\r\n", 19);
+    append(&c->up_out, "\r\n", 2);
+
+    c->body_left = length;
+    c->resp_head_done = 0;
+    c->resp_has_length = 0;
+    c->resp_left = 0;
+    c->up_done = 0;
+    c->close_after = !c->keep_alive;
+    if (start_upstream(c, route) < 0)
+        simple_response(c, 502, "Bad Gateway", c->body_left > 0);
+}
+
+/*
+ * The upstream's response head is complete at out[off..end): rewrite the
+ * hop-by-hop headers for the client and work out where the body ends.
+ */
+static void handle_response_head(conn_t *c, const char *head, const char *head_end) {
+    const char *line_end = memmem(head, head_end - head, "\r\n", 2);
+    int status = 0;
+    if (line_end - head >= 12)
+        status = atoi(head + 9);
+
+    if (c->upgrade && status == 101) {
+        /* Pass the handshake through untouched; from here on it is a byte stream */
+        c->resp_head_done = 1;
+        c->state = ST_TUNNEL;
+        transfer(&c->in, &c->up_out, UINT64_MAX);
+        return;
+    }
+
+    int chunked = 0, has_length = 0, length_ok = 1;
+    uint64_t length = 0;
+    header_t h;
+    const char *p = line_end + 2;
+    while (next_header(&p, head_end, &h)) {
+        if (header_is(&h, "Content-Length")) {
+            length = parse_length(h.value, h.value_len, &length_ok);
+            has_length = length_ok;
+        } else if (header_is(&h, "Transfer-Encoding")) {
+            chunked = has_token(h.value, h.value_len, "chunked");
+        }
+    }
+    if (c->head_only || status == 204 || status == 304 || (status >= 100 && status < 200)) {
+        has_length = 1;
+        length = 0;
+    }
+    if (!has_length && !chunked)
+        c->close_after = 1;  /* the body ends when the connection does */
+    if (c->body_left)
+        c->close_after = 1;  /* the upstream answered before reading the whole body */
+
+    buf_t rewritten;
+    rewritten.off = rewritten.len = 0;
+    append(&rewritten, head, line_end + 2 - head);
+    p = line_end + 2;
+    while (next_header(&p, head_end, &h))
+        if (!hop_header(&h))
+            append(&rewritten, h.name, p - h.name);
+    appendf(&rewritten, "Connection: %s\r\n\r\n", c->close_after ? "close" : "keep-alive");
+
+    /* Replace the head in out with the rewritten one, keeping any body bytes after it */
+    size_t body = c->out.len - (size_t)(head_end - c->out.data);
+    char *tail = malloc(body ? body : 1);
+    if (!tail) {
+        c->close_after = 1;
+        return;
+    }
+    memcpy(tail, head_end, body);
+    c->out.off = c->out.len = 0;
+    append(&c->out, rewritten.data, rewritten.len);
+    if (has_length && body > length)
+        body = (size_t)length;
+    append(&c->out, tail, body);
+    free(tail);
+
+    c->resp_head_done = 1;
+    c->resp_has_length = has_length;
+    if (has_length) {
+        c->resp_left = length - body;
+        if (c->resp_left == 0) {
+            c->up_done = 1;
+            close_handle(&c->up);
+        }
+    }
+}
+
+/* --------------------------------------------------------------- progress */
+
+static int finish_response(conn_t *c);
+
+/* Read what is available from fd into b (at most max bytes); -1 on EOF or error */
+static int fill(int fd, buf_t *b, uint64_t max) {
+    size_t room = space(b);
+    if (room > max)
+        room = (size_t)max;
+    if (room == 0)
+        return 0;
+    ssize_t n = read(fd, b->data + b->len, room);
+    if (n > 0) {
+        b->len += (size_t)n;
+        return (int)n;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return 0;
+    return -1;
+}
+
+/* Write what is pending in b to fd; -1 on error */
+static int flush(int fd, buf_t *b) {
+    while (pending(b)) {
+        ssize_t n = send(fd, b->data + b->off, pending(b), MSG_NOSIGNAL);
+        if (n < 0)
+            return errno == EAGAIN || errno == EINTR ? 0 : -1;
+        b->off += (size_t)n;
+    }
+    b->off = b->len = 0;
+    return 0;
+}
+
+/* Parse and start every complete request waiting in in; stops once one is in flight */
+static void next_request(conn_t *c) {
+    while (c->state == ST_REQUEST) {
+        const char *head = c->in.data + c->in.off;
+        const char *end = find_head_end(head, pending(&c->in));
+        if (!end) {
+            if (space(&c->in) == 0) {
+                c->keep_alive = 0;
+                simple_response(c, 431, "Request Header Fields Too Large", 1);
+            }
+            return;
+        }
+        c->in.off = end - c->in.data;
+        handle_request(c, head, end);
+        if (c->state == ST_CONNECTING || c->state == ST_PROXY)
+            c->body_left -= transfer(&c->in, &c->up_out, c->body_left);
+    }
+}
+
+/* The exchange is over: keep the client for its next request, or close it. 0 if closed */
+static int finish_response(conn_t *c) {
+    close_handle(&c->up);
+    close_file(c);
+    if (c->close_after || c->client_eof) {
+        destroy(c);
+        return 0;
+    }
+    c->state = ST_REQUEST;
+    c->out.off = c->out.len = 0;
+    c->up_out.off = c->up_out.len = 0;
+    next_request(c);
+    return 1;
+}
+
+static void update_interest(conn_t *c) {
+    uint32_t client = 0, up = 0;
+    switch (c->state) {
+    case ST_REQUEST:
+        client = EPOLLIN;
+        break;
+    case ST_STATIC:
+        client = EPOLLOUT;
+        break;
+    case ST_CONNECTING:
+        up = EPOLLOUT;
+        break;
+    case ST_PROXY:
+        if (c->body_left && space(&c->up_out))
+            client |= EPOLLIN;
+        if (pending(&c->out))
+            client |= EPOLLOUT;
+        if (!c->up_done && space(&c->out))
+            up |= EPOLLIN;
+        if (pending(&c->up_out))
+            up |= EPOLLOUT;
+        break;
+    case ST_TUNNEL:
+        if (!c->client_eof && space(&c->up_out))
+            client |= EPOLLIN;
+        if (pending(&c->out))
+            client |= EPOLLOUT;
+        if (!c->up_done && space(&c->out))
+            up |= EPOLLIN;
+        if (pending(&c->up_out))
+            up |= EPOLLOUT;
+        break;
+    }
+    watch(&c->client, client);
+    watch(&c->up, up);
+}
+
+/* Returns 0 if the connection was destroyed */
+static int on_client(conn_t *c, uint32_t events) {
+    c->last_active = time(NULL);
+    if (events & EPOLLERR) {
+        destroy(c);
+        return 0;
+    }
+
+    if (events & (EPOLLIN | EPOLLHUP)) {
+        switch (c->state) {
+        case ST_REQUEST:
+            if (fill(c->client.fd, &c->in, UINT64_MAX) < 0) {
+                destroy(c);
+                return 0;
+            }
+            next_request(c);
+            break;
+        case ST_PROXY:
+            if (c->body_left) {
+                int n = fill(c->client.fd, &c->up_out, c->body_left);
+                if (n < 0) {
+                    destroy(c);
+                    return 0;
+                }
+                c->body_left -= (uint64_t)n;
+            } else if (events & EPOLLHUP) {
+                destroy(c);
+                return 0;
+            }
+            break;
+        case ST_TUNNEL:
+            if (!c->client_eof && fill(c->client.fd, &c->up_out, UINT64_MAX) < 0)
+                c->client_eof = 1;
+            break;
+        default:
+            if (events & EPOLLHUP) {
+                destroy(c);
+                return 0;
+            }
+        }
+    }
+
+    if (events & EPOLLOUT) {
+        if (flush(c->client.fd, &c->out) < 0) {
+            destroy(c);
+            return 0;
+        }
+        if (c->state == ST_STATIC && !pending(&c->out)) {
+            while (c->file_fd >= 0 && c->file_off < c->file_end) {
+                size_t chunk = c->file_end - c->file_off;
+                if (chunk > SENDFILE_CHUNK)
+                    chunk = SENDFILE_CHUNK;
+                ssize_t n = sendfile(c->client.fd, c->file_fd, &c->file_off, chunk);
+                if (n < 0 && (errno == EAGAIN || errno == EINTR))
+                    break;
+                if (n <= 0) {
+                    destroy(c);
+                    return 0;
+                }
+            }
+            if (c->file_fd >= 0 && c->file_off >= c->file_end) {
+                set_cork(c, 0);
+                close_file(c);
+            }
+        }
+    }
+    return 1;
+}
+
+static int on_upstream(conn_t *c, uint32_t events) {
+    if (c->state == ST_CONNECTING) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(c->up.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err || (events & EPOLLERR)) {
+            simple_response(c, 502, "Bad Gateway", c->body_left > 0);
+            return 1;
+        }
+        c->state = ST_PROXY;
+    }
+
+    if (events & EPOLLOUT) {
+        if (flush(c->up.fd, &c->up_out) < 0) {
+            if (!c->resp_head_done)
+                simple_response(c, 502, "Bad Gateway", 1);
+            else
+                c->close_after = c->up_done = 1;
+            close_handle(&c->up);
+            return 1;
+        }
+    }
+
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        uint64_t max = c->resp_head_done && c->resp_has_length ? c->resp_left : UINT64_MAX;
+        int n = fill(c->up.fd, &c->out, max);
+        if (n < 0) {
+            close_handle(&c->up);
+            c->up_done = 1;
+            if (c->state == ST_PROXY && !c->resp_head_done) {
+                simple_response(c, 502, "Bad Gateway", 1);
+                return 1;
+            }
+            if (c->resp_has_length && c->resp_left)
+                c->close_after = 1;  /* truncated */
+        } else if (n > 0 && c->state == ST_PROXY) {
+            if (!c->resp_head_done) {
+                const char *head = c->out.data + c->out.off;
+                const char *end = find_head_end(head, pending(&c->out));
+                if (end)
+                    handle_response_head(c, head, end);
+                else if (space(&c->out) == 0) {
+                    simple_response(c, 502, "Bad Gateway", 1);
+                    return 1;
+                }
+            } else if (c->resp_has_length) {
+                c->resp_left -= (uint64_t)n;
+                if (c->resp_left == 0) {
+                    c->up_done = 1;
+                    close_handle(&c->up);
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+/* After any event: flush what can be flushed and decide whether the exchange is over */
+static void settle(conn_t *c) {
+    if (c->state == ST_PROXY || c->state == ST_TUNNEL) {
+        if (pending(&c->out) && flush(c->client.fd, &c->out) < 0) {
+            destroy(c);
+            return;
+        }
+        if (c->up.fd >= 0 && pending(&c->up_out) && flush(c->up.fd, &c->up_out) < 0) {
+            close_handle(&c->up);
+            c->up_done = 1;
+        }
+    }
+    switch (c->state) {
+    case ST_STATIC:
+        if (!pending(&c->out) && c->file_fd < 0 && !finish_response(c))
+            return;
+        break;
+    case ST_PROXY:
+        if (c->up_done && !pending(&c->out) && !finish_response(c))
+            return;
+        break;
+    case ST_TUNNEL:
+        /* Either side hanging up ends the tunnel once its last bytes are delivered */
+        if ((c->up_done && !pending(&c->out)) || (c->client_eof && !pending(&c->up_out))) {
+            destroy(c);
+            return;
+        }
+        break;
+    }
+    update_interest(c);
+}
+
+/* ------------------------------------------------------------------- main */
+
+static void accept_all(int listener) {
+    for (;;) {
+        int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EINTR && errno != ECONNABORTED)
+                fprintf(stderr, "tekton-front: accept: %s\n", strerror(errno));
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        conn_t *c = calloc(1, sizeof(*c));
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        c->client.conn = c->up.conn = c;
+        c->up.fd = -1;
+        c->file_fd = -1;
+        c->state = ST_REQUEST;
+        c->last_active = time(NULL);
+        if (add_fd(&c->client, fd, 0, EPOLLIN) < 0) {
+            close(fd);
+            free(c);
+            continue;
+        }
+        c->next = connections;
+        if (connections)
+            connections->prev = c;
+        connections = c;
+    }
+}
+
+static void sweep_idle(void) {
+    time_t now = time(NULL);
+    conn_t *c = connections;
+    while (c) {
+        conn_t *next = c->next;
+        if (c->state == ST_REQUEST && now - c->last_active > idle_timeout)
+            destroy(c);
+        c = next;
+    }
+}
+
+static int resolve(const char *spec, route_t *route) {
+    char host[256];
+    const char *colon = strrchr(spec, ':');
+    if (!colon || (size_t)(colon - spec) >= sizeof(host))
+        return -1;
+    memcpy(host, spec, colon - spec);
+    host[colon - spec] = '\0';
+    struct addrinfo hints = {.ai_socktype = SOCK_STREAM}, *res;
+    if (getaddrinfo(host, colon + 1, &hints, &res) != 0)
+        return -1;
+    memcpy(&route->addr, res->ai_addr, res->ai_addrlen);
+    route->addrlen = res->ai_addrlen;
+    freeaddrinfo(res);
+    return 0;
+}
+
+static void stop(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "Usage: tekton-front --port PORT --root DIR --upstream HOST:PORT\n"
+            "                    [--route PREFIX=HOST:PORT]... [--bind ADDR]\n"
+            "                    [--idle-timeout SECONDS] [--parent PID]\n");
+}
+
+int main(int argc, char **argv) {
+    const char *bind_addr = "0.0.0.0", *upstream = NULL;
+    int port = 0;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i], *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            usage();
+            return 2;
+        }
+        if (strcmp(arg, "--port") == 0) port = atoi(value);
+        else if (strcmp(arg, "--root") == 0) root = value;
+        else if (strcmp(arg, "--upstream") == 0) upstream = value;
+        else if (strcmp(arg, "--bind") == 0) bind_addr = value;
+        else if (strcmp(arg, "--idle-timeout") == 0) idle_timeout = atoi(value);
+        else if (strcmp(arg, "--parent") == 0) parent_pid = (pid_t)atoi(value);
+        else if (strcmp(arg, "--route") == 0) {
+            const char *eq = strchr(value, '=');
+            route_t *r = &routes[route_count];
+            if (!eq || route_count == MAX_ROUTES || (size_t)(eq - value) >= sizeof(r->prefix) ||
+                resolve(eq + 1, r) < 0) {
+                fprintf(stderr, "tekton-front: bad route %s\n", value);
+                return 2;
+            }
+            memcpy(r->prefix, value, eq - value);
+            r->prefix[eq - value] = '\0';
+            r->len = eq - value;
+            route_count++;
+        } else {
+            usage();
+            return 2;
+        }
+        i++;
+    }
+    if (!port || !root || !upstream) {
+        usage();
+        return 2;
+    }
+    if (resolve(upstream, &default_upstream) < 0) {
+        fprintf(stderr, "tekton-front: cannot resolve upstream %s\n", upstream);
+        return 2;
+    }
+    static char root_path[PATH_MAX];
+    if (!realpath(root, root_path)) {
+        fprintf(stderr, "tekton-front: %s: %s\n", root, strerror(errno));
+        return 2;
+    }
+    root = root_path;
+
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction sa = {.sa_handler = stop};
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
+    int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons((uint16_t)port)};
+    if (inet_pton(AF_INET, bind_addr, &addr.sin_addr) != 1 ||
+        bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listener, 1024) < 0) {
+        fprintf(stderr, "tekton-front: cannot listen on %s:%d: %s\n", bind_addr, port, strerror(errno));
+        return 1;
+    }
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    handle_t listen_handle = {.conn = NULL, .fd = listener};
+    struct epoll_event lev = {.events = EPOLLIN, .data.ptr = &listen_handle};
+    epoll_ctl(epfd, EPOLL_CTL_ADD, listener, &lev);
+    fprintf(stderr, "tekton-front: serving %s on %s:%d, upstream %s, %d routes\n",
+            root, bind_addr, port, upstream, route_count);
+
+    struct epoll_event events[MAX_EVENTS];
+    time_t last_sweep = time(NULL);
+    while (running) {
+        int n = epoll_wait(epfd, events, MAX_EVENTS, 1000);
+        if (n < 0 && errno != EINTR)
+            break;
+        for (int i = 0; i < n; i++) {
+            handle_t *h = events[i].data.ptr;
+            if (h == &listen_handle) {
+                accept_all(listener);
+                continue;
+            }
+            conn_t *c = h->conn;
+            /* Skip handles closed by an earlier event in this batch */
+            if (h->fd < 0)
+                continue;
+            int alive = h->upstream ? on_upstream(c, events[i].events) : on_client(c, events[i].events);
+            if (alive)
+                settle(c);
+        }
+        time_t now = time(NULL);
+        if (now != last_sweep) {
+            last_sweep = now;
+            sweep_idle();
+            if (parent_pid && getppid() != parent_pid)
+                break;
+        }
+    }
+    while (connections)
+        destroy(connections);
+    close(listener);
+    return 0;
+}
@@ -0,0 +1,681 @@
+/*
+ * tekton-graph.c - Compressed-sparse-row graph engine for Athena
+ *
+ * Edge e runs from src[e] to dst[e]. For direction d (0 outgoing, 1
+ * incoming) node n's edges are adj[d][off[d][n] .. off[d][n + 1]) for the
+ * edges that existed at the last build, then the chain head[d][n] ->
+ * next[d][e] for those added since. Removed edges stay in both until the
+ * next build and are skipped by their dead flag.
+ *
+ * Query scratch is per node and stamped: a slot holds information only if
+ * it carries the current query's stamp, so nothing is cleared between
+ * queries.
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "tekton-graph.h"
+
+#define NONE UINT32_MAX
+#define MAX_NODES (UINT32_MAX - 1)
+#define MAX_EDGES ((uint64_t)UINT32_MAX - 1)
+/* Rebuild once this many edges, plus an eighth (added) or a quarter (removed) of the built ones, have changed */
+#define COMPACT_SLACK 4096
+#define EXPAND_CHUNK 256
+#define UNREACHABLE (UINT32_MAX / 2)
+
+typedef struct {
+    uint32_t *data;
+    uint64_t len, cap;
+} vec32;
+
+struct tg_graph {
+    uint32_t nodes, node_cap;
+    uint64_t edges, edge_cap;
+    uint64_t live_nodes, live_edges;
+    uint32_t *src, *dst, *type;      /* per edge */
+    uint8_t *dead;                   /* per edge */
+    uint8_t *gone;                   /* per node */
+
+    uint32_t built_nodes;
+    uint64_t built_edges, dead_built;
+    uint64_t *off[2];                /* per built node + 1; [0] outgoing, [1] incoming */
+    uint32_t *adj[2];                /* live built edges sorted by (node, neighbour, edge) */
+    uint32_t *head[2], *tail[2];     /* per node: edges added since the build */
+    uint32_t *next[2];               /* per edge */
+
+    uint32_t *mark, mark_stamp;      /* per node: neighbour taken, or node visited */
+    uint32_t *fseen, *bseen, search_stamp;
+    uint32_t *bdist;                 /* hops to the path target, where bseen holds the stamp */
+    uint8_t *on_path;
+    uint32_t *eseen, edge_stamp;     /* per edge, for tg_expand */
+    uint64_t eseen_cap;
+    vec32 result, cand, queue[3];
+};
+
+static int vec_reserve(vec32 *v, uint64_t extra) {
+    if (v->len + extra <= v->cap)
+        return 0;
+    uint64_t cap = v->cap ? v->cap : 256;
+    while (cap < v->len + extra)
+        cap *= 2;
+    uint32_t *p = realloc(v->data, cap * sizeof *p);
+    if (!p)
+        return -1;
+    v->data = p;
+    v->cap = cap;
+    return 0;
+}
+
+static inline int vec_push(vec32 *v, uint32_t x) {
+    if (v->len == v->cap && vec_reserve(v, 1))
+        return -1;
+    v->data[v->len++] = x;
+    return 0;
+}
+
+static int vec_append(vec32 *v, const vec32 *from) {
+    if (vec_reserve(v, from->len))
+        return -1;
+    memcpy(v->data + v->len, from->data, from->len * sizeof *v->data);
+    v->len += from->len;
+    return 0;
+}
+
+/* Resize *pp from old to cap elements, filling the new ones with fill bytes */
+static int grow(void *pp, size_t size, uint64_t old, uint64_t cap, int fill) {
+    void **p = pp;
+    void *q = realloc(*p, cap * size);
+    if (!q)
+        return -1;
+    memset((char *)q + old * size, fill, (cap - old) * size);
+    *p = q;
+    return 0;
+}
+
+static uint32_t new_stamp(uint32_t *stamp, uint32_t *a, uint32_t *b, uint64_t n) {
+    if (++*stamp == 0) {
+        memset(a, 0, n * sizeof *a);
+        if (b)
+            memset(b, 0, n * sizeof *b);
+        *stamp = 1;
+    }
+    return *stamp;
+}
+
+static inline uint32_t near_end(const tg_graph *g, int d, uint32_t e) {
+    return d ? g->dst[e] : g->src[e];
+}
+
+static inline uint32_t far_end(const tg_graph *g, int d, uint32_t e) {
+    return d ? g->src[e] : g->dst[e];
+}
+
+typedef struct {
+    const uint32_t *adj, *chain;
+    const uint8_t *dead;
+    uint64_t i, end;
+    uint32_t next;
+} edge_iter;
+
+static inline void iter_init(edge_iter *it, const tg_graph *g, uint32_t n, int d) {
+    it->adj = g->adj[d];
+    it->chain = g->next[d];
+    it->dead = g->dead;
+    if (n < g->built_nodes) {
+        it->i = g->off[d][n];
+        it->end = g->off[d][n + 1];
+    } else {
+        it->i = it->end = 0;
+    }
+    it->next = g->head[d][n];
+}
+
+static inline int iter_next(edge_iter *it, uint32_t *e) {
+    while (it->i < it->end) {
+        uint32_t x = it->adj[it->i++];
+        if (!it->dead[x]) {
+            *e = x;
+            return 1;
+        }
+    }
+    while (it->next != NONE) {
+        uint32_t x = it->next;
+        it->next = it->chain[x];
+        if (!it->dead[x]) {
+            *e = x;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+tg_graph *tg_new(void) {
+    return calloc(1, sizeof(tg_graph));
+}
+
+void tg_free(tg_graph *g) {
+    if (!g)
+        return;
+    free(g->src);
+    free(g->dst);
+    free(g->type);
+    free(g->dead);
+    free(g->gone);
+    for (int d = 0; d < 2; d++) {
+        free(g->off[d]);
+        free(g->adj[d]);
+        free(g->head[d]);
+        free(g->tail[d]);
+        free(g->next[d]);
+    }
+    free(g->mark);
+    free(g->fseen);
+    free(g->bseen);
+    free(g->bdist);
+    free(g->on_path);
+    free(g->eseen);
+    free(g->result.data);
+    free(g->cand.data);
+    for (int i = 0; i < 3; i++)
+        free(g->queue[i].data);
+    free(g);
+}
+
+static int reserve_nodes(tg_graph *g, uint64_t cap) {
+    uint64_t old = g->node_cap;
+    if (cap <= old)
+        return 0;
+    if (cap > MAX_NODES)
+        cap = MAX_NODES;
+    if (grow(&g->gone, 1, old, cap, 0) || grow(&g->on_path, 1, old, cap, 0) ||
+        grow(&g->head[0], 4, old, cap, 0xff) || grow(&g->head[1], 4, old, cap, 0xff) ||
+        grow(&g->tail[0], 4, old, cap, 0xff) || grow(&g->tail[1], 4, old, cap, 0xff) ||
+        grow(&g->mark, 4, old, cap, 0) || grow(&g->fseen, 4, old, cap, 0) ||
+        grow(&g->bseen, 4, old, cap, 0) || grow(&g->bdist, 4, old, cap, 0))
+        return -1;
+    g->node_cap = cap;
+    return 0;
+}
+
+static int reserve_edges(tg_graph *g, uint64_t needed) {
+    uint64_t old = g->edge_cap;
+    if (needed <= old)
+        return 0;
+    uint64_t cap = old ? old : 4096;
+    while (cap < needed)
+        cap *= 2;
+    if (cap > MAX_EDGES)
+        cap = MAX_EDGES;
+    if (grow(&g->src, 4, old, cap, 0) || grow(&g->dst, 4, old, cap, 0) ||
+        grow(&g->type, 4, old, cap, 0) || grow(&g->dead, 1, old, cap, 0) ||
+        grow(&g->next[0], 4, old, cap, 0xff) || grow(&g->next[1], 4, old, cap, 0xff))
+        return -1;
+    g->edge_cap = cap;
+    return 0;
+}
+
+int64_t tg_add_nodes(tg_graph *g, uint32_t count) {
+    uint64_t needed = (uint64_t)g->nodes + count;
+    if (needed > MAX_NODES)
+        return -1;
+    if (needed > g->node_cap) {
+        uint64_t cap = g->node_cap ? 2 * (uint64_t)g->node_cap : 1024;
+        if (reserve_nodes(g, cap > needed ? cap : needed))
+            return -1;
+    }
+    uint32_t first = g->nodes;
+    g->nodes += count;
+    g->live_nodes += count;
+    return first;
+}
+
+int64_t tg_add_node(tg_graph *g) {
+    return tg_add_nodes(g, 1);
+}
+
+uint64_t tg_node_count(const tg_graph *g) {
+    return g->live_nodes;
+}
+
+uint64_t tg_edge_count(const tg_graph *g) {
+    return g->live_edges;
+}
+
+static void maybe_compact(tg_graph *g) {
+    if (g->edges - g->built_edges > COMPACT_SLACK + g->built_edges / 8 ||
+        g->dead_built > COMPACT_SLACK + g->built_edges / 4)
+        tg_compact(g);  /* on failure the chains keep working */
+}
+
+int tg_compact(tg_graph *g) {
+    uint32_t n = g->nodes;
+    uint64_t live = g->live_edges;
+    uint64_t *off[2] = {NULL, NULL}, *count = NULL;
+    uint32_t *adj[2] = {NULL, NULL}, *tmp = NULL;
+    int d;
+
+    count = malloc((n + 1) * sizeof *count);
+    tmp = malloc((live ? live : 1) * sizeof *tmp);
+    for (d = 0; d < 2; d++) {
+        off[d] = malloc((n + 1) * sizeof *off[d]);
+        adj[d] = malloc((live ? live : 1) * sizeof *adj[d]);
+    }
+    if (!count || !tmp || !off[0] || !off[1] || !adj[0] || !adj[1]) {
+        free(count);
+        free(tmp);
+        for (d = 0; d < 2; d++) {
+            free(off[d]);
+            free(adj[d]);
+        }
+        return -1;
+    }
+
+    for (d = 0; d < 2; d++) {
+        /* Counting sort by neighbour, then a stable one by node */
+        memset(count, 0, (n + 1) * sizeof *count);
+        for (uint64_t e = 0; e < g->edges; e++)
+            if (!g->dead[e])
+                count[far_end(g, d, e) + 1]++;
+        for (uint32_t v = 0; v < n; v++)
+            count[v + 1] += count[v];
+        for (uint64_t e = 0; e < g->edges; e++)
+            if (!g->dead[e])
+                tmp[count[far_end(g, d, e)]++] = e;
+
+        memset(off[d], 0, (n + 1) * sizeof *off[d]);
+        for (uint64_t i = 0; i < live; i++)
+            off[d][near_end(g, d, tmp[i]) + 1]++;
+        for (uint32_t v = 0; v < n; v++)
+            off[d][v + 1] += off[d][v];
+        memcpy(count, off[d], (n + 1) * sizeof *count);
+        for (uint64_t i = 0; i < live; i++)
+            adj[d][count[near_end(g, d, tmp[i])]++] = tmp[i];
+
+        free(g->off[d]);
+        free(g->adj[d]);
+        g->off[d] = off[d];
+        g->adj[d] = adj[d];
+        memset(g->head[d], 0xff, (uint64_t)n * sizeof *g->head[d]);
+        memset(g->tail[d], 0xff, (uint64_t)n * sizeof *g->tail[d]);
+    }
+    free(count);
+    free(tmp);
+    g->built_nodes = n;
+    g->built_edges = g->edges;
+    g->dead_built = 0;
+    return 0;
+}
+
+int64_t tg_add_edges(tg_graph *g, uint64_t count, const uint32_t *src, const uint32_t *dst,
+                     const uint32_t *type) {
+    for (uint64_t i = 0; i < count; i++)
+        if (src[i] >= g->nodes || dst[i] >= g->nodes || g->gone[src[i]] || g->gone[dst[i]])
+            return -1;
+    if (g->edges + count > MAX_EDGES || reserve_edges(g, g->edges + count))
+        return -1;
+
+    uint64_t first = g->edges;
+    for (uint64_t i = 0; i < count; i++) {
+        uint32_t e = g->edges++;
+        g->src[e] = src[i];
+        g->dst[e] = dst[i];
+        g->type[e] = type[i];
+        g->dead[e] = 0;
+        for (int d = 0; d < 2; d++) {
+            uint32_t n = near_end(g, d, e);
+            g->next[d][e] = NONE;
+            if (g->tail[d][n] == NONE)
+                g->head[d][n] = e;
+            else
+                g->next[d][g->tail[d][n]] = e;
+            g->tail[d][n] = e;
+        }
+    }
+    g->live_edges += count;
+    maybe_compact(g);
+    return first;
+}
+
+int64_t tg_add_edge(tg_graph *g, uint32_t src, uint32_t dst, uint32_t type) {
+    return tg_add_edges(g, 1, &src, &dst, &type);
+}
+
+static void kill_edge(tg_graph *g, uint32_t e) {
+    g->dead[e] = 1;
+    g->live_edges--;
+    if (e < g->built_edges)
+        g->dead_built++;
+}
+
+int tg_remove_edge(tg_graph *g, uint32_t e) {
+    if (e >= g->edges || g->dead[e])
+        return -1;
+    kill_edge(g, e);
+    maybe_compact(g);
+    return 0;
+}
+
+int64_t tg_remove_node(tg_graph *g, uint32_t n) {
+    if (n >= g->nodes || g->gone[n])
+        return -1;
+    g->result.len = 0;
+    for (int d = 0; d < 2; d++) {
+        edge_iter it;
+        uint32_t e;
+        iter_init(&it, g, n, d);
+        while (iter_next(&it, &e)) {
+            if (vec_push(&g->result, e))
+                return -1;
+            kill_edge(g, e);
+        }
+    }
+    g->gone[n] = 1;
+    g->live_nodes--;
+    maybe_compact(g);
+    return g->result.len;
+}
+
+int64_t tg_edges_of(tg_graph *g, uint32_t n, int dir, uint32_t type) {
+    if (n >= g->nodes)
+        return -1;
+    g->result.len = 0;
+    for (int d = 0; d < 2; d++) {
+        if (!(dir & (1 << d)))
+            continue;
+        edge_iter it;
+        uint32_t e;
+        iter_init(&it, g, n, d);
+        while (iter_next(&it, &e))
+            if ((type == TG_ANY_TYPE || g->type[e] == type) && vec_push(&g->result, e))
+                return -1;
+    }
+    return g->result.len;
+}
+
+/*
+ * Label nodes from src forwards and from dst backwards, one level of the
+ * smaller frontier at a time, until the two radii add up to max_hops.
+ * Returns 1 if some node got both labels (a path of at most max_hops
+ * exists), 0 if not, -1 on allocation failure. *rb is the backward radius
+ * reached, or UNREACHABLE if every node that can reach dst was labelled.
+ */
+static int bidirectional_search(tg_graph *g, uint32_t src, uint32_t dst, uint32_t max_hops,
+                                uint32_t stamp, uint32_t *rb_out) {
+    vec32 *front[2] = {&g->queue[0], &g->queue[1]}, *next = &g->queue[2];
+    uint32_t *seen[2] = {g->fseen, g->bseen};
+    uint32_t radius[2] = {0, 0};
+    int met = 0;
+
+    front[0]->len = front[1]->len = 0;
+    if (vec_push(front[0], src) || vec_push(front[1], dst))
+        return -1;
+    g->fseen[src] = stamp;
+    g->bseen[dst] = stamp;
+    g->bdist[dst] = 0;
+
+    while (radius[0] + radius[1] < max_hops && front[0]->len && front[1]->len) {
+        int d = front[1]->len <= front[0]->len;  /* 1: expand backwards along incoming edges */
+        next->len = 0;
+        for (uint64_t i = 0; i < front[d]->len; i++) {
+            edge_iter it;
+            uint32_t e;
+            iter_init(&it, g, front[d]->data[i], d);
+            while (iter_next(&it, &e)) {
+                uint32_t v = far_end(g, d, e);
+                if (seen[d][v] == stamp)
+                    continue;
+                seen[d][v] = stamp;
+                if (d)
+                    g->bdist[v] = radius[1] + 1;
+                if (seen[!d][v] == stamp)
+                    met = 1;
+                if (vec_push(next, v))
+                    return -1;
+            }
+        }
+        vec32 swap = *front[d];
+        *front[d] = *next;
+        *next = swap;
+        radius[d]++;
+    }
+    *rb_out = front[1]->len ? radius[1] : UNREACHABLE;
+    return met;
+}
+
+/* Push (neighbour, edge) for u's distinct outgoing neighbours that can still reach dst in time */
+static int collect(tg_graph *g, uint32_t u, uint32_t depth, uint32_t dst, uint32_t max_hops,
+                   uint32_t stamp, uint32_t unlabelled) {
+    uint32_t taken = new_stamp(&g->mark_stamp, g->mark, NULL, g->node_cap);
+    edge_iter it;
+    uint32_t e;
+    iter_init(&it, g, u, 0);
+    while (iter_next(&it, &e)) {
+        uint32_t v = g->dst[e];
+        if (g->mark[v] == taken || g->on_path[v])
+            continue;
+        g->mark[v] = taken;
+        uint32_t bound = v == dst ? 0 : g->bseen[v] == stamp ? g->bdist[v] : unlabelled;
+        if ((uint64_t)depth + 1 + bound > max_hops)
+            continue;
+        if (vec_push(&g->cand, v) || vec_push(&g->cand, e))
+            return -1;
+    }
+    return 0;
+}
+
+int64_t tg_paths(tg_graph *g, uint32_t src, uint32_t dst, uint32_t max_hops, uint64_t max_paths) {
+    if (src >= g->nodes || dst >= g->nodes)
+        return -1;
+    g->result.len = 0;
+    if (src == dst || g->gone[src] || g->gone[dst] || !max_hops || !max_paths)
+        return 0;
+
+    uint32_t stamp = new_stamp(&g->search_stamp, g->fseen, g->bseen, g->node_cap);
+    uint32_t unlabelled;
+    int met = bidirectional_search(g, src, dst, max_hops, stamp, &unlabelled);
+    if (met <= 0)
+        return met;
+    if (unlabelled != UNREACHABLE)
+        unlabelled++;  /* unlabelled nodes are at least one hop beyond the backward radius */
+
+    /* Depth-first over candidate slices: frame k holds [begin, end) of cand pairs and the next one to try */
+    uint64_t *frames = malloc(3 * ((uint64_t)max_hops + 1) * sizeof *frames);
+    uint32_t *path = malloc(2 * ((uint64_t)max_hops + 1) * sizeof *path);
+    if (!frames || !path) {
+        free(frames);
+        free(path);
+        return -1;
+    }
+    uint64_t *begin = frames, *pos = frames + max_hops + 1, *end = frames + 2 * (max_hops + 1);
+    uint32_t *node = path, *edge = path + max_hops + 1;
+    uint64_t found = 0;
+    int64_t status = 0;
+    uint32_t depth = 0;
+
+    g->cand.len = 0;
+    node[0] = src;
+    g->on_path[src] = 1;
+    if (collect(g, src, 0, dst, max_hops, stamp, unlabelled))
+        status = -1;
+    begin[0] = pos[0] = 0;
+    end[0] = g->cand.len / 2;
+
+    while (status == 0) {
+        if (pos[depth] == end[depth]) {
+            g->on_path[node[depth]] = 0;
+            if (depth == 0)
+                break;
+            g->cand.len = 2 * begin[depth];
+            depth--;
+            continue;
+        }
+        uint64_t p = pos[depth]++;
+        uint32_t v = g->cand.data[2 * p], e = g->cand.data[2 * p + 1];
+        edge[depth] = e;
+        if (v == dst) {
+            if (vec_push(&g->result, depth + 1) || vec_reserve(&g->result, depth + 1)) {
+                status = -1;
+                break;
+            }
+            memcpy(g->result.data + g->result.len, edge, (depth + 1) * sizeof *edge);
+            g->result.len += depth + 1;
+            if (++found == max_paths)
+                break;
+            continue;
+        }
+        if (depth + 1 >= max_hops)
+            continue;
+        depth++;
+        node[depth] = v;
+        g->on_path[v] = 1;
+        begin[depth] = pos[depth] = g->cand.len / 2;
+        if (collect(g, v, depth, dst, max_hops, stamp, unlabelled))
+            status = -1;
+        end[depth] = g->cand.len / 2;
+    }
+    for (uint32_t k = 0; k <= depth; k++)
+        g->on_path[node[k]] = 0;
+    free(frames);
+    free(path);
+    return status ? status : (int64_t)found;
+}
+
+typedef struct {
+    tg_graph *g;
+    const uint32_t *frontier;
+    uint64_t count;
+    int dir;
+    uint32_t type, node_stamp, edge_stamp;
+    _Atomic uint64_t next;
+    _Atomic int error;
+} expand_job;
+
+typedef struct {
+    expand_job *job;
+    vec32 nodes, edges;
+} expand_worker;
+
+static void *expand_run(void *arg) {
+    expand_worker *w = arg;
+    expand_job *job = w->job;
+    tg_graph *g = job->g;
+    for (;;) {
+        uint64_t from = atomic_fetch_add(&job->next, EXPAND_CHUNK);
+        if (from >= job->count || atomic_load(&job->error))
+            break;
+        uint64_t to = from + EXPAND_CHUNK < job->count ? from + EXPAND_CHUNK : job->count;
+        for (uint64_t i = from; i < to; i++) {
+            for (int d = 0; d < 2; d++) {
+                if (!(job->dir & (1 << d)))
+                    continue;
+                edge_iter it;
+                uint32_t e;
+                iter_init(&it, g, job->frontier[i], d);
+                while (iter_next(&it, &e)) {
+                    if (job->type != TG_ANY_TYPE && g->type[e] != job->type)
+                        continue;
+                    if (__atomic_exchange_n(&g->eseen[e], job->edge_stamp, __ATOMIC_RELAXED) != job->edge_stamp &&
+                        vec_push(&w->edges, e))
+                        goto fail;
+                    uint32_t v = far_end(g, d, e);
+                    if (__atomic_exchange_n(&g->mark[v], job->node_stamp, __ATOMIC_RELAXED) != job->node_stamp &&
+                        vec_push(&w->nodes, v))
+                        goto fail;
+                }
+            }
+        }
+    }
+    return NULL;
+fail:
+    atomic_store(&job->error, 1);
+    return NULL;
+}
+
+int64_t tg_expand(tg_graph *g, const uint32_t *seeds, uint32_t count, uint32_t hops, int dir,
+                  uint32_t type, int threads, uint64_t *edges) {
+    for (uint32_t i = 0; i < count; i++)
+        if (seeds[i] >= g->nodes)
+            return -1;
+    if (g->eseen_cap < g->edge_cap) {
+        if (grow(&g->eseen, 4, g->eseen_cap, g->edge_cap, 0))
+            return -1;
+        g->eseen_cap = g->edge_cap;
+    }
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (threads > TG_MAX_THREADS)
+        threads = TG_MAX_THREADS;
+
+    expand_job job = {.g = g, .dir = dir, .type = type};
+    job.node_stamp = new_stamp(&g->mark_stamp, g->mark, NULL, g->node_cap);
+    job.edge_stamp = new_stamp(&g->edge_stamp, g->eseen, NULL, g->eseen_cap);
+    vec32 *nodes = &g->result, *frontier = &g->queue[0], *followed = &g->queue[1];
+    expand_worker workers[TG_MAX_THREADS];
+    int64_t status = 0;
+
+    nodes->len = frontier->len = followed->len = 0;
+    for (int t = 0; t < threads; t++)
+        workers[t] = (expand_worker){.job = &job};
+    for (uint32_t i = 0; i < count; i++) {
+        if (g->gone[seeds[i]] || g->mark[seeds[i]] == job.node_stamp)
+            continue;
+        g->mark[seeds[i]] = job.node_stamp;
+        if (vec_push(nodes, seeds[i]) || vec_push(frontier, seeds[i]))
+            status = -1;
+    }
+
+    for (uint32_t level = 0; level < hops && frontier->len && status == 0; level++) {
+        uint64_t wanted = (frontier->len + TG_MIN_FRONTIER_PER_THREAD - 1) / TG_MIN_FRONTIER_PER_THREAD;
+        int used = wanted < (uint64_t)threads ? (int)wanted : threads;
+        pthread_t ids[TG_MAX_THREADS];
+        int started = 0;
+
+        job.frontier = frontier->data;
+        job.count = frontier->len;
+        atomic_store(&job.next, 0);
+        for (int t = 1; t < used; t++) {
+            if (pthread_create(&ids[started], NULL, expand_run, &workers[t]) != 0)
+                break;  /* the chunk counter lets fewer workers finish the level */
+            started++;
+        }
+        expand_run(&workers[0]);
+        for (int t = 0; t < started; t++)
+            pthread_join(ids[t], NULL);
+        if (atomic_load(&job.error)) {
+            status = -1;
+            break;
+        }
+
+        frontier->len = 0;
+        for (int t = 0; t <= started; t++) {
+            if (vec_append(frontier, &workers[t].nodes) || vec_append(nodes, &workers[t].nodes) ||
+                vec_append(followed, &workers[t].edges))
+                status = -1;
+            workers[t].nodes.len = workers[t].edges.len = 0;
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        free(workers[t].nodes.data);
+        free(workers[t].edges.data);
+    }
+    if (status)
+        return -1;
+
+    uint64_t reached = nodes->len;
+    if (vec_append(nodes, followed))
+        return -1;
+    *edges = followed->len;
+    return reached;
+}
+
+const uint32_t *tg_result(const tg_graph *g, uint64_t *len) {
+    *len = g->result.len;
+    return g->result.data;
+}
@@ -0,0 +1,94 @@
+/*
+ * tekton-graph.h - Compressed-sparse-row graph engine for Athena
+ *
+ * Nodes and edges are dense indices handed out by the graph; the caller
+ * interns its own ids (entity and relationship UUIDs, relationship types)
+ * onto them. Each edge has a source, a target and a type.
+ *
+ * Adjacency is kept twice, outgoing and incoming, as CSR arrays of edge
+ * indices sorted by (node, neighbour, edge). Edges added since the arrays
+ * were built are chained per node after them and removed edges are only
+ * flagged, so mutations are O(1); the arrays are rebuilt from the live
+ * edges with two counting sorts once enough has changed.
+ *
+ * Queries write their output to a result buffer owned by the graph (see
+ * tg_result). A graph is not safe for concurrent calls; tg_expand uses
+ * threads internally.
+ */
+#ifndef TEKTON_GRAPH_H
+#define TEKTON_GRAPH_H
+
+#include <stdint.h>
+
+#define TG_OUT 1
+#define TG_IN 2
+#define TG_BOTH 3
+
+/* Type filter matching every edge */
+#define TG_ANY_TYPE UINT32_MAX
+
+/* Frontiers smaller than this per thread are expanded on fewer threads */
+#define TG_MIN_FRONTIER_PER_THREAD 1024
+#define TG_MAX_THREADS 64
+
+typedef struct tg_graph tg_graph;
+
+tg_graph *tg_new(void);
+void tg_free(tg_graph *g);
+
+/* A new node. Returns its index or -1 */
+int64_t tg_add_node(tg_graph *g);
+/* count nodes at once, with consecutive indices. Returns the first or -1 */
+int64_t tg_add_nodes(tg_graph *g, uint32_t count);
+/* Remove node n and every edge touching it; the result is those edges. Returns their count or -1 */
+int64_t tg_remove_node(tg_graph *g, uint32_t n);
+
+/* A new edge between existing nodes. Returns its index or -1 */
+int64_t tg_add_edge(tg_graph *g, uint32_t src, uint32_t dst, uint32_t type);
+/* count edges at once, with consecutive indices. Returns the first or -1 */
+int64_t tg_add_edges(tg_graph *g, uint64_t count, const uint32_t *src, const uint32_t *dst,
+                     const uint32_t *type);
+/* 0, or -1 if e is not a live edge */
+int tg_remove_edge(tg_graph *g, uint32_t e);
+
+uint64_t tg_node_count(const tg_graph *g);
+uint64_t tg_edge_count(const tg_graph *g);
+
+/* Rebuild the CSR arrays from the live edges now. 0 or -1 */
+int tg_compact(tg_graph *g);
+
+/*
+ * Live edges of node n in direction dir (TG_OUT, TG_IN or TG_BOTH,
+ * outgoing first) of the given type. The result is their indices.
+ * Returns the count or -1.
+ */
+int64_t tg_edges_of(tg_graph *g, uint32_t n, int dir, uint32_t type);
+
+/*
+ * Simple directed paths from src to dst of at most max_hops edges, stopping
+ * after max_paths. Each path is written as its edge count followed by its
+ * edge indices. Between two consecutive nodes only the lowest-indexed edge
+ * is used, so parallel edges do not multiply paths.
+ *
+ * A bidirectional breadth-first search, bounded by max_hops, first decides
+ * whether dst is reachable at all; its backward distances then prune the
+ * depth-first enumeration to nodes that can still reach dst in time.
+ * Returns the number of paths or -1.
+ */
+int64_t tg_paths(tg_graph *g, uint32_t src, uint32_t dst, uint32_t max_hops, uint64_t max_paths);
+
+/*
+ * Nodes within hops of the seeds along edges in direction dir of the given
+ * type, expanded one level at a time with up to threads workers (0 = one per
+ * CPU). The result is the nodes reached, seeds first and then level by
+ * level, followed by the edges followed. With more than one thread the order
+ * within a level is unspecified. Returns the node count and sets *edges to
+ * the edge count, or returns -1.
+ */
+int64_t tg_expand(tg_graph *g, const uint32_t *seeds, uint32_t count, uint32_t hops, int dir,
+                  uint32_t type, int threads, uint64_t *edges);
+
+/* Output of the last query, valid until the next call on the graph */
+const uint32_t *tg_result(const tg_graph *g, uint64_t *len);
+
+#endif /* TEKTON_GRAPH_H */
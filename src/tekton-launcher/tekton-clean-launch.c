@@ -16,34 +16,140 @@
 #include <libgen.h>
 #include <time.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <signal.h>
+
+/*
+ * USDT probes (provider "tekton") for bpftrace/perf on production builds.
+ * Compiled out when <sys/sdt.h> is unavailable or with make USDT=0.
+ * Latencies are in nanoseconds; see bpftrace/ for example scripts.
+ */
+#if defined(__has_include) && !defined(TEKTON_NO_USDT)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define TEKTON_USDT 1
+#endif
+#endif
+
+#ifdef TEKTON_USDT
+#define TEKTON_PROBE1(name, a) DTRACE_PROBE1(tekton, name, a)
+#define TEKTON_PROBE2(name, a, b) DTRACE_PROBE2(tekton, name, a, b)
+#define TEKTON_PROBE3(name, a, b, c) DTRACE_PROBE3(tekton, name, a, b, c)
+#else
+/* sizeof keeps the arguments "used" without evaluating them */
+#define TEKTON_PROBE1(name, a) ((void)sizeof(a))
+#define TEKTON_PROBE2(name, a, b) ((void)sizeof(a), (void)sizeof(b))
+#define TEKTON_PROBE3(name, a, b, c) ((void)sizeof(a), (void)sizeof(b), (void)sizeof(c))
+#endif
 
 #define MAX_PATH 4096
 #define MAX_LINE 8192
 #define MAX_ARGS 1024
 #define TILL_REGISTRY_FILE ".till/tekton/till-private.json"
 
+/* Host-wide port block leases, shared by every installation on this host */
+#define PORT_BLOCK_FILE ".till/tekton/port-blocks.bin"
+#define PORT_BLOCK_MAGIC "TKPB"
+#define PORT_BLOCK_VERSION 2
+#define PORT_BLOCK_SLOTS 40
+#define PORT_BLOCK_SIZE 100
+#define PORT_BLOCK_START 8000
+#define AI_PORT_BLOCK_START 45000
+#define AI_PORT_BLOCK_STEP 1000
+/* CI blocks stop above the highest component block so the two ranges never meet */
+#define AI_PORT_BLOCK_FLOOR (PORT_BLOCK_START + PORT_BLOCK_SLOTS * PORT_BLOCK_SIZE)
+#define PORT_LEASE_ROOT_MAX 1024
+
+/* Compiled component config written by the launcher (tekton/utils/component_blob.py) */
+#define COMPONENT_BLOB_FILE ".tekton/component_config.bin"
+#define COMPONENT_BLOB_MAGIC "TKCB"
+#define COMPONENT_BLOB_VERSION 3
+#define COMPONENT_BLOB_HEADER_MIN 44
+#define COMPONENT_BLOB_YAML "config/tekton_components.yaml"
+/* Ports exported from the blob, so the next launcher and Python can tell them from configured ones */
+#define COMPONENT_BLOB_PORTS_VAR "_TEKTON_BLOB_PORTS"
+#define COMPONENT_NAME_SIZE 32
+
 /* Structure to hold environment variables */
 typedef struct {
     char **vars;
+    unsigned char *from_tekton; /* set by an env file or the launcher, not inherited */
+    int inheriting;
     int count;
     int capacity;
 } env_list_t;
 
+/* One installation's lease on a component port block and CI port block */
+typedef struct {
+    int32_t in_use;
+    uint32_t port_base;
+    uint32_t ai_port_base;
+    uint32_t cfg_port_base;    /* configured blocks the lease was granted for */
+    uint32_t cfg_ai_port_base;
+    int32_t pid;               /* last `tekton start`, which execs the Python launcher */
+    int64_t last_used;
+    char root[PORT_LEASE_ROOT_MAX];
+} port_lease_t;
+
+/* Layout of PORT_BLOCK_FILE; also read by shared/utils/installations.py */
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t block_size;
+    port_lease_t slots[PORT_BLOCK_SLOTS];
+} port_table_t;
+
+/* Read-only view of the compiled component config; integers are little-endian u32 */
+typedef struct {
+    void *map;
+    size_t size;
+    uint32_t count;
+    const char *names;              /* count x COMPONENT_NAME_SIZE */
+    const unsigned char *ports;     /* count */
+    const unsigned char *ai_ports;  /* count */
+    const unsigned char *deps;      /* count + 1 starts into dep_names */
+    const unsigned char *dep_names; /* string table offsets, in declared order */
+    const char *strings;
+    size_t strings_size;
+} component_blob_t;
+
 /* Function prototypes */
 static char* find_tekton_root(const char *path_or_name);
 static char* lookup_in_till_registry(const char *name);
 static char* find_default_tekton(void);
 static int is_tekton_directory(const char *path);
 static int is_subcommand(const char *arg);
+static int takes_component_args(const char *subcommand);
 static void load_env_file(const char *filepath, env_list_t *env);
 static void set_environment(env_list_t *env);
 static char* get_env_value(env_list_t *env, const char *key);
 static void parse_arguments(int argc, char *argv[], char **path_or_name, char **coder_letter, char **subcommand, char ***sub_args, int *debug);
 static void execute_python_script(const char *script_name, char **args);
 static void execute_till(char **args);
+static void execute_command(char **args);
+static int print_environment(env_list_t *env, char **args);
 static env_list_t* create_env_list(void);
 static void add_env_var(env_list_t *env, const char *key, const char *value);
-static void write_javascript_env(const char *tekton_root, env_list_t *env);
+static void remove_env_var(env_list_t *env, const char *key);
+static void drop_exported_blob_ports(env_list_t *env);
+static void write_javascript_env(const char *tekton_root, env_list_t *env, component_blob_t *blob);
+static void allocate_port_block(const char *tekton_root, env_list_t *env, int acquire);
+static int open_component_blob(const char *tekton_root, env_list_t *env, component_blob_t *blob);
+static void close_component_blob(component_blob_t *blob);
+static uint32_t blob_u32(const unsigned char *p, uint32_t i);
+static const char* blob_string(component_blob_t *blob, uint32_t offset);
+static int blob_component_port(component_blob_t *blob, const char *component_id);
+static void export_blob_ports(env_list_t *env, component_blob_t *blob);
+static uint64_t blob_port_env_digest(env_list_t *env, const char *names, uint32_t count);
+static void print_json_string(FILE *fp, const char *value);
+static const char* port_value(env_list_t *env, component_blob_t *blob, const char *key, const char *fallback);
+static uint64_t monotonic_ns(void);
 
 int main(int argc, char *argv[]) {
     char *tekton_root;
@@ -53,6 +159,7 @@ int main(int argc, char *argv[]) {
     char **sub_args = NULL;
     int debug = 0;
     env_list_t *env;
+    component_blob_t blob;
     char path[MAX_PATH];
     
     /* Parse arguments to find path/name and global options */
@@ -66,6 +173,8 @@ int main(int argc, char *argv[]) {
     
     /* Find TEKTON_ROOT using new resolution logic */
     /* Priority: coder_letter > path_or_name > current_dir > default */
+    uint64_t resolve_start = monotonic_ns();
+    TEKTON_PROBE1(root_resolve_start, path_or_name ? path_or_name : "");
     if (coder_letter) {
         /* Legacy -c flag support */
         char coder_name[32];
@@ -78,6 +187,7 @@ int main(int argc, char *argv[]) {
     } else {
         tekton_root = find_tekton_root(path_or_name);
     }
+    TEKTON_PROBE2(root_resolve_done, tekton_root ? tekton_root : "", monotonic_ns() - resolve_start);
     
     if (!tekton_root) {
         fprintf(stderr, "Error: Could not determine Tekton directory\n");
@@ -87,6 +197,7 @@ int main(int argc, char *argv[]) {
     
     /* Create environment list starting with current environment */
     env = create_env_list();
+    drop_exported_blob_ports(env);
     
     /* Load environment files in order */
     /* 1. User home .env */
@@ -101,11 +212,24 @@ int main(int argc, char *argv[]) {
     snprintf(path, sizeof(path), "%s/.env.local", tekton_root);
     load_env_file(path, env);
     
+    /* 4. Host-wide port block lease (remaps ports on collision with another installation) */
+    allocate_port_block(tekton_root, env, subcommand &&
+                        (strcmp(subcommand, "start") == 0 || strcmp(subcommand, "launch") == 0));
+    
+    /* 5. Ports of compiled components the env files don't set (stale blobs are ignored) */
+    open_component_blob(tekton_root, env, &blob);
+    export_blob_ports(env, &blob);
+    
     /* Set the frozen environment marker */
     add_env_var(env, "_TEKTON_ENV_FROZEN", "1");
     
-    /* Write env.js file for Hephaestus to read */
-    write_javascript_env(tekton_root, env);
+    /* Write env.js file for Hephaestus to read (exec and env only consume the environment) */
+    if (!subcommand || (strcmp(subcommand, "exec") != 0 && strcmp(subcommand, "env") != 0)) {
+        uint64_t env_js_start = monotonic_ns();
+        write_javascript_env(tekton_root, env, &blob);
+        TEKTON_PROBE2(env_js_write, tekton_root, monotonic_ns() - env_js_start);
+    }
+    close_component_blob(&blob);
 
     /* Set debug logging if requested */
     if (debug) {
@@ -132,6 +256,12 @@ int main(int argc, char *argv[]) {
         printf("  status                Show component status\n");
         printf("  start, launch         Start components\n");
         printf("  stop, kill            Stop components\n");
+        printf("  restart <components>  Restart components (--overlap: no closed-port window)\n");
+        printf("  logs [-f] [components] Show component logs merged by time\n");
+        printf("  reload [--dry-run]    Restart components affected by .env edits\n");
+        printf("  exec -- <cmd...>      Run any command in the Tekton environment\n");
+        printf("  env [--export] [--format sh|json]\n");
+        printf("                        Print the Tekton environment\n");
         printf("  revert                Revert changes\n");
         printf("  till [args...]        Pass through to till command\n");
         printf("  help                  Show this help message\n\n");
@@ -139,7 +269,15 @@ int main(int argc, char *argv[]) {
         printf("  tekton start                    # Start Tekton in current dir\n");
         printf("  tekton start coder-b            # Start Coder-B from registry\n");
         printf("  tekton start /path/to/tekton   # Start specific path\n");
+        printf("  tekton start --trace trace.json # Record a launch timeline for Perfetto\n");
         printf("  tekton -c d status              # Status of Coder-D (legacy)\n");
+        printf("  tekton status --all-installations # Matrix of every registered Tekton\n");
+        printf("  tekton restart rhetor --overlap # Replace Rhetor while its port stays open\n");
+        printf("  tekton reload --dry-run         # Which components an .env edit touches\n");
+        printf("  tekton exec -- pytest tests/    # Tools see the same env as components\n");
+        printf("  eval \"$(tekton env --export)\"  # Load the environment into a shell\n");
+        printf("  tekton logs -f rhetor engram    # Follow two components in one stream\n");
+        printf("  tekton logs --grep timeout --since 1h --level ERROR # Indexed search\n");
         printf("  tekton till install tekton -i  # Run till interactively\n");
         return 0;
     }
@@ -151,11 +289,21 @@ int main(int argc, char *argv[]) {
         execute_python_script("enhanced_tekton_launcher.py", sub_args);
     } else if (strcmp(subcommand, "stop") == 0 || strcmp(subcommand, "kill") == 0) {
         execute_python_script("enhanced_tekton_killer.py", sub_args);
+    } else if (strcmp(subcommand, "restart") == 0) {
+        execute_python_script("enhanced_tekton_restart.py", sub_args);
+    } else if (strcmp(subcommand, "logs") == 0) {
+        execute_python_script("enhanced_tekton_logs.py", sub_args);
+    } else if (strcmp(subcommand, "reload") == 0) {
+        execute_python_script("enhanced_tekton_reload.py", sub_args);
     } else if (strcmp(subcommand, "revert") == 0) {
         execute_python_script("tekton-revert", sub_args);
+    } else if (strcmp(subcommand, "exec") == 0) {
+        execute_command(sub_args);
+    } else if (strcmp(subcommand, "env") == 0) {
+        return print_environment(env, sub_args);
     } else {
         fprintf(stderr, "Unknown command: %s\n", subcommand);
-        fprintf(stderr, "Available commands: status, start, stop, revert\n");
+        fprintf(stderr, "Available commands: status, start, stop, restart, logs, reload, revert, exec, env\n");
         return 1;
     }
     
@@ -210,7 +358,7 @@ static int is_tekton_directory(const char *path) {
 static int is_subcommand(const char *arg) {
     const char *commands[] = {
         "status", "start", "launch", "stop", "kill", 
-        "revert", "till", "help", "--help", "-h",
+        "restart", "logs", "reload", "revert", "exec", "env", "till", "help", "--help", "-h",
         NULL
     };
     
@@ -222,6 +370,12 @@ static int is_subcommand(const char *arg) {
     return 0;
 }
 
+/* Subcommands whose positional arguments are component names or a command, not a path/name */
+static int takes_component_args(const char *subcommand) {
+    return strcmp(subcommand, "restart") == 0 || strcmp(subcommand, "logs") == 0 ||
+           strcmp(subcommand, "exec") == 0;
+}
+
 static char* find_default_tekton(void) {
     char resolved[MAX_PATH];
     
@@ -259,6 +413,9 @@ static char* lookup_in_till_registry(const char *name) {
     
     if (!home) return NULL;
     
+    uint64_t lookup_start = monotonic_ns();
+    TEKTON_PROBE1(registry_lookup_start, name);
+    
     /* Convert name to lowercase for matching */
     int i;
     for (i = 0; name[i] && i < 255; i++) {
@@ -286,6 +443,7 @@ static char* lookup_in_till_registry(const char *name) {
         if (getenv("TEKTON_DEBUG")) {
             fprintf(stderr, "DEBUG: Could not open %s\n", till_path);
         }
+        TEKTON_PROBE3(registry_lookup_done, name, "", monotonic_ns() - lookup_start);
         return NULL;
     }
     
@@ -393,6 +551,7 @@ static char* lookup_in_till_registry(const char *name) {
     }
     
     fclose(fp);
+    TEKTON_PROBE3(registry_lookup_done, name, result ? result : "", monotonic_ns() - lookup_start);
     return result;
 }
 
@@ -401,6 +560,8 @@ static env_list_t* create_env_list(void) {
     env->capacity = 100;
     env->count = 0;
     env->vars = malloc(sizeof(char*) * env->capacity);
+    env->from_tekton = calloc(env->capacity, 1);
+    env->inheriting = 1;
     
     /* Copy current environment */
     extern char **environ;
@@ -412,6 +573,7 @@ static env_list_t* create_env_list(void) {
             *eq = '=';
         }
     }
+    env->inheriting = 0;
     
     return env;
 }
@@ -430,6 +592,7 @@ static void add_env_var(env_list_t *env, const char *key, const char *value) {
                 char *new_var = malloc(strlen(key) + strlen(value) + 2);
                 sprintf(new_var, "%s=%s", key, value);
                 env->vars[i] = new_var;
+                env->from_tekton[i] = !env->inheriting;
                 return;
             }
         }
@@ -439,17 +602,54 @@ static void add_env_var(env_list_t *env, const char *key, const char *value) {
     if (env->count >= env->capacity - 1) {
         env->capacity *= 2;
         env->vars = realloc(env->vars, sizeof(char*) * env->capacity);
+        env->from_tekton = realloc(env->from_tekton, env->capacity);
     }
     
     char *new_var = malloc(strlen(key) + strlen(value) + 2);
     sprintf(new_var, "%s=%s", key, value);
+    env->from_tekton[env->count] = !env->inheriting;
     env->vars[env->count++] = new_var;
     env->vars[env->count] = NULL;
 }
 
+static void remove_env_var(env_list_t *env, const char *key) {
+    size_t len = strlen(key);
+    
+    for (int i = 0; i < env->count; i++) {
+        if (strncmp(env->vars[i], key, len) == 0 && env->vars[i][len] == '=') {
+            free(env->vars[i]);
+            memmove(&env->vars[i], &env->vars[i + 1], sizeof(char*) * (env->count - i));
+            memmove(&env->from_tekton[i], &env->from_tekton[i + 1], env->count - i - 1);
+            env->count--;
+            return;
+        }
+    }
+}
+
+/* An inherited launcher environment (tekton exec, nested tekton) must not pass
+ * ports it took from the blob off as configured ones */
+static void drop_exported_blob_ports(env_list_t *env) {
+    char *list = get_env_value(env, COMPONENT_BLOB_PORTS_VAR);
+    char *copy, *key, *save;
+    
+    if (!list) return;
+    copy = strdup(list);
+    for (key = strtok_r(copy, ",", &save); key; key = strtok_r(NULL, ",", &save)) {
+        remove_env_var(env, key);
+    }
+    free(copy);
+    remove_env_var(env, COMPONENT_BLOB_PORTS_VAR);
+}
+
 static void load_env_file(const char *filepath, env_list_t *env) {
+    uint64_t load_start = monotonic_ns();
+    int loaded = 0;
     FILE *fp = fopen(filepath, "r");
-    if (!fp) return;  /* File doesn't exist, skip */
+    if (!fp) {
+        /* File doesn't exist, skip */
+        TEKTON_PROBE3(env_file_load, filepath, -1, monotonic_ns() - load_start);
+        return;
+    }
     
     char line[MAX_LINE];
     while (fgets(line, sizeof(line), fp)) {
@@ -484,9 +684,11 @@ static void load_env_file(const char *filepath, env_list_t *env) {
         
         /* Add to environment */
         add_env_var(env, key, value);
+        loaded++;
     }
     
     fclose(fp);
+    TEKTON_PROBE3(env_file_load, filepath, loaded, monotonic_ns() - load_start);
 }
 
 static void set_environment(env_list_t *env) {
@@ -521,7 +723,8 @@ static void parse_arguments(int argc, char *argv[], char **path_or_name, char **
                 subcommand_index = i;
                 *subcommand = argv[i];
                 /* Check if next arg is path/name */
-                if (i + 1 < argc && argv[i + 1][0] != '-' && !is_subcommand(argv[i + 1])) {
+                if (i + 1 < argc && argv[i + 1][0] != '-' && !is_subcommand(argv[i + 1]) &&
+                    !takes_component_args(argv[i])) {
                     path_index = i + 1;
                     *path_or_name = argv[i + 1];
                 }
@@ -600,6 +803,7 @@ static void execute_python_script(const char *script_name, char **args) {
     exec_args[i] = NULL;
     
     /* Execute Python script */
+    TEKTON_PROBE2(exec, script_path, i - 2);
     execvp("python3", exec_args);
     
     /* If we get here, exec failed */
@@ -608,6 +812,12 @@ static void execute_python_script(const char *script_name, char **args) {
 }
 
 
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
 static char* get_env_value(env_list_t *env, const char *key) {
     for (int i = 0; i < env->count; i++) {
         char *eq = strchr(env->vars[i], '=');
@@ -621,7 +831,7 @@ static char* get_env_value(env_list_t *env, const char *key) {
     return NULL;
 }
 
-static void write_javascript_env(const char *tekton_root, env_list_t *env) {
+static void write_javascript_env(const char *tekton_root, env_list_t *env, component_blob_t *blob) {
     char filepath[MAX_PATH];
     FILE *fp;
     time_t now;
@@ -655,27 +865,44 @@ static void write_javascript_env(const char *tekton_root, env_list_t *env) {
     fprintf(fp, "// Single Port Architecture environment variables - from actual environment\n");
     
     /* Write port variables */
-    fprintf(fp, "window.HEPHAESTUS_PORT = %s;  // Hephaestus port\n", get_env_value(env, "HEPHAESTUS_PORT") ?: "8080");
-    fprintf(fp, "window.ENGRAM_PORT = %s;      // Engram port\n", get_env_value(env, "ENGRAM_PORT") ?: "8000");
-    fprintf(fp, "window.HERMES_PORT = %s;      // Hermes port\n", get_env_value(env, "HERMES_PORT") ?: "8001");
-    fprintf(fp, "window.ERGON_PORT = %s;       // Ergon port\n", get_env_value(env, "ERGON_PORT") ?: "8002");
-    fprintf(fp, "window.RHETOR_PORT = %s;      // Rhetor port\n", get_env_value(env, "RHETOR_PORT") ?: "8003");
-    fprintf(fp, "window.TERMA_PORT = %s;       // Terma port\n", get_env_value(env, "TERMA_PORT") ?: "8004");
-    fprintf(fp, "window.ATHENA_PORT = %s;      // Athena port\n", get_env_value(env, "ATHENA_PORT") ?: "8005");
-    fprintf(fp, "window.PROMETHEUS_PORT = %s;  // Prometheus port\n", get_env_value(env, "PROMETHEUS_PORT") ?: "8006");
-    fprintf(fp, "window.HARMONIA_PORT = %s;    // Harmonia port\n", get_env_value(env, "HARMONIA_PORT") ?: "8007");
-    fprintf(fp, "window.TELOS_PORT = %s;       // Telos port\n", get_env_value(env, "TELOS_PORT") ?: "8008");
-    fprintf(fp, "window.SYNTHESIS_PORT = %s;   // Synthesis port\n", get_env_value(env, "SYNTHESIS_PORT") ?: "8009");
-    fprintf(fp, "window.TEKTON_CORE_PORT = %s; // Tekton Core port\n", get_env_value(env, "TEKTON_CORE_PORT") ?: "8010");
-    fprintf(fp, "window.METIS_PORT = %s;       // Metis port\n", get_env_value(env, "METIS_PORT") ?: "8011");
-    fprintf(fp, "window.APOLLO_PORT = %s;      // Apollo port\n", get_env_value(env, "APOLLO_PORT") ?: "8012");
-    fprintf(fp, "window.BUDGET_PORT = %s;      // Budget port\n", get_env_value(env, "BUDGET_PORT") ?: "8013");
-    fprintf(fp, "window.PENIA_PORT = %s;       // Penia port (same as budget)\n", get_env_value(env, "PENIA_PORT") ?: "8013");
-    fprintf(fp, "window.SOPHIA_PORT = %s;      // Sophia port\n", get_env_value(env, "SOPHIA_PORT") ?: "8014");
-    fprintf(fp, "window.NOESIS_PORT = %s;      // Noesis port\n", get_env_value(env, "NOESIS_PORT") ?: "8015");
-    fprintf(fp, "window.NUMA_PORT = %s;        // Numa port\n", get_env_value(env, "NUMA_PORT") ?: "8016");
-    fprintf(fp, "window.AISH_PORT = %s;        // aish port\n", get_env_value(env, "AISH_PORT") ?: "8017");
-    fprintf(fp, "window.AISH_MCP_PORT = %s;    // aish MCP port\n\n", get_env_value(env, "AISH_MCP_PORT") ?: "8018");
+    fprintf(fp, "window.HEPHAESTUS_PORT = %s;  // Hephaestus port\n", port_value(env, blob, "HEPHAESTUS_PORT", "8080"));
+    fprintf(fp, "window.ENGRAM_PORT = %s;      // Engram port\n", port_value(env, blob, "ENGRAM_PORT", "8000"));
+    fprintf(fp, "window.HERMES_PORT = %s;      // Hermes port\n", port_value(env, blob, "HERMES_PORT", "8001"));
+    fprintf(fp, "window.ERGON_PORT = %s;       // Ergon port\n", port_value(env, blob, "ERGON_PORT", "8002"));
+    fprintf(fp, "window.RHETOR_PORT = %s;      // Rhetor port\n", port_value(env, blob, "RHETOR_PORT", "8003"));
+    fprintf(fp, "window.TERMA_PORT = %s;       // Terma port\n", port_value(env, blob, "TERMA_PORT", "8004"));
+    fprintf(fp, "window.ATHENA_PORT = %s;      // Athena port\n", port_value(env, blob, "ATHENA_PORT", "8005"));
+    fprintf(fp, "window.PROMETHEUS_PORT = %s;  // Prometheus port\n", port_value(env, blob, "PROMETHEUS_PORT", "8006"));
+    fprintf(fp, "window.HARMONIA_PORT = %s;    // Harmonia port\n", port_value(env, blob, "HARMONIA_PORT", "8007"));
+    fprintf(fp, "window.TELOS_PORT = %s;       // Telos port\n", port_value(env, blob, "TELOS_PORT", "8008"));
+    fprintf(fp, "window.SYNTHESIS_PORT = %s;   // Synthesis port\n", port_value(env, blob, "SYNTHESIS_PORT", "8009"));
+    fprintf(fp, "window.TEKTON_CORE_PORT = %s; // Tekton Core port\n", port_value(env, blob, "TEKTON_CORE_PORT", "8010"));
+    fprintf(fp, "window.METIS_PORT = %s;       // Metis port\n", port_value(env, blob, "METIS_PORT", "8011"));
+    fprintf(fp, "window.APOLLO_PORT = %s;      // Apollo port\n", port_value(env, blob, "APOLLO_PORT", "8012"));
+    fprintf(fp, "window.BUDGET_PORT = %s;      // Budget port\n", port_value(env, blob, "BUDGET_PORT", "8013"));
+    fprintf(fp, "window.PENIA_PORT = %s;       // Penia port (same as budget)\n", port_value(env, blob, "PENIA_PORT", "8013"));
+    fprintf(fp, "window.SOPHIA_PORT = %s;      // Sophia port\n", port_value(env, blob, "SOPHIA_PORT", "8014"));
+    fprintf(fp, "window.NOESIS_PORT = %s;      // Noesis port\n", port_value(env, blob, "NOESIS_PORT", "8015"));
+    fprintf(fp, "window.NUMA_PORT = %s;        // Numa port\n", port_value(env, blob, "NUMA_PORT", "8016"));
+    fprintf(fp, "window.AISH_PORT = %s;        // aish port\n", port_value(env, blob, "AISH_PORT", "8017"));
+    fprintf(fp, "window.AISH_MCP_PORT = %s;    // aish MCP port\n\n", port_value(env, blob, "AISH_MCP_PORT", "8018"));
+    
+    /* Write the compiled component table: ports, CI ports and dependencies in declared order */
+    fprintf(fp, "// Components from the compiled config (.tekton/component_config.bin)\n");
+    fprintf(fp, "window.TEKTON_COMPONENTS = {\n");
+    for (uint32_t i = 0; i < blob->count; i++) {
+        uint32_t end = blob_u32(blob->deps, i + 1);
+        fprintf(fp, "    ");
+        print_json_string(fp, blob->names + (size_t)i * COMPONENT_NAME_SIZE);
+        fprintf(fp, ": { port: %u, aiPort: %u, dependencies: [",
+                blob_u32(blob->ports, i), blob_u32(blob->ai_ports, i));
+        for (uint32_t d = blob_u32(blob->deps, i); d < end; d++) {
+            if (d > blob_u32(blob->deps, i)) fprintf(fp, ", ");
+            print_json_string(fp, blob_string(blob, blob_u32(blob->dep_names, d)));
+        }
+        fprintf(fp, "] },\n");
+    }
+    fprintf(fp, "};\n\n");
     
     /* Write port base configuration */
     fprintf(fp, "// Port base configuration for CI port calculation\n");
@@ -734,6 +961,529 @@ static void write_javascript_env(const char *tekton_root, env_list_t *env) {
     }
 }
 
+static int blocks_overlap(uint32_t a, uint32_t b) {
+    return (a > b ? a - b : b - a) < PORT_BLOCK_SIZE;
+}
+
+static int lease_conflicts(port_table_t *table, int self, uint32_t port_base, uint32_t ai_port_base) {
+    for (int i = 0; i < PORT_BLOCK_SLOTS; i++) {
+        port_lease_t *lease = &table->slots[i];
+        if (i == self || !lease->in_use) continue;
+        if (blocks_overlap(lease->port_base, port_base) ||
+            blocks_overlap(lease->ai_port_base, ai_port_base) ||
+            blocks_overlap(lease->port_base, ai_port_base) ||
+            blocks_overlap(lease->ai_port_base, port_base)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void remap_block_ports(env_list_t *env, uint32_t from_base, uint32_t to_base,
+                              uint32_t from_ai, uint32_t to_ai) {
+    char key[256];
+    char value[32];
+    
+    for (int i = 0; i < env->count; i++) {
+        char *eq = strchr(env->vars[i], '=');
+        size_t key_len;
+        char *end;
+        long port;
+        
+        if (!eq) continue;
+        key_len = eq - env->vars[i];
+        if (key_len < 5 || key_len >= sizeof(key) || strncmp(eq - 5, "_PORT", 5) != 0) continue;
+        
+        port = strtol(eq + 1, &end, 10);
+        if (end == eq + 1 || *end != '\0' || port <= 0) continue;
+        
+        if (port >= from_ai && port < from_ai + PORT_BLOCK_SIZE) {
+            snprintf(value, sizeof(value), "%ld", to_ai + (port - from_ai));
+        } else if (port >= from_base && port < from_base + PORT_BLOCK_SIZE) {
+            snprintf(value, sizeof(value), "%ld", to_base + (port - from_base));
+        } else {
+            continue;
+        }
+        
+        /* add_env_var replaces (and frees) this entry, so copy the key first */
+        memcpy(key, env->vars[i], key_len);
+        key[key_len] = '\0';
+        add_env_var(env, key, value);
+    }
+}
+
+static int port_in_use(uint32_t port) {
+    struct sockaddr_in addr;
+    int fd, in_use;
+    
+    if (port == 0 || port > 65535) return 0;
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return 0;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    in_use = bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 && errno == EADDRINUSE;
+    close(fd);
+    return in_use;
+}
+
+/* An installation is alive while its last start runs or anything listens in its blocks */
+static int lease_alive(port_lease_t *lease) {
+    if (lease->pid > 0 && (kill(lease->pid, 0) == 0 || errno == EPERM)) return 1;
+    for (uint32_t i = 0; i < PORT_BLOCK_SIZE; i++) {
+        if (port_in_use(lease->port_base + i) || port_in_use(lease->ai_port_base + i)) return 1;
+    }
+    return 0;
+}
+
+/* First free block, preferring the configured one; 0 if every block is leased */
+static uint32_t free_port_block(port_table_t *table, uint32_t cfg_base, uint32_t cfg_ai_base,
+                                uint32_t *ai_port_base) {
+    if (!lease_conflicts(table, -1, cfg_base, cfg_ai_base)) {
+        *ai_port_base = cfg_ai_base;
+        return cfg_base;
+    }
+    for (int k = 0; k < PORT_BLOCK_SLOTS &&
+                    AI_PORT_BLOCK_START - k * AI_PORT_BLOCK_STEP >= AI_PORT_BLOCK_FLOOR; k++) {
+        uint32_t candidate = PORT_BLOCK_START + k * PORT_BLOCK_SIZE;
+        uint32_t ai_candidate = AI_PORT_BLOCK_START - k * AI_PORT_BLOCK_STEP;
+        if (!lease_conflicts(table, -1, candidate, ai_candidate)) {
+            *ai_port_base = ai_candidate;
+            return candidate;
+        }
+    }
+    return 0;
+}
+
+static void apply_port_block(env_list_t *env, uint32_t cfg_base, uint32_t cfg_ai_base,
+                             uint32_t port_base, uint32_t ai_port_base, int announce) {
+    char value[32];
+    
+    if (port_base == cfg_base && ai_port_base == cfg_ai_base) return;
+    if (announce || getenv("TEKTON_DEBUG")) {
+        fprintf(stderr, "Note: port block %u/%u is leased by another installation; using %u/%u\n",
+                cfg_base, cfg_ai_base, port_base, ai_port_base);
+    }
+    remap_block_ports(env, cfg_base, port_base, cfg_ai_base, ai_port_base);
+    snprintf(value, sizeof(value), "%u", port_base);
+    add_env_var(env, "TEKTON_PORT_BASE", value);
+    snprintf(value, sizeof(value), "%u", ai_port_base);
+    add_env_var(env, "TEKTON_AI_PORT_BASE", value);
+}
+
+/*
+ * Only `tekton start` (acquire) takes, refreshes or re-validates a lease.
+ * Every other subcommand follows the existing lease under a shared lock
+ * and writes nothing; a lease granted for another configured block is
+ * ignored until the next start replaces it.
+ */
+static void allocate_port_block(const char *tekton_root, env_list_t *env, int acquire) {
+    char path[MAX_PATH];
+    char *home = getenv("HOME");
+    char *allocator = get_env_value(env, "TEKTON_PORT_ALLOCATOR");
+    char *base_str = get_env_value(env, "TEKTON_PORT_BASE");
+    char *ai_base_str = get_env_value(env, "TEKTON_AI_PORT_BASE");
+    port_table_t *table;
+    uint32_t port_base, ai_port_base;
+    time_t now = time(NULL);
+    int self = -1;
+    int newly_leased = 0;
+    int fd;
+    
+    if (!home || (allocator && strcmp(allocator, "0") == 0)) return;
+    /* Only installations with a configured block take part */
+    if (!base_str || !ai_base_str) return;
+    uint32_t cfg_base = (uint32_t)strtoul(base_str, NULL, 10);
+    uint32_t cfg_ai_base = (uint32_t)strtoul(ai_base_str, NULL, 10);
+    if (!cfg_base || !cfg_ai_base) return;
+    if (strlen(tekton_root) >= PORT_LEASE_ROOT_MAX) return;
+    
+    if (acquire) {
+        snprintf(path, sizeof(path), "%s/.till", home);
+        mkdir(path, 0755);
+        snprintf(path, sizeof(path), "%s/.till/tekton", home);
+        mkdir(path, 0755);
+    }
+    snprintf(path, sizeof(path), "%s/%s", home, PORT_BLOCK_FILE);
+    
+    fd = acquire ? open(path, O_RDWR | O_CREAT, 0644) : open(path, O_RDONLY);
+    if (fd < 0) {
+        if (acquire && getenv("TEKTON_DEBUG")) {
+            fprintf(stderr, "DEBUG: Port allocator unavailable (%s): %s\n", path, strerror(errno));
+        }
+        return;
+    }
+    
+    if (!acquire) {
+        struct stat st;
+        if (flock(fd, LOCK_SH) != 0 || fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(port_table_t)) {
+            close(fd);
+            return;
+        }
+        table = mmap(NULL, sizeof(port_table_t), PROT_READ, MAP_SHARED, fd, 0);
+        if (table == MAP_FAILED) {
+            flock(fd, LOCK_UN);
+            close(fd);
+            return;
+        }
+        port_base = cfg_base;
+        ai_port_base = cfg_ai_base;
+        if (memcmp(table->magic, PORT_BLOCK_MAGIC, 4) == 0 && table->version == PORT_BLOCK_VERSION) {
+            for (int i = 0; i < PORT_BLOCK_SLOTS; i++) {
+                port_lease_t *lease = &table->slots[i];
+                if (lease->in_use && strncmp(lease->root, tekton_root, PORT_LEASE_ROOT_MAX) == 0 &&
+                    lease->cfg_port_base == cfg_base && lease->cfg_ai_port_base == cfg_ai_base) {
+                    port_base = lease->port_base;
+                    ai_port_base = lease->ai_port_base;
+                    break;
+                }
+            }
+        }
+        munmap(table, sizeof(port_table_t));
+        flock(fd, LOCK_UN);
+        close(fd);
+        apply_port_block(env, cfg_base, cfg_ai_base, port_base, ai_port_base, 0);
+        return;
+    }
+    
+    /* Serializes allocation across concurrent launches on this host */
+    if (flock(fd, LOCK_EX) != 0 || ftruncate(fd, sizeof(port_table_t)) != 0) {
+        close(fd);
+        return;
+    }
+    
+    table = mmap(NULL, sizeof(port_table_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (table == MAP_FAILED) {
+        flock(fd, LOCK_UN);
+        close(fd);
+        return;
+    }
+    
+    if (memcmp(table->magic, PORT_BLOCK_MAGIC, 4) != 0 || table->version != PORT_BLOCK_VERSION) {
+        memset(table, 0, sizeof(port_table_t));
+        memcpy(table->magic, PORT_BLOCK_MAGIC, 4);
+        table->version = PORT_BLOCK_VERSION;
+        table->slot_count = PORT_BLOCK_SLOTS;
+        table->block_size = PORT_BLOCK_SIZE;
+    }
+    
+    /* Reclaim leases of installations that were removed */
+    for (int i = 0; i < PORT_BLOCK_SLOTS; i++) {
+        port_lease_t *lease = &table->slots[i];
+        if (!lease->in_use) continue;
+        if (strncmp(lease->root, tekton_root, PORT_LEASE_ROOT_MAX) == 0) {
+            self = i;
+            continue;
+        }
+        if (!is_tekton_directory(lease->root)) {
+            if (getenv("TEKTON_DEBUG")) {
+                fprintf(stderr, "DEBUG: Reclaiming port block %u for %s\n", lease->port_base, lease->root);
+            }
+            memset(lease, 0, sizeof(*lease));
+        }
+    }
+    
+    /* The configured blocks changed since the lease was granted: lease again */
+    if (self >= 0 && (table->slots[self].cfg_port_base != cfg_base ||
+                      table->slots[self].cfg_ai_port_base != cfg_ai_base)) {
+        if (getenv("TEKTON_DEBUG")) {
+            fprintf(stderr, "DEBUG: Port block %u/%u was configured as %u/%u; leasing again\n",
+                    table->slots[self].cfg_port_base, table->slots[self].cfg_ai_port_base,
+                    cfg_base, cfg_ai_base);
+        }
+        memset(&table->slots[self], 0, sizeof(table->slots[self]));
+        self = -1;
+    }
+    
+    while (self < 0) {
+        /* First launch: prefer the configured block, else the first free one */
+        int victim = -1;
+        port_base = free_port_block(table, cfg_base, cfg_ai_base, &ai_port_base);
+        for (int i = 0; i < PORT_BLOCK_SLOTS && port_base; i++) {
+            if (!table->slots[i].in_use) {
+                self = i;
+                break;
+            }
+        }
+        if (self >= 0) {
+            port_lease_t *lease = &table->slots[self];
+            lease->in_use = 1;
+            lease->port_base = port_base;
+            lease->ai_port_base = ai_port_base;
+            lease->cfg_port_base = cfg_base;
+            lease->cfg_ai_port_base = cfg_ai_base;
+            strncpy(lease->root, tekton_root, PORT_LEASE_ROOT_MAX - 1);
+            newly_leased = 1;
+            break;
+        }
+        
+        /* Full: take over the least recently started installation that isn't running */
+        for (int i = 0; i < PORT_BLOCK_SLOTS; i++) {
+            port_lease_t *lease = &table->slots[i];
+            if (lease->in_use && (victim < 0 || lease->last_used < table->slots[victim].last_used) &&
+                !lease_alive(lease)) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            fprintf(stderr, "Warning: No free port block on this host; using configured ports\n");
+            break;
+        }
+        if (getenv("TEKTON_DEBUG")) {
+            fprintf(stderr, "DEBUG: Reclaiming port block %u of stopped installation %s\n",
+                    table->slots[victim].port_base, table->slots[victim].root);
+        }
+        memset(&table->slots[victim], 0, sizeof(table->slots[victim]));
+    }
+    
+    if (self >= 0) {
+        port_lease_t *lease = &table->slots[self];
+        lease->last_used = now;
+        lease->pid = (int32_t)getpid();
+        port_base = lease->port_base;
+        ai_port_base = lease->ai_port_base;
+    } else {
+        port_base = cfg_base;
+        ai_port_base = cfg_ai_base;
+    }
+    
+    msync(table, sizeof(port_table_t), MS_SYNC);
+    munmap(table, sizeof(port_table_t));
+    flock(fd, LOCK_UN);
+    close(fd);
+    
+    apply_port_block(env, cfg_base, cfg_ai_base, port_base, ai_port_base, newly_leased);
+}
+
+static int open_component_blob(const char *tekton_root, env_list_t *env, component_blob_t *blob) {
+    char path[MAX_PATH];
+    char yaml_path[MAX_PATH];
+    struct stat st, yaml_st;
+    const unsigned char *base;
+    uint16_t version, header_size;
+    uint32_t count, port_base, ai_port_base, dep_count;
+    uint64_t yaml_size, digest;
+    double yaml_mtime;
+    size_t deps_at, strings_at;
+    char *cfg_base = get_env_value(env, "TEKTON_PORT_BASE");
+    char *cfg_ai_base = get_env_value(env, "TEKTON_AI_PORT_BASE");
+    int fd;
+    
+    memset(blob, 0, sizeof(*blob));
+    snprintf(path, sizeof(path), "%s/%s", tekton_root, COMPONENT_BLOB_FILE);
+    
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;  /* Not compiled yet - callers use literal defaults */
+    
+    if (fstat(fd, &st) != 0 || st.st_size < COMPONENT_BLOB_HEADER_MIN) {
+        close(fd);
+        return 0;
+    }
+    
+    blob->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (blob->map == MAP_FAILED) {
+        blob->map = NULL;
+        return 0;
+    }
+    blob->size = st.st_size;
+    base = blob->map;
+    
+    /* Header fields are packed little-endian; copy out to avoid unaligned reads */
+    memcpy(&version, base + 4, sizeof(version));
+    memcpy(&header_size, base + 6, sizeof(header_size));
+    count = blob_u32(base + 8, 0);
+    port_base = blob_u32(base + 12, 0);
+    ai_port_base = blob_u32(base + 16, 0);
+    memcpy(&yaml_mtime, base + 20, sizeof(yaml_mtime));
+    memcpy(&yaml_size, base + 28, sizeof(yaml_size));
+    memcpy(&digest, base + 36, sizeof(digest));
+    
+    /* names, ports, ai_ports, priorities, then count + 1 dependency starts */
+    deps_at = (size_t)header_size + (size_t)count * (COMPONENT_NAME_SIZE + 12);
+    if (memcmp(base, COMPONENT_BLOB_MAGIC, 4) != 0 || version != COMPONENT_BLOB_VERSION ||
+        header_size < COMPONENT_BLOB_HEADER_MIN || count > blob->size ||
+        deps_at + ((size_t)count + 1) * 4 > blob->size) {
+        goto invalid;
+    }
+    blob->deps = base + deps_at;
+    dep_count = blob_u32(blob->deps, count);
+    strings_at = deps_at + ((size_t)count + 1) * 4 + (size_t)dep_count * 4 + (size_t)count * 16;
+    if (dep_count > blob->size || strings_at > blob->size) goto invalid;
+    for (uint32_t i = 0; i < count; i++) {
+        if (blob_u32(blob->deps, i) > blob_u32(blob->deps, i + 1)) goto invalid;
+    }
+    
+    /* Compiled for another port block (reconfigured or moved by the lease): stale */
+    if ((cfg_base && strtoul(cfg_base, NULL, 10) != port_base) ||
+        (cfg_ai_base && strtoul(cfg_ai_base, NULL, 10) != ai_port_base)) {
+        if (getenv("TEKTON_DEBUG")) {
+            fprintf(stderr, "DEBUG: Ignoring component blob %s compiled for port block %u/%u\n",
+                    path, port_base, ai_port_base);
+        }
+        close_component_blob(blob);
+        return 0;
+    }
+    
+    /* The same staleness checks as load_component_blob() in component_blob.py.
+     * st_mtime there is sec + nsec * 1e-9 as a double, so compare it exactly. */
+    snprintf(yaml_path, sizeof(yaml_path), "%s/%s", tekton_root, COMPONENT_BLOB_YAML);
+    if (stat(yaml_path, &yaml_st) != 0 ||
+        (double)yaml_st.st_mtim.tv_sec + (double)yaml_st.st_mtim.tv_nsec * 1e-9 != yaml_mtime ||
+        (uint64_t)yaml_st.st_size != yaml_size ||
+        blob_port_env_digest(env, (const char *)base + header_size, count) != digest) {
+        if (getenv("TEKTON_DEBUG")) {
+            fprintf(stderr, "DEBUG: Ignoring component blob %s: stale for %s or the port environment\n",
+                    path, yaml_path);
+        }
+        close_component_blob(blob);
+        return 0;
+    }
+    
+    blob->count = count;
+    blob->names = (const char *)base + header_size;
+    blob->ports = base + header_size + (size_t)count * COMPONENT_NAME_SIZE;
+    blob->ai_ports = blob->ports + (size_t)count * 4;
+    blob->dep_names = blob->deps + ((size_t)count + 1) * 4;
+    blob->strings = (const char *)base + strings_at;
+    blob->strings_size = blob->size - strings_at;
+    
+    if (getenv("TEKTON_DEBUG")) {
+        fprintf(stderr, "DEBUG: Mapped %u components from %s\n", count, path);
+    }
+    return 1;
+    
+invalid:
+    if (getenv("TEKTON_DEBUG")) {
+        fprintf(stderr, "DEBUG: Ignoring invalid component blob %s\n", path);
+    }
+    close_component_blob(blob);
+    return 0;
+}
+
+static void close_component_blob(component_blob_t *blob) {
+    if (blob->map) {
+        munmap(blob->map, blob->size);
+    }
+    memset(blob, 0, sizeof(*blob));
+}
+
+static uint32_t blob_u32(const unsigned char *p, uint32_t i) {
+    p += (size_t)i * 4;
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* A NUL-terminated string from the string table, or "" if the offset is out of bounds */
+static const char* blob_string(component_blob_t *blob, uint32_t offset) {
+    if (offset >= blob->strings_size ||
+        !memchr(blob->strings + offset, '\0', blob->strings_size - offset)) {
+        return "";
+    }
+    return blob->strings + offset;
+}
+
+static int blob_component_port(component_blob_t *blob, const char *component_id) {
+    for (uint32_t i = 0; i < blob->count; i++) {
+        const char *name = blob->names + (size_t)i * COMPONENT_NAME_SIZE;
+        if (strncmp(name, component_id, COMPONENT_NAME_SIZE) == 0) {
+            return (int)blob_u32(blob->ports, i);
+        }
+    }
+    return -1;
+}
+
+/* hermes -> HERMES_PORT, for every compiled component the environment lacks */
+static void export_blob_ports(env_list_t *env, component_blob_t *blob) {
+    char key[COMPONENT_NAME_SIZE + 5];
+    char value[16];
+    char *exported = NULL;
+    size_t exported_len = 0;
+    
+    for (uint32_t i = 0; i < blob->count; i++) {
+        const char *name = blob->names + (size_t)i * COMPONENT_NAME_SIZE;
+        size_t len = strnlen(name, COMPONENT_NAME_SIZE);
+        
+        if (len == 0 || len >= COMPONENT_NAME_SIZE) continue;
+        for (size_t j = 0; j < len; j++) {
+            key[j] = toupper((unsigned char)name[j]);
+        }
+        memcpy(key + len, "_PORT", 6);
+        if (get_env_value(env, key)) continue;
+        
+        snprintf(value, sizeof(value), "%u", blob_u32(blob->ports, i));
+        add_env_var(env, key, value);
+        
+        exported = realloc(exported, exported_len + len + 7);
+        exported_len += sprintf(exported + exported_len, "%s%s", exported_len ? "," : "", key);
+    }
+    if (exported) {
+        add_env_var(env, COMPONENT_BLOB_PORTS_VAR, exported);
+        free(exported);
+    }
+}
+
+/*
+ * FNV-1a 64 over "KEY=value\n" for the port bases and every component's
+ * *_PORT, as port_env_digest() in component_blob.py computes it. Called
+ * before export_blob_ports(), so it sees only configured ports.
+ */
+static uint64_t blob_port_env_digest(env_list_t *env, const char *names, uint32_t count) {
+    const char *bases[] = {"TEKTON_PORT_BASE", "TEKTON_AI_PORT_BASE"};
+    char key[COMPONENT_NAME_SIZE + 5];
+    uint64_t h = 0xcbf29ce484222325ULL;
+    
+    for (uint32_t i = 0; i < count + 2; i++) {
+        const char *value;
+        const unsigned char *p;
+        
+        if (i < 2) {
+            snprintf(key, sizeof(key), "%s", bases[i]);
+        } else {
+            const char *name = names + (size_t)(i - 2) * COMPONENT_NAME_SIZE;
+            size_t len = strnlen(name, COMPONENT_NAME_SIZE);
+            for (size_t j = 0; j < len; j++) {
+                key[j] = toupper((unsigned char)name[j]);
+            }
+            memcpy(key + len, "_PORT", 6);
+        }
+        value = get_env_value(env, key);
+        for (p = (const unsigned char *)key; *p; p++) h = (h ^ *p) * 0x100000001b3ULL;
+        h = (h ^ '=') * 0x100000001b3ULL;
+        for (p = (const unsigned char *)(value ? value : ""); *p; p++) h = (h ^ *p) * 0x100000001b3ULL;
+        h = (h ^ '\n') * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static const char* port_value(env_list_t *env, component_blob_t *blob, const char *key, const char *fallback) {
+    /* Small ring so several results can be live at once */
+    static char buffers[4][16];
+    static int next = 0;
+    char component_id[COMPONENT_NAME_SIZE];
+    size_t len;
+    int port;
+    
+    char *value = get_env_value(env, key);
+    if (value) return value;
+    
+    /* HERMES_PORT -> hermes, TEKTON_CORE_PORT -> tekton_core */
+    len = strlen(key);
+    if (len <= 5 || len - 5 >= sizeof(component_id)) return fallback;
+    for (size_t i = 0; i < len - 5; i++) {
+        component_id[i] = tolower((unsigned char)key[i]);
+    }
+    component_id[len - 5] = '\0';
+    
+    port = blob_component_port(blob, component_id);
+    if (port <= 0) return fallback;
+    
+    char *buf = buffers[next];
+    next = (next + 1) % 4;
+    snprintf(buf, sizeof(buffers[0]), "%d", port);
+    return buf;
+}
+
 static void execute_till(char **args) {
     char till_path[MAX_PATH];
     char *home = getenv("HOME");
@@ -766,9 +1516,112 @@ static void execute_till(char **args) {
     exec_args[i] = NULL;
     
     /* Execute till */
+    TEKTON_PROBE2(exec, till_path, i - 1);
     execv(till_path, exec_args);
     
     /* If we get here, exec failed */
     perror("execv");
     exit(1);
 }
+
+/* tekton exec [--] cmd args...: the environment is already applied, so just exec */
+static void execute_command(char **args) {
+    if (args && *args && strcmp(*args, "--") == 0) {
+        args++;
+    }
+    if (!args || !*args) {
+        fprintf(stderr, "Usage: tekton exec -- <command> [args...]\n");
+        exit(2);
+    }
+
+    TEKTON_PROBE2(exec, args[0], 0);
+    execvp(args[0], args);
+
+    fprintf(stderr, "tekton exec: %s: %s\n", args[0], strerror(errno));
+    exit(errno == ENOENT ? 127 : 126);
+}
+
+static void print_sh_quoted(const char *value) {
+    putchar('\'');
+    for (const char *p = value; *p; p++) {
+        if (*p == '\'') {
+            fputs("'\\''", stdout);
+        } else {
+            putchar(*p);
+        }
+    }
+    putchar('\'');
+}
+
+static void print_json_string(FILE *fp, const char *value) {
+    fputc('"', fp);
+    for (const unsigned char *p = (const unsigned char *)value; *p; p++) {
+        switch (*p) {
+            case '"':  fputs("\\\"", fp); break;
+            case '\\': fputs("\\\\", fp); break;
+            case '\n': fputs("\\n", fp); break;
+            case '\r': fputs("\\r", fp); break;
+            case '\t': fputs("\\t", fp); break;
+            default:
+                if (*p < 0x20) {
+                    fprintf(fp, "\\u%04x", *p);
+                } else {
+                    fputc(*p, fp);
+                }
+        }
+    }
+    fputc('"', fp);
+}
+
+/*
+ * tekton env [--export] [--format sh|json]
+ *
+ * Prints what the env files and the port lease contribute (not the
+ * inherited environment), so a shell or CI job can load it once:
+ * KEY=value lines by default, export statements with --export, or a
+ * JSON object.
+ */
+static int print_environment(env_list_t *env, char **args) {
+    int export = 0;
+    const char *format = "sh";
+
+    for (; args && *args; args++) {
+        if (strcmp(*args, "--export") == 0) {
+            export = 1;
+        } else if (strcmp(*args, "--format") == 0 && args[1]) {
+            format = *++args;
+        } else if (strncmp(*args, "--format=", 9) == 0) {
+            format = *args + 9;
+        } else {
+            fprintf(stderr, "Usage: tekton env [--export] [--format sh|json]\n");
+            return 2;
+        }
+    }
+    if (strcmp(format, "sh") != 0 && strcmp(format, "json") != 0) {
+        fprintf(stderr, "tekton env: unknown format '%s' (sh or json)\n", format);
+        return 2;
+    }
+
+    int json = strcmp(format, "json") == 0;
+    int first = 1;
+    if (json) putchar('{');
+    for (int i = 0; i < env->count; i++) {
+        char *eq = strchr(env->vars[i], '=');
+        if (!eq || !env->from_tekton[i]) continue;
+        *eq = '\0';
+        if (json) {
+            fputs(first ? "\n  " : ",\n  ", stdout);
+            print_json_string(stdout, env->vars[i]);
+            fputs(": ", stdout);
+            print_json_string(stdout, eq + 1);
+        } else {
+            printf("%s%s=", export ? "export " : "", env->vars[i]);
+            print_sh_quoted(eq + 1);
+            putchar('\n');
+        }
+        *eq = '=';
+        first = 0;
+    }
+    if (json) fputs(first ? "}\n" : "\n}\n", stdout);
+    return fflush(stdout) == 0 ? 0 : 1;
+}
@@ -0,0 +1,334 @@
+/*
+ * tekton-stub.c - Stand-in component for launcher benchmarks
+ *
+ * Answers what the launcher, status and killer talk to on a real
+ * component (GET /health, /ready, POST /shutdown on the HTTP port and the
+ * newline-delimited JSON {"type": "info"} request on the CI port) with
+ * none of the Python startup cost, so scripts/tekton_launch_benchmark.py
+ * can start hundreds of them and time only the tooling.
+ *
+ * Startup delay, resident memory and log output rate are configurable to
+ * approximate heavier components.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define MAX_CLIENTS 64
+#define REQUEST_MAX 4096
+#define RESPONSE_MAX 1024
+
+typedef struct {
+    int fd;
+    int is_ci;          /* CI protocol connection rather than HTTP */
+    size_t len;
+    char buf[REQUEST_MAX];
+} client_t;
+
+static const char *name = "stub";
+static int port = 0;
+static int ai_port = 0;
+static volatile sig_atomic_t stop_requested = 0;
+static unsigned long log_seq = 0;
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s --port PORT [--ai-port PORT] [--name NAME]\n"
+            "          [--startup-delay MS] [--memory MB] [--log-rate LINES_PER_SEC]\n",
+            prog);
+    exit(2);
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Log lines in the launcher's "YYYY-mm-dd HH:MM:SS,mmm" format */
+static void log_line(const char *level, const char *message) {
+    struct timeval tv;
+    struct tm tm;
+    char stamp[32];
+
+    gettimeofday(&tv, NULL);
+    localtime_r(&tv.tv_sec, &tm);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+    printf("%s,%03d - %s - %s - %s\n", stamp, (int)(tv.tv_usec / 1000), name, level, message);
+}
+
+static int listen_on(int listen_port) {
+    struct sockaddr_in addr;
+    int one = 1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        perror("socket");
+        exit(1);
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(listen_port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "%s: bind port %d: %s\n", name, listen_port, strerror(errno));
+        exit(1);
+    }
+    if (listen(fd, 128) < 0) {
+        perror("listen");
+        exit(1);
+    }
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+}
+
+static void send_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+static void http_reply(int fd, int status, const char *reason, const char *body) {
+    char response[RESPONSE_MAX];
+    int len = snprintf(response, sizeof(response),
+                       "HTTP/1.1 %d %s\r\n"
+                       "Content-Type: application/json\r\n"
+                       "Content-Length: %zu\r\n"
+                       "Connection: close\r\n\r\n%s",
+                       status, reason, strlen(body), body);
+    send_all(fd, response, len);
+}
+
+/* Returns 1 once the request is complete and answered */
+static int handle_http(client_t *c) {
+    char body[RESPONSE_MAX / 2];
+    char method[8], path[256];
+
+    c->buf[c->len] = '\0';
+    if (!strstr(c->buf, "\r\n\r\n")) {
+        if (c->len >= REQUEST_MAX - 1) {
+            http_reply(c->fd, 431, "Request Header Fields Too Large", "{}");
+            return 1;
+        }
+        return 0;
+    }
+    if (sscanf(c->buf, "%7s %255s", method, path) != 2) {
+        http_reply(c->fd, 400, "Bad Request", "{}");
+        return 1;
+    }
+    char *query = strchr(path, '?');
+    if (query) *query = '\0';
+
+    if (strcmp(path, "/health") == 0 || strcmp(path, "/api/health") == 0) {
+        snprintf(body, sizeof(body),
+                 "{\"status\": \"healthy\", \"component\": \"%s\", \"version\": \"stub\", \"port\": %d}",
+                 name, port);
+        http_reply(c->fd, 200, "OK", body);
+    } else if (strcmp(path, "/ready") == 0) {
+        snprintf(body, sizeof(body),
+                 "{\"ready\": true, \"component\": \"%s\", \"initialization_status\": \"ready\"}",
+                 name);
+        http_reply(c->fd, 200, "OK", body);
+    } else if (strcmp(path, "/shutdown") == 0 || strcmp(path, "/api/shutdown") == 0) {
+        http_reply(c->fd, 200, "OK", "{\"status\": \"shutting down\"}");
+        stop_requested = 1;
+    } else {
+        http_reply(c->fd, 404, "Not Found", "{\"detail\": \"Not Found\"}");
+    }
+    return 1;
+}
+
+/* CI socket protocol: one JSON request per line, one JSON reply per line */
+static int handle_ci(client_t *c) {
+    char reply[RESPONSE_MAX / 2];
+    char *newline;
+
+    c->buf[c->len] = '\0';
+    while ((newline = strchr(c->buf, '\n')) != NULL) {
+        *newline = '\0';
+        if (strstr(c->buf, "\"info\"")) {
+            snprintf(reply, sizeof(reply),
+                     "{\"type\": \"info\", \"ai_id\": \"%s-ci\", \"model_name\": \"stub\", \"status\": \"ready\"}\n",
+                     name);
+        } else {
+            snprintf(reply, sizeof(reply), "{\"type\": \"error\", \"error\": \"unsupported request\"}\n");
+        }
+        send_all(c->fd, reply, strlen(reply));
+        size_t consumed = newline + 1 - c->buf;
+        memmove(c->buf, newline + 1, c->len - consumed + 1);
+        c->len -= consumed;
+    }
+    /* An overlong line is dropped rather than buffered */
+    return c->len >= REQUEST_MAX - 1;
+}
+
+static void accept_clients(int listen_fd, int is_ci, client_t *clients) {
+    for (;;) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) return;
+        int slot = -1;
+        for (int i = 0; i < MAX_CLIENTS; i++) {
+            if (clients[i].fd < 0) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0) {
+            close(fd);
+            continue;
+        }
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        clients[slot].fd = fd;
+        clients[slot].is_ci = is_ci;
+        clients[slot].len = 0;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long startup_delay_ms = 0;
+    long memory_mb = 0;
+    double log_rate = 0;
+    client_t clients[MAX_CLIENTS];
+    struct pollfd fds[2 + MAX_CLIENTS];
+    int slot_of[2 + MAX_CLIENTS];
+    char message[128];
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        if (strcmp(argv[i], "--port") == 0) port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ai-port") == 0) ai_port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--name") == 0) name = argv[++i];
+        else if (strcmp(argv[i], "--startup-delay") == 0) startup_delay_ms = atol(argv[++i]);
+        else if (strcmp(argv[i], "--memory") == 0) memory_mb = atol(argv[++i]);
+        else if (strcmp(argv[i], "--log-rate") == 0) log_rate = atof(argv[++i]);
+        else usage(argv[0]);
+    }
+    if (port <= 0) usage(argv[0]);
+
+    /* Output goes to the launcher's log pipe; keep whole lines together */
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    signal(SIGTERM, on_signal);
+    signal(SIGINT, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    log_line("INFO", "Starting");
+
+    /* Stand-in for import and initialization time */
+    if (startup_delay_ms > 0) {
+        struct timespec delay = { startup_delay_ms / 1000, (startup_delay_ms % 1000) * 1000000L };
+        while (nanosleep(&delay, &delay) < 0 && errno == EINTR && !stop_requested) {}
+    }
+
+    /* Touch every page so the footprint is resident, not just reserved */
+    if (memory_mb > 0) {
+        size_t size = (size_t)memory_mb << 20;
+        char *ballast = malloc(size);
+        if (!ballast) {
+            fprintf(stderr, "%s: could not allocate %ld MB\n", name, memory_mb);
+            return 1;
+        }
+        for (size_t off = 0; off < size; off += 4096) ballast[off] = 1;
+    }
+
+    int http_fd = listen_on(port);
+    int ci_fd = ai_port > 0 ? listen_on(ai_port) : -1;
+    snprintf(message, sizeof(message), "Serving on port %d (CI port %d)", port, ai_port);
+    log_line("INFO", message);
+
+    for (int i = 0; i < MAX_CLIENTS; i++) clients[i].fd = -1;
+
+    double log_interval = log_rate > 0 ? 1.0 / log_rate : 0;
+    double next_log = now_seconds() + log_interval;
+
+    while (!stop_requested) {
+        int nfds = 0;
+        fds[nfds].fd = http_fd;
+        fds[nfds++].events = POLLIN;
+        if (ci_fd >= 0) {
+            fds[nfds].fd = ci_fd;
+            fds[nfds++].events = POLLIN;
+        }
+        int listeners = nfds;
+        for (int i = 0; i < MAX_CLIENTS; i++) {
+            if (clients[i].fd >= 0) {
+                fds[nfds].fd = clients[i].fd;
+                fds[nfds].events = POLLIN;
+                slot_of[nfds++] = i;
+            }
+        }
+
+        int timeout = -1;
+        if (log_interval > 0) {
+            double wait = next_log - now_seconds();
+            timeout = wait > 0 ? (int)(wait * 1000) : 0;
+        }
+        if (poll(fds, nfds, timeout) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        if (log_interval > 0) {
+            double now = now_seconds();
+            while (next_log <= now) {
+                snprintf(message, sizeof(message), "tick %lu", ++log_seq);
+                log_line("INFO", message);
+                next_log += log_interval;
+            }
+        }
+
+        for (int i = 0; i < listeners; i++) {
+            if (fds[i].revents & POLLIN) {
+                accept_clients(fds[i].fd, fds[i].fd == ci_fd, clients);
+            }
+        }
+        for (int i = listeners; i < nfds; i++) {
+            if (!fds[i].revents) continue;
+            client_t *c = &clients[slot_of[i]];
+            ssize_t n = read(c->fd, c->buf + c->len, REQUEST_MAX - 1 - c->len);
+            int done;
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+                done = 1;
+            } else {
+                c->len += n;
+                done = c->is_ci ? handle_ci(c) : handle_http(c);
+            }
+            if (done) {
+                close(c->fd);
+                c->fd = -1;
+            }
+        }
+    }
+
+    log_line("INFO", "Shutting down");
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) close(clients[i].fd);
+    }
+    close(http_fd);
+    if (ci_fd >= 0) close(ci_fd);
+    return 0;
+}
@@ -0,0 +1,523 @@
+/*
+ * tekton-ws.c - RFC 6455 WebSocket framing
+ *
+ * See tekton-ws.h. The ring is one memfd mapped twice in a row, so the
+ * bytes at [head, tail) are always contiguous starting at base + head % cap.
+ * A frame is parsed and unmasked in place; an unfragmented, uncompressed
+ * message is returned as a pointer into the ring and released on the next
+ * call. Everything else is copied (or inflated) into the message buffer.
+ */
+#define _GNU_SOURCE
+#include "tekton-ws.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/random.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define VECTOR_CLONES __attribute__((target_clones("avx2", "default")))
+#endif
+#endif
+#ifndef VECTOR_CLONES
+#define VECTOR_CLONES
+#endif
+
+/* The tail permessage-deflate strips from every compressed message */
+static const uint8_t DEFLATE_TAIL[4] = {0x00, 0x00, 0xff, 0xff};
+
+typedef struct {
+    uint8_t *base;
+    size_t cap;               /* a multiple of the page size */
+    uint64_t head, tail;      /* absolute positions; buffered bytes are [head, tail) */
+} ring_t;
+
+struct tw_decoder {
+    ring_t ring;
+    int flags;
+    uint64_t max_message;
+    uint64_t release;         /* bytes of the last returned frame, dropped on the next call */
+    int msg_opcode;           /* the data message being assembled, 0 if none */
+    int msg_compressed;
+    uint8_t *buf;
+    size_t buf_len, buf_cap;
+    z_stream inflater;
+    int inflater_ready;
+    int window_bits;
+};
+
+struct tw_encoder {
+    int flags;
+    z_stream deflater;
+    int deflater_ready;
+    uint8_t *buf;
+    size_t cap;
+    uint8_t random[256];
+    size_t random_used;
+};
+
+/* ------------------------------------------------------------ primitives */
+
+typedef uint64_t block_t __attribute__((vector_size(32)));
+
+VECTOR_CLONES
+void tw_unmask(uint8_t *data, uint64_t len, const uint8_t mask[4], uint64_t offset) {
+    uint8_t m[8];
+    for (int i = 0; i < 8; i++)
+        m[i] = mask[(offset + i) & 3];
+    uint64_t word;
+    memcpy(&word, m, 8);
+    block_t key = {word, word, word, word};
+    uint64_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        block_t v;
+        memcpy(&v, data + i, 32);
+        v ^= key;
+        memcpy(data + i, &v, 32);
+    }
+    for (; i + 8 <= len; i += 8) {
+        uint64_t v;
+        memcpy(&v, data + i, 8);
+        v ^= word;
+        memcpy(data + i, &v, 8);
+    }
+    for (; i < len; i++)
+        data[i] ^= m[i & 7];
+}
+
+size_t tw_header(uint8_t *out, int fin, int rsv1, int opcode, uint64_t len, const uint8_t *mask) {
+    size_t n = 2;
+    out[0] = (uint8_t)((fin ? 0x80 : 0) | (rsv1 ? 0x40 : 0) | (opcode & 0x0f));
+    uint8_t masked = mask ? 0x80 : 0;
+    if (len < 126) {
+        out[1] = masked | (uint8_t)len;
+    } else if (len <= 0xffff) {
+        out[1] = masked | 126;
+        out[2] = (uint8_t)(len >> 8);
+        out[3] = (uint8_t)len;
+        n = 4;
+    } else {
+        out[1] = masked | 127;
+        for (int i = 0; i < 8; i++)
+            out[2 + i] = (uint8_t)(len >> (56 - 8 * i));
+        n = 10;
+    }
+    if (mask) {
+        memcpy(out + n, mask, 4);
+        n += 4;
+    }
+    return n;
+}
+
+int tw_utf8_valid(const uint8_t *s, uint64_t len) {
+    uint64_t i = 0;
+    while (i < len) {
+        /* ASCII runs eight bytes at a time */
+        while (i + 8 <= len) {
+            uint64_t v;
+            memcpy(&v, s + i, 8);
+            if (v & 0x8080808080808080ULL)
+                break;
+            i += 8;
+        }
+        if (i >= len)
+            break;
+        uint8_t c = s[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+        int n;
+        uint32_t cp;
+        if (c >= 0xc2 && c <= 0xdf) { n = 1; cp = c & 0x1f; }
+        else if (c >= 0xe0 && c <= 0xef) { n = 2; cp = c & 0x0f; }
+        else if (c >= 0xf0 && c <= 0xf4) { n = 3; cp = c & 0x07; }
+        else return 0;
+        if (i + n >= len)
+            return 0;
+        for (int k = 1; k <= n; k++) {
+            if ((s[i + k] & 0xc0) != 0x80)
+                return 0;
+            cp = (cp << 6) | (s[i + k] & 0x3f);
+        }
+        if ((n == 2 && cp < 0x800) || (n == 3 && cp < 0x10000) || cp > 0x10ffff ||
+            (cp >= 0xd800 && cp <= 0xdfff))
+            return 0;
+        i += n + 1;
+    }
+    return 1;
+}
+
+/* ------------------------------------------------------------------ ring */
+
+static int ring_init(ring_t *r, size_t want) {
+    long page = sysconf(_SC_PAGESIZE);
+    size_t cap = (want + (size_t)page - 1) / (size_t)page * (size_t)page;
+    int fd = memfd_create("tekton-ws", MFD_CLOEXEC);
+    if (fd < 0)
+        return -1;
+    if (ftruncate(fd, (off_t)cap) < 0) {
+        close(fd);
+        return -1;
+    }
+    uint8_t *area = mmap(NULL, 2 * cap, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    if (mmap(area, cap, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(area + cap, cap, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(area, 2 * cap);
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    r->base = area;
+    r->cap = cap;
+    r->head = r->tail = 0;
+    return 0;
+}
+
+static void ring_free(ring_t *r) {
+    if (r->base)
+        munmap(r->base, 2 * r->cap);
+    r->base = NULL;
+}
+
+static uint8_t *ring_data(const ring_t *r) { return r->base + r->head % r->cap; }
+static size_t ring_used(const ring_t *r) { return (size_t)(r->tail - r->head); }
+
+/* Move the buffered bytes to a ring of at least want bytes */
+static int ring_grow(ring_t *r, size_t want) {
+    ring_t bigger;
+    size_t cap = r->cap;
+    while (cap < want)
+        cap *= 2;
+    if (ring_init(&bigger, cap) < 0)
+        return -1;
+    size_t used = ring_used(r);
+    memcpy(bigger.base, ring_data(r), used);
+    bigger.tail = used;
+    ring_free(r);
+    *r = bigger;
+    return 0;
+}
+
+/* --------------------------------------------------------------- decoder */
+
+tw_decoder *tw_decoder_new(size_t capacity, int flags, uint64_t max_message, int window_bits) {
+    tw_decoder *d = calloc(1, sizeof(*d));
+    if (!d)
+        return NULL;
+    if (ring_init(&d->ring, capacity ? capacity : 65536) < 0) {
+        free(d);
+        return NULL;
+    }
+    d->flags = flags;
+    d->max_message = max_message;
+    d->window_bits = window_bits >= 8 && window_bits <= 15 ? window_bits : 15;
+    return d;
+}
+
+void tw_decoder_free(tw_decoder *d) {
+    if (!d)
+        return;
+    ring_free(&d->ring);
+    if (d->inflater_ready)
+        inflateEnd(&d->inflater);
+    free(d->buf);
+    free(d);
+}
+
+uint8_t *tw_decoder_space(tw_decoder *d, size_t *avail) {
+    *avail = d->ring.cap - ring_used(&d->ring);
+    return d->ring.base + d->ring.tail % d->ring.cap;
+}
+
+void tw_decoder_commit(tw_decoder *d, size_t n) {
+    d->ring.tail += n;
+}
+
+size_t tw_decoder_pending(const tw_decoder *d) {
+    return ring_used(&d->ring) - (size_t)d->release;
+}
+
+int tw_decoder_feed(tw_decoder *d, const uint8_t *data, size_t len) {
+    size_t avail;
+    tw_decoder_space(d, &avail);
+    if (avail < len && ring_grow(&d->ring, ring_used(&d->ring) + len) < 0)
+        return -1;
+    uint8_t *space = tw_decoder_space(d, &avail);
+    memcpy(space, data, len);
+    tw_decoder_commit(d, len);
+    return 0;
+}
+
+static int reserve(tw_decoder *d, size_t extra) {
+    if (d->buf_cap - d->buf_len >= extra)
+        return 0;
+    size_t cap = d->buf_cap ? d->buf_cap : 4096;
+    while (cap - d->buf_len < extra)
+        cap *= 2;
+    uint8_t *buf = realloc(d->buf, cap);
+    if (!buf)
+        return -1;
+    d->buf = buf;
+    d->buf_cap = cap;
+    return 0;
+}
+
+static int inflate_into(tw_decoder *d, const uint8_t *in, size_t len) {
+    z_stream *z = &d->inflater;
+    if (!d->inflater_ready) {
+        memset(z, 0, sizeof(*z));
+        if (inflateInit2(z, -d->window_bits) != Z_OK)
+            return -1;
+        d->inflater_ready = 1;
+    }
+    z->next_in = (Bytef *)in;
+    z->avail_in = (uInt)len;
+    do {
+        if (reserve(d, 16384) < 0)
+            return -1;
+        size_t room = d->buf_cap - d->buf_len;
+        z->next_out = d->buf + d->buf_len;
+        z->avail_out = (uInt)room;
+        int ret = inflate(z, Z_SYNC_FLUSH);
+        d->buf_len += room - z->avail_out;
+        if (ret == Z_MEM_ERROR)
+            return -1;
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+            return -TW_CLOSE_INVALID_DATA;
+        if (d->buf_len > d->max_message)
+            return -TW_CLOSE_TOO_BIG;
+    } while (z->avail_in > 0 || z->avail_out == 0);
+    return 0;
+}
+
+static int valid_close(const uint8_t *payload, uint64_t len) {
+    if (len == 0)
+        return 1;
+    if (len == 1)
+        return 0;
+    int code = payload[0] << 8 | payload[1];
+    if (!((code >= 1000 && code <= 1003) || (code >= 1007 && code <= 1011) ||
+          (code >= 3000 && code <= 4999)))
+        return 0;
+    return tw_utf8_valid(payload + 2, len - 2);
+}
+
+int tw_decoder_next(tw_decoder *d, tw_message *msg) {
+    ring_t *r = &d->ring;
+    r->head += d->release;
+    d->release = 0;
+
+    for (;;) {
+        size_t avail = ring_used(r);
+        if (avail < 2)
+            return 0;
+        uint8_t *p = ring_data(r);
+        int fin = p[0] & 0x80, rsv1 = p[0] & 0x40, opcode = p[0] & 0x0f;
+        int masked = p[1] & 0x80, len7 = p[1] & 0x7f;
+        size_t hlen = 2 + (len7 == 126 ? 2 : len7 == 127 ? 8 : 0) + (masked ? 4 : 0);
+        if (avail < hlen)
+            return 0;
+        uint64_t len = (uint64_t)len7;
+        if (len7 == 126) {
+            len = (uint64_t)p[2] << 8 | p[3];
+        } else if (len7 == 127) {
+            len = 0;
+            for (int i = 0; i < 8; i++)
+                len = len << 8 | p[2 + i];
+        }
+
+        int control = opcode & 0x08;
+        if ((p[0] & 0x30) || (opcode > TW_OP_BINARY && opcode < TW_OP_CLOSE) || opcode > TW_OP_PONG)
+            return -TW_CLOSE_PROTOCOL;
+        if (rsv1 && (!(d->flags & TW_DEFLATE) || control || opcode == TW_OP_CONTINUATION))
+            return -TW_CLOSE_PROTOCOL;
+        if ((d->flags & TW_REQUIRE_MASK) && !masked)
+            return -TW_CLOSE_PROTOCOL;
+        if (control && (!fin || len > 125))
+            return -TW_CLOSE_PROTOCOL;
+        if (len >> 63)
+            return -TW_CLOSE_PROTOCOL;
+        if (len > d->max_message)
+            return -TW_CLOSE_TOO_BIG;
+
+        uint64_t total = hlen + len;
+        if (total > avail) {
+            if (total > r->cap && ring_grow(r, (size_t)total) < 0)
+                return -1;
+            return 0;
+        }
+        uint8_t *payload = p + hlen;
+        if (masked)
+            tw_unmask(payload, len, p + hlen - 4, 0);
+
+        if (control) {
+            if (opcode == TW_OP_CLOSE && !valid_close(payload, len))
+                return len == 1 ? -TW_CLOSE_PROTOCOL : -TW_CLOSE_INVALID_DATA;
+            msg->opcode = opcode;
+            msg->data = payload;
+            msg->len = len;
+            d->release = total;
+            return 1;
+        }
+
+        if (opcode != TW_OP_CONTINUATION) {
+            if (d->msg_opcode)
+                return -TW_CLOSE_PROTOCOL;
+            if (fin && !rsv1) {
+                /* The common case: one frame, handed back where it lies */
+                if (opcode == TW_OP_TEXT && !tw_utf8_valid(payload, len))
+                    return -TW_CLOSE_INVALID_DATA;
+                msg->opcode = opcode;
+                msg->data = payload;
+                msg->len = len;
+                d->release = total;
+                return 1;
+            }
+            d->msg_opcode = opcode;
+            d->msg_compressed = rsv1 != 0;
+            d->buf_len = 0;
+        } else if (!d->msg_opcode) {
+            return -TW_CLOSE_PROTOCOL;
+        }
+
+        int err = 0;
+        if (d->msg_compressed) {
+            err = inflate_into(d, payload, (size_t)len);
+        } else if (d->buf_len + len > d->max_message) {
+            err = -TW_CLOSE_TOO_BIG;
+        } else if (reserve(d, (size_t)len) < 0) {
+            err = -1;
+        } else {
+            memcpy(d->buf + d->buf_len, payload, (size_t)len);
+            d->buf_len += (size_t)len;
+        }
+        if (err)
+            return err;
+        r->head += total;
+        if (!fin)
+            continue;
+
+        if (d->msg_compressed) {
+            if ((err = inflate_into(d, DEFLATE_TAIL, sizeof(DEFLATE_TAIL))) != 0)
+                return err;
+            if (d->flags & TW_NO_CONTEXT_TAKEOVER)
+                inflateReset(&d->inflater);
+        }
+        if (d->msg_opcode == TW_OP_TEXT && !tw_utf8_valid(d->buf, d->buf_len))
+            return -TW_CLOSE_INVALID_DATA;
+        msg->opcode = d->msg_opcode;
+        msg->data = d->buf;
+        msg->len = d->buf_len;
+        d->msg_opcode = 0;
+        return 1;
+    }
+}
+
+/* --------------------------------------------------------------- encoder */
+
+tw_encoder *tw_encoder_new(int flags, int window_bits) {
+    tw_encoder *e = calloc(1, sizeof(*e));
+    if (!e)
+        return NULL;
+    e->flags = flags;
+    if (flags & TW_DEFLATE) {
+        /* zlib cannot produce a raw deflate stream with an 8-bit window */
+        int bits = window_bits >= 9 && window_bits <= 15 ? window_bits : 15;
+        if (deflateInit2(&e->deflater, Z_BEST_SPEED, Z_DEFLATED, -bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            free(e);
+            return NULL;
+        }
+        e->deflater_ready = 1;
+    }
+    e->random_used = sizeof(e->random);
+    return e;
+}
+
+void tw_encoder_free(tw_encoder *e) {
+    if (!e)
+        return;
+    if (e->deflater_ready)
+        deflateEnd(&e->deflater);
+    free(e->buf);
+    free(e);
+}
+
+static int ensure(tw_encoder *e, size_t need) {
+    if (e->cap >= need)
+        return 0;
+    size_t cap = e->cap ? e->cap : 4096;
+    while (cap < need)
+        cap *= 2;
+    uint8_t *buf = realloc(e->buf, cap);
+    if (!buf)
+        return -1;
+    e->buf = buf;
+    e->cap = cap;
+    return 0;
+}
+
+static void random_mask(tw_encoder *e, uint8_t mask[4]) {
+    if (e->random_used + 4 > sizeof(e->random)) {
+        if (getrandom(e->random, sizeof(e->random), 0) != (ssize_t)sizeof(e->random))
+            for (size_t i = 0; i < sizeof(e->random); i++)
+                e->random[i] = (uint8_t)rand();
+        e->random_used = 0;
+    }
+    memcpy(mask, e->random + e->random_used, 4);
+    e->random_used += 4;
+}
+
+int64_t tw_encode(tw_encoder *e, int opcode, const uint8_t *data, uint64_t len,
+                  int compress, const uint8_t **out) {
+    compress = compress && e->deflater_ready && !(opcode & 0x08);
+    uint64_t plen;
+    /* The payload goes at TW_MAX_HEADER and its header right before it */
+    if (compress) {
+        z_stream *z = &e->deflater;
+        if (ensure(e, TW_MAX_HEADER + deflateBound(z, (uLong)len) + 16) < 0)
+            return -1;
+        z->next_in = (Bytef *)data;
+        z->avail_in = (uInt)len;
+        plen = 0;
+        do {
+            if (e->cap - TW_MAX_HEADER - plen < 64 && ensure(e, e->cap * 2) < 0)
+                return -1;
+            size_t room = e->cap - TW_MAX_HEADER - plen;
+            z->next_out = e->buf + TW_MAX_HEADER + plen;
+            z->avail_out = (uInt)room;
+            if (deflate(z, Z_SYNC_FLUSH) == Z_STREAM_ERROR)
+                return -1;
+            plen += room - z->avail_out;
+        } while (z->avail_in > 0 || z->avail_out == 0);
+        if (plen >= 4 && memcmp(e->buf + TW_MAX_HEADER + plen - 4, DEFLATE_TAIL, 4) == 0)
+            plen -= 4;
+        if (e->flags & TW_NO_CONTEXT_TAKEOVER)
+            deflateReset(z);
+    } else {
+        if (ensure(e, TW_MAX_HEADER + len) < 0)
+            return -1;
+        memcpy(e->buf + TW_MAX_HEADER, data, len);
+        plen = len;
+    }
+
+    uint8_t mask[4], header[TW_MAX_HEADER];
+    int masking = e->flags & TW_MASK;
+    if (masking) {
+        random_mask(e, mask);
+        tw_unmask(e->buf + TW_MAX_HEADER, plen, mask, 0);
+    }
+    size_t hlen = tw_header(header, 1, compress, opcode, plen, masking ? mask : NULL);
+    uint8_t *start = e->buf + TW_MAX_HEADER - hlen;
+    memcpy(start, header, hlen);
+    *out = start;
+    return (int64_t)(hlen + plen);
+}
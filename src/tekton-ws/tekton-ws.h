@@ -0,0 +1,103 @@
+/*
+ * tekton-ws.h - RFC 6455 WebSocket framing for the Hephaestus socket bridge
+ *
+ * A decoder owns a ring buffer mapped twice back to back, so any span of
+ * buffered bytes is contiguous in memory. Callers recv() straight into
+ * tw_decoder_space(); frames are parsed and unmasked where they lie, and an
+ * unfragmented, uncompressed message is handed back as a pointer into the
+ * ring. Fragmented messages are joined, and compressed ones inflated, into
+ * a separate message buffer.
+ *
+ * permessage-deflate (RFC 7692) is supported in both directions: raw
+ * deflate, the 0x00 0x00 0xff 0xff tail removed from each message, with
+ * the sliding window kept between messages unless no_context_takeover was
+ * negotiated for that direction.
+ *
+ * Errors are reported as the negated close code the connection should be
+ * closed with (1002 protocol error, 1007 invalid payload, 1009 too big), or
+ * -1 when memory runs out.
+ */
+#ifndef TEKTON_WS_H
+#define TEKTON_WS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TW_OP_CONTINUATION 0x0
+#define TW_OP_TEXT 0x1
+#define TW_OP_BINARY 0x2
+#define TW_OP_CLOSE 0x8
+#define TW_OP_PING 0x9
+#define TW_OP_PONG 0xA
+
+#define TW_CLOSE_PROTOCOL 1002
+#define TW_CLOSE_INVALID_DATA 1007
+#define TW_CLOSE_TOO_BIG 1009
+
+/* Decoder: frames must be masked (a server reading a client) */
+#define TW_REQUIRE_MASK 0x1
+/* Encoder: mask frames (a client writing to a server) */
+#define TW_MASK 0x1
+/* permessage-deflate was negotiated */
+#define TW_DEFLATE 0x2
+/* The compressing side resets its window after every message */
+#define TW_NO_CONTEXT_TAKEOVER 0x4
+
+/* Longest frame header: 2 + 8 length + 4 mask */
+#define TW_MAX_HEADER 14
+
+typedef struct tw_decoder tw_decoder;
+typedef struct tw_encoder tw_encoder;
+
+typedef struct {
+    int opcode;              /* TW_OP_TEXT, _BINARY, _CLOSE, _PING or _PONG */
+    const uint8_t *data;     /* valid until the next call on the decoder */
+    uint64_t len;
+} tw_message;
+
+/*
+ * A decoder with a ring of at least capacity bytes (grown for larger
+ * frames) that rejects messages over max_message bytes. window_bits is the
+ * peer's deflate window (8-15), used with TW_DEFLATE.
+ */
+tw_decoder *tw_decoder_new(size_t capacity, int flags, uint64_t max_message, int window_bits);
+void tw_decoder_free(tw_decoder *d);
+
+/* Where to put received bytes, and how many fit there */
+uint8_t *tw_decoder_space(tw_decoder *d, size_t *avail);
+/* n bytes were written at tw_decoder_space() */
+void tw_decoder_commit(tw_decoder *d, size_t n);
+/* Copy data in (for callers that did not read into the ring). 0 or -1 */
+int tw_decoder_feed(tw_decoder *d, const uint8_t *data, size_t len);
+/* Bytes buffered but not yet consumed */
+size_t tw_decoder_pending(const tw_decoder *d);
+
+/*
+ * The next complete message: 1 and msg filled in, 0 if more bytes are
+ * needed, or a negated close code. Control frames are returned as soon as
+ * they arrive, including between the fragments of a data message.
+ */
+int tw_decoder_next(tw_decoder *d, tw_message *msg);
+
+/* An encoder; window_bits is our deflate window (8-15), used with TW_DEFLATE */
+tw_encoder *tw_encoder_new(int flags, int window_bits);
+void tw_encoder_free(tw_encoder *e);
+
+/*
+ * One frame carrying a whole message, compressed if compress is set and
+ * the encoder was made with TW_DEFLATE (never for control frames). *out
+ * is valid until the next call. Returns the frame length or -1.
+ */
+int64_t tw_encode(tw_encoder *e, int opcode, const uint8_t *data, uint64_t len,
+                  int compress, const uint8_t **out);
+
+/* XOR len bytes with the 4-byte mask, starting offset bytes into the mask stream */
+void tw_unmask(uint8_t *data, uint64_t len, const uint8_t mask[4], uint64_t offset);
+
+/* Write a frame header to out (TW_MAX_HEADER bytes); mask may be NULL. Returns its length */
+size_t tw_header(uint8_t *out, int fin, int rsv1, int opcode, uint64_t len, const uint8_t *mask);
+
+/* Is data valid UTF-8? */
+int tw_utf8_valid(const uint8_t *data, uint64_t len);
+
+#endif /* TEKTON_WS_H */
@@ -204,7 +204,7 @@ class TektonConfig:
         
         # Load all environment variables with the specified prefix
         from shared.env import TektonEnviron
-        for key, value in TektonEnviron.all().items():
+        for key, value in TektonEnviron.with_prefix(prefix).items():
             if key.startswith(prefix):
                 # Convert env var name to config key (e.g., MYCOMPONENT_PORT -> port)
                 config_key = key[len(prefix):].lower()
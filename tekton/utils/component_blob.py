@@ -0,0 +1,221 @@
+"""
+Precompiled binary component configuration.
+
+The launcher compiles config/tekton_components.yaml plus the merged port
+environment into one versioned binary file under $TEKTON_ROOT/.tekton/.
+Python (ComponentConfig) and the C launcher both mmap that file instead of
+reparsing YAML and re-reading every *_PORT variable.
+
+Layout (little-endian):
+
+    header   magic "TKCB", version, header size, count, port base,
+             CI port base, yaml mtime, yaml size, port env digest
+    names    count x 32-byte NUL padded component ids
+    ports    count x u32
+    ai_ports count x u32   (TEKTON_AI_PORT_BASE + port - TEKTON_PORT_BASE)
+    priority count x i32
+    deps     count + 1 x u32 starts into dep names; component i depends on
+             dep_names[deps[i]:deps[i + 1]], in declared order
+    dep_names one u32 string table offset per dependency, including
+             dependencies that are not in the component table
+    strings  count x 4 x u32 offsets (name, description, category,
+             comma-joined capabilities) into the string table that follows
+
+A blob is only used when the YAML file and every port variable it was
+compiled from are unchanged; otherwise callers fall back to parsing. The
+C launcher applies the same checks before it exports ports from a blob.
+Ports the launcher exported from the blob itself (listed in
+_TEKTON_BLOB_PORTS) count as unset in the digest, so the digest always
+describes the env files, which is all the launcher sees.
+"""
+
+import mmap
+import os
+import struct
+from pathlib import Path
+from typing import Dict, List, Optional
+
+BLOB_MAGIC = b"TKCB"
+BLOB_VERSION = 3
+BLOB_FILENAME = "component_config.bin"
+
+NAME_SIZE = 32
+
+_HEADER = struct.Struct("<4sHHIIIdQQ")
+
+# Set by the C launcher: the *_PORT variables it exported from the blob
+BLOB_PORTS_VAR = "_TEKTON_BLOB_PORTS"
+
+_FNV_OFFSET = 0xcbf29ce484222325
+_FNV_PRIME = 0x100000001b3
+
+
+def blob_path(tekton_root: os.PathLike) -> Path:
+    """Location of the compiled configuration for an installation."""
+    return Path(tekton_root) / ".tekton" / BLOB_FILENAME
+
+
+def port_env_digest(component_ids: List[str], env) -> int:
+    """
+    FNV-1a 64 of every environment value a blob's ports were derived from.
+
+    Mirrors blob_port_env_digest() in tekton-clean-launch.c.
+    """
+    keys = ["TEKTON_PORT_BASE", "TEKTON_AI_PORT_BASE"]
+    keys += [f"{comp_id.upper()}_PORT" for comp_id in component_ids]
+    exported = set(filter(None, (env.get(BLOB_PORTS_VAR) or "").split(",")))
+    h = _FNV_OFFSET
+    for key in keys:
+        value = "" if key in exported else (env.get(key) or "")
+        for byte in f"{key}={value}\n".encode("utf-8"):
+            h = ((h ^ byte) * _FNV_PRIME) & 0xffffffffffffffff
+    return h
+
+
+def write_component_blob(components: Dict[str, "ComponentInfo"],
+                         path: os.PathLike,
+                         yaml_path: os.PathLike,
+                         env) -> Path:
+    """
+    Serialize parsed components to the binary format.
+
+    env is anything with get(key, default), such as a dict or TektonEnviron.
+
+    Written to a temporary file and renamed so readers never map a
+    partially written blob.
+    """
+    ids = list(components.keys())
+    port_base = int(env.get("TEKTON_PORT_BASE") or 0)
+    ai_port_base = int(env.get("TEKTON_AI_PORT_BASE") or 0)
+
+    strings = bytearray()
+
+    def intern(text: str) -> int:
+        offset = len(strings)
+        strings.extend(text.encode("utf-8") + b"\0")
+        return offset
+
+    names, ports, ai_ports, priorities, offsets = [], [], [], [], []
+    deps, dep_names = [0], []
+    for comp_id in ids:
+        comp = components[comp_id]
+        encoded = comp_id.encode("utf-8")
+        if len(encoded) >= NAME_SIZE:
+            raise ValueError(f"Component id too long for blob: {comp_id}")
+        names.append(encoded.ljust(NAME_SIZE, b"\0"))
+        ports.append(comp.port)
+        ai_ports.append(ai_port_base + (comp.port - port_base) if ai_port_base else 0)
+        priorities.append(comp.startup_priority)
+        dep_names.extend(intern(dep) for dep in comp.dependencies)
+        deps.append(len(dep_names))
+        offsets.extend([
+            intern(comp.name),
+            intern(comp.description),
+            intern(comp.category),
+            intern(",".join(comp.capabilities)),
+        ])
+
+    st = os.stat(yaml_path)
+    count = len(ids)
+    header = _HEADER.pack(
+        BLOB_MAGIC, BLOB_VERSION, _HEADER.size, count, port_base, ai_port_base,
+        st.st_mtime, st.st_size, port_env_digest(ids, env)
+    )
+    body = b"".join([
+        b"".join(names),
+        struct.pack(f"<{count}I", *ports),
+        struct.pack(f"<{count}I", *ai_ports),
+        struct.pack(f"<{count}i", *priorities),
+        struct.pack(f"<{count + 1}I", *deps),
+        struct.pack(f"<{len(dep_names)}I", *dep_names),
+        struct.pack(f"<{count * 4}I", *offsets),
+        bytes(strings),
+    ])
+
+    path = Path(path)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    tmp_path = path.with_suffix(f".tmp.{os.getpid()}")
+    with open(tmp_path, "wb") as f:
+        f.write(header)
+        f.write(body)
+    os.replace(tmp_path, path)
+    return path
+
+
+def load_component_blob(path: os.PathLike,
+                        yaml_path: os.PathLike,
+                        env) -> Optional[List["ComponentInfo"]]:
+    """
+    Map a compiled blob and return its components.
+
+    Returns None if the blob is missing, from another format version, or
+    stale relative to the YAML file or the current port environment.
+    """
+    from tekton.utils.component_config import ComponentInfo
+
+    try:
+        st = os.stat(yaml_path)
+        with open(path, "rb") as f:
+            mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    except (OSError, ValueError):
+        return None
+
+    try:
+        if len(mm) < _HEADER.size:
+            return None
+        (magic, version, header_size, count, _port_base, _ai_port_base,
+         yaml_mtime, yaml_size, digest) = _HEADER.unpack_from(mm, 0)
+        if magic != BLOB_MAGIC or version != BLOB_VERSION:
+            return None
+        if yaml_mtime != st.st_mtime or yaml_size != st.st_size:
+            return None
+
+        offset = header_size
+        ids = []
+        for i in range(count):
+            raw = mm[offset + i * NAME_SIZE:offset + (i + 1) * NAME_SIZE]
+            ids.append(raw.rstrip(b"\0").decode("utf-8"))
+        offset += count * NAME_SIZE
+
+        if port_env_digest(ids, env) != digest:
+            return None
+
+        ports = struct.unpack_from(f"<{count}I", mm, offset)
+        offset += 4 * count
+        ai_ports = struct.unpack_from(f"<{count}I", mm, offset)
+        offset += 4 * count
+        priorities = struct.unpack_from(f"<{count}i", mm, offset)
+        offset += 4 * count
+        deps = struct.unpack_from(f"<{count + 1}I", mm, offset)
+        offset += 4 * (count + 1)
+        dep_names = struct.unpack_from(f"<{deps[count]}I", mm, offset)
+        offset += 4 * deps[count]
+        string_offsets = struct.unpack_from(f"<{count * 4}I", mm, offset)
+        strings_start = offset + 16 * count
+
+        def string_at(rel: int) -> str:
+            start = strings_start + rel
+            end = mm.find(b"\0", start)
+            return mm[start:end].decode("utf-8")
+
+        components = []
+        for i, comp_id in enumerate(ids):
+            name, description, category, caps = (
+                string_at(o) for o in string_offsets[i * 4:i * 4 + 4]
+            )
+            components.append(ComponentInfo(
+                id=comp_id,
+                name=name,
+                port=ports[i],
+                ai_port=ai_ports[i] or None,
+                description=description,
+                category=category,
+                startup_priority=priorities[i],
+                dependencies=[string_at(o) for o in dep_names[deps[i]:deps[i + 1]]],
+                capabilities=caps.split(",") if caps else []
+            ))
+        return components
+    except (struct.error, UnicodeDecodeError, IndexError):
+        return None
+    finally:
+        mm.close()
@@ -23,6 +23,7 @@ class ComponentInfo:
     startup_priority: int = 0
     dependencies: List[str] = field(default_factory=list)
     capabilities: List[str] = field(default_factory=list)
+    ai_port: Optional[int] = None  # CI port, when loaded from the compiled blob
     
 
 @dataclass
@@ -46,12 +47,47 @@ class ComponentConfig:
         self._services: Dict[str, ServiceInfo] = {}
         self._load_config()
         
+    @staticmethod
+    def _config_path() -> Path:
+        return Path(__file__).parent.parent.parent / "config" / "tekton_components.yaml"
+    
+    @staticmethod
+    def _blob_path() -> Path:
+        from tekton.utils.component_blob import blob_path
+        return blob_path(Path(__file__).parent.parent.parent)
+        
+    def _load_blob(self, config_path: Path) -> bool:
+        """Load components from the launcher's compiled blob if it is current"""
+        from tekton.utils.component_blob import load_component_blob
+        from shared.env import TektonEnviron
+        
+        # Through TektonEnviron.get so reload tracking sees the port keys read
+        components = load_component_blob(self._blob_path(), config_path, TektonEnviron)
+        if components is None:
+            return False
+        self._components = {comp.id: comp for comp in components}
+        return True
+    
+    def compile_blob(self) -> Optional[Path]:
+        """Write the compiled blob for other processes (called by the launcher)"""
+        from tekton.utils.component_blob import write_component_blob
+        from shared.env import TektonEnviron
+        
+        # Services aren't part of the blob format; keep parsing YAML if any exist
+        if self._services:
+            return None
+        return write_component_blob(self._components, self._blob_path(),
+                                    self._config_path(), TektonEnviron)
+        
     def _load_config(self):
-        """Load configuration from YAML file"""
-        config_path = Path(__file__).parent.parent.parent / "config" / "tekton_components.yaml"
+        """Load configuration from the compiled blob, or the YAML file"""
+        config_path = self._config_path()
         
         if not config_path.exists():
             raise FileNotFoundError(f"Component configuration not found at {config_path}")
+        
+        if self._load_blob(config_path):
+            return
             
         with open(config_path, 'r') as f:
             self._config = yaml.safe_load(f)
@@ -204,7 +204,8 @@ class TektonConfig:
         loaded = False
         
         # Load all environment variables with the specified prefix
-        for key, value in os.environ.items():
+        from shared.env import TektonEnviron
+        for key, value in TektonEnviron.with_prefix(prefix).items():
             if key.startswith(prefix):
                 # Convert env var name to config key (e.g., MYCOMPONENT_PORT -> port)
                 config_key = key[len(prefix):].lower()
@@ -0,0 +1,134 @@
+"""
+Tests for the precompiled binary component configuration.
+"""
+
+import json
+import os
+import shutil
+import subprocess
+import tempfile
+import unittest
+from pathlib import Path
+
+from tekton.utils.component_config import ComponentInfo
+from tekton.utils.component_blob import (
+    write_component_blob,
+    load_component_blob,
+    BLOB_FILENAME
+)
+
+LAUNCHER_SOURCE = Path(__file__).parents[3] / "src" / "tekton-launcher"
+
+
+class TestComponentBlob(unittest.TestCase):
+    """Test compiling and mapping the component blob."""
+
+    def setUp(self):
+        """Set up a YAML stand-in and a small component set."""
+        self.tmpdir = tempfile.TemporaryDirectory()
+        root = Path(self.tmpdir.name)
+        self.yaml_path = root / "tekton_components.yaml"
+        self.yaml_path.write_text("components: {}\n")
+        self.blob_path = root / ".tekton" / BLOB_FILENAME
+        self.env = {
+            "TEKTON_PORT_BASE": "8100",
+            "TEKTON_AI_PORT_BASE": "44000",
+            "HERMES_PORT": "8101",
+            "RHETOR_PORT": "8103",
+        }
+        self.components = {
+            "hermes": ComponentInfo(
+                id="hermes", name="Hermes", port=8101,
+                description="Service registry", category="infrastructure",
+                startup_priority=1, ai_port=44001
+            ),
+            "rhetor": ComponentInfo(
+                id="rhetor", name="Rhetor", port=8103,
+                description="LLM orchestration", category="ai",
+                startup_priority=3, dependencies=["hermes"],
+                capabilities=["llm_orchestration", "intelligent_routing"],
+                ai_port=44003
+            ),
+        }
+
+    def tearDown(self):
+        """Clean up."""
+        self.tmpdir.cleanup()
+
+    def test_round_trip(self):
+        """Components survive compile and load unchanged."""
+        write_component_blob(self.components, self.blob_path, self.yaml_path, self.env)
+        loaded = load_component_blob(self.blob_path, self.yaml_path, self.env)
+        self.assertIsNotNone(loaded)
+        self.assertEqual({c.id: c for c in loaded}, self.components)
+
+    def test_dependencies_keep_order_and_unknown_names(self):
+        """Dependencies come back as declared, including ones outside the table."""
+        self.components["rhetor"].dependencies = ["ollama", "hermes", "engram"]
+        write_component_blob(self.components, self.blob_path, self.yaml_path, self.env)
+        loaded = {c.id: c for c in load_component_blob(self.blob_path, self.yaml_path, self.env)}
+        self.assertEqual(loaded["rhetor"].dependencies, ["ollama", "hermes", "engram"])
+        self.assertEqual(loaded["hermes"].dependencies, [])
+
+    def test_stale_when_port_env_changes(self):
+        """A changed port variable invalidates the blob."""
+        write_component_blob(self.components, self.blob_path, self.yaml_path, self.env)
+        changed = dict(self.env, RHETOR_PORT="9103")
+        self.assertIsNone(load_component_blob(self.blob_path, self.yaml_path, changed))
+
+    def test_stale_when_yaml_changes(self):
+        """Editing the YAML file invalidates the blob."""
+        write_component_blob(self.components, self.blob_path, self.yaml_path, self.env)
+        self.yaml_path.write_text("components: {}\n# edited\n")
+        self.assertIsNone(load_component_blob(self.blob_path, self.yaml_path, self.env))
+
+    def test_missing_or_corrupt_blob(self):
+        """Missing or foreign files fall back to parsing."""
+        self.assertIsNone(load_component_blob(self.blob_path, self.yaml_path, self.env))
+        self.blob_path.parent.mkdir(parents=True)
+        self.blob_path.write_bytes(b"not a blob")
+        self.assertIsNone(load_component_blob(self.blob_path, self.yaml_path, self.env))
+
+    def test_ports_exported_from_the_blob_count_as_unset(self):
+        """The launcher's own exports don't make the blob look stale."""
+        env = dict(self.env)
+        del env["RHETOR_PORT"]
+        write_component_blob(self.components, self.blob_path, self.yaml_path, env)
+        exported = dict(env, RHETOR_PORT="8103", _TEKTON_BLOB_PORTS="RHETOR_PORT")
+        self.assertIsNotNone(load_component_blob(self.blob_path, self.yaml_path, exported))
+        self.assertIsNone(load_component_blob(self.blob_path, self.yaml_path, dict(env, RHETOR_PORT="8103")))
+
+    @unittest.skipUnless(shutil.which("make") and shutil.which("cc"), "no C toolchain")
+    def test_launcher_applies_the_same_staleness_checks(self):
+        """The C launcher exports blob ports only while the YAML and port env match."""
+        root = Path(self.tmpdir.name) / "root"
+        (root / "config").mkdir(parents=True)
+        (root / "home").mkdir()
+        (root / ".env.tekton").write_text("TEKTON_PORT_BASE=8100\nTEKTON_AI_PORT_BASE=44000\nHERMES_PORT=8101\n")
+        yaml_path = root / "config" / "tekton_components.yaml"
+        yaml_path.write_text("components: {}\n")
+        launcher = str(root / "tekton-clean-launch")
+        subprocess.run(["make", "-s", "-C", str(LAUNCHER_SOURCE), f"TARGET={launcher}", "USDT=0"], check=True)
+
+        def launcher_env(env_local=""):
+            (root / ".env.local").write_text(env_local)
+            output = subprocess.run(
+                [launcher, str(root), "env", "--format", "json"], check=True, capture_output=True, text=True,
+                env={"HOME": str(root / "home"), "PATH": os.environ.get("PATH", ""), "TEKTON_PORT_ALLOCATOR": "0"})
+            return json.loads(output.stdout)
+
+        file_env = {"TEKTON_PORT_BASE": "8100", "TEKTON_AI_PORT_BASE": "44000", "HERMES_PORT": "8101"}
+        write_component_blob(self.components, root / ".tekton" / BLOB_FILENAME, yaml_path, file_env)
+        env = launcher_env()
+        self.assertEqual(env["RHETOR_PORT"], "8103")
+        self.assertEqual(env["_TEKTON_BLOB_PORTS"], "RHETOR_PORT")
+        # What Python components see still validates the blob
+        self.assertIsNotNone(load_component_blob(root / ".tekton" / BLOB_FILENAME, yaml_path, env))
+
+        self.assertNotIn("RHETOR_PORT", launcher_env("HERMES_PORT=9101\n"))
+        yaml_path.write_text("components: {}\n# edited\n")
+        self.assertNotIn("RHETOR_PORT", launcher_env())
+
+
+if __name__ == "__main__":
+    unittest.main()